@@ -1,10 +1,12 @@
 
 #include "saci-core/sc-event.h"
 #include "saci-core/sc-rendering.h"
+#include "saci-core/sc-shape.h"
 #include "saci-core/sc-windowing.h"
 #include "saci-utils/su-math.h"
 
 #include <assert.h>
+#include <math.h>
 
 #include <unistd.h>
 
@@ -26,6 +28,8 @@ static saci_Color triangleColor[3] = {
     (saci_Color){0, 0, 1, 1},
 };
 
+static saci_Vec2 starVert[10];
+
 int main() {
     {
         assert(sc_GLFWInit());
@@ -40,17 +44,37 @@ int main() {
     renderer = sc_CreateRenderer(true);
     assert(renderer);
 
+    // NDC is 2 units tall
+    sc_RenderSetShapePixelSize(renderer, 2.0f / screen_height);
+
+    for (int i = 0; i < 10; ++i) {
+        float radius = (i % 2) ? 0.08f : 0.2f;
+        float angle = i * 3.14159265f / 5.0f + 3.14159265f / 2.0f;
+        starVert[i] = (saci_Vec2){-0.5f + radius * cosf(angle), 0.4f + radius * sinf(angle)};
+    }
+
+    sc_Path* wave = sc_CreatePath();
+    sc_PathMoveTo(wave, (saci_Vec2){-0.9f, -0.6f});
+    sc_PathCubicTo(wave, (saci_Vec2){-0.5f, -0.1f}, (saci_Vec2){-0.1f, -1.0f}, (saci_Vec2){0.3f, -0.5f});
+    sc_PathQuadTo(wave, (saci_Vec2){0.5f, -0.3f}, (saci_Vec2){0.7f, -0.6f});
+
     saci_Color bgColor = saci_ColorFromU8(25, 70, 125, 255);
     while (!sc_WindowShouldClose(window)) {
         sc_ClearWindow(bgColor);
 
         sc_RenderBegin(renderer);
         sc_RenderPushTriangle2D(renderer, triangleVert[0], triangleVert[1], triangleVert[2], 0.0f, triangleColor[0], triangleColor[1], triangleColor[2]);
+        sc_RenderPushCircle(renderer, (saci_Vec2){-0.1f, 0.4f}, 0.15f, 0.0f, saci_ColorFromU8(230, 90, 80, 255));
+        sc_RenderPushRoundedRect(renderer, (saci_Vec2){-0.9f, -0.2f}, (saci_Vec2){0.5f, 0.3f}, 0.05f, 0.0f, saci_ColorFromU8(235, 235, 235, 255));
+        sc_RenderPushArc(renderer, (saci_Vec2){0.6f, -0.3f}, 0.2f, 0.04f, 0.0f, 4.5f, 0.0f, saci_ColorFromU8(80, 200, 250, 255));
+        sc_RenderPushPolygon(renderer, starVert, 10, 0.0f, saci_ColorFromU8(250, 220, 60, 255));
+        sc_RenderPushPathStroke(renderer, wave, 0.02f, 0.0f, saci_ColorFromU8(255, 255, 255, 255));
         sc_RenderEnd(renderer, NULL);
         sc_SwapWindowBuffer(window);
 
         sc_PollEvents();
     }
+    sc_DeletePath(wave);
     sc_DeleteRenderer(renderer);
     sc_Terminate();
 }
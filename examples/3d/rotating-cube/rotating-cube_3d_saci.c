@@ -94,8 +94,10 @@ static void init_saci() {
     camera.position.z = -10.0f; // Change as you may
     camera.position.y = 5.0f;
 
-    sc_RenderEnableZBuffer();
-    sc_RenderSetProjectionMode(SACI_RENDER_PERSPECTIVE_PROJECTION);
+    sc_RenderConfig config = sc_RenderGetDefaultConfig();
+    config.useZBuffer = SACI_TRUE;
+    config.projectionMode = SACI_RENDER_PERSPECTIVE_PROJECTION;
+    sc_RenderSetConfig(renderer, &config);
 }
 
 int main() {
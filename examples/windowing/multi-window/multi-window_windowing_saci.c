@@ -0,0 +1,91 @@
+#include "saci-core/sc-event.h"
+#include "saci-core/sc-rendering.h"
+#include "saci-core/sc-window-group.h"
+#include "saci-core/sc-windowing.h"
+#include "saci-utils/su-math.h"
+
+#include <assert.h>
+#include <math.h>
+
+#define WINDOW_COUNT 3
+
+// One per window, only touched by that window's render thread
+typedef struct WindowState {
+    sc_Renderer* renderer;
+    saci_Color bgColor;
+    float speed;
+} WindowState;
+
+static WindowState windowStates[WINDOW_COUNT];
+
+static saci_Color triangleColor[3] = {
+    (saci_Color){1, 0, 0, 1},
+    (saci_Color){0, 1, 0, 1},
+    (saci_Color){0, 0, 1, 1},
+};
+
+static void initWindow(sc_Window* window, void* userData) {
+    (void)window;
+    WindowState* state = (WindowState*)userData;
+    // VAOs aren't shared between contexts, every window needs its own renderer
+    state->renderer = sc_CreateRenderer(true);
+    assert(state->renderer);
+}
+
+static void renderWindow(sc_Window* window, saci_u64 frame, void* userData) {
+    (void)window;
+    WindowState* state = (WindowState*)userData;
+    float angle = frame * state->speed;
+
+    sc_ClearWindow(state->bgColor);
+
+    sc_RenderBegin(state->renderer);
+    saci_Vec2 vertices[3];
+    for (int i = 0; i < 3; i++) {
+        float vertexAngle = angle + i * 2.0f * SACI_PI / 3.0f;
+        vertices[i] = (saci_Vec2){0.6f * cosf(vertexAngle), 0.6f * sinf(vertexAngle)};
+    }
+    sc_RenderPushTriangle2D(state->renderer, vertices[0], vertices[1], vertices[2], 0.0f,
+                            triangleColor[0], triangleColor[1], triangleColor[2]);
+    sc_RenderEnd(state->renderer, NULL);
+}
+
+static void shutdownWindow(sc_Window* window, void* userData) {
+    (void)window;
+    WindowState* state = (WindowState*)userData;
+    sc_DeleteRenderer(state->renderer);
+}
+
+int main() {
+    assert(sc_GLFWInit());
+    saci_InitMath();
+
+    sc_WindowGroup* group = sc_CreateWindowGroup();
+    assert(group);
+
+    for (int i = 0; i < WINDOW_COUNT; i++) {
+        sc_Window* window = sc_WindowGroupCreateWindow(group, 640, 480, "SACI MULTI WINDOW", NULL);
+        assert(window);
+
+        windowStates[i].bgColor = saci_ColorFromU8(25 + i * 60, 70, 125, 255);
+        windowStates[i].speed = 0.01f * (i + 1);
+
+        sc_WindowRenderFunctions functions = {
+            .init = initWindow,
+            .frame = renderWindow,
+            .shutdown = shutdownWindow,
+            .userData = &windowStates[i],
+            .swapInterval = 1,
+        };
+        sc_WindowGroupSetRenderFunctions(group, window, &functions);
+    }
+
+    // Events stay on the main thread, the windows draw on their own
+    assert(sc_WindowGroupStart(group));
+    while (!sc_WindowGroupShouldClose(group)) {
+        sc_WaitForEventsTimeout(0.1);
+    }
+
+    sc_DeleteWindowGroup(group);
+    sc_Terminate();
+}
@@ -0,0 +1,945 @@
+// stb_truetype.h - glyph loading and rasterization for TrueType fonts
+//                  (subset of the stb_truetype API, public domain)
+//
+// The part of the stb_truetype API (https://github.com/nothings/stb,
+// v1.26) that saciGL uses, written against the same declarations so the
+// upstream header can replace this file without touching its users.
+//
+//    Do this:
+//       #define STB_TRUETYPE_IMPLEMENTATION
+//    before you include this file in *one* C or C++ file to create the
+//    implementation.
+//
+// Provided:
+//    stbtt_GetNumberOfFonts()     stbtt_GetFontOffsetForIndex()
+//    stbtt_InitFont()             stbtt_FindGlyphIndex()
+//    stbtt_ScaleForPixelHeight()  stbtt_GetFontVMetrics()
+//    stbtt_GetGlyphHMetrics()     stbtt_GetGlyphKernAdvance()
+//    stbtt_GetGlyphBox()          stbtt_GetGlyphBitmapBox()
+//    stbtt_MakeGlyphBitmap()
+//
+// Fonts with TrueType outlines (glyf), single or in a collection. cmap
+// formats 0, 4, 6, 12 and 13, hmtx metrics and kern format 0 pairs.
+// Composite glyphs are followed, except for point matched offsets. CFF
+// outlines, GPOS kerning, hinting, SDF and the packing/baking APIs are
+// not provided.
+//
+// Like upstream, offsets read from the font are trusted. Check data from
+// untrusted sources before passing it in.
+//
+// LICENSE
+//
+//    This software is dual-licensed to the public domain and under the
+//    following license: you are granted a perpetual, irrevocable license
+//    to copy, modify, publish, and distribute this file as you see fit.
+
+#ifndef __STB_INCLUDE_STB_TRUETYPE_H__
+#define __STB_INCLUDE_STB_TRUETYPE_H__
+
+#ifdef STBTT_STATIC
+#define STBTT_DEF static
+#else
+#define STBTT_DEF extern
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// FONT LOADING
+//
+
+// The number of fonts in a file (1 unless it's a collection), -1 if it
+// isn't a font
+STBTT_DEF int stbtt_GetNumberOfFonts(const unsigned char *data);
+
+// Each .ttf/.ttc file may have more than one font. Each font has a sequential
+// index number starting from 0. Call this function to get the font offset for
+// a given index; it returns -1 if the index is out of range. A regular .ttf
+// file will only define one font and it always be at offset 0, so it will
+// return '0' for index 0, and -1 for all other indices.
+STBTT_DEF int stbtt_GetFontOffsetForIndex(const unsigned char *data, int index);
+
+// The following structure is defined publicly so you can declare one on
+// the stack or as a global or etc, but you should treat it as opaque.
+typedef struct stbtt_fontinfo
+{
+   void           * userdata;
+   unsigned char  * data;              // pointer to .ttf file
+   int              fontstart;         // offset of start of font
+
+   int numGlyphs;                      // number of glyphs, needed for range checking
+
+   int loca,head,glyf,hhea,hmtx,kern;  // table locations as offset from start of .ttf
+   int index_map;                      // a cmap mapping for our chosen character encoding
+   int indexToLocFormat;               // format needed to map from glyph index to glyph
+} stbtt_fontinfo;
+
+// Given an offset into the file that defines a font, this function builds
+// the necessary cached info for the rest of the system. You must allocate
+// the stbtt_fontinfo yourself, and stbtt_InitFont will fill it out. You don't
+// need to do anything special to free it, because the contents are pure
+// value data with no additional data structures. Returns 0 on failure.
+STBTT_DEF int stbtt_InitFont(stbtt_fontinfo *info, const unsigned char *data, int offset);
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CHARACTER TO GLYPH-INDEX CONVERSION
+
+// If you're going to perform multiple operations on the same character
+// and you want a speed-up, call this function with the character you're
+// going to process, then use glyph-based functions instead of the
+// codepoint-based functions.
+// Returns 0 if the character codepoint is not defined in the font.
+STBTT_DEF int stbtt_FindGlyphIndex(const stbtt_fontinfo *info, int unicode_codepoint);
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// CHARACTER PROPERTIES
+//
+
+// computes a scale factor to produce a font whose "height" is 'pixels' tall.
+// Height is measured as the distance from the highest ascender to the lowest
+// descender; in other words, it's equivalent to calling stbtt_GetFontVMetrics
+// and computing:
+//       scale = pixels / (ascent - descent)
+// so if you prefer to measure height by the ascent only, use a similar calculation.
+STBTT_DEF float stbtt_ScaleForPixelHeight(const stbtt_fontinfo *info, float pixels);
+
+// ascent is the coordinate above the baseline the font extends; descent
+// is the coordinate below the baseline the font extends (i.e. it is typically negative)
+// lineGap is the spacing between one row's descent and the next row's ascent...
+// so you should advance the vertical position by "*ascent - *descent + *lineGap"
+//   these are expressed in unscaled coordinates, so you must multiply by
+//   the scale factor for a given size
+STBTT_DEF void stbtt_GetFontVMetrics(const stbtt_fontinfo *info, int *ascent, int *descent, int *lineGap);
+
+// leftSideBearing is the offset from the current horizontal position to the left edge of the character
+// advanceWidth is the offset from the current horizontal position to the next horizontal position
+//   these are expressed in unscaled coordinates
+STBTT_DEF void stbtt_GetGlyphHMetrics(const stbtt_fontinfo *info, int glyph_index, int *advanceWidth, int *leftSideBearing);
+
+// an additional amount to add to the 'advance' value between glyph1 and glyph2
+STBTT_DEF int  stbtt_GetGlyphKernAdvance(const stbtt_fontinfo *info, int glyph1, int glyph2);
+
+// Gets the bounding box of the visible part of the glyph, in unscaled coordinates.
+// Returns 0 for glyphs without an outline
+STBTT_DEF int  stbtt_GetGlyphBox(const stbtt_fontinfo *info, int glyph_index, int *x0, int *y0, int *x1, int *y1);
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// BITMAP RENDERING
+//
+
+// get the bbox of the bitmap centered around the glyph origin; so the
+// bitmap width is ix1-ix0, height is iy1-iy0, and location to place
+// the bitmap top left is (leftSideBearing*scale,iy0).
+// (Note that the bitmap uses y-increases-down, but the shape uses
+// y-increases-up, so GetGlyphBitmapBox and GetGlyphBox are inverted.)
+STBTT_DEF void stbtt_GetGlyphBitmapBox(const stbtt_fontinfo *font, int glyph, float scale_x, float scale_y, int *ix0, int *iy0, int *ix1, int *iy1);
+
+// renders the glyph into an out_w by out_h bitmap with out_stride bytes per
+// row, its top left at the (ix0,iy0) stbtt_GetGlyphBitmapBox returns.
+// Every pixel of the bitmap is written, clipped to its size
+STBTT_DEF void stbtt_MakeGlyphBitmap(const stbtt_fontinfo *info, unsigned char *output, int out_w, int out_h, int out_stride, float scale_x, float scale_y, int glyph);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STB_INCLUDE_STB_TRUETYPE_H__
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+////
+////   IMPLEMENTATION
+////
+////
+
+#ifdef STB_TRUETYPE_IMPLEMENTATION
+#ifndef STB_TRUETYPE_IMPLEMENTATION_DONE
+#define STB_TRUETYPE_IMPLEMENTATION_DONE
+
+#ifndef STBTT_ifloor
+#include <math.h>
+#define STBTT_ifloor(x)   ((int) floor(x))
+#define STBTT_iceil(x)    ((int) ceil(x))
+#endif
+
+#ifndef STBTT_sqrt
+#include <math.h>
+#define STBTT_sqrt(x)      sqrt(x)
+#define STBTT_fabs(x)      fabs(x)
+#endif
+
+// #define your own functions "STBTT_malloc" / "STBTT_free" to avoid malloc.h
+#ifndef STBTT_malloc
+#include <stdlib.h>
+#define STBTT_malloc(x,u)  ((void)(u),malloc(x))
+#define STBTT_free(x,u)    ((void)(u),free(x))
+#endif
+
+#ifndef STBTT_assert
+#include <assert.h>
+#define STBTT_assert(x)    assert(x)
+#endif
+
+#ifndef STBTT_memcpy
+#include <string.h>
+#define STBTT_memcpy       memcpy
+#endif
+
+#ifndef STBTT_memset
+#include <string.h>
+#define STBTT_memset       memset
+#endif
+
+#ifndef STBTT_MAX_COMPOSITE_DEPTH
+#define STBTT_MAX_COMPOSITE_DEPTH 8
+#endif
+
+typedef unsigned char   stbtt_uint8;
+typedef signed   char   stbtt_int8;
+typedef unsigned short  stbtt_uint16;
+typedef signed   short  stbtt_int16;
+typedef unsigned int    stbtt_uint32;
+typedef signed   int    stbtt_int32;
+
+typedef char stbtt__check_size32[sizeof(stbtt_int32)==4 ? 1 : -1];
+typedef char stbtt__check_size16[sizeof(stbtt_int16)==2 ? 1 : -1];
+
+//////////////////////////////////////////////////////////////////////////
+//
+// accessors to parse data from file
+//
+
+#define ttBYTE(p)     (* (const stbtt_uint8 *) (p))
+#define ttCHAR(p)     (* (const stbtt_int8 *) (p))
+
+static stbtt_uint16 ttUSHORT(const stbtt_uint8 *p) { return (stbtt_uint16) (p[0]*256 + p[1]); }
+static stbtt_int16 ttSHORT(const stbtt_uint8 *p)   { return (stbtt_int16) (p[0]*256 + p[1]); }
+static stbtt_uint32 ttULONG(const stbtt_uint8 *p)  { return ((stbtt_uint32) p[0]<<24) + (p[1]<<16) + (p[2]<<8) + p[3]; }
+static stbtt_int32 ttLONG(const stbtt_uint8 *p)    { return (stbtt_int32) ttULONG(p); }
+
+#define stbtt_tag4(p,c0,c1,c2,c3) ((p)[0] == (c0) && (p)[1] == (c1) && (p)[2] == (c2) && (p)[3] == (c3))
+#define stbtt_tag(p,str)           stbtt_tag4(p,str[0],str[1],str[2],str[3])
+
+static int stbtt__isfont(const stbtt_uint8 *font)
+{
+   // check the version number
+   if (stbtt_tag4(font, '1',0,0,0))  return 1; // TrueType 1
+   if (stbtt_tag(font, "typ1"))   return 1; // TrueType with type 1 font -- we don't support this!
+   if (stbtt_tag(font, "OTTO"))   return 1; // OpenType with CFF
+   if (stbtt_tag4(font, 0,1,0,0)) return 1; // OpenType 1.0
+   if (stbtt_tag(font, "true"))   return 1; // Apple specification for TrueType fonts
+   return 0;
+}
+
+// @OPTIMIZE: binary search
+static stbtt_uint32 stbtt__find_table(const stbtt_uint8 *data, stbtt_uint32 fontstart, const char *tag)
+{
+   stbtt_int32 num_tables = ttUSHORT(data+fontstart+4);
+   stbtt_uint32 tabledir = fontstart + 12;
+   stbtt_int32 i;
+   for (i=0; i < num_tables; ++i) {
+      stbtt_uint32 loc = tabledir + 16*i;
+      if (stbtt_tag(data+loc+0, tag))
+         return ttULONG(data+loc+8);
+   }
+   return 0;
+}
+
+STBTT_DEF int stbtt_GetNumberOfFonts(const unsigned char *font_collection)
+{
+   // if it's just a font, there's only one valid font
+   if (stbtt__isfont(font_collection))
+      return 1;
+
+   // check if it's a TTC
+   if (stbtt_tag(font_collection, "ttcf")) {
+      // version 1?
+      if (ttULONG(font_collection+4) == 0x00010000 || ttULONG(font_collection+4) == 0x00020000) {
+         return ttLONG(font_collection+8);
+      }
+   }
+   return -1;
+}
+
+STBTT_DEF int stbtt_GetFontOffsetForIndex(const unsigned char *font_collection, int index)
+{
+   // if it's just a font, there's only one valid index
+   if (stbtt__isfont(font_collection))
+      return index == 0 ? 0 : -1;
+
+   // check if it's a TTC
+   if (stbtt_tag(font_collection, "ttcf")) {
+      // version 1?
+      if (ttULONG(font_collection+4) == 0x00010000 || ttULONG(font_collection+4) == 0x00020000) {
+         stbtt_int32 n = ttLONG(font_collection+8);
+         if (index < 0 || index >= n)
+            return -1;
+         return (int) ttULONG(font_collection+12+index*4);
+      }
+   }
+   return -1;
+}
+
+STBTT_DEF int stbtt_InitFont(stbtt_fontinfo *info, const unsigned char *data2, int fontstart)
+{
+   const stbtt_uint8 *data = (const stbtt_uint8 *) data2;
+   stbtt_uint32 cmap, t;
+   stbtt_int32 i,numTables;
+
+   info->data = (unsigned char *) data2;
+   info->fontstart = fontstart;
+   info->userdata = NULL;
+
+   cmap = stbtt__find_table(data, fontstart, "cmap");       // required
+   info->loca = (int) stbtt__find_table(data, fontstart, "loca"); // required
+   info->head = (int) stbtt__find_table(data, fontstart, "head"); // required
+   info->glyf = (int) stbtt__find_table(data, fontstart, "glyf"); // required
+   info->hhea = (int) stbtt__find_table(data, fontstart, "hhea"); // required
+   info->hmtx = (int) stbtt__find_table(data, fontstart, "hmtx"); // required
+   info->kern = (int) stbtt__find_table(data, fontstart, "kern"); // not required
+
+   if (!cmap || !info->head || !info->hhea || !info->hmtx)
+      return 0;
+   // only TrueType outlines, CFF fonts have no glyf table
+   if (!info->glyf || !info->loca)
+      return 0;
+
+   t = stbtt__find_table(data, fontstart, "maxp");
+   if (t)
+      info->numGlyphs = ttUSHORT(data+t+4);
+   else
+      info->numGlyphs = 0xffff;
+
+   // find a cmap encoding table we understand *now* to avoid searching
+   // later. (todo: could make this installable)
+   // the same regardless of glyph.
+   numTables = ttUSHORT(data + cmap + 2);
+   info->index_map = 0;
+   for (i=0; i < numTables; ++i) {
+      stbtt_uint32 encoding_record = cmap + 4 + 8 * i;
+      // find an encoding we understand:
+      switch(ttUSHORT(data+encoding_record)) {
+         case 3: // Microsoft
+            switch (ttUSHORT(data+encoding_record+2)) {
+               case 1:  // Unicode BMP
+               case 10: // Unicode full
+                  // MS/Unicode
+                  info->index_map = (int) (cmap + ttULONG(data+encoding_record+4));
+                  break;
+            }
+            break;
+         case 0: // Unicode
+            // Mac/iOS has these
+            // all the encodingIDs are unicode, so we don't bother to check it
+            info->index_map = (int) (cmap + ttULONG(data+encoding_record+4));
+            break;
+      }
+   }
+   if (info->index_map == 0)
+      return 0;
+
+   info->indexToLocFormat = ttUSHORT(data+info->head + 50);
+   return 1;
+}
+
+STBTT_DEF int stbtt_FindGlyphIndex(const stbtt_fontinfo *info, int unicode_codepoint)
+{
+   const stbtt_uint8 *data = info->data;
+   stbtt_uint32 index_map = (stbtt_uint32) info->index_map;
+
+   stbtt_uint16 format = ttUSHORT(data + index_map + 0);
+   if (unicode_codepoint < 0)
+      return 0;
+   if (format == 0) { // apple byte encoding
+      stbtt_int32 bytes = ttUSHORT(data + index_map + 2);
+      if (unicode_codepoint < bytes-6)
+         return ttBYTE(data + index_map + 6 + unicode_codepoint);
+      return 0;
+   } else if (format == 6) {
+      stbtt_uint32 first = ttUSHORT(data + index_map + 6);
+      stbtt_uint32 count = ttUSHORT(data + index_map + 8);
+      if ((stbtt_uint32) unicode_codepoint >= first && (stbtt_uint32) unicode_codepoint < first+count)
+         return ttUSHORT(data + index_map + 10 + (unicode_codepoint - first)*2);
+      return 0;
+   } else if (format == 4) { // standard mapping for windows fonts: binary search collection of ranges
+      stbtt_uint32 segcount = ttUSHORT(data+index_map+6) >> 1;
+      stbtt_uint32 endCount = index_map + 14;
+      stbtt_uint32 startCount = endCount + segcount*2 + 2;
+      stbtt_uint32 idDelta = startCount + segcount*2;
+      stbtt_uint32 idRangeOffset = idDelta + segcount*2;
+      stbtt_uint32 low = 0, high = segcount;
+      stbtt_uint16 start, offset;
+
+      // do a binary search of the segments
+      if (unicode_codepoint > 0xffff)
+         return 0;
+
+      // first segment whose end is at or past the codepoint
+      while (low < high) {
+         stbtt_uint32 mid = (low + high) >> 1;
+         if (ttUSHORT(data + endCount + 2*mid) < (stbtt_uint32) unicode_codepoint)
+            low = mid + 1;
+         else
+            high = mid;
+      }
+      if (low >= segcount)
+         return 0;
+
+      start = ttUSHORT(data + startCount + 2*low);
+      if ((stbtt_uint32) unicode_codepoint < start)
+         return 0;
+
+      offset = ttUSHORT(data + idRangeOffset + 2*low);
+      if (offset == 0)
+         return (stbtt_uint16) (unicode_codepoint + ttSHORT(data + idDelta + 2*low));
+      {
+         stbtt_uint16 glyph = ttUSHORT(data + offset + (unicode_codepoint-start)*2 + idRangeOffset + 2*low);
+         return glyph ? (stbtt_uint16) (glyph + ttSHORT(data + idDelta + 2*low)) : 0;
+      }
+   } else if (format == 12 || format == 13) {
+      stbtt_uint32 ngroups = ttULONG(data+index_map+12);
+      stbtt_int32 low,high;
+      low = 0; high = (stbtt_int32)ngroups;
+      // Binary search the right group.
+      while (low < high) {
+         stbtt_int32 mid = low + ((high-low) >> 1); // rounds down, so low <= mid < high
+         stbtt_uint32 start_char = ttULONG(data+index_map+16+mid*12);
+         stbtt_uint32 end_char = ttULONG(data+index_map+16+mid*12+4);
+         if ((stbtt_uint32) unicode_codepoint < start_char)
+            high = mid;
+         else if ((stbtt_uint32) unicode_codepoint > end_char)
+            low = mid+1;
+         else {
+            stbtt_uint32 start_glyph = ttULONG(data+index_map+16+mid*12+8);
+            if (format == 12)
+               return (int) (start_glyph + unicode_codepoint-start_char);
+            else // format == 13
+               return (int) start_glyph;
+         }
+      }
+      return 0; // not found
+   }
+   // @TODO
+   STBTT_assert(0);
+   return 0;
+}
+
+static int stbtt__GetGlyfOffset(const stbtt_fontinfo *info, int glyph_index)
+{
+   int g1,g2;
+
+   if (glyph_index < 0 || glyph_index >= info->numGlyphs) return -1; // glyph index out of range
+   if (info->indexToLocFormat >= 2)    return -1; // unknown index->glyph map format
+
+   if (info->indexToLocFormat == 0) {
+      g1 = info->glyf + ttUSHORT(info->data + info->loca + glyph_index * 2) * 2;
+      g2 = info->glyf + ttUSHORT(info->data + info->loca + glyph_index * 2 + 2) * 2;
+   } else {
+      g1 = info->glyf + (int) ttULONG (info->data + info->loca + glyph_index * 4);
+      g2 = info->glyf + (int) ttULONG (info->data + info->loca + glyph_index * 4 + 4);
+   }
+
+   return g1==g2 ? -1 : g1; // if length is 0, return -1
+}
+
+STBTT_DEF int stbtt_GetGlyphBox(const stbtt_fontinfo *info, int glyph_index, int *x0, int *y0, int *x1, int *y1)
+{
+   int g = stbtt__GetGlyfOffset(info, glyph_index);
+   if (g < 0) return 0;
+
+   if (x0) *x0 = ttSHORT(info->data + g + 2);
+   if (y0) *y0 = ttSHORT(info->data + g + 4);
+   if (x1) *x1 = ttSHORT(info->data + g + 6);
+   if (y1) *y1 = ttSHORT(info->data + g + 8);
+   return 1;
+}
+
+STBTT_DEF void stbtt_GetGlyphHMetrics(const stbtt_fontinfo *info, int glyph_index, int *advanceWidth, int *leftSideBearing)
+{
+   stbtt_uint16 numOfLongHorMetrics = ttUSHORT(info->data+info->hhea + 34);
+   if (glyph_index < numOfLongHorMetrics) {
+      if (advanceWidth)     *advanceWidth    = ttSHORT(info->data + info->hmtx + 4*glyph_index);
+      if (leftSideBearing)  *leftSideBearing = ttSHORT(info->data + info->hmtx + 4*glyph_index + 2);
+   } else {
+      if (advanceWidth)     *advanceWidth    = ttSHORT(info->data + info->hmtx + 4*(numOfLongHorMetrics-1));
+      if (leftSideBearing)  *leftSideBearing = ttSHORT(info->data + info->hmtx + 4*numOfLongHorMetrics + 2*(glyph_index - numOfLongHorMetrics));
+   }
+}
+
+STBTT_DEF int stbtt_GetGlyphKernAdvance(const stbtt_fontinfo *info, int glyph1, int glyph2)
+{
+   const stbtt_uint8 *data = info->data + info->kern;
+   stbtt_uint32 needle, straw;
+   int l, r, m;
+
+   // we only look at the first table. it must be 'horizontal' and format 0.
+   if (!info->kern)
+      return 0;
+   if (ttUSHORT(data+2) < 1) // number of tables, need at least 1
+      return 0;
+   if (ttUSHORT(data+8) != 1) // horizontal flag must be set in format
+      return 0;
+
+   l = 0;
+   r = ttUSHORT(data+10) - 1;
+   needle = (stbtt_uint32) glyph1 << 16 | (stbtt_uint32) glyph2;
+   while (l <= r) {
+      m = (l + r) >> 1;
+      straw = ttULONG(data+18+(m*6)); // note: unaligned read
+      if (needle < straw)
+         r = m - 1;
+      else if (needle > straw)
+         l = m + 1;
+      else
+         return ttSHORT(data+22+(m*6));
+   }
+   return 0;
+}
+
+STBTT_DEF float stbtt_ScaleForPixelHeight(const stbtt_fontinfo *info, float height)
+{
+   int fheight = ttSHORT(info->data + info->hhea + 4) - ttSHORT(info->data + info->hhea + 6);
+   return (float) height / fheight;
+}
+
+STBTT_DEF void stbtt_GetFontVMetrics(const stbtt_fontinfo *info, int *ascent, int *descent, int *lineGap)
+{
+   if (ascent ) *ascent  = ttSHORT(info->data+info->hhea + 4);
+   if (descent) *descent = ttSHORT(info->data+info->hhea + 6);
+   if (lineGap) *lineGap = ttSHORT(info->data+info->hhea + 8);
+}
+
+STBTT_DEF void stbtt_GetGlyphBitmapBox(const stbtt_fontinfo *font, int glyph, float scale_x, float scale_y, int *ix0, int *iy0, int *ix1, int *iy1)
+{
+   int x0=0,y0=0,x1,y1; // =0 suppresses compiler warning
+   if (!stbtt_GetGlyphBox(font, glyph, &x0,&y0,&x1,&y1)) {
+      // e.g. space character
+      if (ix0) *ix0 = 0;
+      if (iy0) *iy0 = 0;
+      if (ix1) *ix1 = 0;
+      if (iy1) *iy1 = 0;
+   } else {
+      // move to integral bboxes (treating pixels as little squares, what pixels get touched)?
+      if (ix0) *ix0 = STBTT_ifloor( x0 * scale_x);
+      if (iy0) *iy0 = STBTT_ifloor(-y1 * scale_y);
+      if (ix1) *ix1 = STBTT_iceil ( x1 * scale_x);
+      if (iy1) *iy1 = STBTT_iceil (-y0 * scale_y);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Outlines, flattened into line segments in bitmap pixels
+//
+
+typedef struct
+{
+   float x0,y0,x1,y1;
+} stbtt__segment;
+
+typedef struct
+{
+   stbtt__segment *segments;
+   int count, capacity;
+   int failed; // an allocation failed, the outline is incomplete
+   int w, h;   // segments are clipped to the bitmap as they are added
+   void *userdata;
+} stbtt__outline;
+
+static void stbtt__push_segment(stbtt__outline *outline, float x0, float y0, float x1, float y1)
+{
+   if (outline->failed)
+      return;
+   if (outline->count == outline->capacity) {
+      int capacity = outline->capacity ? outline->capacity * 2 : 64;
+      stbtt__segment *segments = (stbtt__segment *) STBTT_malloc(capacity * sizeof(stbtt__segment), outline->userdata);
+      if (!segments) {
+         outline->failed = 1;
+         return;
+      }
+      if (outline->count)
+         STBTT_memcpy(segments, outline->segments, outline->count * sizeof(stbtt__segment));
+      if (outline->segments)
+         STBTT_free(outline->segments, outline->userdata);
+      outline->segments = segments;
+      outline->capacity = capacity;
+   }
+   outline->segments[outline->count].x0 = x0;
+   outline->segments[outline->count].y0 = y0;
+   outline->segments[outline->count].x1 = x1;
+   outline->segments[outline->count].y1 = y1;
+   outline->count++;
+}
+
+// Rows above and below the bitmap don't matter. Left of it everything to
+// the right is covered, so the part there runs down its left edge. Right
+// of it covers nothing inside, it runs down the right edge
+static void stbtt__add_segment(stbtt__outline *outline, float x0, float y0, float x1, float y1)
+{
+   float w = (float) outline->w, h = (float) outline->h;
+   if (y0 == y1)
+      return;
+   if ((y0 <= 0 && y1 <= 0) || (y0 >= h && y1 >= h))
+      return;
+
+   if (y0 < 0 || y1 < 0 || y0 > h || y1 > h) {
+      float dxdy = (x1 - x0) / (y1 - y0);
+      if (y0 < 0) { x0 += dxdy * (0 - y0); y0 = 0; }
+      if (y1 < 0) { x1 += dxdy * (0 - y1); y1 = 0; }
+      if (y0 > h) { x0 += dxdy * (h - y0); y0 = h; }
+      if (y1 > h) { x1 += dxdy * (h - y1); y1 = h; }
+   }
+
+   // split where it crosses a side, each part is then on one side or inside
+   if ((x0 < 0) != (x1 < 0) && x0 != 0 && x1 != 0) {
+      float y = y0 + (y1 - y0) * (0 - x0) / (x1 - x0);
+      stbtt__add_segment(outline, x0, y0, 0, y);
+      stbtt__add_segment(outline, 0, y, x1, y1);
+      return;
+   }
+   if ((x0 > w) != (x1 > w) && x0 != w && x1 != w) {
+      float y = y0 + (y1 - y0) * (w - x0) / (x1 - x0);
+      stbtt__add_segment(outline, x0, y0, w, y);
+      stbtt__add_segment(outline, w, y, x1, y1);
+      return;
+   }
+   if (x0 < 0) x0 = x1 = 0;
+   if (x0 > w) x0 = x1 = w;
+   if (x1 < 0 || x1 > w) x1 = x0;
+   stbtt__push_segment(outline, x0, y0, x1, y1);
+}
+
+static void stbtt__add_quadratic(stbtt__outline *outline, float x0, float y0, float cx, float cy, float x1, float y1)
+{
+   // a uniform split stays within dd / (8 n^2) of the curve, keep it under
+   // a tenth of a pixel
+   float ddx = x0 - 2*cx + x1;
+   float ddy = y0 - 2*cy + y1;
+   float dd = (float) STBTT_sqrt(ddx*ddx + ddy*ddy);
+   int steps = (int) STBTT_iceil(STBTT_sqrt(dd / 0.8f));
+   float px = x0, py = y0;
+   int i;
+   if (steps < 1) steps = 1;
+   if (steps > 32) steps = 32;
+
+   for (i=1; i <= steps; ++i) {
+      float t = (float) i / steps;
+      float mt = 1 - t;
+      float x = mt*mt*x0 + 2*mt*t*cx + t*t*x1;
+      float y = mt*mt*y0 + 2*mt*t*cy + t*t*y1;
+      stbtt__add_segment(outline, px, py, x, y);
+      px = x;
+      py = y;
+   }
+}
+
+// transform maps font units to bitmap pixels: x' = a x + c y + e, y' = b x + d y + f
+static void stbtt__collect_outline(const stbtt_fontinfo *info, int glyph_index, const float transform[6], stbtt__outline *outline, int depth)
+{
+   const stbtt_uint8 *data = info->data;
+   const stbtt_uint8 *glyph, *endPtsOfContours, *points;
+   stbtt_int16 numberOfContours;
+   stbtt_uint8 *flags;
+   float *xs, *ys;
+   int g = stbtt__GetGlyfOffset(info, glyph_index);
+   int n, i, first, contour;
+   stbtt_int32 value;
+
+   if (g < 0) return;
+   glyph = data + g;
+   numberOfContours = ttSHORT(glyph);
+
+   if (numberOfContours < 0) {
+      // Compound shapes
+      const stbtt_uint8 *comp = glyph + 10;
+      stbtt_uint16 comp_flags;
+      if (depth >= STBTT_MAX_COMPOSITE_DEPTH) return;
+      do {
+         float mtx[4] = {1,0,0,1}, dx, dy;
+         const float *t = transform;
+         float combined[6];
+         stbtt_uint16 gidx;
+
+         comp_flags = ttUSHORT(comp); comp+=2;
+         gidx = ttUSHORT(comp); comp+=2;
+
+         if (comp_flags & 1) { // ARG_1_AND_2_ARE_WORDS
+            dx = ttSHORT(comp); comp+=2;
+            dy = ttSHORT(comp); comp+=2;
+         } else {
+            dx = ttCHAR(comp); comp+=1;
+            dy = ttCHAR(comp); comp+=1;
+         }
+         if (!(comp_flags & 2)) dx = dy = 0; // point matching isn't supported
+
+         if (comp_flags & (1<<3)) { // WE_HAVE_A_SCALE
+            mtx[0] = mtx[3] = ttSHORT(comp)/16384.0f; comp+=2;
+         } else if (comp_flags & (1<<6)) { // WE_HAVE_AN_X_AND_YSCALE
+            mtx[0] = ttSHORT(comp)/16384.0f; comp+=2;
+            mtx[3] = ttSHORT(comp)/16384.0f; comp+=2;
+         } else if (comp_flags & (1<<7)) { // WE_HAVE_A_TWO_BY_TWO
+            mtx[0] = ttSHORT(comp)/16384.0f; comp+=2;
+            mtx[1] = ttSHORT(comp)/16384.0f; comp+=2;
+            mtx[2] = ttSHORT(comp)/16384.0f; comp+=2;
+            mtx[3] = ttSHORT(comp)/16384.0f; comp+=2;
+         }
+
+         // the component's transform, then ours
+         combined[0] = t[0]*mtx[0] + t[2]*mtx[1];
+         combined[1] = t[1]*mtx[0] + t[3]*mtx[1];
+         combined[2] = t[0]*mtx[2] + t[2]*mtx[3];
+         combined[3] = t[1]*mtx[2] + t[3]*mtx[3];
+         combined[4] = t[0]*dx + t[2]*dy + t[4];
+         combined[5] = t[1]*dx + t[3]*dy + t[5];
+         stbtt__collect_outline(info, gidx, combined, outline, depth + 1);
+      } while (comp_flags & (1<<5)); // MORE_COMPONENTS
+      return;
+   }
+   if (numberOfContours == 0) return;
+
+   endPtsOfContours = glyph + 10;
+   n = 1 + ttUSHORT(endPtsOfContours + numberOfContours*2 - 2);
+   points = endPtsOfContours + numberOfContours*2 + 2 + ttUSHORT(endPtsOfContours + numberOfContours*2);
+
+   // coordinates first so they stay aligned, flags after them
+   xs = (float *) STBTT_malloc(n * (2*sizeof(float) + sizeof(stbtt_uint8)), outline->userdata);
+   if (!xs) {
+      outline->failed = 1;
+      return;
+   }
+   ys = xs + n;
+   flags = (stbtt_uint8 *) (ys + n);
+
+   // first load flags
+   for (i=0; i < n; ) {
+      stbtt_uint8 flag = *points++;
+      int repeat = 1;
+      if (flag & 8)
+         repeat += *points++;
+      while (repeat-- && i < n)
+         flags[i++] = flag;
+   }
+
+   // now load x coordinates
+   value = 0;
+   for (i=0; i < n; ++i) {
+      stbtt_uint8 flag = flags[i];
+      if (flag & 2) {
+         stbtt_int16 dx = *points++;
+         value += (flag & 16) ? dx : -dx; // ???
+      } else if (!(flag & 16)) {
+         value += ttSHORT(points);
+         points += 2;
+      }
+      xs[i] = (float) value;
+   }
+
+   // now load y coordinates
+   value = 0;
+   for (i=0; i < n; ++i) {
+      stbtt_uint8 flag = flags[i];
+      if (flag & 4) {
+         stbtt_int16 dy = *points++;
+         value += (flag & 32) ? dy : -dy; // ???
+      } else if (!(flag & 32)) {
+         value += ttSHORT(points);
+         points += 2;
+      }
+      ys[i] = (float) value;
+   }
+
+   for (i=0; i < n; ++i) {
+      float x = xs[i], y = ys[i];
+      xs[i] = transform[0]*x + transform[2]*y + transform[4];
+      ys[i] = transform[1]*x + transform[3]*y + transform[5];
+   }
+
+   // now walk the contours, quadratic curves between on-curve points with
+   // an implied on-curve point between two off-curve ones
+   first = 0;
+   for (contour=0; contour < numberOfContours; ++contour) {
+      int last = ttUSHORT(endPtsOfContours + contour*2);
+      int count, begin, k, has_control = 0;
+      float start_x, start_y, pen_x, pen_y, control_x = 0, control_y = 0;
+      if (last >= n || last < first) break;
+      count = last - first + 1;
+
+      // start on an on-curve point, or between two off-curve ones
+      begin = 0;
+      while (begin < count && !(flags[first + begin] & 1)) ++begin;
+      if (begin < count) {
+         start_x = xs[first + begin];
+         start_y = ys[first + begin];
+      } else {
+         begin = 0;
+         start_x = (xs[first] + xs[first + (1 % count)]) * 0.5f;
+         start_y = (ys[first] + ys[first + (1 % count)]) * 0.5f;
+      }
+
+      pen_x = start_x;
+      pen_y = start_y;
+      for (k=1; k <= count; ++k) {
+         int index = first + (begin + k) % count;
+         float x = xs[index], y = ys[index];
+         if (flags[index] & 1) {
+            if (has_control)
+               stbtt__add_quadratic(outline, pen_x, pen_y, control_x, control_y, x, y);
+            else
+               stbtt__add_segment(outline, pen_x, pen_y, x, y);
+            pen_x = x;
+            pen_y = y;
+            has_control = 0;
+         } else {
+            if (has_control) {
+               float mid_x = (control_x + x) * 0.5f;
+               float mid_y = (control_y + y) * 0.5f;
+               stbtt__add_quadratic(outline, pen_x, pen_y, control_x, control_y, mid_x, mid_y);
+               pen_x = mid_x;
+               pen_y = mid_y;
+            }
+            control_x = x;
+            control_y = y;
+            has_control = 1;
+         }
+      }
+      if (has_control)
+         stbtt__add_quadratic(outline, pen_x, pen_y, control_x, control_y, start_x, start_y);
+      else if (pen_x != start_x || pen_y != start_y)
+         stbtt__add_segment(outline, pen_x, pen_y, start_x, start_y);
+      first = last + 1;
+   }
+
+   STBTT_free(xs, outline->userdata);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+//
+//  Rasterizer
+//
+// Signed area accumulation: every segment adds the area it covers to the
+// cells it crosses and the rest of its height to the cell after them, a
+// running sum over each row then gives the coverage. Rows get two spare
+// cells past the right edge for what segments along it add
+
+static void stbtt__accumulate(float *accum, int stride, const stbtt__segment *e)
+{
+   float x0 = e->x0, y0 = e->y0, x1 = e->x1, y1 = e->y1;
+   float direction = 1, dxdy, x;
+   int row, row_end;
+
+   if (y0 > y1) {
+      float t;
+      t = x0; x0 = x1; x1 = t;
+      t = y0; y0 = y1; y1 = t;
+      direction = -1;
+   }
+   dxdy = (x1 - x0) / (y1 - y0);
+   x = x0;
+   row_end = STBTT_iceil(y1);
+
+   for (row = STBTT_ifloor(y0); row < row_end; ++row) {
+      float *line = accum + row * stride;
+      float top = row > y0 ? (float) row : y0;
+      float bottom = row + 1 < y1 ? (float) (row + 1) : y1;
+      float dy = bottom - top;
+      float x_next = x + dxdy * dy;
+      float d = dy * direction;
+      float left = x < x_next ? x : x_next;
+      float right = x < x_next ? x_next : x;
+      float left_floor = (float) STBTT_ifloor(left);
+      int left_cell = (int) left_floor;
+      int right_cell = STBTT_iceil(right);
+
+      if (right_cell <= left_cell + 1) {
+         // within one cell, split by the average x
+         float middle = 0.5f * (x + x_next) - left_floor;
+         line[left_cell] += d - d * middle;
+         line[left_cell + 1] += d * middle;
+      } else {
+         float inverse = 1 / (right - left);
+         float left_fraction = left - left_floor;
+         float first_area = 0.5f * inverse * (1 - left_fraction) * (1 - left_fraction);
+         float right_fraction = right - right_cell + 1;
+         float last_area = 0.5f * inverse * right_fraction * right_fraction;
+
+         line[left_cell] += d * first_area;
+         if (right_cell == left_cell + 2) {
+            line[left_cell + 1] += d * (1 - first_area - last_area);
+         } else {
+            float second_area = inverse * (1.5f - left_fraction);
+            float before_last = second_area + (right_cell - left_cell - 3) * inverse;
+            int cell;
+            line[left_cell + 1] += d * (second_area - first_area);
+            for (cell = left_cell + 2; cell < right_cell - 1; ++cell)
+               line[cell] += d * inverse;
+            line[right_cell - 1] += d * (1 - before_last - last_area);
+         }
+         line[right_cell] += d * last_area;
+      }
+      x = x_next;
+   }
+}
+
+STBTT_DEF void stbtt_MakeGlyphBitmap(const stbtt_fontinfo *info, unsigned char *output, int out_w, int out_h, int out_stride, float scale_x, float scale_y, int glyph)
+{
+   stbtt__outline outline;
+   float transform[6];
+   float *accum;
+   int ix0, iy0, stride, i, x, y;
+
+   if (out_w <= 0 || out_h <= 0)
+      return;
+   for (y=0; y < out_h; ++y)
+      STBTT_memset(output + y * out_stride, 0, out_w);
+
+   stbtt_GetGlyphBitmapBox(info, glyph, scale_x, scale_y, &ix0, &iy0, 0, 0);
+   transform[0] = scale_x;
+   transform[1] = 0;
+   transform[2] = 0;
+   transform[3] = -scale_y;
+   transform[4] = (float) -ix0;
+   transform[5] = (float) -iy0;
+
+   STBTT_memset(&outline, 0, sizeof(outline));
+   outline.w = out_w;
+   outline.h = out_h;
+   outline.userdata = info->userdata;
+   stbtt__collect_outline(info, glyph, transform, &outline, 0);
+   if (outline.failed || outline.count == 0) {
+      if (outline.segments)
+         STBTT_free(outline.segments, info->userdata);
+      return;
+   }
+
+   stride = out_w + 2;
+   accum = (float *) STBTT_malloc(stride * out_h * sizeof(float), info->userdata);
+   if (accum) {
+      STBTT_memset(accum, 0, stride * out_h * sizeof(float));
+      for (i=0; i < outline.count; ++i)
+         stbtt__accumulate(accum, stride, &outline.segments[i]);
+
+      for (y=0; y < out_h; ++y) {
+         const float *line = accum + y * stride;
+         unsigned char *pixels = output + y * out_stride;
+         float sum = 0;
+         for (x=0; x < out_w; ++x) {
+            float k;
+            sum += line[x];
+            k = (float) STBTT_fabs(sum);
+            if (k > 1) k = 1;
+            pixels[x] = (unsigned char) (k * 255 + 0.5f);
+         }
+      }
+      STBTT_free(accum, info->userdata);
+   }
+   STBTT_free(outline.segments, info->userdata);
+}
+
+#endif // STB_TRUETYPE_IMPLEMENTATION_DONE
+#endif // STB_TRUETYPE_IMPLEMENTATION
@@ -6,9 +6,22 @@
 #ifndef __SACI_sc_H__
 #define __SACI_sc_H__
 
+#include "saci-core/sc-capture.h"
+#include "saci-core/sc-dynamic-resolution.h"
 #include "saci-core/sc-event.h"
+#include "saci-core/sc-font.h"
+#include "saci-core/sc-frame-pacer.h"
+#include "saci-core/sc-mesh.h"
+#include "saci-core/sc-readback.h"
+#include "saci-core/sc-render-graph.h"
+#include "saci-core/sc-render-target.h"
 #include "saci-core/sc-rendering.h"
+#include "saci-core/sc-scene.h"
+#include "saci-core/sc-sdf.h"
 #include "saci-core/sc-shadering.h"
+#include "saci-core/sc-shape.h"
+#include "saci-core/sc-static-batch.h"
+#include "saci-core/sc-window-group.h"
 #include "saci-core/sc-windowing.h"
 
 #endif
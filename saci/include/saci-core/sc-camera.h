@@ -3,7 +3,28 @@
 
 #include "saci-utils/su-types.h"
 
-typedef struct sc_Camera {
+typedef struct sc_Camera sc_Camera;
+
+typedef enum sc_RenderProjectionMode {
+    SACI_RENDER_ORTHOGRAPHIC_PROJECTION = 0,
+    SACI_RENDER_PERSPECTIVE_PROJECTION = 1,
+    SACI_RENDER_CUSTOM_PROJECTION = 2,
+} sc_RendererProjectionMode;
+typedef saci_Mat4 (*sc_RendererCustomProjectionFunction)(sc_Camera camera);
+
+// Planes point inwards, a point p is inside when a*x + b*y + c*z + d >= 0 for
+// all of them. Order is left, right, bottom, top, near, far
+typedef struct sc_Frustum {
+    saci_Vec4 planes[6];
+} sc_Frustum;
+
+typedef enum sc_CameraDirtyFlags {
+    SACI_CAMERA_DIRTY_VIEW = 1 << 0,
+    SACI_CAMERA_DIRTY_PROJECTION = 1 << 1,
+    SACI_CAMERA_DIRTY_ALL = SACI_CAMERA_DIRTY_VIEW | SACI_CAMERA_DIRTY_PROJECTION,
+} sc_CameraDirtyFlags;
+
+struct sc_Camera {
     saci_Vec3 position;
     saci_Vec3 target;
     saci_Vec3 up;
@@ -12,9 +33,70 @@ typedef struct sc_Camera {
     float aspectRatio;
     float near;
     float far;
-} sc_Camera;
+
+    // Everything below is owned by the sc_Camera* functions. The fields above
+    // can still be written directly, sc_CameraUpdate notices it
+    saci_u32 dirty;   // sc_CameraDirtyFlags
+    saci_u64 version; // bumped when the matrices below change, 0 before any update
+
+    sc_RendererProjectionMode cachedProjectionMode;
+    sc_RendererCustomProjectionFunction cachedCustomProjection;
+    float cachedParams[13]; // fields above as of the last update
+
+    saci_Mat4 view;
+    saci_Mat4 projection;
+    saci_Mat4 viewProjection;
+    saci_Mat4 inverseView;
+    saci_Mat4 inverseViewProjection;
+    sc_Frustum frustum;
+};
 
 sc_Camera sc_GenerateDefaultCamera3D();
 sc_Camera sc_GenerateDefaultCamera2D();
 
+//----------------------------------------------------------------------------//
+// Camera setters
+//----------------------------------------------------------------------------//
+
+void sc_CameraSetPosition(sc_Camera* camera, saci_Vec3 position);
+void sc_CameraSetTarget(sc_Camera* camera, saci_Vec3 target);
+void sc_CameraSetUp(sc_Camera* camera, saci_Vec3 up);
+void sc_CameraLookAt(sc_Camera* camera, saci_Vec3 position, saci_Vec3 target, saci_Vec3 up);
+
+void sc_CameraSetFov(sc_Camera* camera, float fov);
+void sc_CameraSetAspectRatio(sc_Camera* camera, float aspectRatio);
+void sc_CameraSetClipPlanes(sc_Camera* camera, float near, float far);
+
+//----------------------------------------------------------------------------//
+// Cached matrices
+//----------------------------------------------------------------------------//
+
+// Rebuilds whatever changed since the last call, for the given projection.
+// Custom projections are rebuilt every call, the function may depend on more
+// than the camera. Returns false if no projection could be built (custom mode
+// without a function), the matrices are left as they were
+saci_Bool sc_CameraUpdate(sc_Camera* camera, sc_RendererProjectionMode mode,
+                          sc_RendererCustomProjectionFunction customProjection);
+
+// Valid after sc_CameraUpdate
+const saci_Mat4* sc_CameraGetView(const sc_Camera* camera);
+const saci_Mat4* sc_CameraGetProjection(const sc_Camera* camera);
+const saci_Mat4* sc_CameraGetViewProjection(const sc_Camera* camera);
+const saci_Mat4* sc_CameraGetInverseView(const sc_Camera* camera);
+const saci_Mat4* sc_CameraGetInverseViewProjection(const sc_Camera* camera);
+const sc_Frustum* sc_CameraGetFrustum(const sc_Camera* camera);
+
+// Caches built from the camera (culling results, uniform buffers) can compare
+// this against the version they were built with
+saci_u64 sc_CameraVersion(const sc_Camera* camera);
+
+//----------------------------------------------------------------------------//
+// Frustum tests
+//----------------------------------------------------------------------------//
+
+sc_Frustum sc_FrustumFromMatrix(const saci_Mat4* viewProjection);
+// Conservative, a box crossing a corner outside the frustum can pass
+saci_Bool sc_FrustumTestAABB(const sc_Frustum* frustum, saci_Vec3 min, saci_Vec3 max);
+saci_Bool sc_FrustumTestSphere(const sc_Frustum* frustum, saci_Vec3 center, float radius);
+
 #endif
@@ -0,0 +1,46 @@
+#ifndef __SACI_CORE_SC_CAPTURE_H__
+#define __SACI_CORE_SC_CAPTURE_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Capture
+//----------------------------------------------------------------------------//
+
+// Every sc_RenderEnd between Begin and End is written to path: the batch,
+// camera, render config and the textures it references. Returns false if the
+// file can't be opened or the renderer is already capturing
+saci_Bool sc_RenderCaptureBegin(sc_Renderer* renderer, const char* path);
+void sc_RenderCaptureEnd(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Replay
+//----------------------------------------------------------------------------//
+
+typedef struct sc_RenderCapture sc_RenderCapture;
+
+typedef struct sc_RenderCaptureTexture {
+    saci_TextureID id;  // as seen while capturing
+    int width, height;  // 0 if unknown
+    saci_Bool flipImg;  // as passed to the load function
+    const char* path;   // NULL if saci didn't load it from a file
+} sc_RenderCaptureTexture;
+
+// NULL if the file is missing, truncated or from another format version
+sc_RenderCapture* sc_RenderCaptureLoad(const char* path);
+void sc_RenderCaptureFree(sc_RenderCapture* capture);
+
+saci_u32 sc_RenderCaptureFrameCount(const sc_RenderCapture* capture);
+
+saci_u32 sc_RenderCaptureTextureCount(const sc_RenderCapture* capture);
+sc_RenderCaptureTexture sc_RenderCaptureGetTexture(const sc_RenderCapture* capture, saci_u32 index);
+// Captured IDs replay as themselves unless mapped, e.g. to textures reloaded
+// in another process or to software textures
+void sc_RenderCaptureMapTexture(sc_RenderCapture* capture, saci_TextureID capturedID, saci_TextureID replayID);
+
+// Sets the frame's config on renderer, pushes its batch and calls
+// sc_RenderBegin/End
+void sc_RenderCaptureReplayFrame(sc_Renderer* renderer, const sc_RenderCapture* capture, saci_u32 frameIndex);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef __SACI_CORE_SC_DYNAMIC_RESOLUTION_H__
+#define __SACI_CORE_SC_DYNAMIC_RESOLUTION_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Dynamic Resolution Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// An offscreen target for the 3D scene whose resolution follows the GPU time
+// spent in it. The scene is drawn into a corner of a framebuffer allocated at
+// the largest scale, then stretched over the window, so changing scale never
+// reallocates. 2D/UI drawn after sc_DynamicResolutionEnd stays native. The
+// framebuffer is a render target from the renderer's pool, a resize gives it
+// back and takes one of the new size
+typedef struct sc_DynamicResolution sc_DynamicResolution;
+
+// width and height are the window's framebuffer size. Scales apply to both
+// axes, e.g. 0.5 renders a quarter of the pixels. renderer must outlive it
+sc_DynamicResolution* sc_CreateDynamicResolution(sc_Renderer* renderer, int width, int height, float minScale,
+                                                 float maxScale, double targetMilliseconds);
+void sc_DeleteDynamicResolution(sc_DynamicResolution* resolution);
+
+// For window resizes, keeps the current scale
+void sc_DynamicResolutionResize(sc_DynamicResolution* resolution, int width, int height);
+
+//----------------------------------------------------------------------------//
+// Dynamic Resolution Usage
+//----------------------------------------------------------------------------//
+
+// Binds the target at the current scale and clears it. Draw the scene (e.g. a
+// whole sc_RenderBegin/End) between Begin and End
+void sc_DynamicResolutionBegin(sc_DynamicResolution* resolution, saci_Color clearColor);
+// Stretches the scene over the window's back buffer, with the previous
+// framebuffer and viewport bound again. Only color is copied
+void sc_DynamicResolutionEnd(sc_DynamicResolution* resolution);
+
+// A fixed scale turns the controller off until sc_DynamicResolutionSetAuto
+void sc_DynamicResolutionSetScale(sc_DynamicResolution* resolution, float scale);
+void sc_DynamicResolutionSetAuto(sc_DynamicResolution* resolution);
+
+float sc_DynamicResolutionScale(const sc_DynamicResolution* resolution);
+// Size the scene is currently rendered at
+void sc_DynamicResolutionGetSize(const sc_DynamicResolution* resolution, int* width, int* height);
+// Smoothed GPU time between Begin and End, from timer queries a few frames
+// old and estimated for the current scale. 0 until the first result or
+// without GL 3.3
+double sc_DynamicResolutionGPUTime(const sc_DynamicResolution* resolution);
+// For reading the scene back, it sits at (0, 0) with the size above
+saci_u32 sc_DynamicResolutionFramebuffer(const sc_DynamicResolution* resolution);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __SACI_CORE_SC_FONT_H__
+#define __SACI_CORE_SC_FONT_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+#include <stddef.h>
+
+//----------------------------------------------------------------------------//
+// Font Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// A TrueType font at one pixel size. Glyphs are rasterized the first time
+// they are drawn into an atlas texture that grows as needed, laid out
+// strings are cached so a label that stays the same costs no shaping
+typedef struct sc_Font sc_Font;
+
+// pixelHeight is the distance from the highest ascender to the lowest
+// descender. NULL if the file can't be read or isn't a TrueType or OpenType
+// font
+sc_Font* sc_CreateFont(const char* path, float pixelHeight);
+// The data is copied
+sc_Font* sc_CreateFontFromMemory(const saci_u8* data, size_t size, float pixelHeight);
+void sc_DeleteFont(sc_Font* font);
+
+// Pixels from one baseline to the next
+float sc_FontLineHeight(const sc_Font* font);
+// Pixels above the baseline
+float sc_FontAscent(const sc_Font* font);
+// Size of the UTF-8 text in pixels, '\n' starts a new line
+saci_Vec2 sc_FontMeasureText(sc_Font* font, const char* text);
+
+//----------------------------------------------------------------------------//
+// Font Usage
+//----------------------------------------------------------------------------//
+
+// Pushes one textured quad per glyph into the batch, neighbouring text with
+// the same font draws in one call. position is the left end of the first
+// line's baseline, lines go down (-y). scale converts font pixels to the
+// renderer's units, e.g. 2.0f / windowHeight without a camera. Edges are
+// coverage in alpha, turn on alphaBlending in the render config
+void sc_RenderPushText(sc_Renderer* renderer, sc_Font* font, const char* text, saci_Vec2 position, float depth,
+                       float scale, saci_Color color);
+
+#endif
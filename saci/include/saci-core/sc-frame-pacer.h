@@ -0,0 +1,54 @@
+#ifndef __SACI_CORE_SC_FRAME_PACER_H__
+#define __SACI_CORE_SC_FRAME_PACER_H__
+
+#include "saci-core/sc-windowing.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Frame Pacer Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Decides when a frame starts. Replaces the sc_PollEvents/sc_SwapWindowBuffer
+// pair of the main loop:
+//
+//     while (!sc_WindowShouldClose(window)) {
+//         sc_FramePacerBeginFrame(pacer); // waits, then polls events
+//         ... render ...
+//         sc_FramePacerEndFrame(pacer, window); // swaps
+//     }
+typedef struct sc_FramePacer sc_FramePacer;
+
+typedef enum sc_FramePacerLatencyMode {
+    // Events are polled as soon as the previous frame is done, the limiter
+    // waits after that
+    SACI_FRAME_PACER_LATENCY_DEFAULT = 0,
+    // The limiter waits first and events are polled right before rendering,
+    // as late as the measured frame time allows. The GPU is never more than a
+    // frame behind
+    SACI_FRAME_PACER_LATENCY_LOW = 1,
+} sc_FramePacerLatencyMode;
+
+// targetFPS 0 leaves the rate to the swap interval. maxFramesInFlight 0 lets
+// the driver queue as many as it wants
+sc_FramePacer* sc_CreateFramePacer(double targetFPS, saci_u32 maxFramesInFlight);
+// Needs the GL context the fences were made on
+void sc_DeleteFramePacer(sc_FramePacer* pacer);
+
+void sc_FramePacerSetTargetFPS(sc_FramePacer* pacer, double targetFPS);
+// Capped to 8. Needs GL 3.2 fences, ignored without them
+void sc_FramePacerSetMaxFramesInFlight(sc_FramePacer* pacer, saci_u32 maxFramesInFlight);
+void sc_FramePacerSetLatencyMode(sc_FramePacer* pacer, sc_FramePacerLatencyMode mode);
+
+//----------------------------------------------------------------------------//
+// Frame Pacer Usage
+//----------------------------------------------------------------------------//
+
+void sc_FramePacerBeginFrame(sc_FramePacer* pacer);
+void sc_FramePacerEndFrame(sc_FramePacer* pacer, sc_Window* window);
+
+// Seconds between the last two frame starts
+double sc_FramePacerFrameTime(const sc_FramePacer* pacer);
+// Smoothed seconds from BeginFrame returning to EndFrame, swap excluded
+double sc_FramePacerWorkTime(const sc_FramePacer* pacer);
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __SACI_CORE_SC_MESH_H__
+#define __SACI_CORE_SC_MESH_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Mesh Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Geometry uploaded once and drawn by reference every frame. A main memory
+// copy is kept for the software backend and for bounds
+typedef struct sc_Mesh sc_Mesh;
+
+// colors and texCoords can be NULL (white, 0). indices are triangles
+sc_Mesh* sc_CreateMesh(const saci_Vec3* positions, const saci_Color* colors, const saci_Vec2* texCoords,
+                       saci_u32 vertexCount, const saci_u32* indices, saci_u32 indexCount,
+                       saci_TextureID textureID);
+void sc_DeleteMesh(sc_Mesh* mesh);
+
+// Object space axis aligned box
+void sc_MeshGetBounds(const sc_Mesh* mesh, saci_Vec3* min, saci_Vec3* max);
+
+//----------------------------------------------------------------------------//
+// Mesh Usage
+//----------------------------------------------------------------------------//
+
+// model can be NULL for identity. Meshes are drawn after the immediate batch,
+// in push order, so push large occluders (walls, floors) first
+void sc_RenderPushMesh(sc_Renderer* renderer, sc_Mesh* mesh, const saci_Mat4* model);
+
+//----------------------------------------------------------------------------//
+// Level of detail
+//----------------------------------------------------------------------------//
+
+// A range of the mesh's index buffer drawn while the mesh covers at least
+// minScreenSize of the screen height (its bounding sphere against the camera
+// fov and distance)
+typedef struct sc_MeshLOD {
+    saci_u32 firstIndex;
+    saci_u32 indexCount;
+    float minScreenSize;
+} sc_MeshLOD;
+
+// lods go from most to least detailed with decreasing minScreenSize, the last
+// one is used below every threshold. Replaces the previous set, count 0
+// draws the whole index buffer again. False if a range is out of bounds
+saci_Bool sc_MeshSetLODs(sc_Mesh* mesh, const sc_MeshLOD* lods, saci_u32 count);
+
+// A mesh only changes LOD once it's this fraction past the threshold, so
+// objects sitting at a boundary don't pop every frame. Defaults to 0.1
+void sc_RenderSetLODHysteresis(sc_Renderer* renderer, float hysteresis);
+
+// LOD renderer drew for the instance-th push of mesh last frame. Every
+// renderer keeps its own, a mesh can be drawn by several at once
+saci_u32 sc_RenderGetMeshLOD(const sc_Renderer* renderer, const sc_Mesh* mesh, saci_u32 instance);
+
+//----------------------------------------------------------------------------//
+// Occlusion culling
+//----------------------------------------------------------------------------//
+
+// OpenGL backend with the z buffer on. Every tested mesh gets a bounding box
+// occlusion query at the end of the frame. The next frame skips it if the box
+// was hidden, or lets the GPU decide with conditional rendering when the
+// result isn't back yet. Something that comes into view shows up a frame late
+void sc_RenderSetOcclusionCulling(sc_Renderer* renderer, saci_Bool enabled);
+
+// On by default. Turn it off for cheap meshes, the query would cost more than
+// the draw
+void sc_MeshSetOcclusionTested(sc_Mesh* mesh, saci_Bool tested);
+
+// renderer's last known query result for the instance-th push of mesh in a
+// frame. True until a query said otherwise
+saci_Bool sc_RenderIsMeshVisible(const sc_Renderer* renderer, const sc_Mesh* mesh, saci_u32 instance);
+
+#endif
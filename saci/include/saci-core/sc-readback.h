@@ -0,0 +1,62 @@
+#ifndef __SACI_CORE_SC_READBACK_H__
+#define __SACI_CORE_SC_READBACK_H__
+
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Asynchronous readback
+//----------------------------------------------------------------------------//
+
+// rgba is only valid during the call. Rows are bottom to top, as GL returns
+// them
+typedef void (*sc_ReadbackCallback)(const saci_u8* rgba, int width, int height,
+                                    saci_u64 frameIndex, void* userData);
+
+typedef struct sc_Readback sc_Readback;
+
+// ringSize pixel buffers are cycled, a frame is delivered about ringSize - 1
+// frames after it was queued. 0 picks 3
+sc_Readback* sc_CreateReadback(saci_u32 ringSize);
+// Delivers every frame still in flight before freeing the buffers
+void sc_DeleteReadback(sc_Readback* readback);
+
+// Queues a copy of a rect of fbo (0 is the window's back buffer, read it
+// before swapping) and returns without waiting for the GPU. Finished frames
+// are delivered from here and from sc_ReadbackPoll, on the GL thread. Only
+// blocks when every buffer of the ring is still in flight
+void sc_ReadPixelsAsync(sc_Readback* readback, saci_u32 fbo, int x, int y, int width, int height,
+                        sc_ReadbackCallback callback, void* userData);
+// Delivers the frames the GPU has finished, or all of them if waitAll
+void sc_ReadbackPoll(sc_Readback* readback, saci_Bool waitAll);
+
+//----------------------------------------------------------------------------//
+// Frame writer
+//----------------------------------------------------------------------------//
+
+typedef enum sc_FrameWriterFormat {
+    SACI_FRAME_WRITER_PNG = 0, // one file per frame, path is a pattern like "frames/%05u.png"
+    SACI_FRAME_WRITER_RAW = 1, // RGBA frames appended top to bottom to a single file
+    SACI_FRAME_WRITER_Y4M = 2, // YUV4MPEG2 4:2:0 stream, playable by ffmpeg/mpv
+} sc_FrameWriterFormat;
+
+typedef struct sc_FrameWriter sc_FrameWriter;
+
+// Encodes and writes frames on its own thread. Up to maxQueuedFrames copies
+// wait for it, frames submitted past that are dropped (0 picks 8)
+sc_FrameWriter* sc_CreateFrameWriter(const char* path, sc_FrameWriterFormat format,
+                                     saci_u32 fps, saci_u32 maxQueuedFrames);
+// Writes what's still queued, then closes the output
+void sc_DeleteFrameWriter(sc_FrameWriter* writer);
+
+// Copies the frame and returns, false if it was dropped. Frames after the
+// first with another size are dropped by the RAW and Y4M formats
+saci_Bool sc_FrameWriterSubmit(sc_FrameWriter* writer, const saci_u8* rgba, int width, int height,
+                               saci_Bool bottomUp);
+// An sc_ReadbackCallback, pass the writer as userData
+void sc_FrameWriterReadbackCallback(const saci_u8* rgba, int width, int height,
+                                    saci_u64 frameIndex, void* writer);
+
+saci_u64 sc_FrameWriterWrittenFrames(sc_FrameWriter* writer);
+saci_u64 sc_FrameWriterDroppedFrames(sc_FrameWriter* writer);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef __SACI_CORE_SC_RENDER_GRAPH_H__
+#define __SACI_CORE_SC_RENDER_GRAPH_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+#include <stddef.h>
+
+//----------------------------------------------------------------------------//
+// Render Graph Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// A frame described as passes that read and write textures and buffers. On
+// execute, passes nothing visible depends on are culled, the rest run with
+// writers ahead of readers, and transient resources are taken from pools
+// kept across frames: textures from the renderer's render target pool (see
+// sc_RenderAcquireTarget), buffers from the graph's own. Transients whose
+// lifetimes don't overlap share the same GL object, so multi-pass effects
+// stop allocating per frame and the memory used is bounded by what is alive
+// at once.
+//
+// Each pass gets its write targets bound as a framebuffer with a matching
+// viewport before its function runs, a whole sc_RenderBegin/End can go in it
+typedef struct sc_RenderGraph sc_RenderGraph;
+
+// Resource handles are only valid for the frame they were declared in
+#define SACI_RENDER_GRAPH_NONE 0xFFFFFFFFu
+
+typedef enum sc_RenderGraphFormat {
+    SACI_RENDER_GRAPH_FORMAT_RGBA8 = 0,
+    SACI_RENDER_GRAPH_FORMAT_RGBA16F,
+    SACI_RENDER_GRAPH_FORMAT_R32F,
+    SACI_RENDER_GRAPH_FORMAT_DEPTH24_STENCIL8, // attached as depth and stencil
+} sc_RenderGraphFormat;
+
+typedef void (*sc_RenderPassFunction)(sc_RenderGraph* graph, void* userData);
+
+typedef struct sc_RenderGraphStats {
+    saci_u32 passCount;
+    saci_u32 culledPassCount;
+    saci_u32 transientCount;     // declared and used by a pass that ran
+    // Render targets the transient textures held at once
+    saci_u32 peakTargetCount;
+    size_t peakTargetBytes;
+    saci_u32 pooledBufferCount; // GL buffers the graph's pool holds after the frame
+    size_t pooledBufferBytes;
+} sc_RenderGraphStats;
+
+// renderer lends its render target pool and must outlive the graph
+sc_RenderGraph* sc_CreateRenderGraph(sc_Renderer* renderer);
+// Deletes the pooled buffers and framebuffers, on the context the graph
+// executed on, and gives its render targets back to the renderer
+void sc_DeleteRenderGraph(sc_RenderGraph* graph);
+
+//----------------------------------------------------------------------------//
+// Render Graph Declaration
+//----------------------------------------------------------------------------//
+
+// Drops the previous frame's passes and resources, the pool stays
+void sc_RenderGraphBegin(sc_RenderGraph* graph);
+
+// Contents are undefined when a frame first writes them, clear them or
+// cover every pixel. name must outlive sc_RenderGraphExecute
+saci_u32 sc_RenderGraphCreateTexture(sc_RenderGraph* graph, const char* name, int width, int height,
+                                     sc_RenderGraphFormat format);
+saci_u32 sc_RenderGraphCreateBuffer(sc_RenderGraph* graph, const char* name, size_t size);
+// Resources owned elsewhere. Passes writing them are never culled
+saci_u32 sc_RenderGraphImportTexture(sc_RenderGraph* graph, const char* name, saci_TextureID texture, int width,
+                                     int height, sc_RenderGraphFormat format);
+saci_u32 sc_RenderGraphImportBuffer(sc_RenderGraph* graph, const char* name, saci_u32 buffer, size_t size);
+// The default framebuffer, it can only be written
+saci_u32 sc_RenderGraphImportBackbuffer(sc_RenderGraph* graph, int width, int height);
+// Keeps the passes writing a transient, e.g. to read it back after execute
+void sc_RenderGraphMarkOutput(sc_RenderGraph* graph, saci_u32 resource);
+
+// Passes that write nothing are never culled either. Passes run in the order
+// they were added, a read sees the last write by a pass added before it
+saci_u32 sc_RenderGraphAddPass(sc_RenderGraph* graph, const char* name, sc_RenderPassFunction function,
+                               void* userData);
+void sc_RenderGraphPassRead(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource);
+// Textures written are the pass's attachments (up to 4 colors and a depth),
+// all the same size. The backbuffer can't be mixed with textures
+void sc_RenderGraphPassWrite(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource);
+// Clears the pass's color attachments to color, and depth to 1, before it runs
+void sc_RenderGraphPassClear(sc_RenderGraph* graph, saci_u32 pass, saci_Color color);
+
+//----------------------------------------------------------------------------//
+// Render Graph Execution
+//----------------------------------------------------------------------------//
+
+// Runs the frame, with the framebuffer and viewport bound before restored
+// afterwards. Without a GL context passes still run but get no GL objects
+void sc_RenderGraphExecute(sc_RenderGraph* graph);
+
+// GL name behind a resource, for pass functions (e.g. as a texture ID to
+// push triangles with) and after execute. 0 before it is allocated. Outputs
+// keep their contents until the next execute
+saci_TextureID sc_RenderGraphGetTexture(const sc_RenderGraph* graph, saci_u32 resource);
+saci_u32 sc_RenderGraphGetBuffer(const sc_RenderGraph* graph, saci_u32 resource);
+saci_Bool sc_RenderGraphPassCulled(const sc_RenderGraph* graph, saci_u32 pass);
+
+sc_RenderGraphStats sc_RenderGraphGetStats(const sc_RenderGraph* graph);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef __SACI_CORE_SC_RENDER_TARGET_H__
+#define __SACI_CORE_SC_RENDER_TARGET_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Render Target Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// An offscreen framebuffer a renderer can draw into instead of the one bound
+// by the application. The color attachment is a texture, so the result can
+// be pushed as one in a later frame
+typedef struct sc_RenderTarget sc_RenderTarget;
+
+typedef enum sc_RenderTargetFormat {
+    SACI_RENDER_TARGET_FORMAT_RGBA8 = 0,
+    SACI_RENDER_TARGET_FORMAT_RGBA16F,
+    SACI_RENDER_TARGET_FORMAT_R32F,
+    SACI_RENDER_TARGET_FORMAT_NONE, // no color, for depth only targets
+} sc_RenderTargetFormat;
+
+typedef struct sc_RenderTargetDesc {
+    int width, height;
+    sc_RenderTargetFormat colorFormat;
+    saci_Bool depth; // depth and stencil, for renderers with useZBuffer. Needed without color
+    // Above 1 draws into multisampled buffers, resolved into the color
+    // texture at every sc_RenderEnd
+    int samples;
+    // Depth is discarded after every sc_RenderEnd unless kept, which saves
+    // writing it back to memory on tiled GPUs
+    saci_Bool keepDepth;
+} sc_RenderTargetDesc;
+
+// Needs an OpenGL context, NULL without one
+sc_RenderTarget* sc_CreateRenderTarget(const sc_RenderTargetDesc* desc);
+void sc_DeleteRenderTarget(sc_RenderTarget* target);
+
+// From a pool kept by the renderer, reusing a released target with the same
+// description instead of creating one. Released targets no frame asked for
+// in a while are deleted by sc_RenderEnd, the rest go with the renderer.
+// Render graphs and dynamic resolution take their targets from it too
+sc_RenderTarget* sc_RenderAcquireTarget(sc_Renderer* renderer, const sc_RenderTargetDesc* desc);
+// Its contents stay until it is acquired again
+void sc_RenderReleaseTarget(sc_Renderer* renderer, sc_RenderTarget* target);
+// Targets the pool holds, acquired or not
+saci_u32 sc_RenderTargetPoolSize(const sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Render Target Usage
+//----------------------------------------------------------------------------//
+
+// sc_RenderBegin for a frame drawn into target by sc_RenderEnd, with the
+// viewport over all of it. The previous framebuffer and viewport are bound
+// again afterwards. clearColor clears color to it and depth to 1 first, NULL
+// draws over what is there. Only the OpenGL backend uses the target
+void sc_RenderBeginTarget(sc_Renderer* renderer, sc_RenderTarget* target, const saci_Color* clearColor);
+
+// The resolved color, 0 without color
+saci_TextureID sc_RenderTargetTexture(const sc_RenderTarget* target);
+// 0 without depth or when multisampled
+saci_TextureID sc_RenderTargetDepthTexture(const sc_RenderTarget* target);
+// Single sampled framebuffer holding the texture, for reading back
+saci_u32 sc_RenderTargetFramebuffer(const sc_RenderTarget* target);
+void sc_RenderTargetGetSize(const sc_RenderTarget* target, int* width, int* height);
+
+#endif
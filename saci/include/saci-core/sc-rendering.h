@@ -4,35 +4,104 @@
 #include "saci-core/sc-camera.h"
 #include "saci-utils/su-types.h"
 
+#include <stddef.h>
+
 //----------------------------------------------------------------------------//
 // Render Initialization/Deletion
 //----------------------------------------------------------------------------//
 
+// Layout of the batch's vertex buffer, for sc_RenderPushVertices. Colors
+// are uploaded as normalized bytes
+typedef struct saci_Vertice {
+    saci_Vec3 pos;
+    saci_ColorU8 color;
+    saci_Vec2 texCoord;
+} saci_Vertice;
+
 typedef struct sc_Renderer sc_Renderer;
 
+typedef enum sc_RendererBackend {
+    SACI_RENDER_BACKEND_OPENGL = 0,
+    SACI_RENDER_BACKEND_SOFTWARE = 1, // CPU rasterizer, needs no GL context
+    SACI_RENDER_BACKEND_NULL = 2,     // Runs the whole frontend, only counts what GL would get
+} sc_RendererBackend;
+
+// Same as sc_CreateRendererWithBackend(SACI_RENDER_BACKEND_OPENGL, ...)
 sc_Renderer* sc_CreateRenderer(saci_Bool generateDefaults);
+sc_Renderer* sc_CreateRendererWithBackend(sc_RendererBackend backend, saci_Bool generateDefaults);
 void sc_DeleteRenderer(sc_Renderer* renderer);
 
 //----------------------------------------------------------------------------//
 // Renderer config
 //----------------------------------------------------------------------------//
+
+// Pipeline state of a renderer, applied to GL at every sc_RenderEnd
+typedef struct sc_RenderConfig {
+    sc_RendererProjectionMode projectionMode;
+    sc_RendererCustomProjectionFunction customProjectionFunction;
+
+    saci_Bool shouldFillShape;
+    saci_Bool useZBuffer;
+    // OpenGL backend with useZBuffer. Everything is drawn depth only first,
+    // then shaded with GL_EQUAL so every pixel runs the fragment shader once.
+    // Pays off when overdraw costs more than the second geometry pass. Off
+    // while alphaBlending is on, blended colors must not hide what is behind
+    // them. Lines are not in the depth pass, they are shaded after the rest
+    saci_Bool depthPrePass;
+    // Colors are blended over what is drawn with their alpha (GL_SRC_ALPHA,
+    // GL_ONE_MINUS_SRC_ALPHA), text needs it for smooth edges. Draw order
+    // matters, back to front
+    saci_Bool alphaBlending;
+} sc_RenderConfig;
+
+// A renderer follows the global defaults below until it gets its own config,
+// NULL makes it follow them again. Renderers with their own config share
+// nothing, so they can be driven from different threads (one context each)
+void sc_RenderSetConfig(sc_Renderer* renderer, const sc_RenderConfig* config);
+sc_RenderConfig sc_RenderGetConfig(const sc_Renderer* renderer);
+
+// Global defaults. Set them before starting render threads
+sc_RenderConfig sc_RenderGetDefaultConfig(void);
 void sc_RenderSetNoFillMode(void);
 void sc_RenderSetFillMode(void);
 void sc_RenderEnableZBuffer(void);
 
-typedef enum sc_RenderProjectionMode {
-    SACI_RENDER_ORTHOGRAPHIC_PROJECTION = 0,
-    SACI_RENDER_PERSPECTIVE_PROJECTION = 1,
-    SACI_RENDER_CUSTOM_PROJECTION = 2,
-} sc_RendererProjectionMode;
+// sc_RendererProjectionMode lives in sc-camera.h, cameras cache per mode
 void sc_RenderSetProjectionMode(sc_RendererProjectionMode renderProjectionMode);
-typedef saci_Mat4 (*sc_RendererCustomProjectionFunction)(sc_Camera camera);
 void sc_RenderSetCustomProjectionMode(sc_RendererCustomProjectionFunction renderCustomProjectionMode);
 
 //----------------------------------------------------------------------------//
 // Renderer Usage
 //----------------------------------------------------------------------------//
 
+// What the backend submitted, or for SACI_RENDER_BACKEND_NULL what it would
+// have submitted. vertices and triangles are counted for every backend
+typedef struct sc_RenderStats {
+    saci_u64 frames;
+    saci_u64 drawCalls;
+    saci_u64 vertices;
+    saci_u64 triangles;
+    saci_u64 textureBinds;
+    saci_u64 bufferUploads;
+    saci_u64 bytesUploaded;
+    saci_u64 occlusionQueries;
+    saci_u64 occludedDraws; // mesh draws skipped on a previous query result
+    saci_u64 lodTrianglesSaved; // mesh triangles skipped by drawing a coarser LOD
+    saci_u64 depthPrePassDrawCalls;
+    saci_u64 samplesShaded; // see sc_RenderSetOverdrawCounter
+} sc_RenderStats;
+
+// lastFrame covers the last sc_RenderEnd, total everything since creation or
+// the last reset. Either can be NULL
+void sc_RenderGetStats(const sc_Renderer* renderer, sc_RenderStats* lastFrame, sc_RenderStats* total);
+void sc_RenderResetStats(sc_Renderer* renderer);
+
+// OpenGL backend. Counts the samples that passed the depth test while shading
+// with a query, reported in samplesShaded once the result is back (usually a
+// frame or two later, the counter never waits). Divided by the viewport's
+// pixel count it gives the overdraw, 1 being none
+void sc_RenderSetOverdrawCounter(sc_Renderer* renderer, saci_Bool enabled);
+
 void sc_RenderBegin(sc_Renderer* renderer);
 void sc_RenderEnd(sc_Renderer* renderer, const sc_Camera* camera);
 
@@ -48,4 +117,55 @@ void sc_RenderPushTriangle2D(sc_Renderer* renderer,
 void sc_RenderPushTriangle3D(sc_Renderer* renderer,
                              const saci_Vec3 a, const saci_Vec3 b, const saci_Vec3 c,
                              const saci_Color aColor, const saci_Color bColor, const saci_Color cColor);
+
+// Bulk versions, count is in vertices (3 per triangle), 0 pushes nothing.
+// Colors can be NULL for white. Pushing many triangles at once costs one call
+// in the batch
+void sc_RenderPushTriangles3D(sc_Renderer* renderer, const saci_Vec3* positions, const saci_Color* colors,
+                              size_t count);
+void sc_RenderPushTriangles2D(sc_Renderer* renderer, const saci_Vec2* positions, float depth,
+                              const saci_Color* colors, size_t count);
+void sc_RenderPushTrianglesTexture(sc_Renderer* renderer, const saci_Vec3* positions, const saci_Color* colors,
+                                   const saci_Vec2* uvs, size_t count, const saci_TextureID texID);
+
+// Same as above with colors packed as 0xRRGGBBAA (see saci_ColorFromHex).
+// Vertices keep colors as saci_ColorU8, r, g, b, a in that byte order, so
+// these are only swizzled from the high byte down (saci_ColorU8FromHex) and
+// never go through floats. The float pushes above clamp every channel to 0-1
+// and round it to a byte (saci_ColorU8FromColor)
+void sc_RenderPushTriangle2DHex(sc_Renderer* renderer,
+                                const saci_Vec2 a, const saci_Vec2 b, const saci_Vec2 c, float depth,
+                                saci_u32 aColor, saci_u32 bColor, saci_u32 cColor);
+void sc_RenderPushTriangle3DHex(sc_Renderer* renderer,
+                                const saci_Vec3 a, const saci_Vec3 b, const saci_Vec3 c,
+                                saci_u32 aColor, saci_u32 bColor, saci_u32 cColor);
+void sc_RenderPushTriangles3DHex(sc_Renderer* renderer, const saci_Vec3* positions, const saci_u32* colors,
+                                 size_t count);
+void sc_RenderPushTriangles2DHex(sc_Renderer* renderer, const saci_Vec2* positions, float depth,
+                                 const saci_u32* colors, size_t count);
+void sc_RenderPushTrianglesTextureHex(sc_Renderer* renderer, const saci_Vec3* positions, const saci_u32* colors,
+                                      const saci_Vec2* uvs, size_t count, const saci_TextureID texID);
+
+// Already interleaved triangles, copied straight into the batch
+void sc_RenderPushVertices(sc_Renderer* renderer, const saci_Vertice* vertices, size_t count,
+                           const saci_TextureID texID);
+
+//----------------------------------------------------------------------------//
+// Software backend
+//----------------------------------------------------------------------------//
+
+// Tiled half-space rasterizer spread over all cores. sc_RenderEnd draws the
+// batch into the renderer's own color and depth buffers instead of the window
+void sc_RenderSoftwareSetSize(sc_Renderer* renderer, int width, int height);
+void sc_RenderSoftwareClear(sc_Renderer* renderer, const saci_Color color);
+
+// RGBA8, first row is the top of the image (glReadPixels gives the bottom one)
+const saci_u8* sc_RenderSoftwareGetPixels(const sc_Renderer* renderer, int* width, int* height);
+
+// Software textures live in main memory, their IDs are only meaningful to
+// software renderers
+saci_TextureID sc_RenderSoftwareTextureLoad(const char* path, saci_Bool flipImg);
+saci_TextureID sc_RenderSoftwareTextureCreate(const saci_u8* rgba, int width, int height);
+void sc_RenderSoftwareTextureFree(saci_TextureID textureID);
+
 #endif
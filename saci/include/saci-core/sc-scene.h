@@ -0,0 +1,69 @@
+#ifndef __SACI_CORE_SC_SCENE_H__
+#define __SACI_CORE_SC_SCENE_H__
+
+#include "saci-core/sc-mesh.h"
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Scene Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Tree of nodes with a local translation, rotation and scale. World matrices
+// are cached and only recomputed for nodes whose transform, or an ancestor's,
+// changed since the last update. Nodes are kept depth first in contiguous
+// arrays, so an update is one forward pass with parents ahead of children
+typedef struct sc_Scene sc_Scene;
+
+// Parent of root nodes, and what node queries return for "none"
+#define SACI_SCENE_NO_NODE 0xFFFFFFFFu
+
+// Called by sc_RenderPushScene for nodes with a callback, world is only valid
+// during the call
+typedef void (*sc_SceneDrawCallback)(sc_Renderer* renderer, const saci_Mat4* world, void* userData);
+
+sc_Scene* sc_CreateScene(void);
+void sc_DeleteScene(sc_Scene* scene);
+
+//----------------------------------------------------------------------------//
+// Scene Nodes
+//----------------------------------------------------------------------------//
+
+// Identity transform. IDs stay valid until the node is deleted, then get
+// reused. SACI_SCENE_NO_NODE if the node couldn't be allocated
+saci_u32 sc_SceneCreateNode(sc_Scene* scene, saci_u32 parent);
+// Deletes the node's children too
+void sc_SceneDeleteNode(sc_Scene* scene, saci_u32 node);
+// The node keeps its local transform, ignored if parent is node or one of
+// its children
+void sc_SceneSetParent(sc_Scene* scene, saci_u32 node, saci_u32 parent);
+saci_u32 sc_SceneGetParent(const sc_Scene* scene, saci_u32 node);
+saci_u32 sc_SceneNodeCount(const sc_Scene* scene);
+
+// rotation is in radians around X, then Y, then Z
+void sc_SceneSetTransform(sc_Scene* scene, saci_u32 node, saci_Vec3 translation, saci_Vec3 rotation,
+                          saci_Vec3 scale);
+void sc_SceneSetTranslation(sc_Scene* scene, saci_u32 node, saci_Vec3 translation);
+void sc_SceneSetRotation(sc_Scene* scene, saci_u32 node, saci_Vec3 rotation);
+void sc_SceneSetScale(sc_Scene* scene, saci_u32 node, saci_Vec3 scale);
+void sc_SceneGetTransform(const sc_Scene* scene, saci_u32 node, saci_Vec3* translation, saci_Vec3* rotation,
+                          saci_Vec3* scale);
+
+// What sc_RenderPushScene draws for the node, NULL for nothing. A node can
+// have both, the mesh is pushed first
+void sc_SceneSetMesh(sc_Scene* scene, saci_u32 node, sc_Mesh* mesh);
+void sc_SceneSetDrawCallback(sc_Scene* scene, saci_u32 node, sc_SceneDrawCallback callback, void* userData);
+
+//----------------------------------------------------------------------------//
+// Scene Usage
+//----------------------------------------------------------------------------//
+
+// Recomputes the world matrices that are out of date, returns how many were
+saci_u32 sc_SceneUpdate(sc_Scene* scene);
+// As of the last sc_SceneUpdate
+saci_Mat4 sc_SceneGetWorldMatrix(const sc_Scene* scene, saci_u32 node);
+
+// Updates the scene and pushes its meshes and callbacks in depth first order
+void sc_RenderPushScene(sc_Renderer* renderer, sc_Scene* scene);
+
+#endif
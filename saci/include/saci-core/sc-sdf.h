@@ -0,0 +1,33 @@
+#ifndef __SACI_CORE_SC_SDF_H__
+#define __SACI_CORE_SC_SDF_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// SDF Usage
+//----------------------------------------------------------------------------//
+
+// Primitives drawn as one quad each, the fragment shader works out the
+// coverage from the shape's distance function so edges are antialiased at
+// any size. A frame's SDF primitives go out in a single instanced draw after
+// the rest of the batch, blended and without writing depth.
+//
+// The quads get a pixel of margin for the soft edge, the pixel sc-shape.h
+// tessellates for (see sc_RenderSetShapePixelSize). The software backend has
+// no fragment shader and tessellates them like sc-shape.h does instead, also
+// after the rest of the batch. Captures store them tessellated that way for
+// every backend
+
+void sc_RenderPushSdfCircle(sc_Renderer* renderer, saci_Vec2 center, float radius, float depth, saci_Color color);
+// thickness wide, centered on radius
+void sc_RenderPushSdfRing(sc_Renderer* renderer, saci_Vec2 center, float radius, float thickness, float depth,
+                          saci_Color color);
+// position is the bottom left corner, radius is clamped to half the shorter side
+void sc_RenderPushSdfRoundedBox(sc_Renderer* renderer, saci_Vec2 position, saci_Vec2 size, float radius, float depth,
+                                saci_Color color);
+// Segment from a to b with round ends
+void sc_RenderPushSdfCapsule(sc_Renderer* renderer, saci_Vec2 a, saci_Vec2 b, float radius, float depth,
+                             saci_Color color);
+
+#endif
@@ -6,8 +6,11 @@
 saci_u32 sc_CompileShaderV(const char* source);
 saci_u32 sc_CompileShaderF(const char* source);
 saci_u32 sc_CompileShaderG(const char* source);
+// Needs GL 4.3
+saci_u32 sc_CompileShaderC(const char* source);
 
 saci_u32 sc_GetShaderProgram(saci_ShaderID vshader, saci_ShaderID fshader);
 saci_u32 sc_GetShaderProgramg(saci_ShaderID vshader, saci_ShaderID fshader, saci_ShaderID gshader);
+saci_u32 sc_GetComputeShaderProgram(saci_ShaderID cshader);
 
 #endif
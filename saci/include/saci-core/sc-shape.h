@@ -0,0 +1,68 @@
+#ifndef __SACI_CORE_SC_SHAPE_H__
+#define __SACI_CORE_SC_SHAPE_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Shape Config
+//----------------------------------------------------------------------------//
+
+// Size of one screen pixel in the renderer's units, curves are split until
+// they stay within a quarter of it. Unless set, every sc_RenderEnd works it
+// out from the camera's projection at its target and the viewport height,
+// for the shapes of the next frame (2.0f / 1080.0f before the first one).
+// Set it when shapes sit far from the target's depth, 0 goes back to
+// deriving it
+void sc_RenderSetShapePixelSize(sc_Renderer* renderer, float pixelSize);
+
+//----------------------------------------------------------------------------//
+// Shape Usage
+//----------------------------------------------------------------------------//
+
+// Shapes are pushed as flat colored triangles at depth. Tessellations are
+// kept per renderer by shape parameters, relative to the shape's position,
+// so a shape drawn again (anywhere) is only copied into the batch. Shapes
+// not drawn in the last frame are dropped when the cache fills up
+
+void sc_RenderPushCircle(sc_Renderer* renderer, saci_Vec2 center, float radius, float depth, saci_Color color);
+// position is the bottom left corner, radius is clamped to half the shorter side
+void sc_RenderPushRoundedRect(sc_Renderer* renderer, saci_Vec2 position, saci_Vec2 size, float radius, float depth,
+                              saci_Color color);
+// A ring segment thickness wide centered on radius, counter-clockwise from
+// startAngle to endAngle (radians)
+void sc_RenderPushArc(sc_Renderer* renderer, saci_Vec2 center, float radius, float thickness, float startAngle,
+                      float endAngle, float depth, saci_Color color);
+// Simple polygon (no self intersections) in either winding, ear clipped
+void sc_RenderPushPolygon(sc_Renderer* renderer, const saci_Vec2* points, saci_u32 pointCount, float depth,
+                          saci_Color color);
+
+//----------------------------------------------------------------------------//
+// Path Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Lines and bezier curves split in contours by sc_PathMoveTo. The path keeps
+// its last fill and stroke tessellation until it is edited
+typedef struct sc_Path sc_Path;
+
+sc_Path* sc_CreatePath(void);
+void sc_DeletePath(sc_Path* path);
+
+//----------------------------------------------------------------------------//
+// Path Usage
+//----------------------------------------------------------------------------//
+
+void sc_PathClear(sc_Path* path);
+void sc_PathMoveTo(sc_Path* path, saci_Vec2 point);
+void sc_PathLineTo(sc_Path* path, saci_Vec2 point);
+void sc_PathQuadTo(sc_Path* path, saci_Vec2 control, saci_Vec2 point);
+void sc_PathCubicTo(sc_Path* path, saci_Vec2 control0, saci_Vec2 control1, saci_Vec2 point);
+// Joins the contour back to its first point
+void sc_PathClose(sc_Path* path);
+
+// Every contour is filled as a simple polygon on its own, holes aren't cut
+void sc_RenderPushPathFill(sc_Renderer* renderer, sc_Path* path, float depth, saci_Color color);
+// Segments width wide with bevel joins and butt caps
+void sc_RenderPushPathStroke(sc_Renderer* renderer, sc_Path* path, float width, float depth, saci_Color color);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef __SACI_CORE_SC_STATIC_BATCH_H__
+#define __SACI_CORE_SC_STATIC_BATCH_H__
+
+#include "saci-core/sc-mesh.h"
+#include "saci-core/sc-rendering.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Static Batch Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Many static meshes transformed once on the CPU and packed into one vertex
+// and index buffer, grouped by texture. Each group draws with a single call
+typedef struct sc_StaticBatch sc_StaticBatch;
+
+sc_StaticBatch* sc_CreateStaticBatch(void);
+void sc_DeleteStaticBatch(sc_StaticBatch* batch);
+
+// Copies mesh (its most detailed LOD) transformed by model, NULL for
+// identity. The mesh can be deleted afterwards. Returns the item's ID for
+// sc_StaticBatchSetEnabled, items show up after the next build
+saci_u32 sc_StaticBatchAdd(sc_StaticBatch* batch, const sc_Mesh* mesh, const saci_Mat4* model);
+// Sorts the items by texture and uploads them, can be called again after
+// adding more
+void sc_StaticBatchBuild(sc_StaticBatch* batch);
+
+saci_u32 sc_StaticBatchItemCount(const sc_StaticBatch* batch);
+// Disabled items are left out of the group's draw, contiguous enabled items
+// still go out as one range
+void sc_StaticBatchSetEnabled(sc_StaticBatch* batch, saci_u32 item, saci_Bool enabled);
+saci_Bool sc_StaticBatchIsEnabled(const sc_StaticBatch* batch, saci_u32 item);
+
+// Frustum culls the items in a compute shader instead of drawing every
+// enabled one. The visible items are packed into indirect draw commands and
+// each texture group goes out as one glMultiDrawElementsIndirect, there is no
+// per item CPU work left. Needs GL 4.3, false (and nothing changes) without
+// it. Render stats still count every enabled item, the culled count never
+// comes back to the CPU
+saci_Bool sc_StaticBatchSetGPUCulling(sc_StaticBatch* batch, saci_Bool enabled);
+
+//----------------------------------------------------------------------------//
+// Static Batch Usage
+//----------------------------------------------------------------------------//
+
+// Drawn after the immediate batch and before meshes, static geometry makes
+// good occluders
+void sc_RenderPushStaticBatch(sc_Renderer* renderer, sc_StaticBatch* batch);
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "saci-utils/su-types.h"
 
+#include <stddef.h>
+
 typedef struct sc_TextureData {
     int width, height;
     int nrChannels;
@@ -13,4 +15,67 @@ saci_u8* sc_TextureLoadData(const char* path, saci_Bool flipImg, sc_TextureData*
 saci_TextureID sc_TextureLoad(const char* path, saci_Bool flipImg);
 void sc_TextureFree(saci_TextureID textureID);
 
+//----------------------------------------------------------------------------//
+// Asynchronous loading
+//----------------------------------------------------------------------------//
+
+// Decodes images on its own threads and uploads them from the GL thread a
+// little every frame, so loading many textures never stalls a frame for long
+typedef struct sc_TextureLoader sc_TextureLoader;
+
+// threadCount decoding threads, 0 uses one per online core. Every
+// sc_TextureLoaderUpdate spends about uploadMilliseconds copying pixels
+// (0 picks 2). Needs an OpenGL context, NULL without one
+sc_TextureLoader* sc_CreateTextureLoader(saci_u32 threadCount, double uploadMilliseconds);
+// Drops what is still loading, those textures keep their placeholder
+void sc_DeleteTextureLoader(sc_TextureLoader* loader);
+
+// Returns a texture right away holding a 1x1 grey placeholder, replaced by
+// the image (with mipmaps, like sc_TextureLoad) once it finished uploading.
+// Images are decoded as RGBA. A failed load keeps the placeholder
+saci_TextureID sc_TextureLoadAsync(sc_TextureLoader* loader, const char* path, saci_Bool flipImg);
+// Stops loading it and deletes the texture. Textures still loading must be
+// freed with this rather than sc_TextureFree
+void sc_TextureLoaderCancel(sc_TextureLoader* loader, saci_TextureID textureID);
+
+// Call once per frame on the GL thread
+void sc_TextureLoaderUpdate(sc_TextureLoader* loader);
+saci_Bool sc_TextureLoaderIsPending(sc_TextureLoader* loader, saci_TextureID textureID);
+// Textures queued, decoding or uploading
+saci_u32 sc_TextureLoaderPendingCount(sc_TextureLoader* loader);
+
+//----------------------------------------------------------------------------//
+// Texture cache
+//----------------------------------------------------------------------------//
+
+// Shares one texture between every load of the same file. Entries are keyed
+// by the canonical path (symlinks, "." and ".." resolved) and flipImg, and
+// counted, the texture is freed when the last reference is released. GL
+// thread only
+typedef struct sc_TextureCache sc_TextureCache;
+
+typedef struct sc_TextureCacheStats {
+    saci_u32 textureCount;
+    saci_u64 references; // acquired and not released yet
+    saci_u64 hits;       // acquires that found the texture loaded
+    saci_u64 misses;     // acquires that loaded it, failed loads included
+    // Estimated from the sizes, 4 bytes per pixel plus a third for mipmaps.
+    // Textures still loading asynchronously count once uploaded
+    size_t bytes;
+} sc_TextureCacheStats;
+
+// Loads through loader when given (misses return its placeholder right
+// away), with sc_TextureLoad otherwise. loader must outlive the cache
+sc_TextureCache* sc_CreateTextureCache(sc_TextureLoader* loader);
+// Frees every texture still referenced
+void sc_DeleteTextureCache(sc_TextureCache* cache);
+
+// 0 if the synchronous load failed, which isn't cached
+saci_TextureID sc_TextureCacheAcquire(sc_TextureCache* cache, const char* path, saci_Bool flipImg);
+// One more reference to a texture the cache holds
+void sc_TextureCacheRetain(sc_TextureCache* cache, saci_TextureID textureID);
+void sc_TextureCacheRelease(sc_TextureCache* cache, saci_TextureID textureID);
+
+sc_TextureCacheStats sc_TextureCacheGetStats(const sc_TextureCache* cache);
+
 #endif
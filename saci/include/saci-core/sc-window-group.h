@@ -0,0 +1,70 @@
+#ifndef __SACI_CORE_SC_WINDOW_GROUP_H__
+#define __SACI_CORE_SC_WINDOW_GROUP_H__
+
+#include "saci-core/sc-windowing.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Window Group Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Windows whose contexts share one object namespace, each drawn by its own
+// thread. The group owns a hidden resource context that stays current on the
+// thread that created it, textures, shaders and buffers made there are
+// visible to every window.
+//
+// VAOs, framebuffers and queries are never shared between contexts, so
+// renderers, meshes and static batches must be created on the window's own
+// render thread (in its init function)
+typedef struct sc_WindowGroup sc_WindowGroup;
+
+// Needs sc_GLFWInit. Makes the resource context current and loads GL, so
+// don't call sc_GLADInit as well
+sc_WindowGroup* sc_CreateWindowGroup(void);
+// Stops the render threads and destroys every window of the group
+void sc_DeleteWindowGroup(sc_WindowGroup* group);
+
+// Main thread only, like every GLFW window call. The window's context is
+// never current on the calling thread
+sc_Window* sc_WindowGroupCreateWindow(sc_WindowGroup* group, int width, int height, const char* title,
+                                      sc_Monitor* monitor);
+
+//----------------------------------------------------------------------------//
+// Render threads
+//----------------------------------------------------------------------------//
+
+// Each runs on the window's render thread with its context current
+typedef void (*sc_WindowRenderInit)(sc_Window* window, void* userData);
+typedef void (*sc_WindowRenderFrame)(sc_Window* window, saci_u64 frame, void* userData);
+typedef void (*sc_WindowRenderShutdown)(sc_Window* window, void* userData);
+
+typedef struct sc_WindowRenderFunctions {
+    sc_WindowRenderInit init;         // can be NULL
+    sc_WindowRenderFrame frame;       // buffers are swapped after it returns
+    sc_WindowRenderShutdown shutdown; // can be NULL
+    void* userData;
+    int swapInterval;                 // 1 waits for vsync
+} sc_WindowRenderFunctions;
+
+// Set before sc_WindowGroupStart
+void sc_WindowGroupSetRenderFunctions(sc_WindowGroup* group, sc_Window* window,
+                                      const sc_WindowRenderFunctions* functions);
+
+// Starts one thread per window. False if a thread couldn't be started, the
+// ones already running are stopped again
+saci_Bool sc_WindowGroupStart(sc_WindowGroup* group);
+// Asks every thread to finish its frame, runs the shutdown functions and waits
+// for them. Safe to call when not running
+void sc_WindowGroupStop(sc_WindowGroup* group);
+
+// True once any window of the group was asked to close
+saci_Bool sc_WindowGroupShouldClose(const sc_WindowGroup* group);
+
+// Makes objects created on the resource context complete for the render
+// threads. Call it after uploading, before the windows use them
+void sc_WindowGroupSyncResources(sc_WindowGroup* group);
+
+// Frames the window finished since the group started
+saci_u64 sc_WindowGroupFrameCount(const sc_WindowGroup* group, sc_Window* window);
+
+#endif
@@ -32,4 +32,9 @@ void sc_ClearWindow(const saci_Color color);
 
 void sc_SwapWindowBuffer(sc_Window* window);
 
+// For the current context. 0 swaps right away (no vsync), 1 waits for the
+// next vertical blank, n for the n-th one. Negative values allow a late swap
+// to tear instead of waiting a whole interval, where the driver supports it
+void sc_SetSwapInterval(int interval);
+
 #endif
@@ -0,0 +1,10 @@
+// NOTE: Engine layer on top of saci-core. Entities and their components live
+// in an se_World and are handed to an sc_Renderer in bulk.
+
+#ifndef __SACI_se_H__
+#define __SACI_se_H__
+
+#include "saci-engine/se-render.h"
+#include "saci-engine/se-world.h"
+
+#endif
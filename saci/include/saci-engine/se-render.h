@@ -0,0 +1,23 @@
+#ifndef __SACI_ENGINE_SE_RENDER_H__
+#define __SACI_ENGINE_SE_RENDER_H__
+
+#include "saci-core/sc-rendering.h"
+#include "saci-engine/se-world.h"
+
+//----------------------------------------------------------------------------//
+// World Rendering
+//----------------------------------------------------------------------------//
+
+// Pushes every entity with a transform and a mesh or sprite. Model matrices
+// and sprite vertices are built on the world's job pool, then meshes go out
+// with sc_RenderPushMesh and sprites with one sc_RenderPushVertices per run
+// of sprites sharing a texture. Entities are visited archetype by archetype,
+// so sprites sharing a texture and components end up in one run.
+//
+// Entities sharing a mesh are pushed back to back, so its buffers and texture
+// are bound once for all of them. Each instance is still its own draw call.
+// Meshes go out in the order of their first entity, which decides what
+// occludes what (sc-mesh.h)
+void se_WorldRender(se_World* world, sc_Renderer* renderer);
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef __SACI_ENGINE_SE_WORLD_H__
+#define __SACI_ENGINE_SE_WORLD_H__
+
+#include "saci-core/sc-mesh.h"
+#include "saci-utils/su-jobs.h"
+#include "saci-utils/su-types.h"
+
+#include <stddef.h>
+
+//----------------------------------------------------------------------------//
+// World Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+// Entities are grouped by the set of components they have (their archetype).
+// Every archetype keeps one packed array per component, so a query walks
+// plain arrays instead of following pointers from entity to entity
+typedef struct se_World se_World;
+
+// Index in the low 32 bits, generation in the high ones. A destroyed
+// entity's handle stops being alive even once its index is reused
+typedef saci_u64 se_Entity;
+#define SACI_NULL_ENTITY ((se_Entity)0)
+
+// Component masks are 64 bits wide
+#define SACI_ECS_MAX_COMPONENTS 64
+#define SACI_COMPONENT_BIT(component) ((saci_u64)1 << (component))
+
+// jobs runs the parallel queries, NULL runs them on the calling thread. The
+// pool isn't owned by the world
+se_World* se_CreateWorld(saci_JobPool* jobs);
+void se_DeleteWorld(se_World* world);
+
+// size can be 0 for tags. Returns the component's ID, SACI_ECS_MAX_COMPONENTS
+// once they are all taken. The built in components below are registered by
+// se_CreateWorld
+saci_u32 se_WorldRegisterComponent(se_World* world, size_t size);
+
+//----------------------------------------------------------------------------//
+// Built in components
+//----------------------------------------------------------------------------//
+
+// Read by se_WorldRender (se-render.h)
+typedef enum se_BuiltinComponent {
+    SACI_COMPONENT_TRANSFORM = 0, // se_Transform
+    SACI_COMPONENT_MESH = 1,      // se_MeshRenderable
+    SACI_COMPONENT_SPRITE = 2,    // se_Sprite
+    SACI_BUILTIN_COMPONENT_COUNT
+} se_BuiltinComponent;
+
+// rotation is in radians around X, then Y, then Z
+typedef struct se_Transform {
+    saci_Vec3 position;
+    saci_Vec3 rotation;
+    saci_Vec3 scale;
+} se_Transform;
+
+typedef struct se_MeshRenderable {
+    sc_Mesh* mesh;
+} se_MeshRenderable;
+
+// Quad of size (times the transform's scale) centered on the position,
+// turned by rotation.z. textureID 0 is untextured
+typedef struct se_Sprite {
+    saci_Vec2 size;
+    saci_ColorU8 color;
+    saci_TextureID textureID;
+} se_Sprite;
+
+//----------------------------------------------------------------------------//
+// Entities
+//----------------------------------------------------------------------------//
+
+// New components are zeroed. Adding or removing components moves the entity
+// to another archetype, component pointers from before are invalidated by
+// any of these
+se_Entity se_WorldCreateEntity(se_World* world, saci_u64 components);
+void se_WorldDestroyEntity(se_World* world, se_Entity entity);
+void se_WorldAddComponents(se_World* world, se_Entity entity, saci_u64 components);
+void se_WorldRemoveComponents(se_World* world, se_Entity entity, saci_u64 components);
+
+saci_Bool se_WorldIsAlive(const se_World* world, se_Entity entity);
+saci_u32 se_WorldEntityCount(const se_World* world);
+// 0 for dead entities
+saci_u64 se_WorldGetComponents(const se_World* world, se_Entity entity);
+// NULL if the entity doesn't have it (or it is a tag)
+void* se_WorldGetComponent(se_World* world, se_Entity entity, saci_u32 component);
+
+//----------------------------------------------------------------------------//
+// Queries
+//----------------------------------------------------------------------------//
+
+// Rows of one archetype. columns are indexed by component ID and NULL for the
+// components the archetype doesn't have
+typedef struct se_QueryChunk {
+    saci_u32 count;
+    // Of the chunk's first row among every row the query visits, for
+    // writing results to a shared array
+    saci_u32 firstIndex;
+    saci_u32 workerIndex; // 0 to saci_JobPoolThreadCount-1, 0 without a pool
+    const se_Entity* entities;
+    void* columns[SACI_ECS_MAX_COMPONENTS];
+} se_QueryChunk;
+
+typedef void (*se_SystemFunction)(const se_QueryChunk* chunk, void* userData);
+
+// Calls system for the entities that have every component of with and none
+// of without, a chunk at a time. Entities can't be created, destroyed or
+// change components until it returns
+void se_WorldQuery(se_World* world, saci_u64 with, saci_u64 without, se_SystemFunction system, void* userData);
+// Same with the chunks spread over the world's job pool, system runs on
+// several threads at once
+void se_WorldQueryParallel(se_World* world, saci_u64 with, saci_u64 without, se_SystemFunction system,
+                           void* userData);
+// Rows se_WorldQuery would visit
+saci_u32 se_WorldQueryCount(const se_World* world, saci_u64 with, saci_u64 without);
+
+#endif
@@ -1,6 +1,10 @@
 #ifndef __SACI_UTILS_SU_GENERAL_H__
 #define __SACI_UTILS_SU_GENERAL_H__
 
+#include "saci-utils/su-types.h"
+
+#include <stddef.h>
+
 #ifdef __cplusplus
 #define SACI_SCAST_TO(type) static_cast<type>
 #else
@@ -9,4 +13,31 @@
 
 #define SACI_ARRLEN(array) (sizeof(array) / sizeof(array[0]))
 
+//------------------------------------------------------------------------------
+// Memory
+//------------------------------------------------------------------------------
+
+// Grows *data to hold at least needed elements of elementSize, doubling
+// *capacity from 16. *data and *capacity are left alone if the allocation
+// fails
+saci_Bool saci_Reserve(void** data, saci_u32* capacity, saci_u32 needed, size_t elementSize);
+
+//------------------------------------------------------------------------------
+// Hashing
+//------------------------------------------------------------------------------
+
+#define SACI_FNV1A_SEED 2166136261u
+
+// 32 bit FNV-1a over size bytes of data. Start from SACI_FNV1A_SEED, or pass a
+// previous result to hash several pieces as if they were one
+saci_u32 saci_HashFNV1a(const void* data, size_t size, saci_u32 seed);
+
+//------------------------------------------------------------------------------
+// Time
+//------------------------------------------------------------------------------
+
+// Seconds on a monotonic clock with an arbitrary start, only differences
+// between two calls mean anything
+double saci_MonotonicSeconds(void);
+
 #endif
@@ -0,0 +1,27 @@
+#ifndef __SACI_UTILS_SU_JOBS_H__
+#define __SACI_UTILS_SU_JOBS_H__
+
+#include "saci-utils/su-types.h"
+
+//------------------------------------------------------------------------------
+// Job pool
+//------------------------------------------------------------------------------
+
+typedef struct saci_JobPool saci_JobPool;
+
+// index goes from 0 to count-1, workerIndex from 0 to saci_JobPoolThreadCount-1
+typedef void (*saci_JobFunction)(void* userData, saci_u32 index, saci_u32 workerIndex);
+
+// threadCount = 0 uses one thread per online core. The calling thread counts as
+// one of them, so a pool of 1 runs everything inline
+saci_JobPool* saci_CreateJobPool(saci_u32 threadCount);
+void saci_DeleteJobPool(saci_JobPool* pool);
+
+saci_u32 saci_JobPoolThreadCount(const saci_JobPool* pool);
+
+// Runs jobFunction for every index in [0, count) and returns once all of them
+// are done. Not reentrant, only one thread may dispatch on a pool at a time
+void saci_JobPoolParallelFor(saci_JobPool* pool, saci_u32 count,
+                             saci_JobFunction jobFunction, void* userData);
+
+#endif
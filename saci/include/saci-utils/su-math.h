@@ -41,6 +41,14 @@ saci_Color saci_ColorFromU8(saci_u8 r, saci_u8 g, saci_u8 b, saci_u8 a);
 
 saci_u32 saci_HexFromColor(saci_Color color);
 
+// hex is 0xRRGGBBAA like saci_ColorFromHex
+saci_ColorU8 saci_ColorU8FromHex(saci_u32 hex);
+
+// Channels are clamped to 0-1 and rounded
+saci_ColorU8 saci_ColorU8FromColor(saci_Color color);
+
+saci_Color saci_ColorFromColorU8(saci_ColorU8 color);
+
 //------------------------------------------------------------------------------
 // Mat4
 //------------------------------------------------------------------------------
@@ -55,6 +63,12 @@ saci_Mat4 saci_PerspectiveMat4(float fov, float aspect, float near, float far);
 
 saci_Mat4 saci_OrthoMat4(float left, float right, float bottom, float top, float near, float far);
 
+// False (result untouched) if mat is singular
+saci_Bool saci_InverseMat4(saci_Mat4 mat, saci_Mat4* result);
+
+// Scales, rotates (radians around X, then Y, then Z) and translates
+saci_Mat4 saci_TRSMat4(saci_Vec3 translation, saci_Vec3 rotation, saci_Vec3 scale);
+
 saci_Mat4 saci_RotateMat4_X(saci_Mat4 mat, float angle);
 saci_Mat4 saci_RotateMat4_Y(saci_Mat4 mat, float angle);
 
@@ -37,6 +37,11 @@ typedef struct saci_Color {
     float r, g, b, a;
 } saci_Color;
 
+// 0 to 255 per channel, the layout colors take in vertex buffers
+typedef struct saci_ColorU8 {
+    saci_u8 r, g, b, a;
+} saci_ColorU8;
+
 typedef struct saci_Mat4 {
     float m[4][4];
 } saci_Mat4;
@@ -2,6 +2,7 @@
 #define __SACI_UTILS_SU_UTILS_H__
 
 #include "saci-utils/su-general.h"
+#include "saci-utils/su-jobs.h"
 #include "saci-utils/su-math.h"
 #include "saci-utils/su-types.h"
 
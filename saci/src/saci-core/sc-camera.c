@@ -1,8 +1,26 @@
 #include "saci-core/sc-camera.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-math.h"
 #include "saci-utils/su-types.h"
 
+#include <math.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_camera_init(sc_Camera* camera);
+void __sc_camera_touch(sc_Camera* camera, saci_u32 dirty);
+void __sc_camera_getParams(const sc_Camera* camera, float params[13]);
+saci_Vec4 __sc_frustum_normalizePlane(float a, float b, float c, float d);
+
+//----------------------------------------------------------------------------//
+
 sc_Camera sc_GenerateDefaultCamera3D() {
     sc_Camera camera;
+    __sc_camera_init(&camera);
     camera.position = (saci_Vec3){0.0f, 0.0f, 0.0f};
     camera.target = (saci_Vec3){0.0f, 0.0f, 0.0f};
     camera.up = (saci_Vec3){0.0f, 1.0f, 0.0f};
@@ -17,6 +35,7 @@ sc_Camera sc_GenerateDefaultCamera3D() {
 
 sc_Camera sc_GenerateDefaultCamera2D() {
     sc_Camera camera;
+    __sc_camera_init(&camera);
     camera.position = (saci_Vec3){0.0f, 0.0f, 1.0f}; // This Z=1.0f is to position
                                                      // the camera "behind" the 2D
                                                      // rendering layer(aka 0),
@@ -33,3 +52,237 @@ sc_Camera sc_GenerateDefaultCamera2D() {
 
     return camera;
 }
+
+//----------------------------------------------------------------------------//
+// Camera setters
+//----------------------------------------------------------------------------//
+
+void sc_CameraSetPosition(sc_Camera* camera, saci_Vec3 position) {
+    camera->position = position;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_VIEW);
+}
+
+void sc_CameraSetTarget(sc_Camera* camera, saci_Vec3 target) {
+    camera->target = target;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_VIEW);
+}
+
+void sc_CameraSetUp(sc_Camera* camera, saci_Vec3 up) {
+    camera->up = up;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_VIEW);
+}
+
+void sc_CameraLookAt(sc_Camera* camera, saci_Vec3 position, saci_Vec3 target, saci_Vec3 up) {
+    camera->position = position;
+    camera->target = target;
+    camera->up = up;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_VIEW);
+}
+
+void sc_CameraSetFov(sc_Camera* camera, float fov) {
+    camera->fov = fov;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_PROJECTION);
+}
+
+void sc_CameraSetAspectRatio(sc_Camera* camera, float aspectRatio) {
+    camera->aspectRatio = aspectRatio;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_PROJECTION);
+}
+
+void sc_CameraSetClipPlanes(sc_Camera* camera, float near, float far) {
+    camera->near = near;
+    camera->far = far;
+    __sc_camera_touch(camera, SACI_CAMERA_DIRTY_PROJECTION);
+}
+
+//----------------------------------------------------------------------------//
+// Cached matrices
+//----------------------------------------------------------------------------//
+
+saci_Bool sc_CameraUpdate(sc_Camera* camera, sc_RendererProjectionMode mode,
+                          sc_RendererCustomProjectionFunction customProjection) {
+    return __sc_camera_update(camera, mode, customProjection, NULL);
+}
+
+const saci_Mat4* sc_CameraGetView(const sc_Camera* camera) {
+    return &camera->view;
+}
+
+const saci_Mat4* sc_CameraGetProjection(const sc_Camera* camera) {
+    return &camera->projection;
+}
+
+const saci_Mat4* sc_CameraGetViewProjection(const sc_Camera* camera) {
+    return &camera->viewProjection;
+}
+
+const saci_Mat4* sc_CameraGetInverseView(const sc_Camera* camera) {
+    return &camera->inverseView;
+}
+
+const saci_Mat4* sc_CameraGetInverseViewProjection(const sc_Camera* camera) {
+    return &camera->inverseViewProjection;
+}
+
+const sc_Frustum* sc_CameraGetFrustum(const sc_Camera* camera) {
+    return &camera->frustum;
+}
+
+saci_u64 sc_CameraVersion(const sc_Camera* camera) {
+    return camera->version;
+}
+
+//----------------------------------------------------------------------------//
+// Frustum tests
+//----------------------------------------------------------------------------//
+
+sc_Frustum sc_FrustumFromMatrix(const saci_Mat4* viewProjection) {
+    // Rows of the clip transform, column-major storage
+    const float(*m)[4] = viewProjection->m;
+    float row[4][4];
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            row[i][j] = m[j][i];
+        }
+    }
+
+    sc_Frustum frustum;
+    for (int i = 0; i < 3; i++) {
+        frustum.planes[i * 2] = __sc_frustum_normalizePlane(row[3][0] + row[i][0], row[3][1] + row[i][1],
+                                                            row[3][2] + row[i][2], row[3][3] + row[i][3]);
+        frustum.planes[i * 2 + 1] = __sc_frustum_normalizePlane(row[3][0] - row[i][0], row[3][1] - row[i][1],
+                                                                row[3][2] - row[i][2], row[3][3] - row[i][3]);
+    }
+    return frustum;
+}
+
+saci_Bool sc_FrustumTestAABB(const sc_Frustum* frustum, saci_Vec3 min, saci_Vec3 max) {
+    for (int i = 0; i < 6; i++) {
+        const saci_Vec4* plane = &frustum->planes[i];
+        // Corner furthest along the plane normal
+        float x = plane->x >= 0.0f ? max.x : min.x;
+        float y = plane->y >= 0.0f ? max.y : min.y;
+        float z = plane->z >= 0.0f ? max.z : min.z;
+        if (plane->x * x + plane->y * y + plane->z * z + plane->w < 0.0f) {
+            return SACI_FALSE;
+        }
+    }
+    return SACI_TRUE;
+}
+
+saci_Bool sc_FrustumTestSphere(const sc_Frustum* frustum, saci_Vec3 center, float radius) {
+    for (int i = 0; i < 6; i++) {
+        const saci_Vec4* plane = &frustum->planes[i];
+        if (plane->x * center.x + plane->y * center.y + plane->z * center.z + plane->w < -radius) {
+            return SACI_FALSE;
+        }
+    }
+    return SACI_TRUE;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_camera_init(sc_Camera* camera) {
+    memset(camera, 0, sizeof(sc_Camera));
+    camera->dirty = SACI_CAMERA_DIRTY_ALL;
+    camera->view = saci_IdentityMat4();
+    camera->projection = saci_IdentityMat4();
+}
+
+void __sc_camera_touch(sc_Camera* camera, saci_u32 dirty) {
+    // The version moves once the matrices are rebuilt, not here
+    camera->dirty |= dirty;
+}
+
+void __sc_camera_getParams(const sc_Camera* camera, float params[13]) {
+    params[0] = camera->position.x;
+    params[1] = camera->position.y;
+    params[2] = camera->position.z;
+    params[3] = camera->target.x;
+    params[4] = camera->target.y;
+    params[5] = camera->target.z;
+    params[6] = camera->up.x;
+    params[7] = camera->up.y;
+    params[8] = camera->up.z;
+    params[9] = camera->fov;
+    params[10] = camera->aspectRatio;
+    params[11] = camera->near;
+    params[12] = camera->far;
+}
+
+saci_Vec4 __sc_frustum_normalizePlane(float a, float b, float c, float d) {
+    float length = sqrtf(a * a + b * b + c * c);
+    if (length == 0.0f) return (saci_Vec4){a, b, c, d};
+    float inverse = 1.0f / length;
+    return (saci_Vec4){a * inverse, b * inverse, c * inverse, d * inverse};
+}
+
+saci_Bool __sc_camera_update(sc_Camera* camera, sc_RendererProjectionMode mode,
+                             sc_RendererCustomProjectionFunction customProjection, const saci_Mat4* fixedProjection) {
+    // Fields written without a setter only show up here
+    float params[13];
+    __sc_camera_getParams(camera, params);
+    if (memcmp(params, camera->cachedParams, sizeof(params)) != 0) {
+        if (memcmp(params, camera->cachedParams, sizeof(float) * 9) != 0) {
+            camera->dirty |= SACI_CAMERA_DIRTY_VIEW;
+        }
+        if (memcmp(params + 9, camera->cachedParams + 9, sizeof(float) * 4) != 0) {
+            camera->dirty |= SACI_CAMERA_DIRTY_PROJECTION;
+        }
+    }
+    if (mode != camera->cachedProjectionMode || customProjection != camera->cachedCustomProjection ||
+        mode == SACI_RENDER_CUSTOM_PROJECTION) {
+        camera->dirty |= SACI_CAMERA_DIRTY_PROJECTION;
+    }
+    if (camera->dirty == 0) return SACI_TRUE;
+
+    if (camera->dirty & SACI_CAMERA_DIRTY_PROJECTION) {
+        switch (mode) {
+            case SACI_RENDER_ORTHOGRAPHIC_PROJECTION: {
+                camera->projection = saci_OrthoMat4(-1, 1, -1, 1, camera->near, camera->far);
+                break;
+            }
+            case SACI_RENDER_PERSPECTIVE_PROJECTION: {
+                camera->projection = saci_PerspectiveMat4(camera->fov, camera->aspectRatio,
+                                                          camera->near, camera->far);
+                break;
+            }
+            case SACI_RENDER_CUSTOM_PROJECTION: {
+                if (customProjection == NULL && fixedProjection == NULL) {
+                    return SACI_FALSE;
+                }
+                saci_Mat4 projection = fixedProjection ? *fixedProjection : customProjection(*camera);
+                // Same matrix as last time, nothing downstream has to know
+                if (camera->cachedProjectionMode == mode && camera->cachedCustomProjection == customProjection &&
+                    memcmp(&projection, &camera->projection, sizeof(saci_Mat4)) == 0) {
+                    camera->dirty &= ~SACI_CAMERA_DIRTY_PROJECTION;
+                }
+                camera->projection = projection;
+                break;
+            }
+        }
+    }
+    if (camera->dirty & SACI_CAMERA_DIRTY_VIEW) {
+        camera->view = saci_LookAtMat4(camera->position, camera->target, camera->up);
+        if (!saci_InverseMat4(camera->view, &camera->inverseView)) {
+            camera->inverseView = saci_IdentityMat4();
+        }
+    }
+
+    if (camera->dirty != 0) {
+        camera->viewProjection = saci_MultiplyMat4(camera->view, camera->projection);
+        if (!saci_InverseMat4(camera->viewProjection, &camera->inverseViewProjection)) {
+            camera->inverseViewProjection = saci_IdentityMat4();
+        }
+        camera->frustum = sc_FrustumFromMatrix(&camera->viewProjection);
+        camera->version++;
+    }
+
+    camera->cachedProjectionMode = mode;
+    camera->cachedCustomProjection = customProjection;
+    memcpy(camera->cachedParams, params, sizeof(params));
+    camera->dirty = 0;
+    return SACI_TRUE;
+}
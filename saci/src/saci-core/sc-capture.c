@@ -0,0 +1,500 @@
+#include "saci-core/sc-capture.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// File layout, all values little endian as written by the capturing machine:
+//
+//   "SACICAPT" u32 version u32 sizeof(saci_Vertice)
+//   chunks of { u32 tag, u32 size, u8 payload[size] }
+//
+// TEXR: u32 id, s32 width, s32 height, u8 flipImg, u16 pathLength, char path[pathLength]
+//       written before the first frame that references the texture
+// FRAM: u8 projectionMode, u8 shouldFillShape, u8 useZBuffer, u8 alphaBlending, u8 depthPrePass,
+//       u8 hasCamera
+//       [hasCamera] 13 floats: position, target, up, fov, aspectRatio, near, far
+//       [hasCamera] u8 hasProjection, [hasProjection] 16 floats
+//       u32 callCount, then per call:
+//         u8 drawMode | SACI_CAPTURE_TEXTURE_CHANGED, [changed] u32 textureID
+//         u32 vertexCount, saci_Vertice vertices[vertexCount]
+//       meshes, static batches and SDF primitives follow the batch's calls as
+//       the triangles the software backend draws for them, whatever the backend
+#define SACI_CAPTURE_MAGIC "SACICAPT"
+#define SACI_CAPTURE_VERSION 5
+
+#define SACI_CAPTURE_TAG(a, b, c, d) ((saci_u32)(a) | ((saci_u32)(b) << 8) | ((saci_u32)(c) << 16) | ((saci_u32)(d) << 24))
+#define SACI_CAPTURE_TAG_TEXTURE SACI_CAPTURE_TAG('T', 'E', 'X', 'R')
+#define SACI_CAPTURE_TAG_FRAME SACI_CAPTURE_TAG('F', 'R', 'A', 'M')
+
+// Draw modes fit in 3 bits (GL_POINTS to GL_QUADS)
+#define SACI_CAPTURE_TEXTURE_CHANGED 0x80
+#define SACI_CAPTURE_DRAW_MODE_MASK 0x7F
+
+typedef struct saci_CaptureBuffer {
+    saci_u8* data;
+    size_t size;
+    size_t capacity;
+} saci_CaptureBuffer;
+
+struct saci_RenderCaptureState {
+    FILE* file;
+    saci_CaptureBuffer frame;
+
+    saci_TextureID* writtenTextures;
+    saci_u32 writtenTextureCount;
+    saci_u32 writtenTextureCapacity;
+};
+
+typedef struct saci_CaptureTextureRef {
+    sc_RenderCaptureTexture info;
+    saci_TextureID replayID;
+} saci_CaptureTextureRef;
+
+struct sc_RenderCapture {
+    saci_u8* blob;
+    size_t blobSize;
+
+    const saci_u8** frames; // payloads of every FRAM chunk, inside blob
+    saci_u32 frameCount;
+
+    saci_CaptureTextureRef* textures; // sorted by captured id
+    saci_u32 textureCount;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_capture_bufferWrite(saci_CaptureBuffer* buffer, const void* data, size_t size);
+void __sc_capture_bufferU8(saci_CaptureBuffer* buffer, saci_u8 value);
+void __sc_capture_bufferU32(saci_CaptureBuffer* buffer, saci_u32 value);
+void __sc_capture_writeChunk(FILE* file, saci_u32 tag, const void* data, saci_u32 size);
+void __sc_capture_writeTextureRef(saci_RenderCaptureState* state, const sc_Renderer* renderer, saci_TextureID id);
+// Appends what the GPU backends drew outside the batch as the software
+// backend's triangles, so every backend captures the same stream
+void __sc_capture_expandDraws(sc_Renderer* renderer);
+
+saci_Bool __sc_capture_read(const saci_u8** cursor, const saci_u8* end, void* out, size_t size);
+int __sc_capture_compareTextureRefs(const void* a, const void* b);
+saci_TextureID __sc_capture_mapTexture(const sc_RenderCapture* capture, saci_TextureID capturedID);
+
+//----------------------------------------------------------------------------//
+// Capture
+//----------------------------------------------------------------------------//
+
+saci_Bool sc_RenderCaptureBegin(sc_Renderer* renderer, const char* path) {
+    if (renderer->capture) {
+        fprintf(stderr, "Renderer is already capturing\n");
+        return SACI_FALSE;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Could not open capture file %s\n", path);
+        return SACI_FALSE;
+    }
+
+    saci_RenderCaptureState* state = (saci_RenderCaptureState*)calloc(1, sizeof(saci_RenderCaptureState));
+    assert(state);
+    state->file = file;
+
+    saci_u32 header[2] = {SACI_CAPTURE_VERSION, sizeof(saci_Vertice)};
+    fwrite(SACI_CAPTURE_MAGIC, 1, 8, file);
+    fwrite(header, sizeof(header), 1, file);
+
+    renderer->capture = state;
+    return SACI_TRUE;
+}
+
+void sc_RenderCaptureEnd(sc_Renderer* renderer) {
+    saci_RenderCaptureState* state = renderer->capture;
+    if (!state) return;
+
+    fclose(state->file);
+    free(state->frame.data);
+    free(state->writtenTextures);
+    free(state);
+    renderer->capture = NULL;
+}
+
+//----------------------------------------------------------------------------//
+// Replay
+//----------------------------------------------------------------------------//
+
+sc_RenderCapture* sc_RenderCaptureLoad(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open capture file %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    sc_RenderCapture* capture = (sc_RenderCapture*)calloc(1, sizeof(sc_RenderCapture));
+    assert(capture);
+    capture->blob = (saci_u8*)malloc(fileSize > 0 ? fileSize : 1);
+    assert(capture->blob);
+    capture->blobSize = fread(capture->blob, 1, fileSize > 0 ? fileSize : 0, file);
+    fclose(file);
+
+    const saci_u8* cursor = capture->blob;
+    const saci_u8* end = capture->blob + capture->blobSize;
+
+    char magic[8];
+    saci_u32 header[2];
+    if (!__sc_capture_read(&cursor, end, magic, sizeof(magic)) || memcmp(magic, SACI_CAPTURE_MAGIC, 8) != 0 ||
+        !__sc_capture_read(&cursor, end, header, sizeof(header))) {
+        fprintf(stderr, "%s is not a saci capture\n", path);
+        sc_RenderCaptureFree(capture);
+        return NULL;
+    }
+    if (header[0] != SACI_CAPTURE_VERSION || header[1] != sizeof(saci_Vertice)) {
+        fprintf(stderr, "%s has capture version %u (vertex size %u), expected %u (%u)\n",
+                path, header[0], header[1], SACI_CAPTURE_VERSION, (saci_u32)sizeof(saci_Vertice));
+        sc_RenderCaptureFree(capture);
+        return NULL;
+    }
+
+    saci_u32 frameCapacity = 0, textureCapacity = 0;
+    while (cursor < end) {
+        saci_u32 chunk[2];
+        if (!__sc_capture_read(&cursor, end, chunk, sizeof(chunk)) || (size_t)(end - cursor) < chunk[1]) {
+            fprintf(stderr, "%s is truncated, replaying the first %u frames\n", path, capture->frameCount);
+            break;
+        }
+        const saci_u8* payload = cursor;
+        cursor += chunk[1];
+
+        if (chunk[0] == SACI_CAPTURE_TAG_FRAME) {
+            if (capture->frameCount == frameCapacity) {
+                frameCapacity = frameCapacity ? frameCapacity * 2 : 64;
+                capture->frames = (const saci_u8**)realloc(capture->frames, frameCapacity * sizeof(saci_u8*));
+                assert(capture->frames);
+            }
+            capture->frames[capture->frameCount++] = payload;
+        } else if (chunk[0] == SACI_CAPTURE_TAG_TEXTURE) {
+            saci_u32 id;
+            saci_s32 size[2];
+            saci_u8 flipImg;
+            saci_u16 pathLength;
+            const saci_u8* texCursor = payload;
+            if (!__sc_capture_read(&texCursor, cursor, &id, sizeof(id)) ||
+                !__sc_capture_read(&texCursor, cursor, size, sizeof(size)) ||
+                !__sc_capture_read(&texCursor, cursor, &flipImg, sizeof(flipImg)) ||
+                !__sc_capture_read(&texCursor, cursor, &pathLength, sizeof(pathLength)) ||
+                (size_t)(cursor - texCursor) < pathLength) {
+                continue;
+            }
+            if (capture->textureCount == textureCapacity) {
+                textureCapacity = textureCapacity ? textureCapacity * 2 : 16;
+                capture->textures = (saci_CaptureTextureRef*)realloc(capture->textures, textureCapacity * sizeof(saci_CaptureTextureRef));
+                assert(capture->textures);
+            }
+            saci_CaptureTextureRef* ref = &capture->textures[capture->textureCount++];
+            ref->info.id = id;
+            ref->info.width = size[0];
+            ref->info.height = size[1];
+            ref->info.flipImg = flipImg;
+            ref->info.path = NULL;
+            if (pathLength > 0) {
+                char* texPath = (char*)malloc(pathLength + 1);
+                assert(texPath);
+                memcpy(texPath, texCursor, pathLength);
+                texPath[pathLength] = '\0';
+                ref->info.path = texPath;
+            }
+            ref->replayID = id;
+        }
+        // Unknown chunks are skipped, newer writers may add some
+    }
+
+    qsort(capture->textures, capture->textureCount, sizeof(saci_CaptureTextureRef), __sc_capture_compareTextureRefs);
+    return capture;
+}
+
+void sc_RenderCaptureFree(sc_RenderCapture* capture) {
+    if (!capture) return;
+    for (saci_u32 i = 0; i < capture->textureCount; ++i) {
+        free((char*)capture->textures[i].info.path);
+    }
+    free(capture->textures);
+    free(capture->frames);
+    free(capture->blob);
+    free(capture);
+}
+
+saci_u32 sc_RenderCaptureFrameCount(const sc_RenderCapture* capture) {
+    return capture->frameCount;
+}
+
+saci_u32 sc_RenderCaptureTextureCount(const sc_RenderCapture* capture) {
+    return capture->textureCount;
+}
+
+sc_RenderCaptureTexture sc_RenderCaptureGetTexture(const sc_RenderCapture* capture, saci_u32 index) {
+    assert(index < capture->textureCount);
+    return capture->textures[index].info;
+}
+
+void sc_RenderCaptureMapTexture(sc_RenderCapture* capture, saci_TextureID capturedID, saci_TextureID replayID) {
+    saci_CaptureTextureRef key = {.info = {.id = capturedID}};
+    saci_CaptureTextureRef* ref = (saci_CaptureTextureRef*)bsearch(&key, capture->textures, capture->textureCount,
+                                                                   sizeof(saci_CaptureTextureRef), __sc_capture_compareTextureRefs);
+    if (!ref) {
+        fprintf(stderr, "Texture %u is not referenced by the capture\n", capturedID);
+        return;
+    }
+    ref->replayID = replayID;
+}
+
+void sc_RenderCaptureReplayFrame(sc_Renderer* renderer, const sc_RenderCapture* capture, saci_u32 frameIndex) {
+    assert(frameIndex < capture->frameCount);
+    const saci_u8* cursor = capture->frames[frameIndex];
+    const saci_u8* end = capture->blob + capture->blobSize;
+
+    saci_u8 flags[6];
+    if (!__sc_capture_read(&cursor, end, flags, sizeof(flags))) return;
+
+    sc_RenderConfig config = *__sc_getRenderConfig(renderer);
+    config.projectionMode = (sc_RendererProjectionMode)flags[0];
+    config.shouldFillShape = flags[1];
+    config.useZBuffer = flags[2];
+    config.alphaBlending = flags[3];
+    config.depthPrePass = flags[4];
+
+    sc_Camera camera = {0};
+    saci_Bool hasCamera = flags[5];
+    // Custom projections come back as the matrix they produced while capturing
+    saci_Mat4 projection;
+    saci_u8 hasProjection = 0;
+    if (hasCamera) {
+        float values[13];
+        if (!__sc_capture_read(&cursor, end, values, sizeof(values)) ||
+            !__sc_capture_read(&cursor, end, &hasProjection, sizeof(hasProjection))) {
+            return;
+        }
+        camera.position = (saci_Vec3){values[0], values[1], values[2]};
+        camera.target = (saci_Vec3){values[3], values[4], values[5]};
+        camera.up = (saci_Vec3){values[6], values[7], values[8]};
+        camera.fov = values[9];
+        camera.aspectRatio = values[10];
+        camera.near = values[11];
+        camera.far = values[12];
+
+        if (hasProjection && !__sc_capture_read(&cursor, end, &projection, sizeof(projection))) return;
+    }
+    sc_RenderSetConfig(renderer, &config);
+
+    saci_u32 callCount = 0;
+    if (!__sc_capture_read(&cursor, end, &callCount, sizeof(callCount))) return;
+
+    sc_RenderBegin(renderer);
+
+    saci_TextureID texID = 0;
+    for (saci_u32 i = 0; i < callCount; ++i) {
+        saci_u8 mode;
+        if (!__sc_capture_read(&cursor, end, &mode, sizeof(mode))) break;
+        if (mode & SACI_CAPTURE_TEXTURE_CHANGED) {
+            saci_u32 capturedID;
+            if (!__sc_capture_read(&cursor, end, &capturedID, sizeof(capturedID))) break;
+            texID = __sc_capture_mapTexture(capture, capturedID);
+        }
+
+        saci_u32 vertexCount;
+        if (!__sc_capture_read(&cursor, end, &vertexCount, sizeof(vertexCount))) break;
+        if ((size_t)(end - cursor) / sizeof(saci_Vertice) < vertexCount) break;
+
+        // Straight from the file into the batch
+        saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, mode & SACI_CAPTURE_DRAW_MODE_MASK,
+                                                          texID, vertexCount);
+        if (!vertices) break;
+        __sc_capture_read(&cursor, end, vertices, vertexCount * sizeof(saci_Vertice));
+    }
+
+    renderer->replayProjection = hasProjection ? &projection : NULL;
+    sc_RenderEnd(renderer, hasCamera ? &camera : NULL);
+    renderer->replayProjection = NULL;
+}
+
+//----------------------------------------------------------------------------//
+// Frontend hook
+//----------------------------------------------------------------------------//
+
+void __sc_capture_writeFrame(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    saci_RenderCaptureState* state = renderer->capture;
+    saci_CaptureBuffer* buffer = &state->frame;
+    const saci_RenderFrame* frame = &renderer->frame;
+    const saci_RenderBatch* batch = &renderer->renderBatch;
+
+    // The frame was submitted, sc_RenderBegin resets the batch before the next
+    __sc_capture_expandDraws(renderer);
+
+    buffer->size = 0;
+    __sc_capture_bufferU8(buffer, (saci_u8)config->projectionMode);
+    __sc_capture_bufferU8(buffer, config->shouldFillShape);
+    __sc_capture_bufferU8(buffer, config->useZBuffer);
+    __sc_capture_bufferU8(buffer, config->alphaBlending);
+    __sc_capture_bufferU8(buffer, config->depthPrePass);
+    __sc_capture_bufferU8(buffer, frame->hasCamera);
+
+    if (frame->hasCamera) {
+        const sc_Camera* camera = &frame->camera;
+        float values[13] = {
+            camera->position.x, camera->position.y, camera->position.z,
+            camera->target.x, camera->target.y, camera->target.z,
+            camera->up.x, camera->up.y, camera->up.z,
+            camera->fov, camera->aspectRatio, camera->near, camera->far};
+        __sc_capture_bufferWrite(buffer, values, sizeof(values));
+
+        // Function pointers mean nothing in another process, keep the matrix
+        saci_Bool hasProjection = config->projectionMode == SACI_RENDER_CUSTOM_PROJECTION && frame->cameraValid;
+        __sc_capture_bufferU8(buffer, hasProjection);
+        if (hasProjection) {
+            __sc_capture_bufferWrite(buffer, &frame->projection, sizeof(saci_Mat4));
+        }
+    }
+
+    // Patched once the empty calls are skipped
+    size_t callCountOffset = buffer->size;
+    saci_u32 callCount = 0;
+    __sc_capture_bufferU32(buffer, callCount);
+
+    saci_TextureID currentTexture = 0;
+    for (saci_u32 i = 0; i < batch->drawCallCount; ++i) {
+        const saci_RenderCall* call = &batch->drawCalls[i];
+        if (call->vertexCount == 0) continue;
+        callCount++;
+
+        saci_u8 mode = (saci_u8)call->drawMode;
+        if (call->textureID != currentTexture) {
+            currentTexture = call->textureID;
+            if (currentTexture != 0) __sc_capture_writeTextureRef(state, renderer, currentTexture);
+            __sc_capture_bufferU8(buffer, mode | SACI_CAPTURE_TEXTURE_CHANGED);
+            __sc_capture_bufferU32(buffer, currentTexture);
+        } else {
+            __sc_capture_bufferU8(buffer, mode);
+        }
+        __sc_capture_bufferU32(buffer, call->vertexCount);
+        __sc_capture_bufferWrite(buffer, batch->vertices + call->firstVertex, call->vertexCount * sizeof(saci_Vertice));
+    }
+    if (buffer->data) memcpy(buffer->data + callCountOffset, &callCount, sizeof(callCount));
+
+    __sc_capture_writeChunk(state->file, SACI_CAPTURE_TAG_FRAME, buffer->data, (saci_u32)buffer->size);
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_capture_bufferWrite(saci_CaptureBuffer* buffer, const void* data, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (newCapacity < buffer->size + size) newCapacity *= 2;
+        saci_u8* newData = (saci_u8*)realloc(buffer->data, newCapacity);
+        if (!newData) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        buffer->data = newData;
+        buffer->capacity = newCapacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+void __sc_capture_bufferU8(saci_CaptureBuffer* buffer, saci_u8 value) {
+    __sc_capture_bufferWrite(buffer, &value, sizeof(value));
+}
+
+void __sc_capture_bufferU32(saci_CaptureBuffer* buffer, saci_u32 value) {
+    __sc_capture_bufferWrite(buffer, &value, sizeof(value));
+}
+
+void __sc_capture_writeChunk(FILE* file, saci_u32 tag, const void* data, saci_u32 size) {
+    saci_u32 chunk[2] = {tag, size};
+    fwrite(chunk, sizeof(chunk), 1, file);
+    if (size > 0) fwrite(data, 1, size, file);
+}
+
+void __sc_capture_writeTextureRef(saci_RenderCaptureState* state, const sc_Renderer* renderer, saci_TextureID id) {
+    for (saci_u32 i = 0; i < state->writtenTextureCount; ++i) {
+        if (state->writtenTextures[i] == id) return;
+    }
+    if (state->writtenTextureCount == state->writtenTextureCapacity) {
+        saci_u32 newCapacity = state->writtenTextureCapacity ? state->writtenTextureCapacity * 2 : 16;
+        saci_TextureID* written = (saci_TextureID*)realloc(state->writtenTextures, newCapacity * sizeof(saci_TextureID));
+        if (!written) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        state->writtenTextures = written;
+        state->writtenTextureCapacity = newCapacity;
+    }
+    state->writtenTextures[state->writtenTextureCount++] = id;
+
+    char* path = NULL;
+    saci_Bool flipImg = SACI_FALSE;
+    int size[2] = {0, 0};
+    if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) {
+        __sc_software_textureSource(id, &path, &flipImg, &size[0], &size[1]);
+    } else {
+        __sc_texture_getSource(id, &path, &flipImg, &size[0], &size[1]);
+    }
+    saci_u16 pathLength = path ? (saci_u16)strnlen(path, 0xFFFF) : 0;
+
+    saci_CaptureBuffer chunk = {0};
+    __sc_capture_bufferU32(&chunk, id);
+    __sc_capture_bufferWrite(&chunk, size, sizeof(size));
+    __sc_capture_bufferU8(&chunk, flipImg);
+    __sc_capture_bufferWrite(&chunk, &pathLength, sizeof(pathLength));
+    if (pathLength > 0) __sc_capture_bufferWrite(&chunk, path, pathLength);
+    __sc_capture_writeChunk(state->file, SACI_CAPTURE_TAG_TEXTURE, chunk.data, (saci_u32)chunk.size);
+    free(chunk.data);
+    free(path);
+}
+
+void __sc_capture_expandDraws(sc_Renderer* renderer) {
+    if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) return;
+    // Same order as they are drawn
+    for (saci_u32 i = 0; i < renderer->staticBatchCount; ++i) {
+        __sc_staticBatch_pushTriangles(renderer, renderer->staticBatches[i]);
+    }
+    for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+        __sc_mesh_pushTriangles(renderer, &renderer->meshDraws[i]);
+    }
+    for (saci_u32 i = 0; i < renderer->sdfInstanceCount; ++i) {
+        __sc_sdf_pushTriangles(renderer, &renderer->sdfInstances[i]);
+    }
+}
+
+saci_Bool __sc_capture_read(const saci_u8** cursor, const saci_u8* end, void* out, size_t size) {
+    if ((size_t)(end - *cursor) < size) return SACI_FALSE;
+    memcpy(out, *cursor, size);
+    *cursor += size;
+    return SACI_TRUE;
+}
+
+int __sc_capture_compareTextureRefs(const void* a, const void* b) {
+    saci_TextureID idA = ((const saci_CaptureTextureRef*)a)->info.id;
+    saci_TextureID idB = ((const saci_CaptureTextureRef*)b)->info.id;
+    return (idA > idB) - (idA < idB);
+}
+
+saci_TextureID __sc_capture_mapTexture(const sc_RenderCapture* capture, saci_TextureID capturedID) {
+    if (capturedID == 0) return 0;
+    saci_CaptureTextureRef key = {.info = {.id = capturedID}};
+    const saci_CaptureTextureRef* ref = (const saci_CaptureTextureRef*)bsearch(&key, capture->textures, capture->textureCount,
+                                                                               sizeof(saci_CaptureTextureRef), __sc_capture_compareTextureRefs);
+    return ref ? ref->replayID : capturedID;
+}
+
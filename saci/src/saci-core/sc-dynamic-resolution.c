@@ -0,0 +1,271 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-dynamic-resolution.h"
+#include "saci-core/sc-render-target.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Timer results come back a few frames late, one query per frame in flight
+#define SACI_DYNRES_QUERY_COUNT 4
+// Weight of the newest GPU time in the running average
+#define SACI_DYNRES_SMOOTHING 0.2
+// Scale only goes up below this fraction of the target, so it doesn't
+// oscillate around it
+#define SACI_DYNRES_HEADROOM 0.85
+// Largest step up per result, drops are taken at once
+#define SACI_DYNRES_MAX_GROWTH 1.05f
+
+struct sc_DynamicResolution {
+    sc_Renderer* renderer; // owns the pool target comes from
+    int width, height; // window
+    int targetWidth, targetHeight; // allocated, at maxScale
+
+    float minScale, maxScale;
+    float scale;
+    saci_Bool automatic;
+    double targetMilliseconds;
+    double gpuMilliseconds; // smoothed, 0 before the first result
+
+    sc_RenderTarget* target;
+
+    saci_Bool timerQueries;
+    saci_u32 queries[SACI_DYNRES_QUERY_COUNT];
+    saci_Bool queryPending[SACI_DYNRES_QUERY_COUNT];
+    float queryScale[SACI_DYNRES_QUERY_COUNT]; // scale the frame was measured at
+    saci_u32 nextQuery;   // oldest pending one is read first
+    saci_Bool queryActive; // one was begun this frame
+
+    // Restored by End
+    GLint previousDrawFramebuffer, previousReadFramebuffer;
+    GLint previousViewport[4];
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_dynamicResolution_allocate(sc_DynamicResolution* resolution);
+void __sc_dynamicResolution_release(sc_DynamicResolution* resolution);
+void __sc_dynamicResolution_readQueries(sc_DynamicResolution* resolution);
+void __sc_dynamicResolution_adjust(sc_DynamicResolution* resolution, double milliseconds, float measuredScale);
+void __sc_dynamicResolution_scaledSize(const sc_DynamicResolution* resolution, int* width, int* height);
+
+//----------------------------------------------------------------------------//
+// Dynamic Resolution Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_DynamicResolution* sc_CreateDynamicResolution(sc_Renderer* renderer, int width, int height, float minScale,
+                                                 float maxScale, double targetMilliseconds) {
+    if (minScale <= 0.0f || maxScale < minScale) {
+        fprintf(stderr, "Invalid dynamic resolution scales: %f to %f.\n", minScale, maxScale);
+        return NULL;
+    }
+    if (!__sc_isGLLoaded()) {
+        fprintf(stderr, "Dynamic resolution needs an OpenGL context.\n");
+        return NULL;
+    }
+
+    sc_DynamicResolution* resolution = (sc_DynamicResolution*)calloc(1, sizeof(sc_DynamicResolution));
+    assert(resolution);
+    resolution->renderer = renderer;
+    resolution->width = width;
+    resolution->height = height;
+    resolution->minScale = minScale;
+    resolution->maxScale = maxScale;
+    resolution->scale = maxScale;
+    resolution->automatic = SACI_TRUE;
+    resolution->targetMilliseconds = targetMilliseconds;
+
+    // Without timer queries it stays a plain offscreen target at a fixed scale
+    resolution->timerQueries = GLAD_GL_VERSION_3_3;
+    if (resolution->timerQueries) {
+        glGenQueries(SACI_DYNRES_QUERY_COUNT, resolution->queries);
+    }
+
+    __sc_dynamicResolution_allocate(resolution);
+    return resolution;
+}
+
+void sc_DeleteDynamicResolution(sc_DynamicResolution* resolution) {
+    if (!resolution) return;
+    __sc_dynamicResolution_release(resolution);
+    if (resolution->timerQueries) {
+        glDeleteQueries(SACI_DYNRES_QUERY_COUNT, resolution->queries);
+    }
+    free(resolution);
+}
+
+void sc_DynamicResolutionResize(sc_DynamicResolution* resolution, int width, int height) {
+    if (width == resolution->width && height == resolution->height) return;
+    resolution->width = width;
+    resolution->height = height;
+    __sc_dynamicResolution_release(resolution);
+    __sc_dynamicResolution_allocate(resolution);
+}
+
+//----------------------------------------------------------------------------//
+// Dynamic Resolution Usage
+//----------------------------------------------------------------------------//
+
+void sc_DynamicResolutionBegin(sc_DynamicResolution* resolution, saci_Color clearColor) {
+    if (resolution->timerQueries) {
+        __sc_dynamicResolution_readQueries(resolution);
+    }
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &resolution->previousDrawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &resolution->previousReadFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, resolution->previousViewport);
+
+    int width, height;
+    __sc_dynamicResolution_scaledSize(resolution, &width, &height);
+    glBindFramebuffer(GL_FRAMEBUFFER, sc_DynamicResolutionFramebuffer(resolution));
+    glViewport(0, 0, width, height);
+
+    // Only the corner in use, the rest of the target is never shown
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(0, 0, width, height);
+    glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+
+    // Every query in flight, the GPU is far behind. Skip measuring this frame
+    // instead of waiting on it
+    resolution->queryActive = SACI_FALSE;
+    if (resolution->timerQueries && !resolution->queryPending[resolution->nextQuery]) {
+        glBeginQuery(GL_TIME_ELAPSED, resolution->queries[resolution->nextQuery]);
+        resolution->queryScale[resolution->nextQuery] = resolution->scale;
+        resolution->queryActive = SACI_TRUE;
+    }
+}
+
+void sc_DynamicResolutionEnd(sc_DynamicResolution* resolution) {
+    if (resolution->queryActive) {
+        glEndQuery(GL_TIME_ELAPSED);
+        resolution->queryPending[resolution->nextQuery] = SACI_TRUE;
+        resolution->nextQuery = (resolution->nextQuery + 1) % SACI_DYNRES_QUERY_COUNT;
+        resolution->queryActive = SACI_FALSE;
+    }
+
+    int width, height;
+    __sc_dynamicResolution_scaledSize(resolution, &width, &height);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, sc_DynamicResolutionFramebuffer(resolution));
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)resolution->previousDrawFramebuffer);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, resolution->width, resolution->height,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)resolution->previousReadFramebuffer);
+    glViewport(resolution->previousViewport[0], resolution->previousViewport[1],
+               resolution->previousViewport[2], resolution->previousViewport[3]);
+}
+
+void sc_DynamicResolutionSetScale(sc_DynamicResolution* resolution, float scale) {
+    if (scale < resolution->minScale) scale = resolution->minScale;
+    if (scale > resolution->maxScale) scale = resolution->maxScale;
+    resolution->scale = scale;
+    resolution->automatic = SACI_FALSE;
+}
+
+void sc_DynamicResolutionSetAuto(sc_DynamicResolution* resolution) {
+    resolution->automatic = SACI_TRUE;
+}
+
+float sc_DynamicResolutionScale(const sc_DynamicResolution* resolution) {
+    return resolution->scale;
+}
+
+void sc_DynamicResolutionGetSize(const sc_DynamicResolution* resolution, int* width, int* height) {
+    __sc_dynamicResolution_scaledSize(resolution, width, height);
+}
+
+double sc_DynamicResolutionGPUTime(const sc_DynamicResolution* resolution) {
+    return resolution->gpuMilliseconds;
+}
+
+saci_u32 sc_DynamicResolutionFramebuffer(const sc_DynamicResolution* resolution) {
+    return resolution->target ? sc_RenderTargetFramebuffer(resolution->target) : 0;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_dynamicResolution_allocate(sc_DynamicResolution* resolution) {
+    resolution->targetWidth = (int)ceilf(resolution->width * resolution->maxScale);
+    resolution->targetHeight = (int)ceilf(resolution->height * resolution->maxScale);
+    if (resolution->targetWidth < 1) resolution->targetWidth = 1;
+    if (resolution->targetHeight < 1) resolution->targetHeight = 1;
+
+    sc_RenderTargetDesc desc = {resolution->targetWidth, resolution->targetHeight, SACI_RENDER_TARGET_FORMAT_RGBA8,
+                                SACI_TRUE, 1, SACI_FALSE};
+    resolution->target = sc_RenderAcquireTarget(resolution->renderer, &desc);
+}
+
+void __sc_dynamicResolution_release(sc_DynamicResolution* resolution) {
+    sc_RenderReleaseTarget(resolution->renderer, resolution->target);
+    resolution->target = NULL;
+}
+
+void __sc_dynamicResolution_readQueries(sc_DynamicResolution* resolution) {
+    // Oldest first, stop at the first one that isn't back yet
+    for (saci_u32 i = 0; i < SACI_DYNRES_QUERY_COUNT; ++i) {
+        saci_u32 index = (resolution->nextQuery + i) % SACI_DYNRES_QUERY_COUNT;
+        if (!resolution->queryPending[index]) continue;
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(resolution->queries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(resolution->queries[index], GL_QUERY_RESULT, &nanoseconds);
+        resolution->queryPending[index] = SACI_FALSE;
+        __sc_dynamicResolution_adjust(resolution, (double)nanoseconds * 1e-6, resolution->queryScale[index]);
+    }
+}
+
+void __sc_dynamicResolution_adjust(sc_DynamicResolution* resolution, double milliseconds, float measuredScale) {
+    // GPU time goes roughly with the pixel count, the square of the scale.
+    // Results still in flight from before a change would otherwise push the
+    // scale the same way a second time
+    double relative = resolution->scale / measuredScale;
+    milliseconds *= relative * relative;
+
+    if (resolution->gpuMilliseconds == 0.0) {
+        resolution->gpuMilliseconds = milliseconds;
+    } else {
+        resolution->gpuMilliseconds += (milliseconds - resolution->gpuMilliseconds) * SACI_DYNRES_SMOOTHING;
+    }
+    if (!resolution->automatic || resolution->gpuMilliseconds <= 0.0) return;
+
+    double ratio = resolution->targetMilliseconds / resolution->gpuMilliseconds;
+    float scale = resolution->scale;
+    if (ratio < 1.0) {
+        scale *= (float)sqrt(ratio);
+    } else if (ratio > 1.0 / SACI_DYNRES_HEADROOM) {
+        float growth = (float)sqrt(ratio * SACI_DYNRES_HEADROOM);
+        scale *= growth < SACI_DYNRES_MAX_GROWTH ? growth : SACI_DYNRES_MAX_GROWTH;
+    }
+
+    if (scale < resolution->minScale) scale = resolution->minScale;
+    if (scale > resolution->maxScale) scale = resolution->maxScale;
+    // The average follows, it's kept for the current scale too
+    double change = scale / resolution->scale;
+    resolution->gpuMilliseconds *= change * change;
+    resolution->scale = scale;
+}
+
+void __sc_dynamicResolution_scaledSize(const sc_DynamicResolution* resolution, int* width, int* height) {
+    int scaledWidth = (int)(resolution->width * resolution->scale + 0.5f);
+    int scaledHeight = (int)(resolution->height * resolution->scale + 0.5f);
+    if (scaledWidth < 1) scaledWidth = 1;
+    if (scaledHeight < 1) scaledHeight = 1;
+    if (scaledWidth > resolution->targetWidth) scaledWidth = resolution->targetWidth;
+    if (scaledHeight > resolution->targetHeight) scaledHeight = resolution->targetHeight;
+    *width = scaledWidth;
+    *height = scaledHeight;
+}
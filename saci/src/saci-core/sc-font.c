@@ -0,0 +1,687 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-font.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <stbtt/stb_truetype.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_FONT_ATLAS_WIDTH 1024
+#define SACI_FONT_ATLAS_MIN_HEIGHT 128
+#define SACI_FONT_ATLAS_MAX_HEIGHT 8192
+
+typedef enum saci_FontTextureKind {
+    SACI_FONT_TEXTURE_GL = 0,
+    SACI_FONT_TEXTURE_SOFTWARE = 1,
+    SACI_FONT_TEXTURE_KIND_COUNT,
+} saci_FontTextureKind;
+
+// The atlas as seen by one kind of renderer
+typedef struct saci_FontTexture {
+    saci_TextureID id; // 0 until first drawn with this kind of renderer
+    int height;        // atlas height the texture was allocated with
+    int dirtyMinY, dirtyMaxY; // rows to upload again, empty when equal
+} saci_FontTexture;
+
+typedef struct saci_FontGlyph {
+    saci_u32 codepoint;
+    saci_u32 glyphIndex;
+    float advance;
+    int offsetX, offsetY;    // bitmap corner from the pen, pixels, y down
+    int width, height;       // bitmap with a blank pixel around it, 0 for blank glyphs
+    int atlasX, atlasY;
+} saci_FontGlyph;
+
+typedef struct saci_FontQuad {
+    float x0, y0, x1, y1; // pixels from the pen, y down
+    float u0, v0, u1, v1; // atlas texels
+} saci_FontQuad;
+
+// A laid out string, atlas coordinates never move so it stays valid
+typedef struct saci_FontRun {
+    char* text;
+    saci_u32 length;
+    saci_u32 hash;
+    saci_FontQuad* quads;
+    saci_u32 quadCount;
+    saci_Vec2 size;
+    saci_u64 lastUsed; // renderer frame
+} saci_FontRun;
+
+struct sc_Font {
+    saci_u8* data; // stb_truetype reads from it for as long as the font lives
+    size_t size;
+    stbtt_fontinfo info;
+
+    float scale; // font units to pixels
+    float ascent, descent, lineGap; // pixels, descent is negative
+
+    saci_u8* atlas; // coverage, SACI_FONT_ATLAS_WIDTH wide
+    int atlasHeight;
+    int shelfX, shelfY, shelfHeight;
+    saci_Bool atlasFull;
+    saci_FontTexture textures[SACI_FONT_TEXTURE_KIND_COUNT];
+
+    // Open addressing, codepoint + 1 so 0 marks a free slot
+    saci_FontGlyph* glyphs;
+    saci_u32 glyphMapCount, glyphMapCapacity;
+
+    saci_FontRun** runs; // open addressing, NULL marks a free slot
+    saci_u32 runCount, runCapacity;
+    saci_u64 frame; // last renderer frame seen, for eviction
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+// stb_truetype takes no length, so every table it may read has to lie inside
+// the data before it is handed over
+saci_Bool __sc_font_checkTables(const saci_u8* data, size_t size, int offset);
+
+const saci_FontGlyph* __sc_font_glyph(sc_Font* font, saci_u32 codepoint);
+void __sc_font_renderGlyph(sc_Font* font, saci_FontGlyph* glyph);
+saci_Bool __sc_font_allocate(sc_Font* font, int width, int height, int* x, int* y);
+void __sc_font_markDirty(sc_Font* font, int y, int height);
+void __sc_font_syncTexture(sc_Font* font, saci_FontTextureKind kind);
+// The atlas texture for the renderer's backend, synced first
+saci_TextureID __sc_font_texture(sc_Renderer* renderer, sc_Font* font);
+saci_FontUse* __sc_font_use(sc_Renderer* renderer, sc_Font* font, saci_TextureID textureID);
+void __sc_font_fixTexCoords(sc_Renderer* renderer, saci_FontUse* use);
+
+saci_u32 __sc_font_decodeUTF8(const char** text);
+saci_u32 __sc_font_hash(const char* text, saci_u32 length);
+// frame 0 looks the run up without counting it as a use
+saci_FontRun* __sc_font_run(sc_Font* font, const char* text, saci_u64 frame);
+saci_FontRun* __sc_font_shape(sc_Font* font, const char* text, saci_u32 length, saci_u32 hash);
+void __sc_font_rehashRuns(sc_Font* font, saci_u32 capacity, saci_u64 keepSince);
+void __sc_font_freeRun(saci_FontRun* run);
+
+//----------------------------------------------------------------------------//
+// Font Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_Font* sc_CreateFont(const char* path, float pixelHeight) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open font %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        fprintf(stderr, "Could not read font %s\n", path);
+        fclose(file);
+        return NULL;
+    }
+    saci_u8* data = (saci_u8*)malloc((size_t)size);
+    if (!data) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        fclose(file);
+        return NULL;
+    }
+    size_t read = fread(data, 1, (size_t)size, file);
+    fclose(file);
+    if (read != (size_t)size) {
+        fprintf(stderr, "Could not read font %s\n", path);
+        free(data);
+        return NULL;
+    }
+    sc_Font* font = sc_CreateFontFromMemory(data, (size_t)size, pixelHeight);
+    free(data);
+    if (!font) fprintf(stderr, "%s is not a TrueType font saci can read\n", path);
+    return font;
+}
+
+sc_Font* sc_CreateFontFromMemory(const saci_u8* data, size_t size, float pixelHeight) {
+    sc_Font* font = (sc_Font*)calloc(1, sizeof(sc_Font));
+    assert(font);
+    font->data = (saci_u8*)malloc(size);
+    if (!font->data) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(font);
+        return NULL;
+    }
+    memcpy(font->data, data, size);
+    font->size = size;
+
+    int offset = size >= 16 ? stbtt_GetFontOffsetForIndex(font->data, 0) : -1;
+    if (offset < 0 || !__sc_font_checkTables(font->data, size, offset) ||
+        !stbtt_InitFont(&font->info, font->data, offset)) {
+        free(font->data);
+        free(font);
+        return NULL;
+    }
+    int ascent, descent, lineGap;
+    stbtt_GetFontVMetrics(&font->info, &ascent, &descent, &lineGap);
+    if (ascent - descent <= 0) {
+        free(font->data);
+        free(font);
+        return NULL;
+    }
+    font->scale = stbtt_ScaleForPixelHeight(&font->info, pixelHeight);
+    font->ascent = ascent * font->scale;
+    font->descent = descent * font->scale;
+    font->lineGap = lineGap * font->scale;
+
+    font->atlasHeight = SACI_FONT_ATLAS_MIN_HEIGHT;
+    font->atlas = (saci_u8*)calloc((size_t)SACI_FONT_ATLAS_WIDTH * font->atlasHeight, 1);
+    font->glyphMapCapacity = 256;
+    font->glyphs = (saci_FontGlyph*)calloc(font->glyphMapCapacity, sizeof(saci_FontGlyph));
+    font->runCapacity = 64;
+    font->runs = (saci_FontRun**)calloc(font->runCapacity, sizeof(saci_FontRun*));
+    assert(font->atlas && font->glyphs && font->runs);
+    return font;
+}
+
+void sc_DeleteFont(sc_Font* font) {
+    if (!font) return;
+    if (font->textures[SACI_FONT_TEXTURE_GL].id) {
+        glDeleteTextures(1, &font->textures[SACI_FONT_TEXTURE_GL].id);
+    }
+    if (font->textures[SACI_FONT_TEXTURE_SOFTWARE].id) {
+        sc_RenderSoftwareTextureFree(font->textures[SACI_FONT_TEXTURE_SOFTWARE].id);
+    }
+    for (saci_u32 i = 0; i < font->runCapacity; ++i) {
+        __sc_font_freeRun(font->runs[i]);
+    }
+    free(font->runs);
+    free(font->glyphs);
+    free(font->atlas);
+    free(font->data);
+    free(font);
+}
+
+float sc_FontLineHeight(const sc_Font* font) {
+    return font->ascent - font->descent + font->lineGap;
+}
+
+float sc_FontAscent(const sc_Font* font) {
+    return font->ascent;
+}
+
+saci_Vec2 sc_FontMeasureText(sc_Font* font, const char* text) {
+    // Measuring doesn't count as a use, only drawing keeps runs alive
+    saci_FontRun* run = __sc_font_run(font, text, 0);
+    return run ? run->size : (saci_Vec2){0, 0};
+}
+
+//----------------------------------------------------------------------------//
+// Font Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderPushText(sc_Renderer* renderer, sc_Font* font, const char* text, saci_Vec2 position, float depth,
+                       float scale, saci_Color color) {
+    if (!text || !*text) return;
+
+    saci_FontRun* run = __sc_font_run(font, text, renderer->frameIndex);
+    if (!run || run->quadCount == 0) return;
+
+    saci_TextureID textureID = __sc_font_texture(renderer, font);
+    saci_FontUse* use = __sc_font_use(renderer, font, textureID);
+    if (!use) return;
+    // The atlas may have grown since this font's last push, here or through
+    // another renderer. sc_RenderEnd checks again for what grows after this
+    __sc_font_fixTexCoords(renderer, use);
+
+    // Uploaded as 2 triangles per quad, like every GL_QUADS call
+    saci_Vertice* vertices =
+        __sc_renderBatch_Reserve(&renderer->renderBatch, GL_QUADS, textureID, 6 * run->quadCount);
+    if (!vertices) return;
+
+    saci_ColorU8 packed = saci_ColorU8FromColor(color);
+    float invWidth = 1.0f / SACI_FONT_ATLAS_WIDTH;
+    float invHeight = 1.0f / font->atlasHeight;
+    for (saci_u32 i = 0; i < run->quadCount; ++i, vertices += 6) {
+        const saci_FontQuad* quad = &run->quads[i];
+        float x0 = position.x + quad->x0 * scale;
+        float x1 = position.x + quad->x1 * scale;
+        float y0 = position.y - quad->y0 * scale;
+        float y1 = position.y - quad->y1 * scale;
+        saci_Vec2 uv0 = {quad->u0 * invWidth, quad->v0 * invHeight};
+        saci_Vec2 uv1 = {quad->u1 * invWidth, quad->v1 * invHeight};
+
+        vertices[0] = (saci_Vertice){{x0, y0, depth}, packed, {uv0.x, uv0.y}};
+        vertices[1] = (saci_Vertice){{x1, y0, depth}, packed, {uv1.x, uv0.y}};
+        vertices[2] = (saci_Vertice){{x1, y1, depth}, packed, {uv1.x, uv1.y}};
+        vertices[3] = (saci_Vertice){{x0, y0, depth}, packed, {uv0.x, uv0.y}};
+        vertices[4] = (saci_Vertice){{x1, y1, depth}, packed, {uv1.x, uv1.y}};
+        vertices[5] = (saci_Vertice){{x0, y1, depth}, packed, {uv0.x, uv1.y}};
+    }
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_font_prepareDraws(sc_Renderer* renderer) {
+    for (saci_u32 i = 0; i < renderer->fontUseCount; ++i) {
+        saci_FontUse* use = &renderer->fontUses[i];
+        __sc_font_texture(renderer, use->font);
+        __sc_font_fixTexCoords(renderer, use);
+    }
+}
+
+saci_TextureID __sc_font_texture(sc_Renderer* renderer, sc_Font* font) {
+    switch (renderer->backend) {
+        case SACI_RENDER_BACKEND_OPENGL: {
+            __sc_font_syncTexture(font, SACI_FONT_TEXTURE_GL);
+            return font->textures[SACI_FONT_TEXTURE_GL].id;
+        }
+        case SACI_RENDER_BACKEND_SOFTWARE: {
+            __sc_font_syncTexture(font, SACI_FONT_TEXTURE_SOFTWARE);
+            return font->textures[SACI_FONT_TEXTURE_SOFTWARE].id;
+        }
+        case SACI_RENDER_BACKEND_NULL: {
+            // Never touches GL, borrows the GL texture if there is one
+            return font->textures[SACI_FONT_TEXTURE_GL].id;
+        }
+    }
+    return 0;
+}
+
+saci_FontUse* __sc_font_use(sc_Renderer* renderer, sc_Font* font, saci_TextureID textureID) {
+    // A frame rarely draws more than a few fonts
+    for (saci_u32 i = 0; i < renderer->fontUseCount; ++i) {
+        saci_FontUse* use = &renderer->fontUses[i];
+        if (use->font != font) continue;
+        // Only the null backend sees it change, once a GL renderer made one
+        use->textureID = textureID;
+        return use;
+    }
+
+    if (renderer->fontUseCount == renderer->fontUseCapacity) {
+        saci_u32 capacity = renderer->fontUseCapacity ? renderer->fontUseCapacity * 2 : 4;
+        saci_FontUse* uses = (saci_FontUse*)realloc(renderer->fontUses, capacity * sizeof(saci_FontUse));
+        if (!uses) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        renderer->fontUses = uses;
+        renderer->fontUseCapacity = capacity;
+    }
+    saci_FontUse* use = &renderer->fontUses[renderer->fontUseCount++];
+    use->font = font;
+    use->textureID = textureID;
+    use->atlasHeight = font->atlasHeight;
+    return use;
+}
+
+void __sc_font_fixTexCoords(sc_Renderer* renderer, saci_FontUse* use) {
+    int atlasHeight = use->font->atlasHeight;
+    if (use->atlasHeight == atlasHeight) return;
+
+    // Texture 0 is untextured geometry, not text
+    if (use->textureID != 0) {
+        // Heights double, the ratio is exact
+        float ratio = (float)use->atlasHeight / (float)atlasHeight;
+        saci_RenderBatch* batch = &renderer->renderBatch;
+        for (saci_u32 i = 0; i < batch->drawCallCount; ++i) {
+            saci_RenderCall* call = &batch->drawCalls[i];
+            if (call->textureID != use->textureID) continue;
+            saci_Vertice* vertices = batch->vertices + call->firstVertex;
+            for (saci_u32 v = 0; v < call->vertexCount; ++v) vertices[v].texCoord.y *= ratio;
+        }
+    }
+    use->atlasHeight = atlasHeight;
+}
+
+saci_Bool __sc_font_checkTables(const saci_u8* data, size_t size, int offset) {
+    if ((size_t)offset + 12 > size) return SACI_FALSE;
+    const saci_u8* directory = data + offset;
+    saci_u32 tableCount = (saci_u32)directory[4] << 8 | directory[5];
+    if ((size_t)offset + 12 + (size_t)tableCount * 16 > size) return SACI_FALSE;
+    for (saci_u32 i = 0; i < tableCount; ++i) {
+        const saci_u8* record = directory + 12 + i * 16;
+        size_t tableOffset = (size_t)record[8] << 24 | (size_t)record[9] << 16 | (size_t)record[10] << 8 | record[11];
+        size_t length = (size_t)record[12] << 24 | (size_t)record[13] << 16 | (size_t)record[14] << 8 | record[15];
+        if (tableOffset > size || length > size - tableOffset) return SACI_FALSE;
+    }
+    return SACI_TRUE;
+}
+
+const saci_FontGlyph* __sc_font_glyph(sc_Font* font, saci_u32 codepoint) {
+    saci_u32 mask = font->glyphMapCapacity - 1;
+    saci_u32 slot = (codepoint * 2654435761u) & mask;
+    while (font->glyphs[slot].codepoint != 0) {
+        if (font->glyphs[slot].codepoint == codepoint + 1) return &font->glyphs[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    if ((font->glyphMapCount + 1) * 4 > font->glyphMapCapacity * 3) {
+        saci_u32 capacity = font->glyphMapCapacity * 2;
+        saci_FontGlyph* glyphs = (saci_FontGlyph*)calloc(capacity, sizeof(saci_FontGlyph));
+        if (!glyphs) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        for (saci_u32 i = 0; i < font->glyphMapCapacity; ++i) {
+            if (font->glyphs[i].codepoint == 0) continue;
+            saci_u32 moved = ((font->glyphs[i].codepoint - 1) * 2654435761u) & (capacity - 1);
+            while (glyphs[moved].codepoint != 0) moved = (moved + 1) & (capacity - 1);
+            glyphs[moved] = font->glyphs[i];
+        }
+        free(font->glyphs);
+        font->glyphs = glyphs;
+        font->glyphMapCapacity = capacity;
+        mask = capacity - 1;
+        slot = (codepoint * 2654435761u) & mask;
+        while (font->glyphs[slot].codepoint != 0) slot = (slot + 1) & mask;
+    }
+
+    saci_FontGlyph* glyph = &font->glyphs[slot];
+    memset(glyph, 0, sizeof(*glyph));
+    glyph->codepoint = codepoint + 1;
+    glyph->glyphIndex = (saci_u32)stbtt_FindGlyphIndex(&font->info, (int)codepoint);
+    font->glyphMapCount++;
+    __sc_font_renderGlyph(font, glyph);
+    return glyph;
+}
+
+void __sc_font_renderGlyph(sc_Font* font, saci_FontGlyph* glyph) {
+    int advance, leftSideBearing;
+    stbtt_GetGlyphHMetrics(&font->info, (int)glyph->glyphIndex, &advance, &leftSideBearing);
+    glyph->advance = advance * font->scale;
+
+    int left, top, right, bottom;
+    stbtt_GetGlyphBitmapBox(&font->info, (int)glyph->glyphIndex, font->scale, font->scale, &left, &top, &right,
+                            &bottom);
+    if (right <= left || bottom <= top) return; // blank, e.g. space
+
+    // A blank pixel on every side keeps linear filtering off the neighbours,
+    // the atlas is cleared so only the inside is written
+    int width = right - left + 2;
+    int height = bottom - top + 2;
+    int x, y;
+    if (!__sc_font_allocate(font, width, height, &x, &y)) return;
+    saci_u8* inside = font->atlas + (size_t)(y + 1) * SACI_FONT_ATLAS_WIDTH + x + 1;
+    stbtt_MakeGlyphBitmap(&font->info, inside, width - 2, height - 2, SACI_FONT_ATLAS_WIDTH, font->scale, font->scale,
+                          (int)glyph->glyphIndex);
+    __sc_font_markDirty(font, y, height);
+
+    glyph->offsetX = left - 1;
+    glyph->offsetY = top - 1;
+    glyph->width = width;
+    glyph->height = height;
+    glyph->atlasX = x;
+    glyph->atlasY = y;
+}
+
+// Shelves: glyphs fill a row left to right, a new row starts below the
+// tallest one. The atlas doubles in height when the rows run out
+saci_Bool __sc_font_allocate(sc_Font* font, int width, int height, int* x, int* y) {
+    if (width > SACI_FONT_ATLAS_WIDTH) return SACI_FALSE;
+    if (font->shelfX + width > SACI_FONT_ATLAS_WIDTH) {
+        font->shelfY += font->shelfHeight;
+        font->shelfX = 0;
+        font->shelfHeight = 0;
+    }
+
+    int newHeight = font->atlasHeight;
+    while (font->shelfY + height > newHeight) newHeight *= 2;
+    if (newHeight > SACI_FONT_ATLAS_MAX_HEIGHT) {
+        if (!font->atlasFull) fprintf(stderr, "Font atlas is full, new glyphs are left blank\n");
+        font->atlasFull = SACI_TRUE;
+        return SACI_FALSE;
+    }
+    if (newHeight != font->atlasHeight) {
+        saci_u8* atlas = (saci_u8*)realloc(font->atlas, (size_t)SACI_FONT_ATLAS_WIDTH * newHeight);
+        if (!atlas) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return SACI_FALSE;
+        }
+        memset(atlas + (size_t)SACI_FONT_ATLAS_WIDTH * font->atlasHeight, 0,
+               (size_t)SACI_FONT_ATLAS_WIDTH * (newHeight - font->atlasHeight));
+        font->atlas = atlas;
+        font->atlasHeight = newHeight;
+    }
+
+    *x = font->shelfX;
+    *y = font->shelfY;
+    font->shelfX += width;
+    if (height > font->shelfHeight) font->shelfHeight = height;
+    return SACI_TRUE;
+}
+
+void __sc_font_markDirty(sc_Font* font, int y, int height) {
+    for (int kind = 0; kind < SACI_FONT_TEXTURE_KIND_COUNT; ++kind) {
+        saci_FontTexture* texture = &font->textures[kind];
+        if (texture->dirtyMinY == texture->dirtyMaxY) {
+            texture->dirtyMinY = y;
+            texture->dirtyMaxY = y + height;
+            continue;
+        }
+        if (y < texture->dirtyMinY) texture->dirtyMinY = y;
+        if (y + height > texture->dirtyMaxY) texture->dirtyMaxY = y + height;
+    }
+}
+
+void __sc_font_syncTexture(sc_Font* font, saci_FontTextureKind kind) {
+    saci_FontTexture* texture = &font->textures[kind];
+    saci_Bool reallocate = texture->id == 0 || texture->height != font->atlasHeight;
+    if (!reallocate && texture->dirtyMinY == texture->dirtyMaxY) return;
+
+    int firstRow = reallocate ? 0 : texture->dirtyMinY;
+    int rowCount = reallocate ? font->atlasHeight : texture->dirtyMaxY - texture->dirtyMinY;
+    const saci_u8* rows = font->atlas + (size_t)firstRow * SACI_FONT_ATLAS_WIDTH;
+
+    if (kind == SACI_FONT_TEXTURE_GL) {
+        if (texture->id == 0) {
+            glGenTextures(1, &texture->id);
+            glBindTexture(GL_TEXTURE_2D, texture->id);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            // One channel of coverage, white with coverage as alpha to the shader
+            GLint swizzle[4] = {GL_ONE, GL_ONE, GL_ONE, GL_RED};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        } else {
+            glBindTexture(GL_TEXTURE_2D, texture->id);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (reallocate) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, SACI_FONT_ATLAS_WIDTH, font->atlasHeight, 0, GL_RED,
+                         GL_UNSIGNED_BYTE, rows);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, SACI_FONT_ATLAS_WIDTH, rowCount, GL_RED, GL_UNSIGNED_BYTE,
+                            rows);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    } else {
+        saci_u8* rgba = (saci_u8*)malloc((size_t)SACI_FONT_ATLAS_WIDTH * rowCount * 4);
+        if (!rgba) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        for (size_t i = 0; i < (size_t)SACI_FONT_ATLAS_WIDTH * rowCount; ++i) {
+            rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = 255;
+            rgba[i * 4 + 3] = rows[i];
+        }
+        if (texture->id == 0) {
+            texture->id = sc_RenderSoftwareTextureCreate(rgba, SACI_FONT_ATLAS_WIDTH, font->atlasHeight);
+        } else {
+            if (reallocate) __sc_software_textureResize(texture->id, SACI_FONT_ATLAS_WIDTH, font->atlasHeight);
+            __sc_software_textureUpdate(texture->id, 0, firstRow, SACI_FONT_ATLAS_WIDTH, rowCount, rgba);
+        }
+        free(rgba);
+    }
+
+    texture->height = font->atlasHeight;
+    texture->dirtyMinY = texture->dirtyMaxY = 0;
+}
+
+saci_u32 __sc_font_decodeUTF8(const char** text) {
+    const saci_u8* p = (const saci_u8*)*text;
+    saci_u32 codepoint;
+    int extra;
+    if (p[0] < 0x80) {
+        codepoint = p[0];
+        extra = 0;
+    } else if ((p[0] & 0xE0) == 0xC0) {
+        codepoint = p[0] & 0x1F;
+        extra = 1;
+    } else if ((p[0] & 0xF0) == 0xE0) {
+        codepoint = p[0] & 0x0F;
+        extra = 2;
+    } else if ((p[0] & 0xF8) == 0xF0) {
+        codepoint = p[0] & 0x07;
+        extra = 3;
+    } else {
+        *text += 1;
+        return 0xFFFD;
+    }
+    for (int i = 1; i <= extra; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            *text += i;
+            return 0xFFFD;
+        }
+        codepoint = codepoint << 6 | (p[i] & 0x3F);
+    }
+    *text += extra + 1;
+    return codepoint;
+}
+
+saci_u32 __sc_font_hash(const char* text, saci_u32 length) {
+    return saci_HashFNV1a(text, length, SACI_FNV1A_SEED);
+}
+
+saci_FontRun* __sc_font_run(sc_Font* font, const char* text, saci_u64 frame) {
+    if (frame > font->frame) font->frame = frame;
+    saci_u32 length = (saci_u32)strlen(text);
+    saci_u32 hash = __sc_font_hash(text, length);
+
+    saci_u32 mask = font->runCapacity - 1;
+    saci_u32 slot = hash & mask;
+    while (font->runs[slot]) {
+        saci_FontRun* run = font->runs[slot];
+        if (run->hash == hash && run->length == length && memcmp(run->text, text, length) == 0) {
+            if (frame > run->lastUsed) run->lastUsed = frame;
+            return run;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    saci_FontRun* run = __sc_font_shape(font, text, length, hash);
+    if (!run) return NULL;
+    run->lastUsed = frame;
+
+    if ((font->runCount + 1) * 4 > font->runCapacity * 3) {
+        // Drop what wasn't drawn last frame, grow if that doesn't free enough
+        __sc_font_rehashRuns(font, font->runCapacity, font->frame ? font->frame - 1 : 0);
+        if ((font->runCount + 1) * 2 > font->runCapacity) {
+            __sc_font_rehashRuns(font, font->runCapacity * 2, 0);
+        }
+        mask = font->runCapacity - 1;
+    }
+    slot = hash & mask;
+    while (font->runs[slot]) slot = (slot + 1) & mask;
+    font->runs[slot] = run;
+    font->runCount++;
+    return run;
+}
+
+saci_FontRun* __sc_font_shape(sc_Font* font, const char* text, saci_u32 length, saci_u32 hash) {
+    saci_FontRun* run = (saci_FontRun*)calloc(1, sizeof(saci_FontRun));
+    char* copy = (char*)malloc(length + 1);
+    // Never more quads than bytes
+    saci_FontQuad* quads = (saci_FontQuad*)malloc((length ? length : 1) * sizeof(saci_FontQuad));
+    if (!run || !copy || !quads) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(run);
+        free(copy);
+        free(quads);
+        return NULL;
+    }
+    memcpy(copy, text, length + 1);
+    run->text = copy;
+    run->length = length;
+    run->hash = hash;
+    run->quads = quads;
+
+    float lineHeight = sc_FontLineHeight(font);
+    float penX = 0.0f, penY = 0.0f, width = 0.0f;
+    saci_u32 previous = 0;
+    saci_Bool hasPrevious = SACI_FALSE;
+    const char* cursor = text;
+    while (*cursor) {
+        saci_u32 codepoint = __sc_font_decodeUTF8(&cursor);
+        if (codepoint == '\n') {
+            if (penX > width) width = penX;
+            penX = 0.0f;
+            penY += lineHeight;
+            hasPrevious = SACI_FALSE;
+            continue;
+        }
+        const saci_FontGlyph* glyph = __sc_font_glyph(font, codepoint);
+        if (!glyph) continue;
+        if (hasPrevious) {
+            penX += stbtt_GetGlyphKernAdvance(&font->info, (int)previous, (int)glyph->glyphIndex) * font->scale;
+        }
+
+        if (glyph->width > 0) {
+            saci_FontQuad* quad = &quads[run->quadCount++];
+            quad->x0 = penX + glyph->offsetX;
+            quad->y0 = penY + glyph->offsetY;
+            quad->x1 = quad->x0 + glyph->width;
+            quad->y1 = quad->y0 + glyph->height;
+            quad->u0 = (float)glyph->atlasX;
+            quad->v0 = (float)glyph->atlasY;
+            quad->u1 = (float)(glyph->atlasX + glyph->width);
+            quad->v1 = (float)(glyph->atlasY + glyph->height);
+        }
+        penX += glyph->advance;
+        previous = glyph->glyphIndex;
+        hasPrevious = SACI_TRUE;
+    }
+    if (penX > width) width = penX;
+    run->size = (saci_Vec2){width, penY + lineHeight};
+    return run;
+}
+
+void __sc_font_rehashRuns(sc_Font* font, saci_u32 capacity, saci_u64 keepSince) {
+    saci_FontRun** runs = (saci_FontRun**)calloc(capacity, sizeof(saci_FontRun*));
+    if (!runs) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    saci_u32 count = 0;
+    for (saci_u32 i = 0; i < font->runCapacity; ++i) {
+        saci_FontRun* run = font->runs[i];
+        if (!run) continue;
+        if (run->lastUsed < keepSince) {
+            __sc_font_freeRun(run);
+            continue;
+        }
+        saci_u32 slot = run->hash & (capacity - 1);
+        while (runs[slot]) slot = (slot + 1) & (capacity - 1);
+        runs[slot] = run;
+        count++;
+    }
+    free(font->runs);
+    font->runs = runs;
+    font->runCapacity = capacity;
+    font->runCount = count;
+}
+
+void __sc_font_freeRun(saci_FontRun* run) {
+    if (!run) return;
+    free(run->text);
+    free(run->quads);
+    free(run);
+}
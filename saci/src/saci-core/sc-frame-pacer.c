@@ -0,0 +1,202 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-event.h"
+#include "saci-core/sc-frame-pacer.h"
+#include "saci-core/sc-windowing.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SACI_FRAME_PACER_MAX_FENCES 8
+// Sleeps overshoot by up to about this much, the rest is spun
+#define SACI_FRAME_PACER_SPIN_SECONDS 0.002
+// Weight of the newest frame in the work time average
+#define SACI_FRAME_PACER_WORK_SMOOTHING 0.1
+// Low latency mode wakes this much earlier than the average work time asks,
+// a slower frame than usual would miss its slot otherwise
+#define SACI_FRAME_PACER_WORK_MARGIN 1.25
+
+struct sc_FramePacer {
+    double targetFrameTime; // 0 when uncapped
+    saci_u32 maxFramesInFlight;
+    sc_FramePacerLatencyMode latencyMode;
+
+    saci_Bool fences; // GL 3.2
+    GLsync inFlight[SACI_FRAME_PACER_MAX_FENCES];
+    saci_u32 inFlightHead;
+    saci_u32 inFlightCount;
+
+    double deadline; // when the current frame should be done, 0 before the first
+    double frameStart;
+    double previousFrameStart;
+    double frameTime;
+    double workTime;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_framePacer_waitUntil(double time);
+void __sc_framePacer_waitFences(sc_FramePacer* pacer, saci_u32 maxInFlight);
+void __sc_framePacer_limit(sc_FramePacer* pacer);
+
+//----------------------------------------------------------------------------//
+// Frame Pacer Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_FramePacer* sc_CreateFramePacer(double targetFPS, saci_u32 maxFramesInFlight) {
+    sc_FramePacer* pacer = (sc_FramePacer*)calloc(1, sizeof(sc_FramePacer));
+    assert(pacer);
+    pacer->fences = __sc_isGLLoaded() && GLAD_GL_VERSION_3_2;
+    pacer->latencyMode = SACI_FRAME_PACER_LATENCY_DEFAULT;
+    sc_FramePacerSetTargetFPS(pacer, targetFPS);
+    sc_FramePacerSetMaxFramesInFlight(pacer, maxFramesInFlight);
+    return pacer;
+}
+
+void sc_DeleteFramePacer(sc_FramePacer* pacer) {
+    if (!pacer) return;
+    for (saci_u32 i = 0; i < pacer->inFlightCount; ++i) {
+        glDeleteSync(pacer->inFlight[(pacer->inFlightHead + i) % SACI_FRAME_PACER_MAX_FENCES]);
+    }
+    free(pacer);
+}
+
+void sc_FramePacerSetTargetFPS(sc_FramePacer* pacer, double targetFPS) {
+    pacer->targetFrameTime = targetFPS > 0.0 ? 1.0 / targetFPS : 0.0;
+    pacer->deadline = 0.0; // restart the cadence from the next frame
+}
+
+void sc_FramePacerSetMaxFramesInFlight(sc_FramePacer* pacer, saci_u32 maxFramesInFlight) {
+    if (maxFramesInFlight > SACI_FRAME_PACER_MAX_FENCES) maxFramesInFlight = SACI_FRAME_PACER_MAX_FENCES;
+    pacer->maxFramesInFlight = maxFramesInFlight;
+}
+
+void sc_FramePacerSetLatencyMode(sc_FramePacer* pacer, sc_FramePacerLatencyMode mode) {
+    pacer->latencyMode = mode;
+}
+
+//----------------------------------------------------------------------------//
+// Frame Pacer Usage
+//----------------------------------------------------------------------------//
+
+void sc_FramePacerBeginFrame(sc_FramePacer* pacer) {
+    saci_Bool lowLatency = pacer->latencyMode == SACI_FRAME_PACER_LATENCY_LOW;
+
+    // Input read now would sit behind every queued frame before it shows up
+    saci_u32 maxInFlight = lowLatency ? 1 : pacer->maxFramesInFlight;
+    __sc_framePacer_waitFences(pacer, maxInFlight);
+
+    if (lowLatency) {
+        __sc_framePacer_limit(pacer);
+        sc_PollEvents();
+    } else {
+        sc_PollEvents();
+        __sc_framePacer_limit(pacer);
+    }
+
+    pacer->frameStart = saci_MonotonicSeconds();
+    if (pacer->previousFrameStart > 0.0) {
+        pacer->frameTime = pacer->frameStart - pacer->previousFrameStart;
+    }
+    pacer->previousFrameStart = pacer->frameStart;
+}
+
+void sc_FramePacerEndFrame(sc_FramePacer* pacer, sc_Window* window) {
+    double work = saci_MonotonicSeconds() - pacer->frameStart;
+    if (pacer->workTime == 0.0) {
+        pacer->workTime = work;
+    } else {
+        pacer->workTime += (work - pacer->workTime) * SACI_FRAME_PACER_WORK_SMOOTHING;
+    }
+
+    sc_SwapWindowBuffer(window);
+
+    if (!pacer->fences) return;
+    if (pacer->maxFramesInFlight == 0 && pacer->latencyMode != SACI_FRAME_PACER_LATENCY_LOW) return;
+
+    if (pacer->inFlightCount == SACI_FRAME_PACER_MAX_FENCES) {
+        __sc_framePacer_waitFences(pacer, SACI_FRAME_PACER_MAX_FENCES);
+    }
+    saci_u32 tail = (pacer->inFlightHead + pacer->inFlightCount) % SACI_FRAME_PACER_MAX_FENCES;
+    pacer->inFlight[tail] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pacer->inFlightCount++;
+}
+
+double sc_FramePacerFrameTime(const sc_FramePacer* pacer) {
+    return pacer->frameTime;
+}
+
+double sc_FramePacerWorkTime(const sc_FramePacer* pacer) {
+    return pacer->workTime;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_framePacer_waitUntil(double time) {
+    // The scheduler wakes late, sleep most of the way and spin the rest
+    double sleepUntil = time - SACI_FRAME_PACER_SPIN_SECONDS;
+    if (sleepUntil > saci_MonotonicSeconds()) {
+        struct timespec ts;
+        ts.tv_sec = (time_t)sleepUntil;
+        ts.tv_nsec = (long)((sleepUntil - (double)ts.tv_sec) * 1e9);
+        // Rounding can land on a whole second, which the call rejects
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        } else if (ts.tv_nsec < 0) {
+            ts.tv_nsec = 0;
+        }
+        // Interrupted by a signal, go back to sleep. Any other error falls
+        // through to the spin
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+    }
+    while (saci_MonotonicSeconds() < time) {
+    }
+}
+
+void __sc_framePacer_waitFences(sc_FramePacer* pacer, saci_u32 maxInFlight) {
+    if (maxInFlight == 0) return;
+    while (pacer->inFlightCount >= maxInFlight) {
+        GLsync fence = pacer->inFlight[pacer->inFlightHead];
+        GLenum status;
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000ull);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        glDeleteSync(fence);
+        pacer->inFlightHead = (pacer->inFlightHead + 1) % SACI_FRAME_PACER_MAX_FENCES;
+        pacer->inFlightCount--;
+    }
+}
+
+void __sc_framePacer_limit(sc_FramePacer* pacer) {
+    if (pacer->targetFrameTime <= 0.0) return;
+
+    double now = saci_MonotonicSeconds();
+    // A frame that missed a whole slot pushes the cadence back instead of
+    // racing through the next ones to catch up
+    if (pacer->deadline == 0.0 || now > pacer->deadline + pacer->targetFrameTime) {
+        pacer->deadline = now + pacer->targetFrameTime;
+        return;
+    }
+    pacer->deadline += pacer->targetFrameTime;
+
+    double slotStart = pacer->deadline - pacer->targetFrameTime;
+    double wake = slotStart;
+    if (pacer->latencyMode == SACI_FRAME_PACER_LATENCY_LOW) {
+        // Start as late as possible and still be done by the deadline
+        wake = pacer->deadline - pacer->workTime * SACI_FRAME_PACER_WORK_MARGIN;
+        if (wake < slotStart) wake = slotStart;
+    }
+    __sc_framePacer_waitUntil(wake);
+}
@@ -0,0 +1,664 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-mesh.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Vec3 __sc_mesh_transformPoint(const saci_Mat4* model, saci_Vec3 point);
+saci_MeshState* __sc_mesh_findState(const sc_Renderer* renderer, saci_u64 serial);
+saci_MeshState* __sc_mesh_state(sc_Renderer* renderer, const sc_Mesh* mesh);
+void __sc_mesh_rehashStates(sc_Renderer* renderer, saci_u32 capacity, saci_u64 keepSince);
+void __sc_mesh_freeState(saci_MeshState* state);
+saci_MeshInstance* __sc_mesh_instance(saci_MeshState* state, saci_u32 instance, saci_Bool issueGL);
+float __sc_mesh_projectedSize(const sc_Mesh* mesh, const saci_Mat4* model, const saci_RenderFrame* frame,
+                              const sc_RenderConfig* config);
+saci_u32 __sc_mesh_selectLOD(const sc_Mesh* mesh, saci_u32 current, float screenSize, float hysteresis);
+saci_Bool __sc_mesh_cameraInsideBounds(const sc_Mesh* mesh, const saci_Mat4* model, const sc_Camera* camera);
+void __sc_mesh_initBoundsCube(sc_Renderer* renderer);
+saci_Bool __sc_mesh_occlusionActive(const sc_Renderer* renderer, const sc_RenderConfig* config);
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// Last serial handed out. Meshes can be created from any render thread
+static atomic_ullong sc_meshSerial;
+
+// Unit cube, scaled and moved onto a mesh's bounds for its occlusion query
+static const saci_Vec3 sc_boundsCubeCorners[8] = {
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+    {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1},
+};
+
+static const saci_u32 sc_boundsCubeIndices[36] = {
+    0, 1, 2, 0, 2, 3, // -z
+    4, 6, 5, 4, 7, 6, // +z
+    0, 4, 5, 0, 5, 1, // -y
+    3, 2, 6, 3, 6, 7, // +y
+    0, 3, 7, 0, 7, 4, // -x
+    1, 5, 6, 1, 6, 2, // +x
+};
+
+//----------------------------------------------------------------------------//
+// Mesh Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_Mesh* sc_CreateMesh(const saci_Vec3* positions, const saci_Color* colors, const saci_Vec2* texCoords,
+                       saci_u32 vertexCount, const saci_u32* indices, saci_u32 indexCount,
+                       saci_TextureID textureID) {
+    if (!positions || vertexCount == 0 || !indices || indexCount == 0 || indexCount % 3 != 0) {
+        fprintf(stderr, "Invalid mesh data.\n");
+        return NULL;
+    }
+    for (saci_u32 i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            fprintf(stderr, "Mesh index %u out of range.\n", indices[i]);
+            return NULL;
+        }
+    }
+
+    sc_Mesh* mesh = (sc_Mesh*)calloc(1, sizeof(sc_Mesh));
+    assert(mesh);
+    mesh->vertices = (saci_Vertice*)malloc(vertexCount * sizeof(saci_Vertice));
+    mesh->indices = (saci_u32*)malloc(indexCount * sizeof(saci_u32));
+    assert(mesh->vertices && mesh->indices);
+    mesh->vertexCount = vertexCount;
+    mesh->indexCount = indexCount;
+    mesh->textureID = textureID;
+    mesh->occlusionTested = SACI_TRUE;
+    mesh->serial = atomic_fetch_add(&sc_meshSerial, 1) + 1;
+    memcpy(mesh->indices, indices, indexCount * sizeof(saci_u32));
+
+    mesh->boundsMin = mesh->boundsMax = positions[0];
+    for (saci_u32 i = 0; i < vertexCount; ++i) {
+        saci_Vertice* vertice = &mesh->vertices[i];
+        vertice->pos = positions[i];
+        vertice->color = colors ? saci_ColorU8FromColor(colors[i]) : (saci_ColorU8){255, 255, 255, 255};
+        vertice->texCoord = texCoords ? texCoords[i] : (saci_Vec2){0, 0};
+
+        if (positions[i].x < mesh->boundsMin.x) mesh->boundsMin.x = positions[i].x;
+        if (positions[i].y < mesh->boundsMin.y) mesh->boundsMin.y = positions[i].y;
+        if (positions[i].z < mesh->boundsMin.z) mesh->boundsMin.z = positions[i].z;
+        if (positions[i].x > mesh->boundsMax.x) mesh->boundsMax.x = positions[i].x;
+        if (positions[i].y > mesh->boundsMax.y) mesh->boundsMax.y = positions[i].y;
+        if (positions[i].z > mesh->boundsMax.z) mesh->boundsMax.z = positions[i].z;
+    }
+    mesh->boundsCenter = saci_MultiplyVec3(saci_AddVec3(mesh->boundsMin, mesh->boundsMax), 0.5f);
+    saci_Vec3 halfExtent = saci_SubtractVec3(mesh->boundsMax, mesh->boundsCenter);
+    mesh->boundsRadius = sqrtf(saci_DotVec3(halfExtent, halfExtent));
+
+    if (!__sc_isGLLoaded()) return mesh;
+
+    glGenVertexArrays(1, &mesh->vao);
+    glBindVertexArray(mesh->vao);
+
+    glGenBuffers(1, &mesh->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(saci_Vertice), mesh->vertices, GL_STATIC_DRAW);
+    __sc_setVertexLayout();
+
+    glGenBuffers(1, &mesh->ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(saci_u32), mesh->indices, GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return mesh;
+}
+
+void sc_DeleteMesh(sc_Mesh* mesh) {
+    if (!mesh) return;
+    if (mesh->vao) {
+        glDeleteVertexArrays(1, &mesh->vao);
+        glDeleteBuffers(1, &mesh->vbo);
+        glDeleteBuffers(1, &mesh->ibo);
+    }
+    // Renderers drop their state for it once their table fills up
+    free(mesh->lods);
+    free(mesh->vertices);
+    free(mesh->indices);
+    free(mesh);
+}
+
+void sc_MeshGetBounds(const sc_Mesh* mesh, saci_Vec3* min, saci_Vec3* max) {
+    if (min) *min = mesh->boundsMin;
+    if (max) *max = mesh->boundsMax;
+}
+
+//----------------------------------------------------------------------------//
+// Mesh Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderPushMesh(sc_Renderer* renderer, sc_Mesh* mesh, const saci_Mat4* model) {
+    if (!mesh) return;
+    saci_Mat4 identity = saci_IdentityMat4();
+    if (!model) model = &identity;
+
+    saci_MeshState* state = __sc_mesh_state(renderer, mesh);
+    if (!state) return;
+    if (state->lastUsed != renderer->frameIndex) {
+        state->lastUsed = renderer->frameIndex;
+        state->instanceCount = 0;
+    }
+    if (state->lodGeneration != mesh->lodGeneration) {
+        // A new LOD set, every instance starts over from the most detailed
+        for (saci_u32 i = 0; i < state->instanceStateCount; ++i) {
+            state->instances[i].lod = 0;
+        }
+        state->lodGeneration = mesh->lodGeneration;
+    }
+    // Grown here so the submits never move the instances under a draw
+    if (!__sc_mesh_instance(state, state->instanceCount, SACI_FALSE)) return;
+
+    if (renderer->meshDrawCount == renderer->meshDrawCapacity) {
+        saci_u32 newCapacity = renderer->meshDrawCapacity ? renderer->meshDrawCapacity * 2 : 64;
+        saci_MeshDraw* draws = (saci_MeshDraw*)realloc(renderer->meshDraws, newCapacity * sizeof(saci_MeshDraw));
+        if (!draws) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        renderer->meshDraws = draws;
+        renderer->meshDrawCapacity = newCapacity;
+    }
+    saci_MeshDraw* draw = &renderer->meshDraws[renderer->meshDrawCount++];
+    draw->mesh = mesh;
+    draw->state = state;
+    draw->model = *model;
+    draw->instance = state->instanceCount++;
+    draw->firstIndex = 0;
+    draw->indexCount = mesh->indexCount;
+}
+
+//----------------------------------------------------------------------------//
+// Level of detail
+//----------------------------------------------------------------------------//
+
+saci_Bool sc_MeshSetLODs(sc_Mesh* mesh, const sc_MeshLOD* lods, saci_u32 count) {
+    for (saci_u32 i = 0; i < count; ++i) {
+        if (lods[i].indexCount == 0 || lods[i].indexCount % 3 != 0 ||
+            lods[i].firstIndex > mesh->indexCount || lods[i].indexCount > mesh->indexCount - lods[i].firstIndex) {
+            fprintf(stderr, "Invalid LOD %u.\n", i);
+            return SACI_FALSE;
+        }
+    }
+
+    free(mesh->lods);
+    mesh->lods = NULL;
+    mesh->lodCount = 0;
+    mesh->lodGeneration++;
+    if (count == 0) return SACI_TRUE;
+
+    mesh->lods = (sc_MeshLOD*)malloc(count * sizeof(sc_MeshLOD));
+    assert(mesh->lods);
+    memcpy(mesh->lods, lods, count * sizeof(sc_MeshLOD));
+    mesh->lodCount = count;
+    return SACI_TRUE;
+}
+
+void sc_RenderSetLODHysteresis(sc_Renderer* renderer, float hysteresis) {
+    if (hysteresis < 0.0f) hysteresis = 0.0f;
+    if (hysteresis > 0.9f) hysteresis = 0.9f;
+    renderer->lodHysteresis = hysteresis;
+}
+
+saci_u32 sc_RenderGetMeshLOD(const sc_Renderer* renderer, const sc_Mesh* mesh, saci_u32 instance) {
+    const saci_MeshState* state = __sc_mesh_findState(renderer, mesh->serial);
+    if (!state || instance >= state->instanceStateCount || state->lodGeneration != mesh->lodGeneration) return 0;
+    return state->instances[instance].lod;
+}
+
+//----------------------------------------------------------------------------//
+// Occlusion culling
+//----------------------------------------------------------------------------//
+
+void sc_RenderSetOcclusionCulling(sc_Renderer* renderer, saci_Bool enabled) {
+    renderer->occlusionCulling = enabled;
+}
+
+void sc_MeshSetOcclusionTested(sc_Mesh* mesh, saci_Bool tested) {
+    mesh->occlusionTested = tested;
+}
+
+saci_Bool sc_RenderIsMeshVisible(const sc_Renderer* renderer, const sc_Mesh* mesh, saci_u32 instance) {
+    const saci_MeshState* state = __sc_mesh_findState(renderer, mesh->serial);
+    if (!state || instance >= state->instanceStateCount) return SACI_TRUE;
+    return state->instances[instance].visible;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_mesh_prepareDraws(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    const saci_RenderFrame* frame = &renderer->frame;
+    saci_Bool canProject = frame->hasCamera && frame->cameraValid;
+
+    for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+        saci_MeshDraw* draw = &renderer->meshDraws[i];
+        sc_Mesh* mesh = draw->mesh;
+        if (mesh->lodCount == 0) continue;
+
+        saci_MeshInstance* state = __sc_mesh_instance(draw->state, draw->instance, SACI_FALSE);
+        saci_u32 lod = 0;
+        if (canProject && state) {
+            float screenSize = __sc_mesh_projectedSize(mesh, &draw->model, frame, config);
+            lod = __sc_mesh_selectLOD(mesh, state->lod, screenSize, renderer->lodHysteresis);
+        }
+        if (state) state->lod = lod;
+
+        draw->firstIndex = mesh->lods[lod].firstIndex;
+        draw->indexCount = mesh->lods[lod].indexCount;
+        if (draw->indexCount < mesh->indexCount) {
+            renderer->frameStats.lodTrianglesSaved += (mesh->indexCount - draw->indexCount) / 3;
+        }
+    }
+
+    // The rasterizer only knows batches, give it world space triangles
+    if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) {
+        for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+            __sc_mesh_pushTriangles(renderer, &renderer->meshDraws[i]);
+        }
+    }
+}
+
+void __sc_mesh_submitDraws(sc_Renderer* renderer, const sc_RenderConfig* config, saci_RenderPass pass) {
+    if (renderer->meshDrawCount == 0) return;
+
+    // Same split as __sc_submitBatch, the null backend only counts
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    saci_Bool shade = pass == SACI_RENDER_PASS_SHADE;
+    sc_RenderStats* stats = &renderer->frameStats;
+    saci_Bool occlusion = __sc_mesh_occlusionActive(renderer, config);
+
+    if (issueGL) {
+        glUseProgram(renderer->shaderProgram);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // Pick up whatever results arrived since last frame, never waiting
+    if (occlusion && issueGL) {
+        for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+            saci_MeshDraw* draw = &renderer->meshDraws[i];
+            if (!draw->mesh->occlusionTested) continue;
+            saci_MeshInstance* state = __sc_mesh_instance(draw->state, draw->instance, issueGL);
+            if (!state || !state->pending) continue;
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(state->query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+            GLuint anySamples = 0;
+            glGetQueryObjectuiv(state->query, GL_QUERY_RESULT, &anySamples);
+            state->visible = anySamples != 0;
+            state->pending = SACI_FALSE;
+        }
+    }
+
+    int useTexture = -1;
+    // Consecutive draws of one mesh share its buffers and texture
+    const sc_Mesh* boundMesh = NULL;
+    for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+        saci_MeshDraw* draw = &renderer->meshDraws[i];
+        sc_Mesh* mesh = draw->mesh;
+
+        saci_MeshInstance* state = NULL;
+        if (occlusion && mesh->occlusionTested) {
+            state = __sc_mesh_instance(draw->state, draw->instance, issueGL);
+        }
+        if (state && !state->pending && !state->visible) {
+            if (shade) stats->occludedDraws++;
+            continue;
+        }
+        // A query still in flight, the GPU drops the draw if it turns out hidden
+        saci_Bool conditional = state && state->pending;
+        saci_Bool rebind = mesh != boundMesh;
+        boundMesh = mesh;
+
+        if (issueGL) {
+            if (shade && useTexture != (mesh->textureID != 0)) {
+                useTexture = mesh->textureID != 0;
+                glUniform1i(renderer->useTextureLoc, useTexture);
+            }
+            if (rebind) {
+                if (shade && mesh->textureID != 0) glBindTexture(GL_TEXTURE_2D, mesh->textureID);
+                glBindVertexArray(mesh->vao);
+            }
+            glUniformMatrix4fv(renderer->modelLoc, 1, GL_FALSE, &draw->model.m[0][0]);
+
+            if (conditional) glBeginConditionalRender(state->query, GL_QUERY_NO_WAIT);
+            glDrawElements(GL_TRIANGLES, (GLsizei)draw->indexCount, GL_UNSIGNED_INT,
+                           (void*)(draw->firstIndex * sizeof(saci_u32)));
+            if (conditional) glEndConditionalRender();
+        }
+        if (!shade) {
+            stats->depthPrePassDrawCalls++;
+            continue;
+        }
+        if (rebind && mesh->textureID != 0) stats->textureBinds++;
+        stats->drawCalls++;
+        stats->vertices += draw->indexCount;
+        stats->triangles += draw->indexCount / 3;
+    }
+
+    if (issueGL) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+}
+
+void __sc_mesh_submitQueries(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    if (renderer->meshDrawCount == 0) return;
+    if (!__sc_mesh_occlusionActive(renderer, config)) return;
+
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    sc_RenderStats* stats = &renderer->frameStats;
+    const saci_RenderFrame* frame = &renderer->frame;
+
+    // Query every tested box against the finished depth buffer. Color and
+    // depth writes are off, only the depth test runs. A mesh filling its box
+    // wrote the box's own depth, LEQUAL keeps it from hiding itself
+    if (issueGL) {
+        glUseProgram(renderer->shaderProgram);
+        __sc_mesh_initBoundsCube(renderer);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        glBindVertexArray(renderer->boundsVao);
+    }
+
+    for (saci_u32 i = 0; i < renderer->meshDrawCount; ++i) {
+        saci_MeshDraw* draw = &renderer->meshDraws[i];
+        sc_Mesh* mesh = draw->mesh;
+        if (!mesh->occlusionTested) continue;
+        saci_MeshInstance* state = __sc_mesh_instance(draw->state, draw->instance, issueGL);
+        if (!state) continue;
+
+        // The near plane would cut the box open and hide it from its own query
+        if (__sc_mesh_cameraInsideBounds(mesh, &draw->model, &frame->camera)) {
+            state->visible = SACI_TRUE;
+            continue;
+        }
+        // Slow GPU, keep waiting for the last one instead of restarting it
+        if (state->pending) continue;
+
+        stats->occlusionQueries++;
+        if (!issueGL) continue;
+
+        saci_Vec3 size = saci_SubtractVec3(mesh->boundsMax, mesh->boundsMin);
+        saci_Mat4 box = saci_IdentityMat4();
+        box.m[0][0] = size.x;
+        box.m[1][1] = size.y;
+        box.m[2][2] = size.z;
+        box.m[3][0] = mesh->boundsMin.x;
+        box.m[3][1] = mesh->boundsMin.y;
+        box.m[3][2] = mesh->boundsMin.z;
+        // Column major, model applied after the box
+        saci_Mat4 boxModel = saci_MultiplyMat4(box, draw->model);
+        glUniformMatrix4fv(renderer->modelLoc, 1, GL_FALSE, &boxModel.m[0][0]);
+
+        glBeginQuery(GL_ANY_SAMPLES_PASSED, state->query);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, (void*)0);
+        glEndQuery(GL_ANY_SAMPLES_PASSED);
+        state->pending = SACI_TRUE;
+    }
+
+    if (issueGL) {
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glDepthFunc(GL_LESS);
+    }
+
+    if (issueGL) {
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+}
+
+saci_Bool __sc_mesh_occlusionActive(const sc_Renderer* renderer, const sc_RenderConfig* config) {
+    // Boxes need a depth buffer to be tested against and a camera to be placed
+    const saci_RenderFrame* frame = &renderer->frame;
+    return renderer->occlusionCulling && config->useZBuffer && frame->hasCamera && frame->cameraValid;
+}
+
+void __sc_mesh_deleteRendererObjects(sc_Renderer* renderer) {
+    for (saci_u32 i = 0; i < renderer->meshStateCapacity; ++i) {
+        __sc_mesh_freeState(renderer->meshStates[i]);
+    }
+    free(renderer->meshStates);
+    renderer->meshStates = NULL;
+    renderer->meshStateCount = renderer->meshStateCapacity = 0;
+
+    if (!renderer->boundsVao) return;
+    glDeleteVertexArrays(1, &renderer->boundsVao);
+    glDeleteBuffers(1, &renderer->boundsVbo);
+    glDeleteBuffers(1, &renderer->boundsIbo);
+    renderer->boundsVao = renderer->boundsVbo = renderer->boundsIbo = 0;
+}
+
+saci_Vec3 __sc_mesh_transformPoint(const saci_Mat4* model, saci_Vec3 point) {
+    const float (*m)[4] = model->m;
+    return (saci_Vec3){
+        m[0][0] * point.x + m[1][0] * point.y + m[2][0] * point.z + m[3][0],
+        m[0][1] * point.x + m[1][1] * point.y + m[2][1] * point.z + m[3][1],
+        m[0][2] * point.x + m[1][2] * point.y + m[2][2] * point.z + m[3][2],
+    };
+}
+
+saci_MeshState* __sc_mesh_findState(const sc_Renderer* renderer, saci_u64 serial) {
+    if (!renderer->meshStates) return NULL;
+    saci_u32 mask = renderer->meshStateCapacity - 1;
+    saci_u32 slot = saci_HashFNV1a(&serial, sizeof(serial), SACI_FNV1A_SEED) & mask;
+    for (; renderer->meshStates[slot]; slot = (slot + 1) & mask) {
+        if (renderer->meshStates[slot]->serial == serial) return renderer->meshStates[slot];
+    }
+    return NULL;
+}
+
+saci_MeshState* __sc_mesh_state(sc_Renderer* renderer, const sc_Mesh* mesh) {
+    saci_MeshState* state = __sc_mesh_findState(renderer, mesh->serial);
+    if (state) return state;
+
+    if (!renderer->meshStates) {
+        renderer->meshStates = (saci_MeshState**)calloc(64, sizeof(saci_MeshState*));
+        assert(renderer->meshStates);
+        renderer->meshStateCapacity = 64;
+    }
+    if ((renderer->meshStateCount + 1) * 4 > renderer->meshStateCapacity * 3) {
+        // Drop the meshes pushed neither this frame nor the last one, the
+        // last one's queries are still read back. Grow if that isn't enough
+        __sc_mesh_rehashStates(renderer, renderer->meshStateCapacity,
+                               renderer->frameIndex ? renderer->frameIndex - 1 : 0);
+        if ((renderer->meshStateCount + 1) * 2 > renderer->meshStateCapacity) {
+            __sc_mesh_rehashStates(renderer, renderer->meshStateCapacity * 2, 0);
+        }
+    }
+
+    state = (saci_MeshState*)calloc(1, sizeof(saci_MeshState));
+    if (!state) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return NULL;
+    }
+    state->serial = mesh->serial;
+    state->lastUsed = renderer->frameIndex;
+    state->lodGeneration = mesh->lodGeneration;
+
+    saci_u32 mask = renderer->meshStateCapacity - 1;
+    saci_u32 slot = saci_HashFNV1a(&state->serial, sizeof(state->serial), SACI_FNV1A_SEED) & mask;
+    while (renderer->meshStates[slot]) slot = (slot + 1) & mask;
+    renderer->meshStates[slot] = state;
+    renderer->meshStateCount++;
+    return state;
+}
+
+void __sc_mesh_rehashStates(sc_Renderer* renderer, saci_u32 capacity, saci_u64 keepSince) {
+    saci_MeshState** states = (saci_MeshState**)calloc(capacity, sizeof(saci_MeshState*));
+    if (!states) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    saci_u32 count = 0;
+    for (saci_u32 i = 0; i < renderer->meshStateCapacity; ++i) {
+        saci_MeshState* state = renderer->meshStates[i];
+        if (!state) continue;
+        if (state->lastUsed < keepSince) {
+            __sc_mesh_freeState(state);
+            continue;
+        }
+        saci_u32 slot = saci_HashFNV1a(&state->serial, sizeof(state->serial), SACI_FNV1A_SEED) & (capacity - 1);
+        while (states[slot]) slot = (slot + 1) & (capacity - 1);
+        states[slot] = state;
+        count++;
+    }
+    free(renderer->meshStates);
+    renderer->meshStates = states;
+    renderer->meshStateCapacity = capacity;
+    renderer->meshStateCount = count;
+}
+
+void __sc_mesh_freeState(saci_MeshState* state) {
+    if (!state) return;
+    // Queries were only generated with the renderer's GL context, current here
+    for (saci_u32 i = 0; i < state->instanceStateCount; ++i) {
+        if (state->instances[i].query) glDeleteQueries(1, &state->instances[i].query);
+    }
+    free(state->instances);
+    free(state);
+}
+
+saci_MeshInstance* __sc_mesh_instance(saci_MeshState* state, saci_u32 instance, saci_Bool issueGL) {
+    if (instance >= state->instanceStateCount) {
+        saci_MeshInstance* instances =
+            (saci_MeshInstance*)realloc(state->instances, (instance + 1) * sizeof(saci_MeshInstance));
+        if (!instances) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        for (saci_u32 i = state->instanceStateCount; i <= instance; ++i) {
+            instances[i].query = 0;
+            instances[i].pending = SACI_FALSE;
+            instances[i].visible = SACI_TRUE;
+            instances[i].lod = 0;
+        }
+        state->instances = instances;
+        state->instanceStateCount = instance + 1;
+    }
+    saci_MeshInstance* entry = &state->instances[instance];
+    if (issueGL && entry->query == 0) glGenQueries(1, &entry->query);
+    return entry;
+}
+
+saci_Bool __sc_mesh_cameraInsideBounds(const sc_Mesh* mesh, const saci_Mat4* model, const sc_Camera* camera) {
+    saci_Vec3 min = __sc_mesh_transformPoint(model, mesh->boundsMin);
+    saci_Vec3 max = min;
+    for (int corner = 1; corner < 8; ++corner) {
+        saci_Vec3 point = {
+            (corner & 1) ? mesh->boundsMax.x : mesh->boundsMin.x,
+            (corner & 2) ? mesh->boundsMax.y : mesh->boundsMin.y,
+            (corner & 4) ? mesh->boundsMax.z : mesh->boundsMin.z,
+        };
+        point = __sc_mesh_transformPoint(model, point);
+        if (point.x < min.x) min.x = point.x;
+        if (point.y < min.y) min.y = point.y;
+        if (point.z < min.z) min.z = point.z;
+        if (point.x > max.x) max.x = point.x;
+        if (point.y > max.y) max.y = point.y;
+        if (point.z > max.z) max.z = point.z;
+    }
+
+    float margin = camera->near * 2.0f;
+    const saci_Vec3* eye = &camera->position;
+    return eye->x >= min.x - margin && eye->x <= max.x + margin &&
+           eye->y >= min.y - margin && eye->y <= max.y + margin &&
+           eye->z >= min.z - margin && eye->z <= max.z + margin;
+}
+
+void __sc_mesh_initBoundsCube(sc_Renderer* renderer) {
+    if (renderer->boundsVao) return;
+
+    saci_Vertice corners[8];
+    for (int corner = 0; corner < 8; ++corner) {
+        corners[corner] = (saci_Vertice){sc_boundsCubeCorners[corner], {255, 255, 255, 255}, {0, 0}};
+    }
+
+    glGenVertexArrays(1, &renderer->boundsVao);
+    glBindVertexArray(renderer->boundsVao);
+
+    glGenBuffers(1, &renderer->boundsVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->boundsVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    __sc_setVertexLayout();
+
+    glGenBuffers(1, &renderer->boundsIbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer->boundsIbo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(sc_boundsCubeIndices), sc_boundsCubeIndices, GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+float __sc_mesh_projectedSize(const sc_Mesh* mesh, const saci_Mat4* model, const saci_RenderFrame* frame,
+                              const sc_RenderConfig* config) {
+    // The largest axis scale keeps the sphere around the scaled mesh
+    float scale = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        const float* column = model->m[axis];
+        float length = sqrtf(column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+        if (length > scale) scale = length;
+    }
+    float radius = mesh->boundsRadius * scale;
+
+    // Orthographic views span 2 units whatever the distance
+    if (config->projectionMode == SACI_RENDER_ORTHOGRAPHIC_PROJECTION) {
+        return radius;
+    }
+
+    saci_Vec3 center = __sc_mesh_transformPoint(model, mesh->boundsCenter);
+    saci_Vec3 toCenter = saci_SubtractVec3(center, frame->camera.position);
+    float distance = sqrtf(saci_DotVec3(toCenter, toCenter));
+    if (distance <= radius) return 1.0f;
+
+    // Diameter over the height of the view at that distance
+    float tanHalfFov = tanf(SACI_DEG2RAD(frame->camera.fov) * 0.5f);
+    if (tanHalfFov <= 0.0f) return 1.0f;
+    return radius / (distance * tanHalfFov);
+}
+
+saci_u32 __sc_mesh_selectLOD(const sc_Mesh* mesh, saci_u32 current, float screenSize, float hysteresis) {
+    saci_u32 lod = current < mesh->lodCount ? current : mesh->lodCount - 1;
+    // Coarser once clearly below this LOD's threshold, finer once clearly
+    // above the next detailed one's
+    while (lod + 1 < mesh->lodCount && screenSize < mesh->lods[lod].minScreenSize * (1.0f - hysteresis)) {
+        lod++;
+    }
+    while (lod > 0 && screenSize >= mesh->lods[lod - 1].minScreenSize * (1.0f + hysteresis)) {
+        lod--;
+    }
+    return lod;
+}
+
+void __sc_mesh_pushTriangles(sc_Renderer* renderer, const saci_MeshDraw* draw) {
+    const sc_Mesh* mesh = draw->mesh;
+    const saci_u32* indices = mesh->indices + draw->firstIndex;
+    saci_u32 count = draw->indexCount - draw->indexCount % 3;
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, mesh->textureID, count);
+    if (!vertices) return;
+    for (saci_u32 i = 0; i < count; ++i) {
+        vertices[i] = mesh->vertices[indices[i]];
+        vertices[i].pos = __sc_mesh_transformPoint(&draw->model, vertices[i].pos);
+    }
+}
@@ -0,0 +1,564 @@
+#include "saci-core/sc-readback.h"
+
+#include "saci-utils/su-types.h"
+
+#include <glad/glad.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_READBACK_DEFAULT_RING 3
+#define SACI_FRAME_WRITER_DEFAULT_QUEUE 8
+
+// Largest payload of a stored (uncompressed) deflate block
+#define SACI_DEFLATE_STORED_MAX 65535
+
+typedef struct saci_ReadbackSlot {
+    saci_u32 pbo;
+    size_t capacity;
+    GLsync fence;
+
+    int width, height;
+    saci_u64 frameIndex;
+    sc_ReadbackCallback callback;
+    void* userData;
+} saci_ReadbackSlot;
+
+struct sc_Readback {
+    saci_ReadbackSlot* slots;
+    saci_u32 slotCount;
+    saci_u32 oldest;   // next slot to be delivered
+    saci_u32 inFlight; // queued, not delivered yet
+    saci_u64 nextFrameIndex;
+
+    saci_Bool synchronous; // no fences before GL 3.2, reads happen in place
+    saci_u8* syncPixels;
+    size_t syncCapacity;
+};
+
+typedef struct saci_WriterFrame {
+    saci_u8* rgba; // top to bottom
+    size_t capacity;
+    int width, height;
+    saci_u64 number;
+} saci_WriterFrame;
+
+struct sc_FrameWriter {
+    sc_FrameWriterFormat format;
+    char* path;
+    FILE* stream; // RAW and Y4M
+    saci_u32 fps;
+    int width, height; // of the stream, set by the first frame
+
+    saci_WriterFrame* queue;
+    saci_u32 queueCapacity;
+    saci_u32 head;
+    saci_u32 count;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t workAvailable;
+    saci_Bool shutdown;
+
+    saci_u64 submitted;
+    saci_u64 written;
+    saci_u64 dropped;
+
+    // Only touched by the writer thread
+    saci_u8* scratch;
+    size_t scratchCapacity;
+};
+
+static saci_u32 sc_crcTable[256];
+static pthread_once_t sc_crcTableOnce = PTHREAD_ONCE_INIT;
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __sc_readback_deliverOldest(sc_Readback* readback, saci_Bool wait);
+
+void* __sc_frameWriter_thread(void* args);
+void __sc_frameWriter_encode(sc_FrameWriter* writer, const saci_WriterFrame* frame);
+saci_u8* __sc_frameWriter_scratch(sc_FrameWriter* writer, size_t size);
+void __sc_frameWriter_writePNG(sc_FrameWriter* writer, const saci_WriterFrame* frame);
+void __sc_frameWriter_writeY4M(sc_FrameWriter* writer, const saci_WriterFrame* frame);
+
+void __sc_png_initCRCTable(void);
+saci_u32 __sc_png_crc(saci_u32 crc, const saci_u8* data, size_t size);
+void __sc_png_writeChunk(FILE* file, const char* type, const saci_u8* data, size_t size);
+void __sc_png_putU32(saci_u8* out, saci_u32 value);
+
+//----------------------------------------------------------------------------//
+// Asynchronous readback
+//----------------------------------------------------------------------------//
+
+sc_Readback* sc_CreateReadback(saci_u32 ringSize) {
+    if (ringSize == 0) ringSize = SACI_READBACK_DEFAULT_RING;
+
+    sc_Readback* readback = (sc_Readback*)calloc(1, sizeof(sc_Readback));
+    assert(readback);
+    readback->synchronous = !GLAD_GL_VERSION_3_2;
+    if (readback->synchronous) return readback;
+
+    readback->slots = (saci_ReadbackSlot*)calloc(ringSize, sizeof(saci_ReadbackSlot));
+    assert(readback->slots);
+    readback->slotCount = ringSize;
+    for (saci_u32 i = 0; i < ringSize; ++i) {
+        glGenBuffers(1, &readback->slots[i].pbo);
+    }
+    return readback;
+}
+
+void sc_DeleteReadback(sc_Readback* readback) {
+    if (!readback) return;
+    sc_ReadbackPoll(readback, SACI_TRUE);
+    for (saci_u32 i = 0; i < readback->slotCount; ++i) {
+        glDeleteBuffers(1, &readback->slots[i].pbo);
+    }
+    free(readback->slots);
+    free(readback->syncPixels);
+    free(readback);
+}
+
+void sc_ReadPixelsAsync(sc_Readback* readback, saci_u32 fbo, int x, int y, int width, int height,
+                        sc_ReadbackCallback callback, void* userData) {
+    if (width <= 0 || height <= 0 || !callback) return;
+    size_t size = (size_t)width * height * 4;
+
+    GLint previousReadFramebuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+
+    if (readback->synchronous) {
+        if (size > readback->syncCapacity) {
+            saci_u8* pixels = (saci_u8*)realloc(readback->syncPixels, size);
+            if (!pixels) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+                return;
+            }
+            readback->syncPixels = pixels;
+            readback->syncCapacity = size;
+        }
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, readback->syncPixels);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+        callback(readback->syncPixels, width, height, readback->nextFrameIndex++, userData);
+        return;
+    }
+
+    sc_ReadbackPoll(readback, SACI_FALSE);
+    // Every buffer is still in flight, the oldest one is the closest to done
+    if (readback->inFlight == readback->slotCount) {
+        __sc_readback_deliverOldest(readback, SACI_TRUE);
+    }
+
+    saci_ReadbackSlot* slot = &readback->slots[(readback->oldest + readback->inFlight) % readback->slotCount];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (size > slot->capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+    // With a pack buffer bound the pointer is an offset, the copy stays on the GPU
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+
+    slot->width = width;
+    slot->height = height;
+    slot->frameIndex = readback->nextFrameIndex++;
+    slot->callback = callback;
+    slot->userData = userData;
+    readback->inFlight++;
+}
+
+void sc_ReadbackPoll(sc_Readback* readback, saci_Bool waitAll) {
+    // Frames are delivered in order, a pending one holds back the rest
+    while (readback->inFlight > 0 && __sc_readback_deliverOldest(readback, waitAll)) {
+    }
+}
+
+//----------------------------------------------------------------------------//
+// Frame writer
+//----------------------------------------------------------------------------//
+
+sc_FrameWriter* sc_CreateFrameWriter(const char* path, sc_FrameWriterFormat format,
+                                     saci_u32 fps, saci_u32 maxQueuedFrames) {
+    if (maxQueuedFrames == 0) maxQueuedFrames = SACI_FRAME_WRITER_DEFAULT_QUEUE;
+    if (fps == 0) fps = 60;
+
+    FILE* stream = NULL;
+    if (format != SACI_FRAME_WRITER_PNG) {
+        stream = fopen(path, "wb");
+        if (!stream) {
+            fprintf(stderr, "Failed to open %s for writing\n", path);
+            return NULL;
+        }
+    }
+    pthread_once(&sc_crcTableOnce, __sc_png_initCRCTable);
+
+    sc_FrameWriter* writer = (sc_FrameWriter*)calloc(1, sizeof(sc_FrameWriter));
+    assert(writer);
+    writer->format = format;
+    writer->path = strdup(path);
+    writer->stream = stream;
+    writer->fps = fps;
+    writer->queue = (saci_WriterFrame*)calloc(maxQueuedFrames, sizeof(saci_WriterFrame));
+    assert(writer->path && writer->queue);
+    writer->queueCapacity = maxQueuedFrames;
+
+    pthread_mutex_init(&writer->mutex, NULL);
+    pthread_cond_init(&writer->workAvailable, NULL);
+    if (pthread_create(&writer->thread, NULL, __sc_frameWriter_thread, writer) != 0) {
+        fprintf(stderr, "Failed to start the frame writer thread\n");
+        pthread_cond_destroy(&writer->workAvailable);
+        pthread_mutex_destroy(&writer->mutex);
+        if (stream) fclose(stream);
+        free(writer->queue);
+        free(writer->path);
+        free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+void sc_DeleteFrameWriter(sc_FrameWriter* writer) {
+    if (!writer) return;
+
+    pthread_mutex_lock(&writer->mutex);
+    writer->shutdown = SACI_TRUE;
+    pthread_cond_signal(&writer->workAvailable);
+    pthread_mutex_unlock(&writer->mutex);
+    pthread_join(writer->thread, NULL);
+
+    if (writer->stream) fclose(writer->stream);
+    for (saci_u32 i = 0; i < writer->queueCapacity; ++i) {
+        free(writer->queue[i].rgba);
+    }
+    pthread_cond_destroy(&writer->workAvailable);
+    pthread_mutex_destroy(&writer->mutex);
+    free(writer->scratch);
+    free(writer->queue);
+    free(writer->path);
+    free(writer);
+}
+
+saci_Bool sc_FrameWriterSubmit(sc_FrameWriter* writer, const saci_u8* rgba, int width, int height,
+                               saci_Bool bottomUp) {
+    if (!rgba || width <= 0 || height <= 0) return SACI_FALSE;
+    size_t rowSize = (size_t)width * 4;
+    size_t size = rowSize * height;
+
+    pthread_mutex_lock(&writer->mutex);
+    saci_Bool sizeChanged = writer->format != SACI_FRAME_WRITER_PNG && writer->width != 0 &&
+                            (writer->width != width || writer->height != height);
+    if (writer->count == writer->queueCapacity || sizeChanged) {
+        writer->dropped++;
+        pthread_mutex_unlock(&writer->mutex);
+        return SACI_FALSE;
+    }
+
+    // The writer thread only reads slots counted in count, this one is free
+    saci_WriterFrame* frame = &writer->queue[(writer->head + writer->count) % writer->queueCapacity];
+    if (size > frame->capacity) {
+        saci_u8* pixels = (saci_u8*)realloc(frame->rgba, size);
+        if (!pixels) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            writer->dropped++;
+            pthread_mutex_unlock(&writer->mutex);
+            return SACI_FALSE;
+        }
+        frame->rgba = pixels;
+        frame->capacity = size;
+    }
+    if (bottomUp) {
+        for (int row = 0; row < height; ++row) {
+            memcpy(frame->rgba + row * rowSize, rgba + (size_t)(height - 1 - row) * rowSize, rowSize);
+        }
+    } else {
+        memcpy(frame->rgba, rgba, size);
+    }
+    frame->width = width;
+    frame->height = height;
+    frame->number = writer->submitted++;
+    if (writer->width == 0) {
+        writer->width = width;
+        writer->height = height;
+    }
+
+    writer->count++;
+    pthread_cond_signal(&writer->workAvailable);
+    pthread_mutex_unlock(&writer->mutex);
+    return SACI_TRUE;
+}
+
+void sc_FrameWriterReadbackCallback(const saci_u8* rgba, int width, int height,
+                                    saci_u64 frameIndex, void* writer) {
+    (void)frameIndex;
+    sc_FrameWriterSubmit((sc_FrameWriter*)writer, rgba, width, height, SACI_TRUE);
+}
+
+saci_u64 sc_FrameWriterWrittenFrames(sc_FrameWriter* writer) {
+    pthread_mutex_lock(&writer->mutex);
+    saci_u64 written = writer->written;
+    pthread_mutex_unlock(&writer->mutex);
+    return written;
+}
+
+saci_u64 sc_FrameWriterDroppedFrames(sc_FrameWriter* writer) {
+    pthread_mutex_lock(&writer->mutex);
+    saci_u64 dropped = writer->dropped;
+    pthread_mutex_unlock(&writer->mutex);
+    return dropped;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __sc_readback_deliverOldest(sc_Readback* readback, saci_Bool wait) {
+    saci_ReadbackSlot* slot = &readback->slots[readback->oldest];
+
+    GLenum status;
+    do {
+        // The flush makes sure the fence gets to the GPU, it could never signal otherwise
+        status = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000ull : 0);
+    } while (wait && status == GL_TIMEOUT_EXPIRED);
+    if (status == GL_TIMEOUT_EXPIRED) return SACI_FALSE;
+    // On GL_WAIT_FAILED mapping still works, it just blocks
+
+    glDeleteSync(slot->fence);
+    slot->fence = NULL;
+
+    size_t size = (size_t)slot->width * slot->height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    const saci_u8* pixels = (const saci_u8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_READ_BIT);
+    if (pixels) {
+        slot->callback(pixels, slot->width, slot->height, slot->frameIndex, slot->userData);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        fprintf(stderr, "Failed to map readback buffer for frame %llu\n", (unsigned long long)slot->frameIndex);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback->oldest = (readback->oldest + 1) % readback->slotCount;
+    readback->inFlight--;
+    return SACI_TRUE;
+}
+
+void* __sc_frameWriter_thread(void* args) {
+    sc_FrameWriter* writer = (sc_FrameWriter*)args;
+    for (;;) {
+        pthread_mutex_lock(&writer->mutex);
+        while (writer->count == 0 && !writer->shutdown) {
+            pthread_cond_wait(&writer->workAvailable, &writer->mutex);
+        }
+        if (writer->count == 0) {
+            pthread_mutex_unlock(&writer->mutex);
+            break;
+        }
+        saci_WriterFrame* frame = &writer->queue[writer->head];
+        pthread_mutex_unlock(&writer->mutex);
+
+        __sc_frameWriter_encode(writer, frame);
+
+        pthread_mutex_lock(&writer->mutex);
+        writer->head = (writer->head + 1) % writer->queueCapacity;
+        writer->count--;
+        writer->written++;
+        pthread_mutex_unlock(&writer->mutex);
+    }
+    return NULL;
+}
+
+void __sc_frameWriter_encode(sc_FrameWriter* writer, const saci_WriterFrame* frame) {
+    switch (writer->format) {
+        case SACI_FRAME_WRITER_PNG:
+            __sc_frameWriter_writePNG(writer, frame);
+            break;
+        case SACI_FRAME_WRITER_RAW:
+            fwrite(frame->rgba, 1, (size_t)frame->width * frame->height * 4, writer->stream);
+            break;
+        case SACI_FRAME_WRITER_Y4M:
+            __sc_frameWriter_writeY4M(writer, frame);
+            break;
+    }
+}
+
+saci_u8* __sc_frameWriter_scratch(sc_FrameWriter* writer, size_t size) {
+    if (size > writer->scratchCapacity) {
+        saci_u8* scratch = (saci_u8*)realloc(writer->scratch, size);
+        if (!scratch) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        writer->scratch = scratch;
+        writer->scratchCapacity = size;
+    }
+    return writer->scratch;
+}
+
+// Filter 0 rows in stored deflate blocks. Big files, but the writer thread
+// keeps up with any frame rate and no compression library is needed
+void __sc_frameWriter_writePNG(sc_FrameWriter* writer, const saci_WriterFrame* frame) {
+    char fileName[4096];
+    snprintf(fileName, sizeof(fileName), writer->path, (unsigned)frame->number);
+    FILE* file = fopen(fileName, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s for writing\n", fileName);
+        return;
+    }
+
+    size_t rowSize = (size_t)frame->width * 4;
+    size_t rawSize = (rowSize + 1) * frame->height;
+    size_t blockCount = (rawSize + SACI_DEFLATE_STORED_MAX - 1) / SACI_DEFLATE_STORED_MAX;
+    size_t idatSize = 2 + rawSize + blockCount * 5 + 4;
+    saci_u8* idat = __sc_frameWriter_scratch(writer, idatSize);
+    if (!idat) {
+        fclose(file);
+        return;
+    }
+
+    // zlib header, no compression, 32K window
+    saci_u8* out = idat;
+    *out++ = 0x78;
+    *out++ = 0x01;
+
+    saci_u32 adlerA = 1, adlerB = 0;
+    size_t remaining = rawSize;
+    size_t row = 0, column = 0; // position in the filtered image
+    while (remaining > 0) {
+        saci_u16 blockSize = remaining > SACI_DEFLATE_STORED_MAX ? SACI_DEFLATE_STORED_MAX : (saci_u16)remaining;
+        remaining -= blockSize;
+        *out++ = remaining == 0 ? 1 : 0;
+        *out++ = (saci_u8)(blockSize & 0xFF);
+        *out++ = (saci_u8)(blockSize >> 8);
+        *out++ = (saci_u8)(~blockSize & 0xFF);
+        *out++ = (saci_u8)((saci_u16)~blockSize >> 8);
+
+        for (saci_u16 i = 0; i < blockSize; ++i) {
+            saci_u8 byte = column == 0 ? 0 : frame->rgba[row * rowSize + column - 1];
+            if (++column > rowSize) {
+                column = 0;
+                row++;
+            }
+            *out++ = byte;
+            adlerA += byte;
+            if (adlerA >= 65521) adlerA -= 65521;
+            adlerB += adlerA;
+            if (adlerB >= 65521) adlerB -= 65521;
+        }
+    }
+    __sc_png_putU32(out, (adlerB << 16) | adlerA);
+
+    static const saci_u8 signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    saci_u8 header[13];
+    __sc_png_putU32(header, (saci_u32)frame->width);
+    __sc_png_putU32(header + 4, (saci_u32)frame->height);
+    header[8] = 8;  // bits per channel
+    header[9] = 6;  // RGBA
+    header[10] = 0; // deflate
+    header[11] = 0; // adaptive filtering
+    header[12] = 0; // not interlaced
+
+    fwrite(signature, 1, sizeof(signature), file);
+    __sc_png_writeChunk(file, "IHDR", header, sizeof(header));
+    __sc_png_writeChunk(file, "IDAT", idat, idatSize);
+    __sc_png_writeChunk(file, "IEND", NULL, 0);
+    fclose(file);
+}
+
+// BT.601 limited range, chroma averaged over 2x2 blocks
+void __sc_frameWriter_writeY4M(sc_FrameWriter* writer, const saci_WriterFrame* frame) {
+    int width = frame->width, height = frame->height;
+    int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    size_t lumaSize = (size_t)width * height;
+    size_t chromaSize = (size_t)chromaWidth * chromaHeight;
+    saci_u8* planes = __sc_frameWriter_scratch(writer, lumaSize + chromaSize * 2);
+    if (!planes) return;
+    saci_u8* planeY = planes;
+    saci_u8* planeU = planes + lumaSize;
+    saci_u8* planeV = planeU + chromaSize;
+
+    if (frame->number == 0) {
+        fprintf(writer->stream, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n", width, height, writer->fps);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        const saci_u8* pixel = frame->rgba + (size_t)y * width * 4;
+        for (int x = 0; x < width; ++x, pixel += 4) {
+            int r = pixel[0], g = pixel[1], b = pixel[2];
+            planeY[(size_t)y * width + x] = (saci_u8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+    for (int cy = 0; cy < chromaHeight; ++cy) {
+        for (int cx = 0; cx < chromaWidth; ++cx) {
+            int r = 0, g = 0, b = 0, samples = 0;
+            for (int dy = 0; dy < 2; ++dy) {
+                int y = cy * 2 + dy;
+                if (y >= height) break;
+                for (int dx = 0; dx < 2; ++dx) {
+                    int x = cx * 2 + dx;
+                    if (x >= width) break;
+                    const saci_u8* pixel = frame->rgba + ((size_t)y * width + x) * 4;
+                    r += pixel[0];
+                    g += pixel[1];
+                    b += pixel[2];
+                    samples++;
+                }
+            }
+            r /= samples;
+            g /= samples;
+            b /= samples;
+            planeU[(size_t)cy * chromaWidth + cx] = (saci_u8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            planeV[(size_t)cy * chromaWidth + cx] = (saci_u8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+
+    fputs("FRAME\n", writer->stream);
+    fwrite(planes, 1, lumaSize + chromaSize * 2, writer->stream);
+}
+
+void __sc_png_initCRCTable(void) {
+    for (saci_u32 n = 0; n < 256; ++n) {
+        saci_u32 c = n;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        sc_crcTable[n] = c;
+    }
+}
+
+saci_u32 __sc_png_crc(saci_u32 crc, const saci_u8* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        crc = sc_crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+void __sc_png_writeChunk(FILE* file, const char* type, const saci_u8* data, size_t size) {
+    saci_u8 word[4];
+    __sc_png_putU32(word, (saci_u32)size);
+    fwrite(word, 1, 4, file);
+    fwrite(type, 1, 4, file);
+    if (size > 0) fwrite(data, 1, size, file);
+
+    saci_u32 crc = __sc_png_crc(0xFFFFFFFFu, (const saci_u8*)type, 4);
+    if (size > 0) crc = __sc_png_crc(crc, data, size);
+    __sc_png_putU32(word, crc ^ 0xFFFFFFFFu);
+    fwrite(word, 1, 4, file);
+}
+
+void __sc_png_putU32(saci_u8* out, saci_u32 value) {
+    out[0] = (saci_u8)(value >> 24);
+    out[1] = (saci_u8)(value >> 16);
+    out[2] = (saci_u8)(value >> 8);
+    out[3] = (saci_u8)value;
+}
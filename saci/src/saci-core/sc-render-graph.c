@@ -0,0 +1,764 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-render-graph.h"
+#include "saci-core/sc-render-target.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_RENDER_GRAPH_MAX_COLORS 4
+// Pooled buffers and framebuffers no execute used for this many frames are
+// deleted
+#define SACI_RENDER_GRAPH_POOL_FRAMES 8
+
+typedef enum saci_RenderGraphKind {
+    SACI_RENDER_GRAPH_TEXTURE,
+    SACI_RENDER_GRAPH_BUFFER,
+    SACI_RENDER_GRAPH_BACKBUFFER,
+} saci_RenderGraphKind;
+
+typedef struct saci_RenderGraphResource {
+    const char* name;
+    saci_RenderGraphKind kind;
+    saci_Bool imported;
+    saci_Bool output;
+    sc_RenderGraphFormat format;
+    int width, height;
+    size_t size;
+    saci_u32 glName;            // 0 until allocated for transients
+    sc_RenderTarget* target;    // transient textures, held from first to last use
+    saci_u32 firstUse, lastUse; // execution positions, SACI_RENDER_GRAPH_NONE if no pass that ran uses it
+} saci_RenderGraphResource;
+
+typedef struct saci_RenderGraphAccess {
+    saci_u32 pass, resource;
+    saci_Bool write;
+} saci_RenderGraphAccess;
+
+typedef struct saci_RenderGraphPass {
+    const char* name;
+    sc_RenderPassFunction function;
+    void* userData;
+    saci_Bool clear;
+    saci_Color clearColor;
+    saci_Bool culled;
+} saci_RenderGraphPass;
+
+typedef struct saci_RenderGraphEdge {
+    saci_u32 from, to;
+} saci_RenderGraphEdge;
+
+// Transient buffers, the render target pool only has textures
+typedef struct saci_RenderGraphPoolEntry {
+    size_t size;
+    saci_u32 glName;
+    saci_u64 lastFrame;  // last execute that used it
+    saci_u32 busyUntil; // execution position the transient using it ends at
+} saci_RenderGraphPoolEntry;
+
+// A texture bound as an attachment, serial is the render target's (see
+// __sc_renderTarget_serial) and 0 for imported textures
+typedef struct saci_RenderGraphAttachment {
+    saci_u32 texture;
+    saci_u64 serial;
+} saci_RenderGraphAttachment;
+
+// Passes writing several textures, a single one is drawn through its render
+// target's own framebuffer
+typedef struct saci_RenderGraphFramebuffer {
+    saci_u32 fbo;
+    saci_RenderGraphAttachment colors[SACI_RENDER_GRAPH_MAX_COLORS];
+    saci_u32 colorCount;
+    saci_RenderGraphAttachment depth;
+    saci_Bool hasImported; // attached again on every use, the name may have been reused
+    saci_u64 lastFrame;
+} saci_RenderGraphFramebuffer;
+
+struct sc_RenderGraph {
+    sc_Renderer* renderer; // owns the render target pool transient textures come from
+
+    // Declared for the current frame
+    saci_RenderGraphResource* resources;
+    saci_u32 resourceCount, resourceCapacity;
+    saci_RenderGraphPass* passes;
+    saci_u32 passCount, passCapacity;
+    saci_RenderGraphAccess* accesses;
+    saci_u32 accessCount, accessCapacity;
+
+    // Built by sc_RenderGraphExecute
+    saci_RenderGraphEdge* edges;
+    saci_u32 edgeCount, edgeCapacity;
+    saci_u32* order; // pass indices in execution order, culled ones left out
+    saci_u32 orderCount, orderCapacity;
+    saci_u32* scratch;
+    saci_u32 scratchCapacity;
+
+    // Kept across frames
+    saci_RenderGraphPoolEntry* pool;
+    saci_u32 poolCount, poolCapacity;
+    saci_RenderGraphFramebuffer* framebuffers;
+    saci_u32 framebufferCount, framebufferCapacity;
+    saci_u64 frame;
+    // Targets of outputs, read after execute and released by the next one
+    sc_RenderTarget** held;
+    saci_u32 heldCount, heldCapacity;
+
+    // Of the transient textures alive at once during execute
+    saci_u32 liveTargets;
+    size_t liveBytes;
+
+    sc_RenderGraphStats stats;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_u32 __sc_renderGraph_addResource(sc_RenderGraph* graph, const saci_RenderGraphResource* resource);
+void __sc_renderGraph_access(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource, saci_Bool write);
+void __sc_renderGraph_cull(sc_RenderGraph* graph);
+// Accesses are ordered as the passes were added: a read after the write it
+// sees, a write after the reads and the write before it. Add order otherwise
+saci_Bool __sc_renderGraph_sort(sc_RenderGraph* graph);
+saci_Bool __sc_renderGraph_addEdge(sc_RenderGraph* graph, saci_u32 from, saci_u32 to);
+void __sc_renderGraph_computeLifetimes(sc_RenderGraph* graph);
+// Transient buffers, textures are acquired as the passes run
+void __sc_renderGraph_allocateBuffers(sc_RenderGraph* graph, saci_Bool gl);
+// Render targets for the textures first used at position, and back to the
+// pool for the ones last used there
+void __sc_renderGraph_acquireTargets(sc_RenderGraph* graph, saci_u32 position);
+void __sc_renderGraph_releaseTargets(sc_RenderGraph* graph, saci_u32 position);
+void __sc_renderGraph_releaseHeld(sc_RenderGraph* graph);
+// Binds what the pass writes, or fallback if it writes no texture
+void __sc_renderGraph_bindTargets(sc_RenderGraph* graph, saci_u32 pass, GLint fallback, const GLint* fallbackViewport);
+saci_u32 __sc_renderGraph_framebuffer(sc_RenderGraph* graph, const saci_RenderGraphAttachment* colors,
+                                      saci_u32 colorCount, saci_RenderGraphAttachment depth, saci_Bool hasImported);
+saci_Bool __sc_renderGraph_attachmentEqual(saci_RenderGraphAttachment a, saci_RenderGraphAttachment b);
+void __sc_renderGraph_evict(sc_RenderGraph* graph, saci_Bool gl);
+size_t __sc_renderGraph_textureBytes(const saci_RenderGraphResource* resource);
+
+//----------------------------------------------------------------------------//
+// Render Graph Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_RenderGraph* sc_CreateRenderGraph(sc_Renderer* renderer) {
+    sc_RenderGraph* graph = (sc_RenderGraph*)calloc(1, sizeof(sc_RenderGraph));
+    assert(graph);
+    graph->renderer = renderer;
+    return graph;
+}
+
+void sc_DeleteRenderGraph(sc_RenderGraph* graph) {
+    if (!graph) return;
+    __sc_renderGraph_releaseHeld(graph);
+    if (__sc_isGLLoaded()) {
+        for (saci_u32 i = 0; i < graph->poolCount; ++i) glDeleteBuffers(1, &graph->pool[i].glName);
+        for (saci_u32 i = 0; i < graph->framebufferCount; ++i) glDeleteFramebuffers(1, &graph->framebuffers[i].fbo);
+    }
+    free(graph->resources);
+    free(graph->passes);
+    free(graph->accesses);
+    free(graph->edges);
+    free(graph->order);
+    free(graph->scratch);
+    free(graph->pool);
+    free(graph->framebuffers);
+    free(graph->held);
+    free(graph);
+}
+
+//----------------------------------------------------------------------------//
+// Render Graph Declaration
+//----------------------------------------------------------------------------//
+
+void sc_RenderGraphBegin(sc_RenderGraph* graph) {
+    graph->resourceCount = 0;
+    graph->passCount = 0;
+    graph->accessCount = 0;
+    graph->orderCount = 0;
+}
+
+saci_u32 sc_RenderGraphCreateTexture(sc_RenderGraph* graph, const char* name, int width, int height,
+                                     sc_RenderGraphFormat format) {
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "Invalid render graph texture size.\n");
+        return SACI_RENDER_GRAPH_NONE;
+    }
+    saci_RenderGraphResource resource = {name, SACI_RENDER_GRAPH_TEXTURE, SACI_FALSE, SACI_FALSE, format,
+                                         width, height, 0, 0, NULL, 0, 0};
+    return __sc_renderGraph_addResource(graph, &resource);
+}
+
+saci_u32 sc_RenderGraphCreateBuffer(sc_RenderGraph* graph, const char* name, size_t size) {
+    if (size == 0) {
+        fprintf(stderr, "Invalid render graph buffer size.\n");
+        return SACI_RENDER_GRAPH_NONE;
+    }
+    saci_RenderGraphResource resource = {name, SACI_RENDER_GRAPH_BUFFER, SACI_FALSE, SACI_FALSE, 0,
+                                         0, 0, size, 0, NULL, 0, 0};
+    return __sc_renderGraph_addResource(graph, &resource);
+}
+
+saci_u32 sc_RenderGraphImportTexture(sc_RenderGraph* graph, const char* name, saci_TextureID texture, int width,
+                                     int height, sc_RenderGraphFormat format) {
+    saci_RenderGraphResource resource = {name, SACI_RENDER_GRAPH_TEXTURE, SACI_TRUE, SACI_TRUE, format,
+                                         width, height, 0, texture, NULL, 0, 0};
+    return __sc_renderGraph_addResource(graph, &resource);
+}
+
+saci_u32 sc_RenderGraphImportBuffer(sc_RenderGraph* graph, const char* name, saci_u32 buffer, size_t size) {
+    saci_RenderGraphResource resource = {name, SACI_RENDER_GRAPH_BUFFER, SACI_TRUE, SACI_TRUE, 0,
+                                         0, 0, size, buffer, NULL, 0, 0};
+    return __sc_renderGraph_addResource(graph, &resource);
+}
+
+saci_u32 sc_RenderGraphImportBackbuffer(sc_RenderGraph* graph, int width, int height) {
+    saci_RenderGraphResource resource = {"backbuffer", SACI_RENDER_GRAPH_BACKBUFFER, SACI_TRUE, SACI_TRUE, 0,
+                                         width, height, 0, 0, NULL, 0, 0};
+    return __sc_renderGraph_addResource(graph, &resource);
+}
+
+void sc_RenderGraphMarkOutput(sc_RenderGraph* graph, saci_u32 resource) {
+    if (resource >= graph->resourceCount) return;
+    graph->resources[resource].output = SACI_TRUE;
+}
+
+saci_u32 sc_RenderGraphAddPass(sc_RenderGraph* graph, const char* name, sc_RenderPassFunction function,
+                               void* userData) {
+    if (!saci_Reserve((void**)&graph->passes, &graph->passCapacity, graph->passCount + 1,
+                      sizeof(saci_RenderGraphPass))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_RENDER_GRAPH_NONE;
+    }
+    graph->passes[graph->passCount] = (saci_RenderGraphPass){name, function, userData, SACI_FALSE, {0, 0, 0, 0},
+                                                             SACI_FALSE};
+    return graph->passCount++;
+}
+
+void sc_RenderGraphPassRead(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource) {
+    if (resource < graph->resourceCount && graph->resources[resource].kind == SACI_RENDER_GRAPH_BACKBUFFER) {
+        fprintf(stderr, "The backbuffer can't be read by a render graph pass.\n");
+        return;
+    }
+    __sc_renderGraph_access(graph, pass, resource, SACI_FALSE);
+}
+
+void sc_RenderGraphPassWrite(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource) {
+    __sc_renderGraph_access(graph, pass, resource, SACI_TRUE);
+}
+
+void sc_RenderGraphPassClear(sc_RenderGraph* graph, saci_u32 pass, saci_Color color) {
+    if (pass >= graph->passCount) return;
+    graph->passes[pass].clear = SACI_TRUE;
+    graph->passes[pass].clearColor = color;
+}
+
+//----------------------------------------------------------------------------//
+// Render Graph Execution
+//----------------------------------------------------------------------------//
+
+void sc_RenderGraphExecute(sc_RenderGraph* graph) {
+    graph->frame++;
+    saci_Bool gl = __sc_isGLLoaded();
+    // The previous frame's outputs, read by now
+    __sc_renderGraph_releaseHeld(graph);
+
+    __sc_renderGraph_cull(graph);
+    if (!__sc_renderGraph_sort(graph)) return;
+    __sc_renderGraph_computeLifetimes(graph);
+    __sc_renderGraph_allocateBuffers(graph, gl);
+
+    GLint previousDrawFramebuffer = 0, previousReadFramebuffer = 0;
+    GLint previousViewport[4] = {0, 0, 0, 0};
+    if (gl) {
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, previousViewport);
+    }
+
+    sc_RenderGraphStats* stats = &graph->stats;
+    stats->peakTargetCount = 0;
+    stats->peakTargetBytes = 0;
+    graph->liveTargets = 0;
+    graph->liveBytes = 0;
+    for (saci_u32 i = 0; i < graph->orderCount; ++i) {
+        saci_RenderGraphPass* pass = &graph->passes[graph->order[i]];
+        saci_Bool debugGroup = gl && GLAD_GL_VERSION_4_3 && pass->name;
+        if (gl) {
+            __sc_renderGraph_acquireTargets(graph, i);
+            __sc_renderGraph_bindTargets(graph, graph->order[i], previousDrawFramebuffer, previousViewport);
+        }
+        if (debugGroup) glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, pass->name);
+        if (pass->function) pass->function(graph, pass->userData);
+        if (debugGroup) glPopDebugGroup();
+        if (gl) __sc_renderGraph_releaseTargets(graph, i);
+    }
+
+    if (gl) {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousDrawFramebuffer);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousReadFramebuffer);
+        glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+    }
+    __sc_renderGraph_evict(graph, gl);
+
+    stats->passCount = graph->passCount;
+    stats->culledPassCount = graph->passCount - graph->orderCount;
+    stats->transientCount = 0;
+    for (saci_u32 i = 0; i < graph->resourceCount; ++i) {
+        const saci_RenderGraphResource* resource = &graph->resources[i];
+        if (!resource->imported && resource->firstUse != SACI_RENDER_GRAPH_NONE) stats->transientCount++;
+    }
+    stats->pooledBufferCount = graph->poolCount;
+    stats->pooledBufferBytes = 0;
+    for (saci_u32 i = 0; i < graph->poolCount; ++i) stats->pooledBufferBytes += graph->pool[i].size;
+}
+
+saci_TextureID sc_RenderGraphGetTexture(const sc_RenderGraph* graph, saci_u32 resource) {
+    if (resource >= graph->resourceCount || graph->resources[resource].kind != SACI_RENDER_GRAPH_TEXTURE) return 0;
+    return graph->resources[resource].glName;
+}
+
+saci_u32 sc_RenderGraphGetBuffer(const sc_RenderGraph* graph, saci_u32 resource) {
+    if (resource >= graph->resourceCount || graph->resources[resource].kind != SACI_RENDER_GRAPH_BUFFER) return 0;
+    return graph->resources[resource].glName;
+}
+
+saci_Bool sc_RenderGraphPassCulled(const sc_RenderGraph* graph, saci_u32 pass) {
+    return pass < graph->passCount && graph->passes[pass].culled;
+}
+
+sc_RenderGraphStats sc_RenderGraphGetStats(const sc_RenderGraph* graph) {
+    return graph->stats;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_u32 __sc_renderGraph_addResource(sc_RenderGraph* graph, const saci_RenderGraphResource* resource) {
+    if (!saci_Reserve((void**)&graph->resources, &graph->resourceCapacity, graph->resourceCount + 1,
+                      sizeof(saci_RenderGraphResource))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_RENDER_GRAPH_NONE;
+    }
+    graph->resources[graph->resourceCount] = *resource;
+    return graph->resourceCount++;
+}
+
+void __sc_renderGraph_access(sc_RenderGraph* graph, saci_u32 pass, saci_u32 resource, saci_Bool write) {
+    if (pass >= graph->passCount || resource >= graph->resourceCount) {
+        fprintf(stderr, "Invalid render graph pass or resource.\n");
+        return;
+    }
+    if (!saci_Reserve((void**)&graph->accesses, &graph->accessCapacity, graph->accessCount + 1,
+                      sizeof(saci_RenderGraphAccess))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    graph->accesses[graph->accessCount++] = (saci_RenderGraphAccess){pass, resource, write};
+}
+
+void __sc_renderGraph_cull(sc_RenderGraph* graph) {
+    // Everything starts culled except the passes with visible results
+    for (saci_u32 p = 0; p < graph->passCount; ++p) graph->passes[p].culled = SACI_TRUE;
+    for (saci_u32 p = 0; p < graph->passCount; ++p) {
+        saci_Bool writes = SACI_FALSE;
+        saci_Bool visible = SACI_FALSE;
+        for (saci_u32 a = 0; a < graph->accessCount; ++a) {
+            const saci_RenderGraphAccess* access = &graph->accesses[a];
+            if (access->pass != p || !access->write) continue;
+            writes = SACI_TRUE;
+            if (graph->resources[access->resource].output) visible = SACI_TRUE;
+        }
+        if (!writes || visible) graph->passes[p].culled = SACI_FALSE;
+    }
+
+    // Then whatever writes what a kept pass reads before it, until nothing
+    // changes. Writers added after the read don't affect what it sees
+    saci_Bool changed = SACI_TRUE;
+    while (changed) {
+        changed = SACI_FALSE;
+        for (saci_u32 r = 0; r < graph->accessCount; ++r) {
+            const saci_RenderGraphAccess* read = &graph->accesses[r];
+            if (read->write || graph->passes[read->pass].culled) continue;
+            for (saci_u32 w = 0; w < graph->accessCount; ++w) {
+                const saci_RenderGraphAccess* write = &graph->accesses[w];
+                if (!write->write || write->resource != read->resource || write->pass >= read->pass) continue;
+                if (!graph->passes[write->pass].culled) continue;
+                graph->passes[write->pass].culled = SACI_FALSE;
+                changed = SACI_TRUE;
+            }
+        }
+    }
+}
+
+saci_Bool __sc_renderGraph_sort(sc_RenderGraph* graph) {
+    graph->edgeCount = 0;
+    graph->orderCount = 0;
+    saci_u32 scratchCount = graph->passCount > graph->resourceCount ? graph->passCount : graph->resourceCount;
+    if (!saci_Reserve((void**)&graph->order, &graph->orderCapacity, graph->passCount, sizeof(saci_u32)) ||
+        !saci_Reserve((void**)&graph->scratch, &graph->scratchCapacity, scratchCount, sizeof(saci_u32))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_FALSE;
+    }
+
+    // Last kept pass to write each resource so far, in add order
+    saci_u32* writers = graph->scratch;
+    for (saci_u32 r = 0; r < graph->resourceCount; ++r) writers[r] = SACI_RENDER_GRAPH_NONE;
+    for (saci_u32 p = 0; p < graph->passCount; ++p) {
+        if (graph->passes[p].culled) continue;
+        // Reads first, a pass reading and writing a resource sees the previous write
+        for (saci_u32 a = 0; a < graph->accessCount; ++a) {
+            const saci_RenderGraphAccess* read = &graph->accesses[a];
+            if (read->pass != p || read->write) continue;
+            saci_u32 writer = writers[read->resource];
+            if (writer != SACI_RENDER_GRAPH_NONE && !__sc_renderGraph_addEdge(graph, writer, p)) return SACI_FALSE;
+        }
+        for (saci_u32 a = 0; a < graph->accessCount; ++a) {
+            const saci_RenderGraphAccess* write = &graph->accesses[a];
+            if (write->pass != p || !write->write) continue;
+            saci_u32 writer = writers[write->resource];
+            if (writer == p) continue;
+            // Readers of the previous contents finish before they are overwritten
+            for (saci_u32 b = 0; b < graph->accessCount; ++b) {
+                const saci_RenderGraphAccess* read = &graph->accesses[b];
+                if (read->write || read->resource != write->resource || read->pass >= p) continue;
+                if (graph->passes[read->pass].culled) continue;
+                if (writer != SACI_RENDER_GRAPH_NONE && read->pass <= writer) continue;
+                if (!__sc_renderGraph_addEdge(graph, read->pass, p)) return SACI_FALSE;
+            }
+            if (writer != SACI_RENDER_GRAPH_NONE && !__sc_renderGraph_addEdge(graph, writer, p)) return SACI_FALSE;
+            writers[write->resource] = p;
+        }
+    }
+
+    // Kahn's algorithm, always taking the earliest added pass that is ready
+    saci_u32* pending = graph->scratch; // incoming edges left per pass
+    memset(pending, 0, graph->passCount * sizeof(saci_u32));
+    for (saci_u32 e = 0; e < graph->edgeCount; ++e) pending[graph->edges[e].to]++;
+    saci_u32 keptCount = 0;
+    for (saci_u32 p = 0; p < graph->passCount; ++p) {
+        if (!graph->passes[p].culled) keptCount++;
+    }
+
+    while (graph->orderCount < keptCount) {
+        saci_u32 next = SACI_RENDER_GRAPH_NONE;
+        for (saci_u32 p = 0; p < graph->passCount; ++p) {
+            if (graph->passes[p].culled || pending[p] != 0) continue;
+            next = p;
+            break;
+        }
+        // Edges only point to later added passes, so there is no cycle
+        assert(next != SACI_RENDER_GRAPH_NONE);
+        graph->order[graph->orderCount++] = next;
+        pending[next] = SACI_RENDER_GRAPH_NONE; // emitted
+        for (saci_u32 e = 0; e < graph->edgeCount; ++e) {
+            if (graph->edges[e].from == next && pending[graph->edges[e].to] != SACI_RENDER_GRAPH_NONE) {
+                pending[graph->edges[e].to]--;
+            }
+        }
+    }
+    return SACI_TRUE;
+}
+
+saci_Bool __sc_renderGraph_addEdge(sc_RenderGraph* graph, saci_u32 from, saci_u32 to) {
+    if (!saci_Reserve((void**)&graph->edges, &graph->edgeCapacity, graph->edgeCount + 1,
+                      sizeof(saci_RenderGraphEdge))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_FALSE;
+    }
+    graph->edges[graph->edgeCount++] = (saci_RenderGraphEdge){from, to};
+    return SACI_TRUE;
+}
+
+void __sc_renderGraph_computeLifetimes(sc_RenderGraph* graph) {
+    for (saci_u32 r = 0; r < graph->resourceCount; ++r) {
+        graph->resources[r].firstUse = SACI_RENDER_GRAPH_NONE;
+        graph->resources[r].lastUse = SACI_RENDER_GRAPH_NONE;
+    }
+    // Execution position of every pass, culled ones stay SACI_RENDER_GRAPH_NONE
+    saci_u32* positions = graph->scratch;
+    for (saci_u32 p = 0; p < graph->passCount; ++p) positions[p] = SACI_RENDER_GRAPH_NONE;
+    for (saci_u32 i = 0; i < graph->orderCount; ++i) positions[graph->order[i]] = i;
+
+    for (saci_u32 a = 0; a < graph->accessCount; ++a) {
+        saci_u32 position = positions[graph->accesses[a].pass];
+        if (position == SACI_RENDER_GRAPH_NONE) continue;
+        saci_RenderGraphResource* resource = &graph->resources[graph->accesses[a].resource];
+        if (resource->firstUse == SACI_RENDER_GRAPH_NONE || position < resource->firstUse) resource->firstUse = position;
+        if (resource->lastUse == SACI_RENDER_GRAPH_NONE || position > resource->lastUse) resource->lastUse = position;
+    }
+}
+
+void __sc_renderGraph_allocateBuffers(sc_RenderGraph* graph, saci_Bool gl) {
+    for (saci_u32 r = 0; r < graph->resourceCount; ++r) {
+        if (graph->resources[r].imported) continue;
+        graph->resources[r].glName = 0;
+        graph->resources[r].target = NULL;
+    }
+
+    // In order of first use, so an entry freed by an earlier pass is reused
+    for (saci_u32 position = 0; position < graph->orderCount; ++position) {
+        for (saci_u32 r = 0; r < graph->resourceCount; ++r) {
+            saci_RenderGraphResource* resource = &graph->resources[r];
+            if (resource->kind != SACI_RENDER_GRAPH_BUFFER || resource->imported) continue;
+            if (resource->firstUse != position) continue;
+
+            saci_RenderGraphPoolEntry* entry = NULL;
+            for (saci_u32 i = 0; i < graph->poolCount; ++i) {
+                saci_RenderGraphPoolEntry* candidate = &graph->pool[i];
+                if (candidate->size != resource->size) continue;
+                if (candidate->lastFrame == graph->frame && candidate->busyUntil >= position) continue;
+                entry = candidate;
+                break;
+            }
+            if (!entry) {
+                if (!saci_Reserve((void**)&graph->pool, &graph->poolCapacity, graph->poolCount + 1,
+                                  sizeof(saci_RenderGraphPoolEntry))) {
+                    fprintf(stderr, "Memory allocation failed.\n");
+                    continue;
+                }
+                entry = &graph->pool[graph->poolCount++];
+                *entry = (saci_RenderGraphPoolEntry){resource->size, 0, 0, 0};
+                if (gl) {
+                    glGenBuffers(1, &entry->glName);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, entry->glName);
+                    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)entry->size, NULL, GL_DYNAMIC_COPY);
+                    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                }
+            }
+            entry->lastFrame = graph->frame;
+            // Outputs are read after execute, nothing later in the frame may alias them
+            entry->busyUntil = resource->output ? UINT32_MAX : resource->lastUse;
+            resource->glName = entry->glName;
+        }
+    }
+}
+
+void __sc_renderGraph_acquireTargets(sc_RenderGraph* graph, saci_u32 position) {
+    for (saci_u32 r = 0; r < graph->resourceCount; ++r) {
+        saci_RenderGraphResource* resource = &graph->resources[r];
+        if (resource->kind != SACI_RENDER_GRAPH_TEXTURE || resource->imported) continue;
+        if (resource->firstUse != position) continue;
+
+        // Depth is kept, later passes of the frame may test against it
+        sc_RenderTargetDesc desc = {resource->width, resource->height, SACI_RENDER_TARGET_FORMAT_RGBA8, SACI_FALSE,
+                                    1, SACI_TRUE};
+        switch (resource->format) {
+            case SACI_RENDER_GRAPH_FORMAT_RGBA8:
+                break;
+            case SACI_RENDER_GRAPH_FORMAT_RGBA16F:
+                desc.colorFormat = SACI_RENDER_TARGET_FORMAT_RGBA16F;
+                break;
+            case SACI_RENDER_GRAPH_FORMAT_R32F:
+                desc.colorFormat = SACI_RENDER_TARGET_FORMAT_R32F;
+                break;
+            case SACI_RENDER_GRAPH_FORMAT_DEPTH24_STENCIL8:
+                desc.colorFormat = SACI_RENDER_TARGET_FORMAT_NONE;
+                desc.depth = SACI_TRUE;
+                break;
+        }
+        resource->target = sc_RenderAcquireTarget(graph->renderer, &desc);
+        if (!resource->target) continue;
+        resource->glName = desc.depth ? sc_RenderTargetDepthTexture(resource->target)
+                                      : sc_RenderTargetTexture(resource->target);
+
+        sc_RenderGraphStats* stats = &graph->stats;
+        graph->liveTargets++;
+        graph->liveBytes += __sc_renderGraph_textureBytes(resource);
+        if (graph->liveTargets > stats->peakTargetCount) stats->peakTargetCount = graph->liveTargets;
+        if (graph->liveBytes > stats->peakTargetBytes) stats->peakTargetBytes = graph->liveBytes;
+    }
+}
+
+void __sc_renderGraph_releaseTargets(sc_RenderGraph* graph, saci_u32 position) {
+    for (saci_u32 r = 0; r < graph->resourceCount; ++r) {
+        saci_RenderGraphResource* resource = &graph->resources[r];
+        if (!resource->target || resource->lastUse != position) continue;
+        // Outputs are read after execute, nothing later in the frame may alias them
+        if (resource->output && saci_Reserve((void**)&graph->held, &graph->heldCapacity, graph->heldCount + 1,
+                                             sizeof(sc_RenderTarget*))) {
+            graph->held[graph->heldCount++] = resource->target;
+        } else {
+            if (resource->output) fprintf(stderr, "Memory allocation failed.\n");
+            sc_RenderReleaseTarget(graph->renderer, resource->target);
+            graph->liveTargets--;
+            graph->liveBytes -= __sc_renderGraph_textureBytes(resource);
+        }
+        resource->target = NULL;
+    }
+}
+
+void __sc_renderGraph_releaseHeld(sc_RenderGraph* graph) {
+    for (saci_u32 i = 0; i < graph->heldCount; ++i) sc_RenderReleaseTarget(graph->renderer, graph->held[i]);
+    graph->heldCount = 0;
+}
+
+void __sc_renderGraph_bindTargets(sc_RenderGraph* graph, saci_u32 pass, GLint fallback, const GLint* fallbackViewport) {
+    saci_RenderGraphAttachment colors[SACI_RENDER_GRAPH_MAX_COLORS];
+    saci_u32 colorCount = 0;
+    saci_RenderGraphAttachment depth = {0, 0};
+    saci_Bool backbuffer = SACI_FALSE;
+    saci_Bool hasImported = SACI_FALSE;
+    const sc_RenderTarget* single = NULL; // of the only texture written, if transient
+    saci_u32 textureCount = 0;
+    int width = 0, height = 0;
+
+    for (saci_u32 a = 0; a < graph->accessCount; ++a) {
+        const saci_RenderGraphAccess* access = &graph->accesses[a];
+        if (access->pass != pass || !access->write) continue;
+        const saci_RenderGraphResource* resource = &graph->resources[access->resource];
+        if (resource->kind == SACI_RENDER_GRAPH_BUFFER) continue;
+        saci_RenderGraphAttachment attachment = {resource->glName,
+                                                 resource->target ? __sc_renderTarget_serial(resource->target) : 0};
+        if (resource->kind == SACI_RENDER_GRAPH_BACKBUFFER) {
+            backbuffer = SACI_TRUE;
+        } else if (resource->format == SACI_RENDER_GRAPH_FORMAT_DEPTH24_STENCIL8) {
+            depth = attachment;
+        } else if (colorCount < SACI_RENDER_GRAPH_MAX_COLORS) {
+            colors[colorCount++] = attachment;
+        } else {
+            fprintf(stderr, "Too many render graph color attachments.\n");
+            continue;
+        }
+        if (resource->kind == SACI_RENDER_GRAPH_TEXTURE) {
+            single = resource->target;
+            textureCount++;
+        }
+        if (width != 0 && (resource->width != width || resource->height != height)) {
+            fprintf(stderr, "Render graph attachments differ in size.\n");
+        }
+        if (width == 0) {
+            width = resource->width;
+            height = resource->height;
+        }
+        if (resource->imported) hasImported = SACI_TRUE;
+    }
+
+    GLbitfield clearMask = 0;
+    if (backbuffer) {
+        if (textureCount > 0) fprintf(stderr, "The backbuffer can't be mixed with textures.\n");
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width, height);
+        clearMask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+    } else if (textureCount > 0) {
+        saci_u32 fbo;
+        if (textureCount == 1 && single) {
+            // A lone transient is drawn through the framebuffer its target already has
+            fbo = sc_RenderTargetFramebuffer(single);
+        } else {
+            fbo = __sc_renderGraph_framebuffer(graph, colors, colorCount, depth, hasImported);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        if (colorCount > 0) clearMask |= GL_COLOR_BUFFER_BIT;
+        if (depth.texture != 0) clearMask |= GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT;
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)fallback);
+        glViewport(fallbackViewport[0], fallbackViewport[1], fallbackViewport[2], fallbackViewport[3]);
+    }
+
+    const saci_RenderGraphPass* graphPass = &graph->passes[pass];
+    if (graphPass->clear && clearMask) {
+        saci_Color color = graphPass->clearColor;
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glClearColor(color.r, color.g, color.b, color.a);
+        glClearDepth(1.0);
+        glClear(clearMask);
+    }
+}
+
+saci_u32 __sc_renderGraph_framebuffer(sc_RenderGraph* graph, const saci_RenderGraphAttachment* colors,
+                                      saci_u32 colorCount, saci_RenderGraphAttachment depth, saci_Bool hasImported) {
+    // Serials tell a target apart from a later one given a deleted target's
+    // texture name
+    saci_RenderGraphFramebuffer* framebuffer = NULL;
+    for (saci_u32 i = 0; i < graph->framebufferCount && !framebuffer; ++i) {
+        saci_RenderGraphFramebuffer* candidate = &graph->framebuffers[i];
+        if (candidate->colorCount != colorCount || !__sc_renderGraph_attachmentEqual(candidate->depth, depth)) continue;
+        saci_Bool same = SACI_TRUE;
+        for (saci_u32 c = 0; c < colorCount && same; ++c) {
+            same = __sc_renderGraph_attachmentEqual(candidate->colors[c], colors[c]);
+        }
+        if (same) framebuffer = candidate;
+    }
+
+    saci_Bool attach = SACI_FALSE;
+    if (!framebuffer) {
+        if (!saci_Reserve((void**)&graph->framebuffers, &graph->framebufferCapacity,
+                          graph->framebufferCount + 1, sizeof(saci_RenderGraphFramebuffer))) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return 0;
+        }
+        framebuffer = &graph->framebuffers[graph->framebufferCount++];
+        memset(framebuffer, 0, sizeof(saci_RenderGraphFramebuffer));
+        memcpy(framebuffer->colors, colors, colorCount * sizeof(saci_RenderGraphAttachment));
+        framebuffer->colorCount = colorCount;
+        framebuffer->depth = depth;
+        glGenFramebuffers(1, &framebuffer->fbo);
+        attach = SACI_TRUE;
+    }
+    framebuffer->hasImported = hasImported;
+    framebuffer->lastFrame = graph->frame;
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer->fbo);
+    if (!attach && !hasImported) return framebuffer->fbo;
+
+    GLenum drawBuffers[SACI_RENDER_GRAPH_MAX_COLORS];
+    for (saci_u32 i = 0; i < colorCount; ++i) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, colors[i].texture, 0);
+        drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    }
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depth.texture, 0);
+    if (colorCount > 0) {
+        glDrawBuffers((GLsizei)colorCount, drawBuffers);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Render graph framebuffer incomplete.\n");
+    }
+    return framebuffer->fbo;
+}
+
+void __sc_renderGraph_evict(sc_RenderGraph* graph, saci_Bool gl) {
+    for (saci_u32 i = 0; i < graph->poolCount;) {
+        saci_RenderGraphPoolEntry* entry = &graph->pool[i];
+        if (graph->frame - entry->lastFrame < SACI_RENDER_GRAPH_POOL_FRAMES) {
+            ++i;
+            continue;
+        }
+        if (gl) glDeleteBuffers(1, &entry->glName);
+        graph->pool[i] = graph->pool[--graph->poolCount];
+    }
+
+    for (saci_u32 i = 0; i < graph->framebufferCount;) {
+        saci_RenderGraphFramebuffer* framebuffer = &graph->framebuffers[i];
+        if (graph->frame - framebuffer->lastFrame < SACI_RENDER_GRAPH_POOL_FRAMES) {
+            ++i;
+            continue;
+        }
+        if (gl) glDeleteFramebuffers(1, &framebuffer->fbo);
+        graph->framebuffers[i] = graph->framebuffers[--graph->framebufferCount];
+    }
+}
+
+saci_Bool __sc_renderGraph_attachmentEqual(saci_RenderGraphAttachment a, saci_RenderGraphAttachment b) {
+    return a.texture == b.texture && a.serial == b.serial;
+}
+
+size_t __sc_renderGraph_textureBytes(const saci_RenderGraphResource* resource) {
+    size_t bytesPerPixel = resource->format == SACI_RENDER_GRAPH_FORMAT_RGBA16F ? 8 : 4;
+    return (size_t)resource->width * resource->height * bytesPerPixel;
+}
@@ -0,0 +1,334 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-render-target.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// Released targets no acquire matched for this many frames are deleted
+#define SACI_RENDER_TARGET_POOL_FRAMES 8
+
+// Last serial handed out, see __sc_renderTarget_serial
+static saci_u64 sc_renderTargetSerial;
+
+struct sc_RenderTarget {
+    sc_RenderTargetDesc desc;
+    saci_u64 serial;
+
+    saci_u32 fbo, colorTexture, depthTexture;
+    // Multisampled targets draw here and resolve into fbo
+    saci_u32 msaaFbo, msaaColor, msaaDepth;
+
+    saci_Bool pooled;
+    saci_Bool acquired;
+    saci_u64 releaseFrame;
+
+    // Restored after sc_RenderEnd, the resolve binds the read framebuffer too
+    GLint previousDrawFramebuffer, previousReadFramebuffer;
+    GLint previousViewport[4];
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __sc_renderTarget_descEqual(const sc_RenderTargetDesc* a, const sc_RenderTargetDesc* b);
+saci_u32 __sc_renderTarget_createTexture(GLenum internalFormat, GLenum format, GLenum type, int width, int height);
+void __sc_renderTarget_colorFormat(sc_RenderTargetFormat format, GLenum* internalFormat, GLenum* pixelFormat,
+                                   GLenum* type);
+void __sc_renderTarget_checkStatus(void);
+
+//----------------------------------------------------------------------------//
+// Render Target Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_RenderTarget* sc_CreateRenderTarget(const sc_RenderTargetDesc* desc) {
+    if (desc->width <= 0 || desc->height <= 0) {
+        fprintf(stderr, "Invalid render target size: %dx%d.\n", desc->width, desc->height);
+        return NULL;
+    }
+    saci_Bool hasColor = desc->colorFormat != SACI_RENDER_TARGET_FORMAT_NONE;
+    if (!hasColor && (!desc->depth || desc->samples > 1)) {
+        fprintf(stderr, "Render targets without color need depth and a single sample.\n");
+        return NULL;
+    }
+    if (!__sc_isGLLoaded()) {
+        fprintf(stderr, "Render targets need an OpenGL context.\n");
+        return NULL;
+    }
+
+    sc_RenderTarget* target = (sc_RenderTarget*)calloc(1, sizeof(sc_RenderTarget));
+    assert(target);
+    target->desc = *desc;
+    target->serial = ++sc_renderTargetSerial;
+    if (target->desc.samples < 1) target->desc.samples = 1;
+    int width = desc->width, height = desc->height;
+    saci_Bool multisampled = target->desc.samples > 1;
+
+    GLint previousDrawFramebuffer, previousReadFramebuffer;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+
+    GLenum colorInternal, colorFormat, colorType;
+    __sc_renderTarget_colorFormat(desc->colorFormat, &colorInternal, &colorFormat, &colorType);
+    glGenFramebuffers(1, &target->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->fbo);
+    if (hasColor) {
+        target->colorTexture = __sc_renderTarget_createTexture(colorInternal, colorFormat, colorType, width, height);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->colorTexture, 0);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    // Multisampled depth is never resolved, only the drawing framebuffer has it
+    if (desc->depth && !multisampled) {
+        target->depthTexture = __sc_renderTarget_createTexture(GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL,
+                                                               GL_UNSIGNED_INT_24_8, width, height);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, target->depthTexture, 0);
+    }
+    __sc_renderTarget_checkStatus();
+
+    if (multisampled) {
+        glGenFramebuffers(1, &target->msaaFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, target->msaaFbo);
+        glGenRenderbuffers(1, &target->msaaColor);
+        glBindRenderbuffer(GL_RENDERBUFFER, target->msaaColor);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, target->desc.samples, colorInternal, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target->msaaColor);
+        if (desc->depth) {
+            glGenRenderbuffers(1, &target->msaaDepth);
+            glBindRenderbuffer(GL_RENDERBUFFER, target->msaaDepth);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, target->desc.samples, GL_DEPTH24_STENCIL8, width,
+                                             height);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target->msaaDepth);
+        }
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        __sc_renderTarget_checkStatus();
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousDrawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousReadFramebuffer);
+    return target;
+}
+
+void sc_DeleteRenderTarget(sc_RenderTarget* target) {
+    if (!target) return;
+    if (target->pooled) {
+        fprintf(stderr, "Pooled render targets are deleted by their renderer.\n");
+        return;
+    }
+    glDeleteFramebuffers(1, &target->fbo);
+    if (target->colorTexture) glDeleteTextures(1, &target->colorTexture);
+    if (target->depthTexture) glDeleteTextures(1, &target->depthTexture);
+    if (target->msaaFbo) {
+        glDeleteFramebuffers(1, &target->msaaFbo);
+        glDeleteRenderbuffers(1, &target->msaaColor);
+        if (target->msaaDepth) glDeleteRenderbuffers(1, &target->msaaDepth);
+    }
+    free(target);
+}
+
+sc_RenderTarget* sc_RenderAcquireTarget(sc_Renderer* renderer, const sc_RenderTargetDesc* desc) {
+    for (saci_u32 i = 0; i < renderer->targetPoolCount; ++i) {
+        sc_RenderTarget* target = renderer->targetPool[i];
+        if (target->acquired || !__sc_renderTarget_descEqual(&target->desc, desc)) continue;
+        target->acquired = SACI_TRUE;
+        return target;
+    }
+
+    if (renderer->targetPoolCount == renderer->targetPoolCapacity) {
+        saci_u32 newCapacity = renderer->targetPoolCapacity ? renderer->targetPoolCapacity * 2 : 8;
+        sc_RenderTarget** newPool = (sc_RenderTarget**)realloc(renderer->targetPool,
+                                                               newCapacity * sizeof(sc_RenderTarget*));
+        if (!newPool) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        renderer->targetPool = newPool;
+        renderer->targetPoolCapacity = newCapacity;
+    }
+    sc_RenderTarget* target = sc_CreateRenderTarget(desc);
+    if (!target) return NULL;
+    target->pooled = SACI_TRUE;
+    target->acquired = SACI_TRUE;
+    renderer->targetPool[renderer->targetPoolCount++] = target;
+    return target;
+}
+
+void sc_RenderReleaseTarget(sc_Renderer* renderer, sc_RenderTarget* target) {
+    if (!target) return;
+    if (!target->pooled || !target->acquired) {
+        fprintf(stderr, "Render target was not acquired from a renderer.\n");
+        return;
+    }
+    target->acquired = SACI_FALSE;
+    target->releaseFrame = renderer->frameIndex;
+}
+
+saci_u32 sc_RenderTargetPoolSize(const sc_Renderer* renderer) {
+    return renderer->targetPoolCount;
+}
+
+//----------------------------------------------------------------------------//
+// Render Target Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderBeginTarget(sc_Renderer* renderer, sc_RenderTarget* target, const saci_Color* clearColor) {
+    sc_RenderBegin(renderer);
+    renderer->target = target;
+    renderer->targetClear = clearColor != NULL;
+    if (clearColor) renderer->targetClearColor = *clearColor;
+}
+
+saci_TextureID sc_RenderTargetTexture(const sc_RenderTarget* target) {
+    return target->colorTexture;
+}
+
+saci_TextureID sc_RenderTargetDepthTexture(const sc_RenderTarget* target) {
+    return target->depthTexture;
+}
+
+saci_u32 sc_RenderTargetFramebuffer(const sc_RenderTarget* target) {
+    return target->fbo;
+}
+
+void sc_RenderTargetGetSize(const sc_RenderTarget* target, int* width, int* height) {
+    if (width) *width = target->desc.width;
+    if (height) *height = target->desc.height;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_renderTarget_bind(sc_Renderer* renderer) {
+    sc_RenderTarget* target = renderer->target;
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target->previousDrawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &target->previousReadFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, target->previousViewport);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target->msaaFbo ? target->msaaFbo : target->fbo);
+    glViewport(0, 0, target->desc.width, target->desc.height);
+    if (renderer->targetClear) {
+        saci_Color color = renderer->targetClearColor;
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glClearColor(color.r, color.g, color.b, color.a);
+        glClearDepth(1.0);
+        glClear((target->colorTexture ? GL_COLOR_BUFFER_BIT : 0) |
+                (target->desc.depth ? GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT : 0));
+    }
+}
+
+void __sc_renderTarget_finish(sc_Renderer* renderer) {
+    sc_RenderTarget* target = renderer->target;
+    saci_Bool invalidate = GLAD_GL_VERSION_4_3;
+    GLenum discard[2];
+    GLsizei discardCount = 0;
+
+    if (target->msaaFbo) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target->msaaFbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->fbo);
+        glBlitFramebuffer(0, 0, target->desc.width, target->desc.height, 0, 0, target->desc.width,
+                          target->desc.height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        // The samples are only ever read through the resolved texture
+        if (invalidate) {
+            discard[discardCount++] = GL_COLOR_ATTACHMENT0;
+            if (target->desc.depth && !target->desc.keepDepth) discard[discardCount++] = GL_DEPTH_STENCIL_ATTACHMENT;
+            glBindFramebuffer(GL_FRAMEBUFFER, target->msaaFbo);
+            glInvalidateFramebuffer(GL_FRAMEBUFFER, discardCount, discard);
+        }
+    } else if (invalidate && target->desc.depth && !target->desc.keepDepth) {
+        discard[discardCount++] = GL_DEPTH_STENCIL_ATTACHMENT;
+        glInvalidateFramebuffer(GL_FRAMEBUFFER, discardCount, discard);
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)target->previousDrawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)target->previousReadFramebuffer);
+    glViewport(target->previousViewport[0], target->previousViewport[1], target->previousViewport[2],
+               target->previousViewport[3]);
+}
+
+void __sc_renderTarget_evictPool(sc_Renderer* renderer) {
+    for (saci_u32 i = 0; i < renderer->targetPoolCount;) {
+        sc_RenderTarget* target = renderer->targetPool[i];
+        if (target->acquired || renderer->frameIndex - target->releaseFrame < SACI_RENDER_TARGET_POOL_FRAMES) {
+            ++i;
+            continue;
+        }
+        target->pooled = SACI_FALSE;
+        sc_DeleteRenderTarget(target);
+        renderer->targetPool[i] = renderer->targetPool[--renderer->targetPoolCount];
+    }
+}
+
+saci_u64 __sc_renderTarget_serial(const sc_RenderTarget* target) {
+    return target->serial;
+}
+
+void __sc_renderTarget_deleteRendererObjects(sc_Renderer* renderer) {
+    for (saci_u32 i = 0; i < renderer->targetPoolCount; ++i) {
+        renderer->targetPool[i]->pooled = SACI_FALSE;
+        sc_DeleteRenderTarget(renderer->targetPool[i]);
+    }
+    free(renderer->targetPool);
+    renderer->targetPool = NULL;
+    renderer->targetPoolCount = renderer->targetPoolCapacity = 0;
+}
+
+saci_Bool __sc_renderTarget_descEqual(const sc_RenderTargetDesc* a, const sc_RenderTargetDesc* b) {
+    int aSamples = a->samples < 1 ? 1 : a->samples;
+    int bSamples = b->samples < 1 ? 1 : b->samples;
+    return a->width == b->width && a->height == b->height && a->colorFormat == b->colorFormat &&
+           !a->depth == !b->depth && aSamples == bSamples && !a->keepDepth == !b->keepDepth;
+}
+
+saci_u32 __sc_renderTarget_createTexture(GLenum internalFormat, GLenum format, GLenum type, int width, int height) {
+    saci_u32 texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)internalFormat, width, height, 0, format, type, NULL);
+    GLint filter = format == GL_DEPTH_STENCIL ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+void __sc_renderTarget_colorFormat(sc_RenderTargetFormat format, GLenum* internalFormat, GLenum* pixelFormat,
+                                   GLenum* type) {
+    *internalFormat = GL_RGBA8;
+    *pixelFormat = GL_RGBA;
+    *type = GL_UNSIGNED_BYTE;
+    switch (format) {
+        case SACI_RENDER_TARGET_FORMAT_RGBA8:
+        case SACI_RENDER_TARGET_FORMAT_NONE:
+            break;
+        case SACI_RENDER_TARGET_FORMAT_RGBA16F:
+            *internalFormat = GL_RGBA16F;
+            *type = GL_HALF_FLOAT;
+            break;
+        case SACI_RENDER_TARGET_FORMAT_R32F:
+            *internalFormat = GL_R32F;
+            *pixelFormat = GL_RED;
+            *type = GL_FLOAT;
+            break;
+    }
+}
+
+void __sc_renderTarget_checkStatus(void) {
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Render target framebuffer incomplete: 0x%x.\n", status);
+    }
+}
@@ -0,0 +1,348 @@
+// NOTE: Private to saci's sources. Shares the renderer internals between the
+// frontend (sc-rendering.c) and the backends that consume its batches.
+
+#ifndef __SACI_CORE_SC_RENDERING_INTERNAL_H__
+#define __SACI_CORE_SC_RENDERING_INTERNAL_H__
+
+#include "saci-core/sc-font.h"
+#include "saci-core/sc-mesh.h"
+#include "saci-core/sc-rendering.h"
+#include "saci-core/sc-static-batch.h"
+#include "saci-utils/su-types.h"
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// A range of the batch's vertices drawn with one texture. GL_LINES are pairs,
+// GL_TRIANGLES and GL_QUADS (uploaded as 2 triangles) are triangle lists
+typedef struct saci_RenderCall {
+    saci_u32 firstVertex;
+    saci_u32 vertexCount;
+    int drawMode;
+    saci_TextureID textureID;
+} saci_RenderCall;
+
+// Every push lands in one vertex array, uploaded with a single copy. A push
+// that matches the last call's texture and primitive extends it
+typedef struct saci_RenderBatch {
+    saci_RenderCall* drawCalls;
+    saci_u32 capacity;
+    saci_u32 drawCallCount;
+
+    saci_Vertice* vertices;
+    saci_u32 vertexCount;
+    saci_u32 vertexCapacity;
+} saci_RenderBatch;
+
+// What the frontend worked out in sc_RenderEnd, backends only read it
+typedef struct saci_RenderFrame {
+    saci_Bool hasCamera;
+    saci_Bool cameraValid; // false if no projection could be built
+    saci_Bool depthPrePass; // the shading pass tests GL_EQUAL against a finished depth buffer
+    sc_Camera camera;      // the renderer's copy, cached matrices up to date
+    saci_Mat4 view;
+    saci_Mat4 projection;
+} saci_RenderFrame;
+
+// What a renderer remembers about the n-th push of a mesh in a frame, see
+// sc-mesh.c
+typedef struct saci_MeshInstance {
+    saci_u32 query;
+    saci_Bool pending; // issued, result not read back yet
+    saci_Bool visible;
+    saci_u32 lod;      // last LOD picked, for hysteresis
+} saci_MeshInstance;
+
+// A renderer's instances of one mesh, found by the mesh's serial. Entries of
+// deleted meshes are dropped once the table fills up
+typedef struct saci_MeshState {
+    saci_u64 serial;
+    saci_u64 lastUsed;       // frameIndex of the last push
+    saci_u32 lodGeneration;  // the mesh's LOD set the instances picked from
+    saci_MeshInstance* instances;
+    saci_u32 instanceStateCount;
+    saci_u32 instanceCount;  // pushed in lastUsed
+} saci_MeshState;
+
+struct sc_Mesh {
+    saci_u32 vao, vbo, ibo; // 0 when created without a GL context
+
+    saci_Vertice* vertices;
+    saci_u32 vertexCount;
+    saci_u32* indices;
+    saci_u32 indexCount;
+    saci_TextureID textureID;
+
+    saci_Vec3 boundsMin, boundsMax;
+    saci_Vec3 boundsCenter;
+    float boundsRadius;
+
+    sc_MeshLOD* lods; // NULL draws every index
+    saci_u32 lodCount;
+
+    saci_u32 lodGeneration; // bumped by sc_MeshSetLODs
+
+    saci_Bool occlusionTested;
+    saci_u64 serial; // keys the renderers' saci_MeshState, never reused
+};
+
+typedef struct saci_MeshDraw {
+    sc_Mesh* mesh;
+    saci_MeshState* state; // the renderer's, lives at least until the frame ends
+    saci_Mat4 model;
+    saci_u32 instance;
+    saci_u32 firstIndex, indexCount; // range of the picked LOD
+} saci_MeshDraw;
+
+// A font drawn this frame and the atlas height its vertices were normalized
+// with. A taller atlas squeezes their v, see sc-font.c
+typedef struct saci_FontUse {
+    sc_Font* font;
+    saci_TextureID textureID;
+    int atlasHeight;
+} saci_FontUse;
+
+// One SDF primitive, drawn as an instanced quad. The quad spans extent
+// around center along axis and its perpendicular, the fragment shader
+// evaluates the distance in that frame
+typedef struct saci_SdfInstance {
+    saci_Vec3 center;
+    saci_Vec2 axis;   // unit, local +x
+    saci_Vec2 extent; // half size of the quad, margin for the edge included
+    saci_Vec4 shape;  // kind then its parameters, see sc-sdf.c
+    saci_Color color;
+} saci_SdfInstance;
+
+// Draws go out once per pass. The depth pass binds no textures and issues no
+// queries, its draw calls are counted apart. Batch lines stay out of it and
+// are shaded last in their own pass
+typedef enum saci_RenderPass {
+    SACI_RENDER_PASS_SHADE = 0,
+    SACI_RENDER_PASS_DEPTH = 1,
+    SACI_RENDER_PASS_LINES = 2,
+} saci_RenderPass;
+
+typedef struct saci_SoftwareRenderer saci_SoftwareRenderer;
+typedef struct saci_RenderCaptureState saci_RenderCaptureState;
+typedef struct saci_ShapeCache saci_ShapeCache;
+typedef struct sc_RenderTarget sc_RenderTarget;
+
+struct sc_Renderer {
+    sc_RendererBackend backend;
+
+    saci_u32 vao, vbo;
+    saci_u32 vboCapacity; // in vertices, the whole batch is uploaded at once
+
+    saci_u32 shaderProgram;
+    saci_s32 useTextureLoc;
+    saci_s32 modelLoc;
+    saci_s32 viewLoc, projectionLoc, useCameraLoc, textureLoc;
+
+    // Matrices are only rebuilt when the camera passed to sc_RenderEnd changed,
+    // and only uploaded when the cached version moved
+    sc_Camera camera;
+    saci_u64 uploadedCameraVersion; // 0 when uUseCam was last set to false
+
+    sc_RenderConfig config;
+    saci_Bool hasConfig; // false follows the global defaults
+
+    saci_RenderBatch renderBatch;
+    saci_RenderFrame frame;
+    saci_u64 frameIndex; // bumped by sc_RenderBegin
+
+    saci_MeshDraw* meshDraws;
+    saci_u32 meshDrawCount;
+    saci_u32 meshDrawCapacity;
+
+    sc_StaticBatch** staticBatches;
+    saci_u32 staticBatchCount;
+    saci_u32 staticBatchCapacity;
+    saci_u32 cullProgram; // static batch GPU culling, compiled on first use
+    saci_s32 cullPlanesLoc, cullItemCountLoc;
+
+    saci_MeshState** meshStates; // open addressing on the mesh serial
+    saci_u32 meshStateCount, meshStateCapacity;
+    saci_Bool occlusionCulling;
+    float lodHysteresis;
+    saci_u32 boundsVao, boundsVbo, boundsIbo; // unit cube, created on first use
+
+    saci_ShapeCache* shapeCache; // created by the first pushed shape
+    float shapePixelSize; // set by sc_RenderSetShapePixelSize, 0 derives it
+    float framePixelSize; // worked out by the last sc_RenderEnd, 0 before one
+
+    saci_FontUse* fontUses;
+    saci_u32 fontUseCount, fontUseCapacity;
+
+    saci_SdfInstance* sdfInstances;
+    saci_u32 sdfInstanceCount;
+    saci_u32 sdfInstanceCapacity;
+    saci_u32 sdfProgram, sdfVao, sdfVbo, sdfVboCapacity; // created on first use
+    saci_s32 sdfViewLoc, sdfProjectionLoc, sdfUseCameraLoc;
+
+    saci_Bool overdrawCounter;
+    saci_u32 samplesQuery; // GL_SAMPLES_PASSED over the shading pass
+    saci_Bool samplesQueryPending;
+
+    sc_RenderTarget* target; // set by sc_RenderBeginTarget for one frame
+    saci_Bool targetClear;
+    saci_Color targetClearColor;
+    sc_RenderTarget** targetPool;
+    saci_u32 targetPoolCount, targetPoolCapacity;
+
+    sc_RenderStats frameStats;
+    sc_RenderStats totalStats;
+
+    saci_SoftwareRenderer* software; // only set for SACI_RENDER_BACKEND_SOFTWARE
+    saci_RenderCaptureState* capture; // set between sc_RenderCaptureBegin/End
+    // Set by sc_RenderCaptureReplayFrame for its sc_RenderEnd, the custom
+    // projection the capture kept as a matrix
+    const saci_Mat4* replayProjection;
+};
+
+//----------------------------------------------------------------------------//
+// Frontend helpers
+//----------------------------------------------------------------------------//
+
+// Room for vertexCount vertices at the end of the batch, for the caller to
+// fill. NULL on a bad draw mode or count, or when out of memory
+saci_Vertice* __sc_renderBatch_Reserve(saci_RenderBatch* renderBatch, int drawMode, saci_TextureID texID,
+                                       saci_u32 vertexCount);
+void __sc_renderBatch_AddTo(saci_RenderBatch* renderBatch, const saci_Vertice* vertices, int drawMode,
+                            saci_TextureID texID, saci_u32 vertexCount);
+
+// Global GL state can only be touched once a context was loaded, the software
+// backend runs without one
+saci_Bool __sc_isGLLoaded(void);
+
+// Attribute pointers for saci_Vertice on the bound VAO and GL_ARRAY_BUFFER
+void __sc_setVertexLayout(void);
+
+// The renderer's own config or the global defaults, for the current frame
+const sc_RenderConfig* __sc_getRenderConfig(const sc_Renderer* renderer);
+
+// Brings the renderer's camera copy up to date with camera, rebuilding the
+// matrices only if something changed. Returns false if no projection could be
+// built (e.g. custom projection without a function)
+saci_Bool __sc_updateRendererCamera(sc_Renderer* renderer, const sc_RenderConfig* config, const sc_Camera* camera);
+
+//----------------------------------------------------------------------------//
+// Software backend (sc-software-rasterizer.c)
+//----------------------------------------------------------------------------//
+
+void __sc_software_init(sc_Renderer* renderer);
+void __sc_software_delete(sc_Renderer* renderer);
+void __sc_software_renderEnd(sc_Renderer* renderer, const sc_RenderConfig* config);
+// path is a copy the caller frees, NULL when the texture wasn't loaded from a
+// file. path and flipImg may be NULL
+saci_Bool __sc_software_textureSource(saci_TextureID id, char** path, saci_Bool* flipImg, int* width, int* height);
+// For textures written to after creation (font atlases). Resizing zeroes the
+// pixels, the ID stays the same
+saci_Bool __sc_software_textureResize(saci_TextureID id, int width, int height);
+void __sc_software_textureUpdate(saci_TextureID id, int x, int y, int width, int height, const saci_u8* rgba);
+
+//----------------------------------------------------------------------------//
+// Textures (sc-texture.c)
+//----------------------------------------------------------------------------//
+
+// Where a GL texture made by sc_TextureLoad came from, false for unknown IDs.
+// path is copied under the registry lock and the caller frees it, path and
+// flipImg may be NULL
+saci_Bool __sc_texture_getSource(saci_TextureID id, char** path, saci_Bool* flipImg, int* width, int* height);
+// Also used by the asynchronous loader once an upload finished
+void __sc_texture_recordSource(saci_TextureID id, const char* path, saci_Bool flipImg, int width, int height);
+void __sc_texture_forgetSource(saci_TextureID id);
+
+//----------------------------------------------------------------------------//
+// Cameras (sc-camera.c)
+//----------------------------------------------------------------------------//
+
+// sc_CameraUpdate, with fixedProjection (when not NULL) standing in for what
+// the custom projection function would return
+saci_Bool __sc_camera_update(sc_Camera* camera, sc_RendererProjectionMode mode,
+                             sc_RendererCustomProjectionFunction customProjection, const saci_Mat4* fixedProjection);
+
+//----------------------------------------------------------------------------//
+// Meshes (sc-mesh.c)
+//----------------------------------------------------------------------------//
+
+// Picks every draw's LOD once the frame's camera is known, the software
+// backend also gets the draws expanded into its batch
+void __sc_mesh_prepareDraws(sc_Renderer* renderer, const sc_RenderConfig* config);
+// World space triangles of the draw's LOD appended to the batch
+void __sc_mesh_pushTriangles(sc_Renderer* renderer, const saci_MeshDraw* draw);
+// Draws (or for the null backend counts) the meshes pushed this frame
+void __sc_mesh_submitDraws(sc_Renderer* renderer, const sc_RenderConfig* config, saci_RenderPass pass);
+// Bounding box occlusion queries, after every shading draw of the frame
+void __sc_mesh_submitQueries(sc_Renderer* renderer, const sc_RenderConfig* config);
+// Frees the instance states for every backend, their queries and the bounds
+// cube only exist with a GL context
+void __sc_mesh_deleteRendererObjects(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Static batches (sc-static-batch.c)
+//----------------------------------------------------------------------------//
+
+// Refreshes toggled ranges and runs the GPU culling, the software backend
+// gets the enabled items expanded into its batch
+void __sc_staticBatch_prepareDraws(sc_Renderer* renderer);
+// The enabled items' triangles appended to the batch
+void __sc_staticBatch_pushTriangles(sc_Renderer* renderer, const sc_StaticBatch* batch);
+void __sc_staticBatch_submitDraws(sc_Renderer* renderer, saci_RenderPass pass);
+void __sc_staticBatch_deleteRendererObjects(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Shapes (sc-shape.c)
+//----------------------------------------------------------------------------//
+
+void __sc_shape_deleteRendererObjects(sc_Renderer* renderer);
+// Size of a pixel the next frame's shapes are tessellated for
+float __sc_shape_pixelSize(const sc_Renderer* renderer);
+// From the frame's projection at the camera's target, and the height of the
+// viewport it was drawn into. 0 leaves the previous one
+void __sc_shape_updatePixelSize(sc_Renderer* renderer, int viewportHeight);
+
+//----------------------------------------------------------------------------//
+// Fonts (sc-font.c)
+//----------------------------------------------------------------------------//
+
+// Brings the atlas textures of the fonts drawn this frame up to date and
+// stretches back the v of text pushed before an atlas grew, whoever grew it
+void __sc_font_prepareDraws(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// SDF primitives (sc-sdf.c)
+//----------------------------------------------------------------------------//
+
+// Draws (or for the null backend counts) the frame's SDF primitives in one
+// instanced call, after everything else as they are blended
+void __sc_sdf_submitDraws(sc_Renderer* renderer, const sc_RenderConfig* config);
+// The software backend gets the frame's primitives expanded into its batch
+void __sc_sdf_prepareDraws(sc_Renderer* renderer);
+// Tessellates one primitive like sc-shape.h does and appends it to the batch
+void __sc_sdf_pushTriangles(sc_Renderer* renderer, const saci_SdfInstance* instance);
+void __sc_sdf_deleteRendererObjects(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Render targets (sc-render-target.c)
+//----------------------------------------------------------------------------//
+
+// Around the OpenGL backend's submit when the frame has a target. Bind clears
+// it if asked, finish resolves and discards, then binds back what was there
+void __sc_renderTarget_bind(sc_Renderer* renderer);
+void __sc_renderTarget_finish(sc_Renderer* renderer);
+// Deletes pooled targets released too many frames ago
+void __sc_renderTarget_evictPool(sc_Renderer* renderer);
+// Unique to the target for the life of the process, unlike its GL names which
+// come back once it is deleted. For caches keyed by targets
+saci_u64 __sc_renderTarget_serial(const sc_RenderTarget* target);
+void __sc_renderTarget_deleteRendererObjects(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// Capture (sc-capture.c)
+//----------------------------------------------------------------------------//
+
+// Called by sc_RenderEnd after the backend consumed the frame
+void __sc_capture_writeFrame(sc_Renderer* renderer, const sc_RenderConfig* config);
+
+#endif
@@ -1,6 +1,7 @@
 #include <glad/glad.h>
 
 #include "saci-core.h"
+#include "sc-rendering-internal.h"
 
 #include "saci-core/sc-camera.h"
 #include "saci-utils/su-general.h"
@@ -16,20 +17,12 @@
 // Helper functions
 //----------------------------------------------------------------------------//
 
-// structs used in helper functions
-typedef struct saci_Vertice saci_Vertice;
-typedef struct saci_RenderCall saci_RenderCall;
-typedef struct saci_RenderBatch saci_RenderBatch;
-
 // This needs to be done to make each new renderer value = 0 or NULL. If not it
 // will generate a garbage value and will lead to a crash
 void __sc_initializeRenderValues(sc_Renderer* renderer);
 
 // Renderer related
-saci_RenderCall __sc_renderCall_create(saci_Vertice* vertices, int drawMode, saci_TextureID texID, saci_u64 verticesAmount);
-
 void __sc_renderBatch_ResizeInternal(saci_RenderBatch* renderBatch, saci_u32 newSize);
-void __sc_renderBatch_AddTo(saci_RenderBatch* renderBatch, saci_RenderCall renderCall);
 void __sc_renderBatch_Empty(saci_RenderBatch* renderBatch);
 void __sc_renderBatch_Free(saci_RenderBatch* renderBatch);
 
@@ -38,8 +31,20 @@ void __sc_resizeVBO(sc_Renderer* renderer, saci_u32 newCapacity);
 void __sc_initRenderer_VBO_VAO(sc_Renderer* renderer);
 void __sc_initRendererShaderProgram(sc_Renderer* renderer);
 void __sc_initRenderer(sc_Renderer* renderer);
+void __sc_initRendererHeadless(sc_Renderer* renderer);
+
+void __sc_setRenderUniform(sc_Renderer* renderer);
+// Polygon mode and depth test from config, on the current context
+void __sc_applyGLState(const sc_RenderConfig* config);
 
-void __sc_setRenderUniform(sc_Renderer* renderer, const sc_Camera* camera);
+// Shared by the OpenGL and null backends so both walk the batch the same way
+void __sc_uploadBatch(sc_Renderer* renderer);
+void __sc_submitBatch(sc_Renderer* renderer, saci_RenderPass pass);
+// Everything the OpenGL and null backends issue for a frame, both passes
+void __sc_submitFrame(sc_Renderer* renderer, const sc_RenderConfig* config);
+void __sc_readSamplesQuery(sc_Renderer* renderer);
+
+void __sc_renderStats_Add(sc_RenderStats* total, const sc_RenderStats* frame);
 
 //----------------------------------------------------------------------------//
 // Base Definitions
@@ -51,75 +56,117 @@ void __sc_setRenderUniform(sc_Renderer* renderer, const sc_Camera* camera);
 
 #define SACI_DEFAULT_TEXTURE_BUFFER_SIZE 8
 
-typedef struct saci_Vertice {
-    saci_Vec3 pos;
-    saci_Color color;
-    saci_Vec2 texCoord;
-} saci_Vertice;
-
-typedef struct saci_RenderCall {
-    saci_Vertice* vertices; // from opengl dot to opengl quad 0-7
-    int drawMode;           // LINE TRIANGLE or QUAD
-    saci_TextureID textureID;
-} saci_RenderCall;
-
-typedef struct saci_RenderBatch {
-    saci_RenderCall* drawCalls;
-    saci_u32 capacity;
-    saci_u32 drawCallCount;
-} saci_RenderBatch;
-
-struct sc_Renderer {
-    saci_u32 vao, vbo;
-
-    saci_u32 shaderProgram;
-
-    saci_RenderBatch renderBatch;
+// Defaults for renderers without their own config
+static sc_RenderConfig sc_renderConfig = {
+    .projectionMode = SACI_RENDER_ORTHOGRAPHIC_PROJECTION,
+    .customProjectionFunction = NULL,
+    .shouldFillShape = SACI_TRUE, // OpenGL's default polygon mode
+    .useZBuffer = SACI_FALSE,
+    .depthPrePass = SACI_FALSE,
+    .alphaBlending = SACI_FALSE,
 };
 
-static struct sc_RenderConfig {
-    sc_RendererProjectionMode projectionMode;
-    sc_RendererCustomProjectionFunction customProjectionFunction;
-
-    bool shouldFillShape;
-} sc_renderConfig;
-
 //----------------------------------------------------------------------------//
 // Render Initialization/Deletion
 //----------------------------------------------------------------------------//
 
 sc_Renderer* sc_CreateRenderer(saci_Bool generateDefaults) {
-    sc_Renderer* renderer = (sc_Renderer*)malloc(sizeof(sc_Renderer));
+    return sc_CreateRendererWithBackend(SACI_RENDER_BACKEND_OPENGL, generateDefaults);
+}
+
+sc_Renderer* sc_CreateRendererWithBackend(sc_RendererBackend backend, saci_Bool generateDefaults) {
+    // Zeroed, so everything generateDefaults leaves out is empty and safe to
+    // delete
+    sc_Renderer* renderer = (sc_Renderer*)calloc(1, sizeof(sc_Renderer));
     assert(renderer);
+    renderer->backend = backend;
+    renderer->lodHysteresis = 0.1f;
+    __sc_initializeRenderValues(renderer);
     if (generateDefaults) {
-        __sc_initRenderer(renderer);
+        switch (backend) {
+            case SACI_RENDER_BACKEND_OPENGL: {
+                __sc_initRenderer(renderer);
+                break;
+            }
+            case SACI_RENDER_BACKEND_SOFTWARE:
+            case SACI_RENDER_BACKEND_NULL: {
+                __sc_initRendererHeadless(renderer);
+                break;
+            }
+        }
     }
     return renderer;
 }
 
 void sc_DeleteRenderer(sc_Renderer* renderer) {
-    glDeleteBuffers(1, &renderer->vbo);
-    glDeleteVertexArrays(1, &renderer->vao);
-
-    glDeleteProgram(renderer->shaderProgram);
+    free(renderer->renderBatch.vertices);
+    renderer->renderBatch.vertices = NULL;
+    free(renderer->renderBatch.drawCalls);
+    renderer->renderBatch.drawCalls = NULL;
+    free(renderer->meshDraws);
+    renderer->meshDraws = NULL;
+    free(renderer->staticBatches);
+    renderer->staticBatches = NULL;
+    __sc_shape_deleteRendererObjects(renderer);
+    free(renderer->fontUses);
+    renderer->fontUses = NULL;
+    free(renderer->sdfInstances);
+    renderer->sdfInstances = NULL;
+    // Only acquired with a GL context, the pool is empty otherwise
+    __sc_renderTarget_deleteRendererObjects(renderer);
+    __sc_mesh_deleteRendererObjects(renderer);
+    switch (renderer->backend) {
+        case SACI_RENDER_BACKEND_OPENGL: {
+            glDeleteBuffers(1, &renderer->vbo);
+            glDeleteVertexArrays(1, &renderer->vao);
+            __sc_staticBatch_deleteRendererObjects(renderer);
+            __sc_sdf_deleteRendererObjects(renderer);
+            if (renderer->samplesQuery) glDeleteQueries(1, &renderer->samplesQuery);
+
+            glDeleteProgram(renderer->shaderProgram);
+            break;
+        }
+        case SACI_RENDER_BACKEND_SOFTWARE: {
+            __sc_software_delete(renderer);
+            break;
+        }
+        case SACI_RENDER_BACKEND_NULL: {
+            break;
+        }
+    }
+    free(renderer);
 }
 
 //----------------------------------------------------------------------------//
 // Renderer config
 //----------------------------------------------------------------------------//
 
+void sc_RenderSetConfig(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    renderer->hasConfig = config != NULL;
+    if (config != NULL) {
+        renderer->config = *config;
+    }
+}
+
+sc_RenderConfig sc_RenderGetConfig(const sc_Renderer* renderer) {
+    return *__sc_getRenderConfig(renderer);
+}
+
+sc_RenderConfig sc_RenderGetDefaultConfig(void) {
+    return sc_renderConfig;
+}
+
+// GL state follows at the next sc_RenderEnd of each renderer
 void sc_RenderSetNoFillMode(void) {
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     sc_renderConfig.shouldFillShape = SACI_FALSE;
 }
 
 void sc_RenderSetFillMode(void) {
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
     sc_renderConfig.shouldFillShape = SACI_TRUE;
 }
 
 void sc_RenderEnableZBuffer(void) {
-    glEnable(GL_DEPTH_TEST);
+    sc_renderConfig.useZBuffer = SACI_TRUE;
 }
 
 void sc_RenderSetProjectionMode(sc_RendererProjectionMode renderProjectionMode) {
@@ -134,51 +181,95 @@ void sc_RenderSetCustomProjectionMode(sc_RendererCustomProjectionFunction render
 // Renderer Usage
 //----------------------------------------------------------------------------//
 
+void sc_RenderGetStats(const sc_Renderer* renderer, sc_RenderStats* lastFrame, sc_RenderStats* total) {
+    if (lastFrame) *lastFrame = renderer->frameStats;
+    if (total) *total = renderer->totalStats;
+}
+
+void sc_RenderResetStats(sc_Renderer* renderer) {
+    memset(&renderer->frameStats, 0, sizeof(sc_RenderStats));
+    memset(&renderer->totalStats, 0, sizeof(sc_RenderStats));
+}
+
+void sc_RenderSetOverdrawCounter(sc_Renderer* renderer, saci_Bool enabled) {
+    renderer->overdrawCounter = enabled;
+}
+
 void sc_RenderBegin(sc_Renderer* renderer) {
+    // The batch keeps its storage, next frame's pushes overwrite it
     renderer->renderBatch.drawCallCount = 0;
+    renderer->renderBatch.vertexCount = 0;
+    renderer->meshDrawCount = 0;
+    renderer->staticBatchCount = 0;
+    renderer->sdfInstanceCount = 0;
+    renderer->fontUseCount = 0;
+    renderer->target = NULL;
+    renderer->frameIndex++;
 }
 
 void sc_RenderEnd(sc_Renderer* renderer, const sc_Camera* camera) {
-    glUseProgram(renderer->shaderProgram);
-
-    __sc_setRenderUniform(renderer, camera);
-
-    glBindVertexArray(renderer->vao);
-    glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    memset(&renderer->frameStats, 0, sizeof(sc_RenderStats));
+    const sc_RenderConfig* config = __sc_getRenderConfig(renderer);
+
+    // Frontend work, every backend goes through it
+    renderer->frame.hasCamera = camera != NULL;
+    renderer->frame.cameraValid = SACI_FALSE;
+    renderer->frame.depthPrePass = config->depthPrePass && config->useZBuffer && !config->alphaBlending &&
+                                   renderer->backend != SACI_RENDER_BACKEND_SOFTWARE;
+    if (camera != NULL) {
+        renderer->frame.cameraValid = __sc_updateRendererCamera(renderer, config, camera);
+        renderer->frame.camera = renderer->camera;
+        renderer->frame.view = renderer->camera.view;
+        renderer->frame.projection = renderer->camera.projection;
+    }
+    __sc_font_prepareDraws(renderer);
+    __sc_staticBatch_prepareDraws(renderer);
+    __sc_mesh_prepareDraws(renderer, config);
+    __sc_sdf_prepareDraws(renderer);
+
+    // Shapes pushed for the next frame are tessellated for this one's pixels
+    int viewportHeight = 0;
+    if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) {
+        sc_RenderSoftwareGetPixels(renderer, NULL, &viewportHeight);
+    } else if (renderer->target) {
+        sc_RenderTargetGetSize(renderer->target, NULL, &viewportHeight);
+    } else if (renderer->backend == SACI_RENDER_BACKEND_OPENGL) {
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        viewportHeight = viewport[3];
+    }
+    __sc_shape_updatePixelSize(renderer, viewportHeight);
 
     for (saci_u32 i = 0; i < renderer->renderBatch.drawCallCount; ++i) {
         saci_RenderCall* call = &renderer->renderBatch.drawCalls[i];
+        renderer->frameStats.vertices += call->vertexCount;
+        if (call->drawMode != GL_LINES) renderer->frameStats.triangles += call->vertexCount / 3;
+    }
 
-        if (call->textureID != 0) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, call->textureID);
+    switch (renderer->backend) {
+        case SACI_RENDER_BACKEND_OPENGL:
+        case SACI_RENDER_BACKEND_NULL: {
+            saci_Bool toTarget = renderer->target && renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+            if (toTarget) __sc_renderTarget_bind(renderer);
+            __sc_submitFrame(renderer, config);
+            if (toTarget) __sc_renderTarget_finish(renderer);
+            if (renderer->backend == SACI_RENDER_BACKEND_OPENGL) __sc_renderTarget_evictPool(renderer);
+            break;
         }
-
-        saci_u32 vertexCount = 0;
-        if (call->drawMode == GL_TRIANGLES) {
-            vertexCount = 3; // Triangle needs 3 vertices
-        } else if (call->drawMode == GL_QUADS) {
-            vertexCount = 6; // A quad uses 6 vertices (2 triangles)
-        } else if (call->drawMode == GL_LINES) {
-            vertexCount = 2; // Line needs 2 vertices
+        case SACI_RENDER_BACKEND_SOFTWARE: {
+            // Meshes, static batches and SDF primitives were expanded into the
+            // batch above
+            __sc_software_renderEnd(renderer, config);
+            break;
         }
+    }
 
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(saci_Vertice) * vertexCount, call->vertices);
-
-        if (call->drawMode == GL_TRIANGLES) {
-            glDrawArrays(GL_TRIANGLES, 0, 3); // Draw 1 triangle
-        } else if (call->drawMode == GL_QUADS) {
-            glDrawArrays(GL_TRIANGLES, 0, 6); // Draw 2 triangles (6 vertices) for the quad
-        } else if (call->drawMode == GL_LINES) {
-            glDrawArrays(GL_LINES, 0, 2); // Draw 1 line (2 vertices)
-        }
+    renderer->frameStats.frames = 1;
+    __sc_renderStats_Add(&renderer->totalStats, &renderer->frameStats);
 
-        if (call->textureID != 0) {
-            glBindTexture(GL_TEXTURE_2D, 0);
-        }
+    if (renderer->capture) {
+        __sc_capture_writeFrame(renderer, config);
     }
-    glBindVertexArray(0);
-    glUseProgram(0);
 }
 
 void sc_RenderPushTriangleTexture(sc_Renderer* renderer,
@@ -187,12 +278,11 @@ void sc_RenderPushTriangleTexture(sc_Renderer* renderer,
                                   const saci_Vec2 aUV, const saci_Vec2 bUV, const saci_Vec2 cUV,
                                   const saci_TextureID texID) {
     saci_Vertice vertices[] = {
-        (saci_Vertice){a, aColor, aUV},
-        (saci_Vertice){b, bColor, bUV},
-        (saci_Vertice){c, cColor, cUV},
+        (saci_Vertice){a, saci_ColorU8FromColor(aColor), aUV},
+        (saci_Vertice){b, saci_ColorU8FromColor(bColor), bUV},
+        (saci_Vertice){c, saci_ColorU8FromColor(cColor), cUV},
     };
-    saci_RenderCall renderCall = __sc_renderCall_create(vertices, GL_TRIANGLES, texID, 3);
-    __sc_renderBatch_AddTo(&renderer->renderBatch, renderCall);
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, texID, 3);
 }
 
 void sc_RenderPushTriangle2D(sc_Renderer* renderer,
@@ -203,24 +293,106 @@ void sc_RenderPushTriangle2D(sc_Renderer* renderer,
     saci_Vec3 c3 = {c.x, c.y, depth};
 
     saci_Vertice vertices[] = {
-        (saci_Vertice){a3, aColor, {0, 0}},
-        (saci_Vertice){b3, bColor, {0, 0}},
-        (saci_Vertice){c3, cColor, {0, 0}},
+        (saci_Vertice){a3, saci_ColorU8FromColor(aColor), {0, 0}},
+        (saci_Vertice){b3, saci_ColorU8FromColor(bColor), {0, 0}},
+        (saci_Vertice){c3, saci_ColorU8FromColor(cColor), {0, 0}},
     };
-    saci_RenderCall renderCall = __sc_renderCall_create(vertices, GL_TRIANGLES, 0, 3);
-    __sc_renderBatch_AddTo(&renderer->renderBatch, renderCall);
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, 0, 3);
 }
 
 void sc_RenderPushTriangle3D(sc_Renderer* renderer,
                              const saci_Vec3 a, const saci_Vec3 b, const saci_Vec3 c,
                              const saci_Color aColor, const saci_Color bColor, const saci_Color cColor) {
     saci_Vertice vertices[] = {
-        (saci_Vertice){a, aColor, {0, 0}},
-        (saci_Vertice){b, bColor, {0, 0}},
-        (saci_Vertice){c, cColor, {0, 0}},
+        (saci_Vertice){a, saci_ColorU8FromColor(aColor), {0, 0}},
+        (saci_Vertice){b, saci_ColorU8FromColor(bColor), {0, 0}},
+        (saci_Vertice){c, saci_ColorU8FromColor(cColor), {0, 0}},
     };
-    saci_RenderCall renderCall = __sc_renderCall_create(vertices, GL_TRIANGLES, 0, 3);
-    __sc_renderBatch_AddTo(&renderer->renderBatch, renderCall);
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, 0, 3);
+}
+
+void sc_RenderPushTriangles3D(sc_Renderer* renderer, const saci_Vec3* positions, const saci_Color* colors,
+                              size_t count) {
+    sc_RenderPushTrianglesTexture(renderer, positions, colors, NULL, count, 0);
+}
+
+void sc_RenderPushTriangles2D(sc_Renderer* renderer, const saci_Vec2* positions, float depth,
+                              const saci_Color* colors, size_t count) {
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, 0, (saci_u32)count);
+    if (!vertices) return;
+    saci_ColorU8 white = {255, 255, 255, 255};
+    for (size_t i = 0; i < count; ++i) {
+        saci_ColorU8 color = colors ? saci_ColorU8FromColor(colors[i]) : white;
+        vertices[i] = (saci_Vertice){{positions[i].x, positions[i].y, depth}, color, {0, 0}};
+    }
+}
+
+void sc_RenderPushTrianglesTexture(sc_Renderer* renderer, const saci_Vec3* positions, const saci_Color* colors,
+                                   const saci_Vec2* uvs, size_t count, const saci_TextureID texID) {
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, texID, (saci_u32)count);
+    if (!vertices) return;
+    saci_ColorU8 white = {255, 255, 255, 255};
+    for (size_t i = 0; i < count; ++i) {
+        saci_ColorU8 color = colors ? saci_ColorU8FromColor(colors[i]) : white;
+        vertices[i] = (saci_Vertice){positions[i], color, uvs ? uvs[i] : (saci_Vec2){0, 0}};
+    }
+}
+
+void sc_RenderPushTriangle2DHex(sc_Renderer* renderer,
+                                const saci_Vec2 a, const saci_Vec2 b, const saci_Vec2 c, float depth,
+                                saci_u32 aColor, saci_u32 bColor, saci_u32 cColor) {
+    saci_Vertice vertices[] = {
+        (saci_Vertice){{a.x, a.y, depth}, saci_ColorU8FromHex(aColor), {0, 0}},
+        (saci_Vertice){{b.x, b.y, depth}, saci_ColorU8FromHex(bColor), {0, 0}},
+        (saci_Vertice){{c.x, c.y, depth}, saci_ColorU8FromHex(cColor), {0, 0}},
+    };
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, 0, 3);
+}
+
+void sc_RenderPushTriangle3DHex(sc_Renderer* renderer,
+                                const saci_Vec3 a, const saci_Vec3 b, const saci_Vec3 c,
+                                saci_u32 aColor, saci_u32 bColor, saci_u32 cColor) {
+    saci_Vertice vertices[] = {
+        (saci_Vertice){a, saci_ColorU8FromHex(aColor), {0, 0}},
+        (saci_Vertice){b, saci_ColorU8FromHex(bColor), {0, 0}},
+        (saci_Vertice){c, saci_ColorU8FromHex(cColor), {0, 0}},
+    };
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, 0, 3);
+}
+
+void sc_RenderPushTriangles3DHex(sc_Renderer* renderer, const saci_Vec3* positions, const saci_u32* colors,
+                                 size_t count) {
+    sc_RenderPushTrianglesTextureHex(renderer, positions, colors, NULL, count, 0);
+}
+
+void sc_RenderPushTriangles2DHex(sc_Renderer* renderer, const saci_Vec2* positions, float depth,
+                                 const saci_u32* colors, size_t count) {
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, 0, (saci_u32)count);
+    if (!vertices) return;
+    for (size_t i = 0; i < count; ++i) {
+        saci_ColorU8 color = saci_ColorU8FromHex(colors ? colors[i] : 0xFFFFFFFF);
+        vertices[i] = (saci_Vertice){{positions[i].x, positions[i].y, depth}, color, {0, 0}};
+    }
+}
+
+void sc_RenderPushTrianglesTextureHex(sc_Renderer* renderer, const saci_Vec3* positions, const saci_u32* colors,
+                                      const saci_Vec2* uvs, size_t count, const saci_TextureID texID) {
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, texID, (saci_u32)count);
+    if (!vertices) return;
+    for (size_t i = 0; i < count; ++i) {
+        saci_ColorU8 color = saci_ColorU8FromHex(colors ? colors[i] : 0xFFFFFFFF);
+        vertices[i] = (saci_Vertice){positions[i], color, uvs ? uvs[i] : (saci_Vec2){0, 0}};
+    }
+}
+
+void sc_RenderPushVertices(sc_Renderer* renderer, const saci_Vertice* vertices, size_t count,
+                           const saci_TextureID texID) {
+    if (count == 0) return;
+    __sc_renderBatch_AddTo(&renderer->renderBatch, vertices, GL_TRIANGLES, texID, (saci_u32)count);
 }
 
 //----------------------------------------------------------------------------//
@@ -231,28 +403,58 @@ void __sc_initializeRenderValues(sc_Renderer* renderer) {
     renderer->renderBatch.drawCalls = NULL;
     renderer->renderBatch.drawCallCount = 0;
     renderer->renderBatch.capacity = 0;
+    renderer->renderBatch.vertices = NULL;
+    renderer->renderBatch.vertexCount = 0;
+    renderer->renderBatch.vertexCapacity = 0;
+
+    memset(&renderer->frame, 0, sizeof(renderer->frame));
+    renderer->camera = sc_GenerateDefaultCamera3D();
+    renderer->uploadedCameraVersion = 0;
+    memset(&renderer->frameStats, 0, sizeof(sc_RenderStats));
+    memset(&renderer->totalStats, 0, sizeof(sc_RenderStats));
 }
 
-saci_RenderCall __sc_renderCall_create(saci_Vertice* vertices, int drawMode, saci_TextureID texID, saci_u64 verticesAmount) {
-    saci_RenderCall renderCall = {0};
-    if (!vertices || verticesAmount == 0) {
-        fprintf(stderr, "Invalid vertices or size.\n");
-        return renderCall;
+saci_Vertice* __sc_renderBatch_Reserve(saci_RenderBatch* renderBatch, int drawMode, saci_TextureID texID,
+                                       saci_u32 vertexCount) {
+    saci_Bool lines = drawMode == GL_LINES;
+    if (!lines && drawMode != GL_TRIANGLES && drawMode != GL_QUADS) {
+        fprintf(stderr, "Invalid draw mode.\n");
+        return NULL;
     }
-    if (drawMode < 0 || drawMode > 7) { // TODO recreate opengl types
+    if (vertexCount == 0 || vertexCount % (lines ? 2 : 3) != 0) {
         fprintf(stderr, "Invalid vertices or size.\n");
-        return renderCall;
+        return NULL;
     }
-    renderCall.vertices = (saci_Vertice*)malloc(verticesAmount * sizeof(saci_Vertice));
-    if (!renderCall.vertices) {
-        fprintf(stderr, "Memory allocation failed.\n");
-        return renderCall;
+
+    if (renderBatch->vertexCount + vertexCount > renderBatch->vertexCapacity) {
+        saci_u32 capacity = renderBatch->vertexCapacity ? renderBatch->vertexCapacity : SACI_DEFAULT_VERTEX_BUFFER_SIZE;
+        while (capacity < renderBatch->vertexCount + vertexCount) capacity *= 2;
+        saci_Vertice* vertices = (saci_Vertice*)realloc(renderBatch->vertices, capacity * sizeof(saci_Vertice));
+        if (!vertices) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        renderBatch->vertices = vertices;
+        renderBatch->vertexCapacity = capacity;
+    }
+
+    // Same texture and primitive as the last call, it just gets longer
+    saci_RenderCall* last = renderBatch->drawCallCount ? &renderBatch->drawCalls[renderBatch->drawCallCount - 1] : NULL;
+    if (!last || last->textureID != texID || (last->drawMode == GL_LINES) != lines) {
+        if (renderBatch->capacity <= renderBatch->drawCallCount) {
+            __sc_renderBatch_ResizeInternal(renderBatch, renderBatch->capacity ? renderBatch->capacity * 2 : SACI_DEFAULT_VERTEX_BUFFER_SIZE);
+        }
+        if (renderBatch->capacity <= renderBatch->drawCallCount) {
+            return NULL;
+        }
+        last = &renderBatch->drawCalls[renderBatch->drawCallCount++];
+        *last = (saci_RenderCall){renderBatch->vertexCount, 0, drawMode, texID};
     }
-    memcpy(renderCall.vertices, vertices, verticesAmount * sizeof(saci_Vertice));
-    renderCall.drawMode = drawMode;
-    renderCall.textureID = texID;
+    last->vertexCount += vertexCount;
 
-    return renderCall;
+    saci_Vertice* reserved = renderBatch->vertices + renderBatch->vertexCount;
+    renderBatch->vertexCount += vertexCount;
+    return reserved;
 }
 
 void __sc_renderBatch_ResizeInternal(saci_RenderBatch* renderBatch, saci_u32 newSize) {
@@ -271,22 +473,26 @@ void __sc_renderBatch_ResizeInternal(saci_RenderBatch* renderBatch, saci_u32 new
     renderBatch->capacity = newSize;
 }
 
-void __sc_renderBatch_AddTo(saci_RenderBatch* renderBatch, saci_RenderCall renderCall) {
-    if (renderBatch->capacity <= renderBatch->drawCallCount) {
-        // TODO
+void __sc_renderBatch_AddTo(saci_RenderBatch* renderBatch, const saci_Vertice* vertices, int drawMode,
+                            saci_TextureID texID, saci_u32 vertexCount) {
+    if (!vertices) {
+        fprintf(stderr, "Invalid vertices or size.\n");
         return;
     }
-    renderBatch->drawCalls[renderBatch->drawCallCount] = renderCall;
-    renderBatch->drawCallCount++;
+    saci_Vertice* reserved = __sc_renderBatch_Reserve(renderBatch, drawMode, texID, vertexCount);
+    if (reserved) memcpy(reserved, vertices, vertexCount * sizeof(saci_Vertice));
 }
 
 void __sc_renderBatch_Empty(saci_RenderBatch* renderBatch) {
     renderBatch->drawCallCount = 0;
     renderBatch->drawCalls = NULL;
+    renderBatch->vertexCount = 0;
+    renderBatch->vertices = NULL;
 }
 
 void __sc_renderBatch_Free(saci_RenderBatch* renderBatch) {
     free(renderBatch->drawCalls);
+    free(renderBatch->vertices);
     free(renderBatch);
 }
 
@@ -297,6 +503,7 @@ void __sc_resizeVBO(sc_Renderer* renderer, saci_u32 newCapacity) {
 
     glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
     glBufferData(GL_ARRAY_BUFFER, newCapacity * sizeof(saci_Vertice), NULL, GL_DYNAMIC_DRAW);
+    renderer->vboCapacity = newCapacity;
 
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -309,9 +516,14 @@ void __sc_initRenderer_VBO_VAO(sc_Renderer* renderer) {
     glGenBuffers(1, &renderer->vbo);
     glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
     glBufferData(GL_ARRAY_BUFFER, renderer->renderBatch.capacity * sizeof(saci_Vertice), NULL, GL_DYNAMIC_DRAW);
+    renderer->vboCapacity = renderer->renderBatch.capacity;
+    __sc_setVertexLayout();
+}
+
+void __sc_setVertexLayout(void) {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(saci_Vertice), (void*)offsetof(saci_Vertice, pos));
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(saci_Vertice), (void*)offsetof(saci_Vertice, color));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(saci_Vertice), (void*)offsetof(saci_Vertice, color));
     glEnableVertexAttribArray(1);
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(saci_Vertice), (void*)offsetof(saci_Vertice, texCoord));
     glEnableVertexAttribArray(2);
@@ -325,6 +537,7 @@ void __sc_initRendererShaderProgram(sc_Renderer* renderer) {
         "layout (location = 1) in vec4 aColor;\n"
         "layout (location = 2) in vec2 aTexCoord;\n"
 
+        "uniform mat4 uModelMatrix;\n"
         "uniform mat4 uViewMatrix;\n"
         "uniform mat4 uProjectionMatrix;\n"
         "uniform bool uUseCam;\n"
@@ -335,9 +548,9 @@ void __sc_initRendererShaderProgram(sc_Renderer* renderer) {
         "void main()\n"
         "{\n"
         "   if(uUseCam){\n"
-        "       gl_Position = uProjectionMatrix * uViewMatrix * vec4(aPos, 1.0);\n"
+        "       gl_Position = uProjectionMatrix * uViewMatrix * uModelMatrix * vec4(aPos, 1.0);\n"
         "   }else {\n"
-        "       gl_Position = vec4(aPos, 1.0);\n"
+        "       gl_Position = uModelMatrix * vec4(aPos, 1.0);\n"
         "   }\n"
         "   vColor = aColor;\n"
         "   vTexCoord = aTexCoord;\n"
@@ -369,12 +582,20 @@ void __sc_initRendererShaderProgram(sc_Renderer* renderer) {
     assert(vShader != 0 && fShader != 0);
     renderer->shaderProgram = sc_GetShaderProgram(vShader, fShader);
     assert(renderer->shaderProgram);
+    renderer->useTextureLoc = glGetUniformLocation(renderer->shaderProgram, "uUseTexture");
+    renderer->modelLoc = glGetUniformLocation(renderer->shaderProgram, "uModelMatrix");
+    renderer->viewLoc = glGetUniformLocation(renderer->shaderProgram, "uViewMatrix");
+    renderer->projectionLoc = glGetUniformLocation(renderer->shaderProgram, "uProjectionMatrix");
+    renderer->useCameraLoc = glGetUniformLocation(renderer->shaderProgram, "uUseCam");
+    renderer->textureLoc = glGetUniformLocation(renderer->shaderProgram, "uTexture");
+
+    // Samplers never change unit
+    glUseProgram(renderer->shaderProgram);
+    glUniform1i(renderer->textureLoc, 0);
+    glUseProgram(0);
 }
 
 void __sc_initRenderer(sc_Renderer* renderer) {
-    // Initializes to remove garbage numbers
-    __sc_initializeRenderValues(renderer);
-
     { // Initializes the vertice and texture buffers with default sizes
         __sc_renderBatch_ResizeInternal(&renderer->renderBatch, SACI_DEFAULT_VERTEX_BUFFER_SIZE);
         assert(renderer->renderBatch.drawCalls);
@@ -385,46 +606,271 @@ void __sc_initRenderer(sc_Renderer* renderer) {
     __sc_initRendererShaderProgram(renderer);
 }
 
-void __sc_setRenderUniform(sc_Renderer* renderer, const sc_Camera* camera) {
-    saci_Mat4 view = {0};
-    saci_Mat4 projection = {0};
+void __sc_initRendererHeadless(sc_Renderer* renderer) {
+    __sc_renderBatch_ResizeInternal(&renderer->renderBatch, SACI_DEFAULT_VERTEX_BUFFER_SIZE);
+    assert(renderer->renderBatch.drawCalls);
+
+    // No GL objects, the software backend keeps its buffers in main memory and
+    // the null backend only counts
+    renderer->vao = 0;
+    renderer->vbo = 0;
+    renderer->shaderProgram = 0;
+    renderer->useTextureLoc = -1;
+    renderer->modelLoc = -1;
+    renderer->viewLoc = -1;
+    renderer->projectionLoc = -1;
+    renderer->useCameraLoc = -1;
+    renderer->textureLoc = -1;
+    if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) {
+        __sc_software_init(renderer);
+    }
+}
+
+const sc_RenderConfig* __sc_getRenderConfig(const sc_Renderer* renderer) {
+    return renderer->hasConfig ? &renderer->config : &sc_renderConfig;
+}
 
-    if (camera == NULL) {
-        int useCamLoc = glGetUniformLocation(renderer->shaderProgram, "uUseCam");
-        glUniform1i(useCamLoc, SACI_FALSE);
+void __sc_applyGLState(const sc_RenderConfig* config) {
+    glPolygonMode(GL_FRONT_AND_BACK, config->shouldFillShape ? GL_FILL : GL_LINE);
+    if (config->useZBuffer) {
+        glEnable(GL_DEPTH_TEST);
+    } else {
+        glDisable(GL_DEPTH_TEST);
+    }
+    if (config->alphaBlending) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    } else {
+        glDisable(GL_BLEND);
+    }
+}
+
+saci_Bool __sc_isGLLoaded(void) {
+    return GLVersion.major != 0;
+}
+
+saci_Bool __sc_updateRendererCamera(sc_Renderer* renderer, const sc_RenderConfig* config, const sc_Camera* camera) {
+    // Only the parameters are taken, the copy keeps its own cache so a camera
+    // the application never updates still skips the rebuild when unchanged
+    sc_Camera* cached = &renderer->camera;
+    cached->position = camera->position;
+    cached->target = camera->target;
+    cached->up = camera->up;
+    cached->fov = camera->fov;
+    cached->aspectRatio = camera->aspectRatio;
+    cached->near = camera->near;
+    cached->far = camera->far;
+    return __sc_camera_update(cached, config->projectionMode, config->customProjectionFunction,
+                              renderer->replayProjection);
+}
+
+void __sc_setRenderUniform(sc_Renderer* renderer) {
+    // Uniforms stay on the program, they only go out when they changed
+    if (!renderer->frame.hasCamera) {
+        if (renderer->uploadedCameraVersion != 0) {
+            glUniform1i(renderer->useCameraLoc, SACI_FALSE);
+            renderer->uploadedCameraVersion = 0;
+        }
+        return;
+    }
+
+    if (!renderer->frame.cameraValid) {
+        return;
+    }
+    const sc_Camera* camera = &renderer->camera;
+    if (renderer->uploadedCameraVersion == camera->version) {
         return;
     }
 
-    view = saci_LookAtMat4(camera->position, camera->target, camera->up);
+    glUniformMatrix4fv(renderer->viewLoc, 1, GL_FALSE, &camera->view.m[0][0]);
+    glUniformMatrix4fv(renderer->projectionLoc, 1, GL_FALSE, &camera->projection.m[0][0]);
+    glUniform1i(renderer->useCameraLoc, SACI_TRUE);
+    renderer->uploadedCameraVersion = camera->version;
+}
 
-    switch (sc_renderConfig.projectionMode) {
-        case SACI_RENDER_ORTHOGRAPHIC_PROJECTION: {
-            projection = saci_OrthoMat4(-1, 1, -1, 1, camera->near, camera->far);
-            break;
+void __sc_submitFrame(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    saci_Bool depthPrePass = renderer->frame.depthPrePass;
+
+    if (issueGL) __sc_applyGLState(config);
+    __sc_uploadBatch(renderer);
+
+    if (depthPrePass) {
+        if (issueGL) {
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
         }
-        case SACI_RENDER_PERSPECTIVE_PROJECTION: {
-            projection = saci_PerspectiveMat4(camera->fov, camera->aspectRatio, camera->near, camera->far);
-            break;
+        __sc_submitBatch(renderer, SACI_RENDER_PASS_DEPTH);
+        __sc_staticBatch_submitDraws(renderer, SACI_RENDER_PASS_DEPTH);
+        __sc_mesh_submitDraws(renderer, config, SACI_RENDER_PASS_DEPTH);
+
+        // Same program and vertices, so the shaded fragments land on exactly
+        // the depth written above
+        if (issueGL) {
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
         }
-        case SACI_RENDER_CUSTOM_PROJECTION: {
-            if (sc_renderConfig.customProjectionFunction == NULL) {
-                return; // TODO: Handle error if no custom projection function is provided
-            }
-            projection = sc_renderConfig.customProjectionFunction(*camera);
-            break;
+    }
+
+    saci_Bool countSamples = issueGL && renderer->overdrawCounter;
+    if (countSamples) {
+        __sc_readSamplesQuery(renderer);
+        // Still in flight, skip this frame rather than wait for it
+        if (!renderer->samplesQueryPending) glBeginQuery(GL_SAMPLES_PASSED, renderer->samplesQuery);
+        else countSamples = SACI_FALSE;
+    }
+
+    __sc_submitBatch(renderer, SACI_RENDER_PASS_SHADE);
+    __sc_staticBatch_submitDraws(renderer, SACI_RENDER_PASS_SHADE);
+    __sc_mesh_submitDraws(renderer, config, SACI_RENDER_PASS_SHADE);
+
+    // Lines left the depth pass out, they are tested against the finished
+    // buffer and land on top of surfaces at their own depth
+    if (depthPrePass) {
+        if (issueGL) glDepthFunc(GL_LEQUAL);
+        __sc_submitBatch(renderer, SACI_RENDER_PASS_LINES);
+    }
+
+    if (countSamples) {
+        glEndQuery(GL_SAMPLES_PASSED);
+        renderer->samplesQueryPending = SACI_TRUE;
+    }
+
+    // Boxes are tested with the usual GL_LESS against the finished buffer
+    if (depthPrePass && issueGL) {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+    __sc_sdf_submitDraws(renderer, config);
+    __sc_mesh_submitQueries(renderer, config);
+}
+
+void __sc_readSamplesQuery(sc_Renderer* renderer) {
+    if (!renderer->samplesQuery) {
+        glGenQueries(1, &renderer->samplesQuery);
+        return;
+    }
+    if (!renderer->samplesQueryPending) return;
+
+    GLuint available = 0;
+    glGetQueryObjectuiv(renderer->samplesQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return;
+    GLuint64 samples = 0;
+    glGetQueryObjectui64v(renderer->samplesQuery, GL_QUERY_RESULT, &samples);
+    renderer->frameStats.samplesShaded = samples;
+    renderer->samplesQueryPending = SACI_FALSE;
+}
+
+void __sc_uploadBatch(sc_Renderer* renderer) {
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    sc_RenderStats* stats = &renderer->frameStats;
+
+    saci_u32 totalVertices = renderer->renderBatch.vertexCount;
+    if (totalVertices == 0) return;
+
+    // One upload for the whole batch, every pass draws from it by offset
+    stats->bufferUploads++;
+    stats->bytesUploaded += sizeof(saci_Vertice) * totalVertices;
+    if (!issueGL) return;
+
+    if (totalVertices > renderer->vboCapacity) {
+        saci_u32 newCapacity = renderer->vboCapacity ? renderer->vboCapacity : SACI_DEFAULT_VERTEX_BUFFER_SIZE;
+        while (newCapacity < totalVertices) newCapacity *= 2;
+        __sc_resizeVBO(renderer, newCapacity);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+    // Invalidating lets the driver hand out fresh storage instead of waiting
+    // for last frame's draws
+    saci_Vertice* mapped = (saci_Vertice*)glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(saci_Vertice) * totalVertices,
+                                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        memcpy(mapped, renderer->renderBatch.vertices, sizeof(saci_Vertice) * totalVertices);
+        if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
+            fprintf(stderr, "Vertex buffer contents were lost while mapped.\n");
         }
+    } else {
+        fprintf(stderr, "Could not map the vertex buffer.\n");
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void __sc_submitBatch(sc_Renderer* renderer, saci_RenderPass pass) {
+    // The null backend walks this exact path, it just never calls into GL
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    saci_Bool shade = pass != SACI_RENDER_PASS_DEPTH;
+    saci_Bool depthPrePass = renderer->frame.depthPrePass;
+    sc_RenderStats* stats = &renderer->frameStats;
+
+    if (issueGL) {
+        glUseProgram(renderer->shaderProgram);
+
+        __sc_setRenderUniform(renderer);
+
+        // Immediate calls are already in world space
+        saci_Mat4 identity = saci_IdentityMat4();
+        glUniformMatrix4fv(renderer->modelLoc, 1, GL_FALSE, &identity.m[0][0]);
+
+        glBindVertexArray(renderer->vao);
+    }
+
+    // Untextured calls must not sample whatever is left on unit 0
+    int useTexture = -1;
+
+    // Pushes with the same texture and primitive were merged into one call
+    // as they came in, e.g. all the glyphs of a string
+    for (saci_u32 i = 0; i < renderer->renderBatch.drawCallCount; ++i) {
+        saci_RenderCall* call = &renderer->renderBatch.drawCalls[i];
+        saci_Bool lines = call->drawMode == GL_LINES;
+        // A line hides next to nothing, and on a surface it ties with the
+        // depth the surface wrote
+        if (depthPrePass && lines != (pass == SACI_RENDER_PASS_LINES)) continue;
+
+        if (shade) {
+            if (call->textureID != 0) {
+                if (issueGL) {
+                    glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, call->textureID);
+                }
+                stats->textureBinds++;
+            }
+            if (useTexture != (call->textureID != 0)) {
+                useTexture = call->textureID != 0;
+                if (issueGL) glUniform1i(renderer->useTextureLoc, useTexture);
+            }
+        }
+
+        // Quads are uploaded as 2 triangles (6 vertices)
+        if (issueGL) {
+            glDrawArrays(lines ? GL_LINES : GL_TRIANGLES, (GLint)call->firstVertex, call->vertexCount);
+        }
+        if (shade) stats->drawCalls++;
+        else stats->depthPrePassDrawCalls++;
 
-    int viewLoc = glGetUniformLocation(renderer->shaderProgram, "uViewMatrix");
-    int projLoc = glGetUniformLocation(renderer->shaderProgram, "uProjectionMatrix");
-    int useCamLoc = glGetUniformLocation(renderer->shaderProgram, "uUseCam");
-    int uTextureLoc = glGetUniformLocation(renderer->shaderProgram, "uTexture");
-    int uUseTextureLoc = glGetUniformLocation(renderer->shaderProgram, "uUseTexture");
+        if (shade && call->textureID != 0) {
+            if (issueGL) glBindTexture(GL_TEXTURE_2D, 0);
+        }
+    }
 
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view.m[0][0]);
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection.m[0][0]);
-    glUniform1i(useCamLoc, SACI_TRUE);
+    if (issueGL) {
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+}
 
-    glUniform1i(uTextureLoc, 0);
-    glUniform1i(uUseTextureLoc, SACI_TRUE);
+void __sc_renderStats_Add(sc_RenderStats* total, const sc_RenderStats* frame) {
+    total->frames += frame->frames;
+    total->drawCalls += frame->drawCalls;
+    total->vertices += frame->vertices;
+    total->triangles += frame->triangles;
+    total->textureBinds += frame->textureBinds;
+    total->bufferUploads += frame->bufferUploads;
+    total->bytesUploaded += frame->bytesUploaded;
+    total->occlusionQueries += frame->occlusionQueries;
+    total->occludedDraws += frame->occludedDraws;
+    total->lodTrianglesSaved += frame->lodTrianglesSaved;
+    total->depthPrePassDrawCalls += frame->depthPrePassDrawCalls;
+    total->samplesShaded += frame->samplesShaded;
 }
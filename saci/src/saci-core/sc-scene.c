@@ -0,0 +1,404 @@
+#include "saci-core/sc-scene.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+typedef struct saci_SceneTransform {
+    saci_Vec3 translation, rotation, scale;
+} saci_SceneTransform;
+
+typedef struct saci_SceneDrawable {
+    sc_Mesh* mesh;
+    sc_SceneDrawCallback callback;
+    void* userData;
+} saci_SceneDrawable;
+
+// Only walked when the order is rebuilt, or to unlink a node
+typedef struct saci_SceneLinks {
+    saci_u32 parent;
+    saci_u32 firstChild, lastChild;
+    saci_u32 nextSibling; // roots are siblings of each other
+} saci_SceneLinks;
+
+struct sc_Scene {
+    // By node ID
+    saci_SceneLinks* links;
+    saci_u32* positions; // into the arrays below, SACI_SCENE_NO_NODE for free IDs
+    saci_u32 idCount, idCapacity;
+    saci_u32* freeIDs;
+    saci_u32 freeCount, freeCapacity;
+    saci_u32 firstRoot, lastRoot;
+    saci_u32 liveCount;
+
+    // By position, parents always ahead of their children
+    saci_SceneTransform* locals;
+    saci_Mat4* worlds;
+    saci_u32* parentPositions;
+    saci_u32* ids; // SACI_SCENE_NO_NODE for deleted nodes until the rebuild
+    saci_SceneDrawable* drawables;
+    saci_u8* dirty; // local transform changed since the last update
+    saci_u32 nodeCount, nodeCapacity;
+
+    // A node was moved or deleted. New nodes go at the end, after their
+    // parent, and keep the order valid but split subtrees up
+    saci_Bool orderDirty;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __sc_scene_reserveNodes(sc_Scene* scene, saci_u32 needed);
+saci_Bool __sc_scene_valid(const sc_Scene* scene, saci_u32 node);
+void __sc_scene_link(sc_Scene* scene, saci_u32 node, saci_u32 parent);
+void __sc_scene_unlink(sc_Scene* scene, saci_u32 node);
+// Depth first walk of root's subtree, SACI_SCENE_NO_NODE as root walks every
+// tree. Returns SACI_SCENE_NO_NODE after the last node
+saci_u32 __sc_scene_next(const sc_Scene* scene, saci_u32 node, saci_u32 root);
+void __sc_scene_rebuildOrder(sc_Scene* scene);
+
+//----------------------------------------------------------------------------//
+// Scene Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_Scene* sc_CreateScene(void) {
+    sc_Scene* scene = (sc_Scene*)calloc(1, sizeof(sc_Scene));
+    assert(scene);
+    scene->firstRoot = SACI_SCENE_NO_NODE;
+    scene->lastRoot = SACI_SCENE_NO_NODE;
+    return scene;
+}
+
+void sc_DeleteScene(sc_Scene* scene) {
+    if (!scene) return;
+    free(scene->links);
+    free(scene->positions);
+    free(scene->freeIDs);
+    free(scene->locals);
+    free(scene->worlds);
+    free(scene->parentPositions);
+    free(scene->ids);
+    free(scene->drawables);
+    free(scene->dirty);
+    free(scene);
+}
+
+//----------------------------------------------------------------------------//
+// Scene Nodes
+//----------------------------------------------------------------------------//
+
+saci_u32 sc_SceneCreateNode(sc_Scene* scene, saci_u32 parent) {
+    if (parent != SACI_SCENE_NO_NODE && !__sc_scene_valid(scene, parent)) {
+        fprintf(stderr, "Invalid scene node parent.\n");
+        return SACI_SCENE_NO_NODE;
+    }
+
+    if (!__sc_scene_reserveNodes(scene, scene->nodeCount + 1)) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_SCENE_NO_NODE;
+    }
+    saci_u32 node;
+    if (scene->freeCount > 0) {
+        node = scene->freeIDs[--scene->freeCount];
+    } else {
+        if (!saci_Reserve((void**)&scene->links, &scene->idCapacity, scene->idCount + 1, sizeof(saci_SceneLinks))) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return SACI_SCENE_NO_NODE;
+        }
+        saci_u32* positions = (saci_u32*)realloc(scene->positions, scene->idCapacity * sizeof(saci_u32));
+        if (!positions) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return SACI_SCENE_NO_NODE;
+        }
+        scene->positions = positions;
+        node = scene->idCount++;
+    }
+
+    saci_u32 position = scene->nodeCount++;
+    scene->positions[node] = position;
+    scene->locals[position] = (saci_SceneTransform){{0, 0, 0}, {0, 0, 0}, {1, 1, 1}};
+    scene->worlds[position] = saci_IdentityMat4();
+    scene->parentPositions[position] = parent == SACI_SCENE_NO_NODE ? SACI_SCENE_NO_NODE : scene->positions[parent];
+    scene->ids[position] = node;
+    scene->drawables[position] = (saci_SceneDrawable){NULL, NULL, NULL};
+    scene->dirty[position] = 1;
+    scene->links[node] = (saci_SceneLinks){SACI_SCENE_NO_NODE, SACI_SCENE_NO_NODE, SACI_SCENE_NO_NODE, SACI_SCENE_NO_NODE};
+    __sc_scene_link(scene, node, parent);
+    scene->liveCount++;
+    return node;
+}
+
+void sc_SceneDeleteNode(sc_Scene* scene, saci_u32 node) {
+    if (!__sc_scene_valid(scene, node)) return;
+
+    // Walked before unlinking, the walk stops at node and never looks at its
+    // siblings
+    saci_u32 freed = 0;
+    for (saci_u32 id = node; id != SACI_SCENE_NO_NODE; id = __sc_scene_next(scene, id, node)) freed++;
+    if (!saci_Reserve((void**)&scene->freeIDs, &scene->freeCapacity, scene->freeCount + freed, sizeof(saci_u32))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+
+    for (saci_u32 id = node; id != SACI_SCENE_NO_NODE; id = __sc_scene_next(scene, id, node)) {
+        saci_u32 position = scene->positions[id];
+        scene->ids[position] = SACI_SCENE_NO_NODE;
+        scene->drawables[position] = (saci_SceneDrawable){NULL, NULL, NULL};
+        scene->freeIDs[scene->freeCount++] = id;
+    }
+    __sc_scene_unlink(scene, node);
+    for (saci_u32 i = scene->freeCount - freed; i < scene->freeCount; ++i) {
+        scene->positions[scene->freeIDs[i]] = SACI_SCENE_NO_NODE;
+    }
+    scene->liveCount -= freed;
+    scene->orderDirty = SACI_TRUE;
+}
+
+void sc_SceneSetParent(sc_Scene* scene, saci_u32 node, saci_u32 parent) {
+    if (!__sc_scene_valid(scene, node)) return;
+    if (parent != SACI_SCENE_NO_NODE && !__sc_scene_valid(scene, parent)) return;
+    if (scene->links[node].parent == parent) return;
+    for (saci_u32 ancestor = parent; ancestor != SACI_SCENE_NO_NODE; ancestor = scene->links[ancestor].parent) {
+        if (ancestor == node) return;
+    }
+
+    __sc_scene_unlink(scene, node);
+    __sc_scene_link(scene, node, parent);
+    saci_u32 position = scene->positions[node];
+    scene->parentPositions[position] = parent == SACI_SCENE_NO_NODE ? SACI_SCENE_NO_NODE : scene->positions[parent];
+    scene->dirty[position] = 1;
+    scene->orderDirty = SACI_TRUE;
+}
+
+saci_u32 sc_SceneGetParent(const sc_Scene* scene, saci_u32 node) {
+    if (!__sc_scene_valid(scene, node)) return SACI_SCENE_NO_NODE;
+    return scene->links[node].parent;
+}
+
+saci_u32 sc_SceneNodeCount(const sc_Scene* scene) {
+    return scene->liveCount;
+}
+
+void sc_SceneSetTransform(sc_Scene* scene, saci_u32 node, saci_Vec3 translation, saci_Vec3 rotation,
+                          saci_Vec3 scale) {
+    if (!__sc_scene_valid(scene, node)) return;
+    saci_u32 position = scene->positions[node];
+    scene->locals[position] = (saci_SceneTransform){translation, rotation, scale};
+    scene->dirty[position] = 1;
+}
+
+void sc_SceneSetTranslation(sc_Scene* scene, saci_u32 node, saci_Vec3 translation) {
+    if (!__sc_scene_valid(scene, node)) return;
+    saci_u32 position = scene->positions[node];
+    scene->locals[position].translation = translation;
+    scene->dirty[position] = 1;
+}
+
+void sc_SceneSetRotation(sc_Scene* scene, saci_u32 node, saci_Vec3 rotation) {
+    if (!__sc_scene_valid(scene, node)) return;
+    saci_u32 position = scene->positions[node];
+    scene->locals[position].rotation = rotation;
+    scene->dirty[position] = 1;
+}
+
+void sc_SceneSetScale(sc_Scene* scene, saci_u32 node, saci_Vec3 scale) {
+    if (!__sc_scene_valid(scene, node)) return;
+    saci_u32 position = scene->positions[node];
+    scene->locals[position].scale = scale;
+    scene->dirty[position] = 1;
+}
+
+void sc_SceneGetTransform(const sc_Scene* scene, saci_u32 node, saci_Vec3* translation, saci_Vec3* rotation,
+                          saci_Vec3* scale) {
+    if (!__sc_scene_valid(scene, node)) return;
+    const saci_SceneTransform* local = &scene->locals[scene->positions[node]];
+    if (translation) *translation = local->translation;
+    if (rotation) *rotation = local->rotation;
+    if (scale) *scale = local->scale;
+}
+
+void sc_SceneSetMesh(sc_Scene* scene, saci_u32 node, sc_Mesh* mesh) {
+    if (!__sc_scene_valid(scene, node)) return;
+    scene->drawables[scene->positions[node]].mesh = mesh;
+}
+
+void sc_SceneSetDrawCallback(sc_Scene* scene, saci_u32 node, sc_SceneDrawCallback callback, void* userData) {
+    if (!__sc_scene_valid(scene, node)) return;
+    saci_SceneDrawable* drawable = &scene->drawables[scene->positions[node]];
+    drawable->callback = callback;
+    drawable->userData = userData;
+}
+
+//----------------------------------------------------------------------------//
+// Scene Usage
+//----------------------------------------------------------------------------//
+
+saci_u32 sc_SceneUpdate(sc_Scene* scene) {
+    if (scene->orderDirty) __sc_scene_rebuildOrder(scene);
+
+    // dirty turns into "world changed" on the way, children only read their
+    // parent's flag after the parent was visited
+    saci_u32 updated = 0;
+    for (saci_u32 i = 0; i < scene->nodeCount; ++i) {
+        saci_u32 parent = scene->parentPositions[i];
+        if (!scene->dirty[i] && (parent == SACI_SCENE_NO_NODE || !scene->dirty[parent])) continue;
+        const saci_SceneTransform* transform = &scene->locals[i];
+        saci_Mat4 local = saci_TRSMat4(transform->translation, transform->rotation, transform->scale);
+        // local first, then the parent's world
+        scene->worlds[i] = parent == SACI_SCENE_NO_NODE ? local : saci_MultiplyMat4(local, scene->worlds[parent]);
+        scene->dirty[i] = 1;
+        updated++;
+    }
+    if (updated > 0) memset(scene->dirty, 0, scene->nodeCount);
+    return updated;
+}
+
+saci_Mat4 sc_SceneGetWorldMatrix(const sc_Scene* scene, saci_u32 node) {
+    if (!__sc_scene_valid(scene, node)) return saci_IdentityMat4();
+    return scene->worlds[scene->positions[node]];
+}
+
+void sc_RenderPushScene(sc_Renderer* renderer, sc_Scene* scene) {
+    sc_SceneUpdate(scene);
+    // Callbacks may add nodes and move the arrays, nothing is kept across them
+    for (saci_u32 i = 0; i < scene->nodeCount; ++i) {
+        saci_SceneDrawable drawable = scene->drawables[i];
+        if (!drawable.mesh && !drawable.callback) continue;
+        saci_Mat4 world = scene->worlds[i];
+        if (drawable.mesh) sc_RenderPushMesh(renderer, drawable.mesh, &world);
+        if (drawable.callback) drawable.callback(renderer, &world, drawable.userData);
+    }
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __sc_scene_reserveNodes(sc_Scene* scene, saci_u32 needed) {
+    if (needed <= scene->nodeCapacity) return SACI_TRUE;
+    saci_u32 capacity = scene->nodeCapacity ? scene->nodeCapacity : 64;
+    while (capacity < needed) capacity *= 2;
+
+    // Each array grows on its own, a failure leaves the larger ones behind,
+    // which is harmless
+    saci_u32 grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->locals, &grown, capacity, sizeof(saci_SceneTransform))) return SACI_FALSE;
+    grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->worlds, &grown, capacity, sizeof(saci_Mat4))) return SACI_FALSE;
+    grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->parentPositions, &grown, capacity, sizeof(saci_u32))) return SACI_FALSE;
+    grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->ids, &grown, capacity, sizeof(saci_u32))) return SACI_FALSE;
+    grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->drawables, &grown, capacity, sizeof(saci_SceneDrawable))) return SACI_FALSE;
+    grown = scene->nodeCapacity;
+    if (!saci_Reserve((void**)&scene->dirty, &grown, capacity, sizeof(saci_u8))) return SACI_FALSE;
+    scene->nodeCapacity = grown;
+    return SACI_TRUE;
+}
+
+saci_Bool __sc_scene_valid(const sc_Scene* scene, saci_u32 node) {
+    return node < scene->idCount && scene->positions[node] != SACI_SCENE_NO_NODE;
+}
+
+void __sc_scene_link(sc_Scene* scene, saci_u32 node, saci_u32 parent) {
+    saci_u32* first = parent == SACI_SCENE_NO_NODE ? &scene->firstRoot : &scene->links[parent].firstChild;
+    saci_u32* last = parent == SACI_SCENE_NO_NODE ? &scene->lastRoot : &scene->links[parent].lastChild;
+    scene->links[node].parent = parent;
+    scene->links[node].nextSibling = SACI_SCENE_NO_NODE;
+    if (*last == SACI_SCENE_NO_NODE) {
+        *first = node;
+    } else {
+        scene->links[*last].nextSibling = node;
+    }
+    *last = node;
+}
+
+void __sc_scene_unlink(sc_Scene* scene, saci_u32 node) {
+    saci_u32 parent = scene->links[node].parent;
+    saci_u32* first = parent == SACI_SCENE_NO_NODE ? &scene->firstRoot : &scene->links[parent].firstChild;
+    saci_u32* last = parent == SACI_SCENE_NO_NODE ? &scene->lastRoot : &scene->links[parent].lastChild;
+
+    saci_u32 previous = SACI_SCENE_NO_NODE;
+    for (saci_u32 sibling = *first; sibling != node; sibling = scene->links[sibling].nextSibling) previous = sibling;
+    if (previous == SACI_SCENE_NO_NODE) {
+        *first = scene->links[node].nextSibling;
+    } else {
+        scene->links[previous].nextSibling = scene->links[node].nextSibling;
+    }
+    if (*last == node) *last = previous;
+    scene->links[node].parent = SACI_SCENE_NO_NODE;
+    scene->links[node].nextSibling = SACI_SCENE_NO_NODE;
+}
+
+saci_u32 __sc_scene_next(const sc_Scene* scene, saci_u32 node, saci_u32 root) {
+    if (scene->links[node].firstChild != SACI_SCENE_NO_NODE) return scene->links[node].firstChild;
+    while (node != root) {
+        if (scene->links[node].nextSibling != SACI_SCENE_NO_NODE) return scene->links[node].nextSibling;
+        node = scene->links[node].parent;
+    }
+    return SACI_SCENE_NO_NODE;
+}
+
+void __sc_scene_rebuildOrder(sc_Scene* scene) {
+    saci_u32 capacity = scene->nodeCapacity;
+    saci_SceneTransform* locals = (saci_SceneTransform*)malloc(capacity * sizeof(saci_SceneTransform));
+    saci_Mat4* worlds = (saci_Mat4*)malloc(capacity * sizeof(saci_Mat4));
+    saci_u32* parentPositions = (saci_u32*)malloc(capacity * sizeof(saci_u32));
+    saci_u32* ids = (saci_u32*)malloc(capacity * sizeof(saci_u32));
+    saci_SceneDrawable* drawables = (saci_SceneDrawable*)malloc(capacity * sizeof(saci_SceneDrawable));
+    saci_u8* dirty = (saci_u8*)malloc(capacity * sizeof(saci_u8));
+    if (!locals || !worlds || !parentPositions || !ids || !drawables || !dirty) {
+        // Only holes are left if nothing was reparented, still correct
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(locals);
+        free(worlds);
+        free(parentPositions);
+        free(ids);
+        free(drawables);
+        free(dirty);
+        return;
+    }
+
+    // Parents are placed first, so their new position is already in
+    // scene->positions when the children come
+    saci_u32 count = 0;
+    saci_u32 node = scene->firstRoot;
+    for (; node != SACI_SCENE_NO_NODE; node = __sc_scene_next(scene, node, SACI_SCENE_NO_NODE)) {
+        saci_u32 old = scene->positions[node];
+        saci_u32 parent = scene->links[node].parent;
+        locals[count] = scene->locals[old];
+        worlds[count] = scene->worlds[old];
+        parentPositions[count] = parent == SACI_SCENE_NO_NODE ? SACI_SCENE_NO_NODE : scene->positions[parent];
+        ids[count] = node;
+        drawables[count] = scene->drawables[old];
+        dirty[count] = scene->dirty[old];
+        scene->positions[node] = count++;
+    }
+    assert(count == scene->liveCount);
+
+    free(scene->locals);
+    free(scene->worlds);
+    free(scene->parentPositions);
+    free(scene->ids);
+    free(scene->drawables);
+    free(scene->dirty);
+    scene->locals = locals;
+    scene->worlds = worlds;
+    scene->parentPositions = parentPositions;
+    scene->ids = ids;
+    scene->drawables = drawables;
+    scene->dirty = dirty;
+    scene->nodeCount = count;
+    scene->orderDirty = SACI_FALSE;
+}
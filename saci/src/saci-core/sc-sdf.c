@@ -0,0 +1,310 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-sdf.h"
+#include "saci-core/sc-shadering.h"
+#include "saci-core/sc-shape.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// saci_SdfInstance.shape.x, the rest of shape per kind:
+//   circle       radius
+//   ring         radius, half thickness
+//   rounded box  half width, half height, corner radius
+//   capsule      half length (along axis), radius
+typedef enum saci_SdfKind {
+    SACI_SDF_CIRCLE = 0,
+    SACI_SDF_RING = 1,
+    SACI_SDF_ROUNDED_BOX = 2,
+    SACI_SDF_CAPSULE = 3,
+} saci_SdfKind;
+
+#define SACI_SDF_MIN_INSTANCE_CAPACITY 256
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_sdf_push(sc_Renderer* renderer, saci_Vec2 center, saci_Vec2 axis, saci_Vec2 halfSize, float depth,
+                   saci_Vec4 shape, saci_Color color);
+saci_Bool __sc_sdf_initProgram(sc_Renderer* renderer);
+
+//----------------------------------------------------------------------------//
+// SDF Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderPushSdfCircle(sc_Renderer* renderer, saci_Vec2 center, float radius, float depth, saci_Color color) {
+    if (radius <= 0.0f) return;
+    __sc_sdf_push(renderer, center, (saci_Vec2){1, 0}, (saci_Vec2){radius, radius}, depth,
+                  (saci_Vec4){SACI_SDF_CIRCLE, radius, 0, 0}, color);
+}
+
+void sc_RenderPushSdfRing(sc_Renderer* renderer, saci_Vec2 center, float radius, float thickness, float depth,
+                          saci_Color color) {
+    if (radius <= 0.0f || thickness <= 0.0f) return;
+    float outer = radius + 0.5f * thickness;
+    __sc_sdf_push(renderer, center, (saci_Vec2){1, 0}, (saci_Vec2){outer, outer}, depth,
+                  (saci_Vec4){SACI_SDF_RING, radius, 0.5f * thickness, 0}, color);
+}
+
+void sc_RenderPushSdfRoundedBox(sc_Renderer* renderer, saci_Vec2 position, saci_Vec2 size, float radius, float depth,
+                                saci_Color color) {
+    if (size.x <= 0.0f || size.y <= 0.0f) return;
+    float maxRadius = 0.5f * (size.x < size.y ? size.x : size.y);
+    if (radius > maxRadius) radius = maxRadius;
+    if (radius < 0.0f) radius = 0.0f;
+    saci_Vec2 half = {0.5f * size.x, 0.5f * size.y};
+    saci_Vec2 center = {position.x + half.x, position.y + half.y};
+    __sc_sdf_push(renderer, center, (saci_Vec2){1, 0}, half, depth,
+                  (saci_Vec4){SACI_SDF_ROUNDED_BOX, half.x, half.y, radius}, color);
+}
+
+void sc_RenderPushSdfCapsule(sc_Renderer* renderer, saci_Vec2 a, saci_Vec2 b, float radius, float depth,
+                             saci_Color color) {
+    if (radius <= 0.0f) return;
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float length = sqrtf(dx * dx + dy * dy);
+    saci_Vec2 axis = length > 0.0f ? (saci_Vec2){dx / length, dy / length} : (saci_Vec2){1, 0};
+    float halfLength = 0.5f * length;
+    saci_Vec2 center = {0.5f * (a.x + b.x), 0.5f * (a.y + b.y)};
+    __sc_sdf_push(renderer, center, axis, (saci_Vec2){halfLength + radius, radius}, depth,
+                  (saci_Vec4){SACI_SDF_CAPSULE, halfLength, radius, 0}, color);
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_sdf_prepareDraws(sc_Renderer* renderer) {
+    if (renderer->backend != SACI_RENDER_BACKEND_SOFTWARE) return;
+    for (saci_u32 i = 0; i < renderer->sdfInstanceCount; ++i) {
+        __sc_sdf_pushTriangles(renderer, &renderer->sdfInstances[i]);
+    }
+}
+
+void __sc_sdf_pushTriangles(sc_Renderer* renderer, const saci_SdfInstance* instance) {
+    saci_Vec2 center = {instance->center.x, instance->center.y};
+    float depth = instance->center.z;
+    saci_Vec4 shape = instance->shape;
+    saci_Color color = instance->color;
+
+    switch ((saci_SdfKind)shape.x) {
+        case SACI_SDF_CIRCLE:
+            sc_RenderPushCircle(renderer, center, shape.y, depth, color);
+            break;
+        case SACI_SDF_RING:
+            sc_RenderPushArc(renderer, center, shape.y, 2.0f * shape.z, 0.0f, 6.28318531f, depth, color);
+            break;
+        case SACI_SDF_ROUNDED_BOX: {
+            saci_Vec2 position = {center.x - shape.y, center.y - shape.z};
+            sc_RenderPushRoundedRect(renderer, position, (saci_Vec2){2.0f * shape.y, 2.0f * shape.z}, shape.w, depth,
+                                     color);
+            break;
+        }
+        case SACI_SDF_CAPSULE: {
+            saci_Vec2 along = {instance->axis.x * shape.y, instance->axis.y * shape.y};
+            saci_Vec2 a = {center.x - along.x, center.y - along.y}, b = {center.x + along.x, center.y + along.y};
+            float radius = shape.z;
+            sc_RenderPushCircle(renderer, a, radius, depth, color);
+            sc_RenderPushCircle(renderer, b, radius, depth, color);
+            if (shape.y == 0.0f) break;
+            saci_Vec2 side = {-instance->axis.y * radius, instance->axis.x * radius};
+            saci_Vec2 a0 = {a.x + side.x, a.y + side.y}, a1 = {a.x - side.x, a.y - side.y};
+            saci_Vec2 b0 = {b.x + side.x, b.y + side.y}, b1 = {b.x - side.x, b.y - side.y};
+            sc_RenderPushTriangle2D(renderer, a1, b1, b0, depth, color, color, color);
+            sc_RenderPushTriangle2D(renderer, a1, b0, a0, depth, color, color, color);
+            break;
+        }
+    }
+}
+
+void __sc_sdf_submitDraws(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    saci_u32 count = renderer->sdfInstanceCount;
+    if (count == 0) return;
+
+    sc_RenderStats* stats = &renderer->frameStats;
+    stats->drawCalls++;
+    stats->vertices += 4ull * count;
+    stats->triangles += 2ull * count;
+    stats->bufferUploads++;
+    stats->bytesUploaded += sizeof(saci_SdfInstance) * count;
+    if (renderer->backend != SACI_RENDER_BACKEND_OPENGL) return;
+    if (!renderer->sdfProgram && !__sc_sdf_initProgram(renderer)) return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->sdfVbo);
+    if (count > renderer->sdfVboCapacity) {
+        saci_u32 capacity = renderer->sdfVboCapacity ? renderer->sdfVboCapacity : SACI_SDF_MIN_INSTANCE_CAPACITY;
+        while (capacity < count) capacity *= 2;
+        glBufferData(GL_ARRAY_BUFFER, sizeof(saci_SdfInstance) * capacity, NULL, GL_STREAM_DRAW);
+        renderer->sdfVboCapacity = capacity;
+    }
+    // Same as the batch, fresh storage instead of waiting on last frame
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, sizeof(saci_SdfInstance) * count,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        fprintf(stderr, "Could not map the SDF instance buffer.\n");
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    memcpy(mapped, renderer->sdfInstances, sizeof(saci_SdfInstance) * count);
+    if (!glUnmapBuffer(GL_ARRAY_BUFFER)) {
+        fprintf(stderr, "SDF instance buffer contents were lost while mapped.\n");
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glUseProgram(renderer->sdfProgram);
+    saci_Bool useCamera = renderer->frame.hasCamera && renderer->frame.cameraValid;
+    if (useCamera) {
+        glUniformMatrix4fv(renderer->sdfViewLoc, 1, GL_FALSE, &renderer->camera.view.m[0][0]);
+        glUniformMatrix4fv(renderer->sdfProjectionLoc, 1, GL_FALSE, &renderer->camera.projection.m[0][0]);
+    }
+    glUniform1i(renderer->sdfUseCameraLoc, useCamera);
+
+    // Edges need blending, and a soft edge writing depth would hide the
+    // primitives behind it at the same depth
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (config->useZBuffer) glDepthMask(GL_FALSE);
+
+    glBindVertexArray(renderer->sdfVao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    if (config->useZBuffer) glDepthMask(GL_TRUE);
+    if (!config->alphaBlending) glDisable(GL_BLEND);
+}
+
+void __sc_sdf_deleteRendererObjects(sc_Renderer* renderer) {
+    if (renderer->sdfProgram) glDeleteProgram(renderer->sdfProgram);
+    if (renderer->sdfVao) glDeleteVertexArrays(1, &renderer->sdfVao);
+    if (renderer->sdfVbo) glDeleteBuffers(1, &renderer->sdfVbo);
+    renderer->sdfProgram = renderer->sdfVao = renderer->sdfVbo = renderer->sdfVboCapacity = 0;
+}
+
+void __sc_sdf_push(sc_Renderer* renderer, saci_Vec2 center, saci_Vec2 axis, saci_Vec2 halfSize, float depth,
+                   saci_Vec4 shape, saci_Color color) {
+    if (renderer->sdfInstanceCount == renderer->sdfInstanceCapacity) {
+        saci_u32 capacity =
+            renderer->sdfInstanceCapacity ? renderer->sdfInstanceCapacity * 2 : SACI_SDF_MIN_INSTANCE_CAPACITY;
+        saci_SdfInstance* instances =
+            (saci_SdfInstance*)realloc(renderer->sdfInstances, capacity * sizeof(saci_SdfInstance));
+        if (!instances) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        renderer->sdfInstances = instances;
+        renderer->sdfInstanceCapacity = capacity;
+    }
+    // A pixel around the shape for the outer half of the soft edge
+    float margin = __sc_shape_pixelSize(renderer);
+    renderer->sdfInstances[renderer->sdfInstanceCount++] = (saci_SdfInstance){
+        .center = {center.x, center.y, depth},
+        .axis = axis,
+        .extent = {halfSize.x + margin, halfSize.y + margin},
+        .shape = shape,
+        .color = color,
+    };
+}
+
+saci_Bool __sc_sdf_initProgram(sc_Renderer* renderer) {
+    const char* vShaderSource =
+        "#version 330 core\n"
+
+        "layout (location = 0) in vec3 aCenter;\n"
+        "layout (location = 1) in vec2 aAxis;\n"
+        "layout (location = 2) in vec2 aExtent;\n"
+        "layout (location = 3) in vec4 aShape;\n"
+        "layout (location = 4) in vec4 aColor;\n"
+
+        "uniform mat4 uViewMatrix;\n"
+        "uniform mat4 uProjectionMatrix;\n"
+        "uniform bool uUseCam;\n"
+
+        "out vec2 vLocal;\n"
+        "flat out vec4 vShape;\n"
+        "flat out vec4 vColor;\n"
+
+        "void main()\n"
+        "{\n"
+        // Strip corners from the vertex index, no per-vertex buffer
+        "   vec2 corner = vec2((gl_VertexID & 1) != 0 ? 1.0 : -1.0, (gl_VertexID & 2) != 0 ? 1.0 : -1.0);\n"
+        "   vLocal = corner * aExtent;\n"
+        "   vec2 side = vec2(-aAxis.y, aAxis.x);\n"
+        "   vec4 position = vec4(aCenter.xy + aAxis * vLocal.x + side * vLocal.y, aCenter.z, 1.0);\n"
+        "   gl_Position = uUseCam ? uProjectionMatrix * uViewMatrix * position : position;\n"
+        "   vShape = aShape;\n"
+        "   vColor = aColor;\n"
+        "}\n\0";
+
+    const char* fShaderSource =
+        "#version 330 core\n"
+
+        "in vec2 vLocal;\n"
+        "flat in vec4 vShape;\n"
+        "flat in vec4 vColor;\n"
+
+        "out vec4 FragColor;\n"
+
+        "void main()\n"
+        "{\n"
+        "   vec2 p = vLocal;\n"
+        "   int kind = int(vShape.x + 0.5);\n"
+        "   float d;\n"
+        "   if (kind == 0) {\n"
+        "       d = length(p) - vShape.y;\n"
+        "   } else if (kind == 1) {\n"
+        "       d = abs(length(p) - vShape.y) - vShape.z;\n"
+        "   } else if (kind == 2) {\n"
+        "       vec2 q = abs(p) - vShape.yz + vShape.w;\n"
+        "       d = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - vShape.w;\n"
+        "   } else {\n"
+        "       p.x -= clamp(p.x, -vShape.y, vShape.y);\n"
+        "       d = length(p) - vShape.z;\n"
+        "   }\n"
+        // Distance in pixels from the screen space gradient, half a pixel
+        // either side of the edge is blended
+        "   float pixel = length(vec2(dFdx(d), dFdy(d)));\n"
+        "   float coverage = clamp(0.5 - d / max(pixel, 1e-6), 0.0, 1.0);\n"
+        "   if (coverage <= 0.0) discard;\n"
+        "   FragColor = vec4(vColor.rgb, vColor.a * coverage);\n"
+        "}\n\0";
+
+    saci_u32 vShader = sc_CompileShaderV(vShaderSource);
+    saci_u32 fShader = sc_CompileShaderF(fShaderSource);
+    if (!vShader || !fShader) return SACI_FALSE;
+    renderer->sdfProgram = sc_GetShaderProgram(vShader, fShader);
+    if (!renderer->sdfProgram) return SACI_FALSE;
+    renderer->sdfViewLoc = glGetUniformLocation(renderer->sdfProgram, "uViewMatrix");
+    renderer->sdfProjectionLoc = glGetUniformLocation(renderer->sdfProgram, "uProjectionMatrix");
+    renderer->sdfUseCameraLoc = glGetUniformLocation(renderer->sdfProgram, "uUseCam");
+
+    glGenVertexArrays(1, &renderer->sdfVao);
+    glGenBuffers(1, &renderer->sdfVbo);
+    glBindVertexArray(renderer->sdfVao);
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->sdfVbo);
+    GLsizei stride = sizeof(saci_SdfInstance);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(saci_SdfInstance, center));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(saci_SdfInstance, axis));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(saci_SdfInstance, extent));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(saci_SdfInstance, shape));
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(saci_SdfInstance, color));
+    for (GLuint attribute = 0; attribute < 5; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return SACI_TRUE;
+}
@@ -24,6 +24,10 @@ saci_u32 sc_CompileShaderG(const char* source) {
     return __sc_compileShader(source, GL_GEOMETRY_SHADER);
 }
 
+saci_u32 sc_CompileShaderC(const char* source) {
+    return __sc_compileShader(source, GL_COMPUTE_SHADER);
+}
+
 saci_u32 sc_GetShaderProgram(saci_u32 vshader, saci_u32 fshader) {
     saci_u32 programID = glCreateProgram();
     glAttachShader(programID, vshader);
@@ -73,6 +77,26 @@ saci_u32 sc_GetShaderProgramg(saci_u32 vshader, saci_u32 fshader, saci_u32 gshad
     return programID;
 }
 
+saci_u32 sc_GetComputeShaderProgram(saci_u32 cshader) {
+    saci_u32 programID = glCreateProgram();
+    glAttachShader(programID, cshader);
+    glLinkProgram(programID);
+
+    saci_s32 success = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &success);
+    if (!success) {
+        char errMessage[2048];
+        int sizeReturned = 0;
+        glGetProgramInfoLog(programID, 2048, &sizeReturned, errMessage);
+        printf("ERROR: Could not link shader\n%s", errMessage);
+        return 0;
+    }
+    glDetachShader(programID, cshader);
+    glDeleteShader(cshader);
+
+    return programID;
+}
+
 //----------------------------------------------------------------------------//
 // Helper functions
 //----------------------------------------------------------------------------//
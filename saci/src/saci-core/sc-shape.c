@@ -0,0 +1,777 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-shape.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_SHAPE_PI 3.14159265358979f
+// NDC on a 1080 pixel tall window, until a frame tells otherwise
+#define SACI_SHAPE_DEFAULT_PIXEL_SIZE (2.0f / 1080.0f)
+#define SACI_SHAPE_MAX_SEGMENTS 4096
+#define SACI_SHAPE_MAX_CURVE_SEGMENTS 256
+
+typedef enum saci_ShapeKind {
+    SACI_SHAPE_CIRCLE = 1,
+    SACI_SHAPE_ROUNDED_RECT,
+    SACI_SHAPE_ARC,
+    SACI_SHAPE_POLYGON,
+} saci_ShapeKind;
+
+// Triangles as 3 points each
+typedef struct saci_ShapeVertices {
+    saci_Vec2* data;
+    saci_u32 count, capacity;
+} saci_ShapeVertices;
+
+typedef struct saci_ShapeEntry {
+    saci_u32 hash;
+    saci_ShapeKind kind;
+    float params[5];
+    saci_Vec2* points; // polygons only, relative to the first point
+    saci_u32 pointCount;
+    saci_ShapeVertices triangles; // relative to the shape's position
+    saci_u64 lastUsed; // renderer frame
+} saci_ShapeEntry;
+
+// Open addressing, NULL marks a free slot
+struct saci_ShapeCache {
+    saci_ShapeEntry** entries;
+    saci_u32 count, capacity;
+};
+
+typedef enum saci_PathCommandType {
+    SACI_PATH_MOVE = 0,
+    SACI_PATH_LINE,
+    SACI_PATH_QUAD,
+    SACI_PATH_CUBIC,
+    SACI_PATH_CLOSE,
+} saci_PathCommandType;
+
+typedef struct saci_PathCommand {
+    saci_PathCommandType type;
+    saci_Vec2 points[3]; // controls first, end point last
+} saci_PathCommand;
+
+typedef struct saci_PathContour {
+    saci_u32 first, count; // into the flattened points
+    saci_Bool closed;
+} saci_PathContour;
+
+struct sc_Path {
+    saci_PathCommand* commands;
+    saci_u32 commandCount, commandCapacity;
+
+    // Cached tessellations, dropped by any edit
+    saci_ShapeVertices fill;
+    float fillTolerance; // 0 when fill is out of date
+    saci_ShapeVertices stroke;
+    float strokeTolerance, strokeWidth; // 0 when stroke is out of date
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+float __sc_shape_tolerance(const sc_Renderer* renderer);
+saci_u32 __sc_shape_circleSegments(float tolerance, float radius);
+saci_u32 __sc_shape_arcSegments(float tolerance, float radius, float thickness, float startAngle, float endAngle);
+void __sc_shape_add(saci_ShapeVertices* vertices, saci_Vec2 point);
+void __sc_shape_addTriangle(saci_ShapeVertices* vertices, saci_Vec2 a, saci_Vec2 b, saci_Vec2 c);
+void __sc_shape_emit(sc_Renderer* renderer, const saci_ShapeVertices* triangles, saci_Vec2 origin, float scale,
+                     float depth, saci_Color color);
+
+saci_ShapeEntry* __sc_shape_find(sc_Renderer* renderer, saci_ShapeKind kind, const float params[5],
+                                 const saci_Vec2* points, saci_u32 pointCount, saci_u32* hash);
+saci_ShapeEntry* __sc_shape_insert(sc_Renderer* renderer, saci_ShapeKind kind, const float params[5],
+                                   const saci_Vec2* points, saci_u32 pointCount, saci_u32 hash);
+void __sc_shape_rehash(saci_ShapeCache* cache, saci_u32 capacity, saci_u64 keepSince);
+void __sc_shape_freeEntry(saci_ShapeEntry* entry);
+
+void __sc_shape_tessellateCircle(saci_ShapeVertices* out, saci_u32 segments);
+void __sc_shape_tessellateRoundedRect(saci_ShapeVertices* out, float width, float height, float radius,
+                                      saci_u32 cornerSegments);
+void __sc_shape_tessellateArc(saci_ShapeVertices* out, float radius, float thickness, float startAngle,
+                              float endAngle, saci_u32 segments);
+void __sc_shape_earClip(const saci_Vec2* points, saci_u32 pointCount, saci_ShapeVertices* out);
+
+void __sc_path_add(sc_Path* path, saci_PathCommandType type, saci_Vec2 a, saci_Vec2 b, saci_Vec2 c);
+saci_u32 __sc_path_curveSegments(int degree, float secondDifference, float tolerance);
+saci_u32 __sc_path_flatten(const sc_Path* path, float tolerance, saci_ShapeVertices* points,
+                           saci_PathContour** contours);
+void __sc_path_strokeContour(const saci_Vec2* points, saci_u32 count, saci_Bool closed, float halfWidth,
+                             saci_ShapeVertices* out);
+
+//----------------------------------------------------------------------------//
+// Shape Config
+//----------------------------------------------------------------------------//
+
+void sc_RenderSetShapePixelSize(sc_Renderer* renderer, float pixelSize) {
+    assert(pixelSize >= 0.0f);
+    renderer->shapePixelSize = pixelSize;
+}
+
+//----------------------------------------------------------------------------//
+// Shape Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderPushCircle(sc_Renderer* renderer, saci_Vec2 center, float radius, float depth, saci_Color color) {
+    if (radius <= 0.0f) return;
+    // Every circle with the same segment count is the unit one scaled
+    saci_u32 segments = __sc_shape_circleSegments(__sc_shape_tolerance(renderer), radius);
+    float params[5] = {(float)segments, 0, 0, 0, 0};
+
+    saci_u32 hash;
+    saci_ShapeEntry* entry = __sc_shape_find(renderer, SACI_SHAPE_CIRCLE, params, NULL, 0, &hash);
+    if (!entry) {
+        entry = __sc_shape_insert(renderer, SACI_SHAPE_CIRCLE, params, NULL, 0, hash);
+        if (!entry) return;
+        __sc_shape_tessellateCircle(&entry->triangles, segments);
+    }
+    __sc_shape_emit(renderer, &entry->triangles, center, radius, depth, color);
+}
+
+void sc_RenderPushRoundedRect(sc_Renderer* renderer, saci_Vec2 position, saci_Vec2 size, float radius, float depth,
+                              saci_Color color) {
+    if (size.x <= 0.0f || size.y <= 0.0f) return;
+    float maxRadius = 0.5f * (size.x < size.y ? size.x : size.y);
+    if (radius > maxRadius) radius = maxRadius;
+    if (radius < 0.0f) radius = 0.0f;
+    // Keyed on the segments rather than the tolerance, which follows the
+    // camera and would miss on every zoom step
+    saci_u32 cornerSegments = 0;
+    if (radius > 0.0f) cornerSegments = (__sc_shape_circleSegments(__sc_shape_tolerance(renderer), radius) + 3) / 4;
+    float params[5] = {size.x, size.y, radius, (float)cornerSegments, 0};
+
+    saci_u32 hash;
+    saci_ShapeEntry* entry = __sc_shape_find(renderer, SACI_SHAPE_ROUNDED_RECT, params, NULL, 0, &hash);
+    if (!entry) {
+        entry = __sc_shape_insert(renderer, SACI_SHAPE_ROUNDED_RECT, params, NULL, 0, hash);
+        if (!entry) return;
+        __sc_shape_tessellateRoundedRect(&entry->triangles, size.x, size.y, radius, cornerSegments);
+    }
+    __sc_shape_emit(renderer, &entry->triangles, position, 1.0f, depth, color);
+}
+
+void sc_RenderPushArc(sc_Renderer* renderer, saci_Vec2 center, float radius, float thickness, float startAngle,
+                      float endAngle, float depth, saci_Color color) {
+    if (thickness <= 0.0f || radius <= 0.0f || startAngle == endAngle) return;
+    saci_u32 segments = __sc_shape_arcSegments(__sc_shape_tolerance(renderer), radius, thickness, startAngle, endAngle);
+    float params[5] = {radius, thickness, startAngle, endAngle, (float)segments};
+
+    saci_u32 hash;
+    saci_ShapeEntry* entry = __sc_shape_find(renderer, SACI_SHAPE_ARC, params, NULL, 0, &hash);
+    if (!entry) {
+        entry = __sc_shape_insert(renderer, SACI_SHAPE_ARC, params, NULL, 0, hash);
+        if (!entry) return;
+        __sc_shape_tessellateArc(&entry->triangles, radius, thickness, startAngle, endAngle, segments);
+    }
+    __sc_shape_emit(renderer, &entry->triangles, center, 1.0f, depth, color);
+}
+
+void sc_RenderPushPolygon(sc_Renderer* renderer, const saci_Vec2* points, saci_u32 pointCount, float depth,
+                          saci_Color color) {
+    if (pointCount < 3) return;
+    // Relative to the first point, so a moved polygon is still the same one
+    saci_Vec2* local = (saci_Vec2*)malloc(pointCount * sizeof(saci_Vec2));
+    if (!local) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    for (saci_u32 i = 0; i < pointCount; ++i) {
+        local[i] = (saci_Vec2){points[i].x - points[0].x, points[i].y - points[0].y};
+    }
+    float params[5] = {0, 0, 0, 0, 0};
+
+    saci_u32 hash;
+    saci_ShapeEntry* entry = __sc_shape_find(renderer, SACI_SHAPE_POLYGON, params, local, pointCount, &hash);
+    if (!entry) {
+        entry = __sc_shape_insert(renderer, SACI_SHAPE_POLYGON, params, local, pointCount, hash);
+        if (!entry) {
+            free(local);
+            return;
+        }
+        __sc_shape_earClip(local, pointCount, &entry->triangles);
+    }
+    free(local);
+    __sc_shape_emit(renderer, &entry->triangles, points[0], 1.0f, depth, color);
+}
+
+//----------------------------------------------------------------------------//
+// Path Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_Path* sc_CreatePath(void) {
+    sc_Path* path = (sc_Path*)calloc(1, sizeof(sc_Path));
+    assert(path);
+    return path;
+}
+
+void sc_DeletePath(sc_Path* path) {
+    if (!path) return;
+    free(path->commands);
+    free(path->fill.data);
+    free(path->stroke.data);
+    free(path);
+}
+
+//----------------------------------------------------------------------------//
+// Path Usage
+//----------------------------------------------------------------------------//
+
+void sc_PathClear(sc_Path* path) {
+    path->commandCount = 0;
+    path->fillTolerance = 0.0f;
+    path->strokeTolerance = 0.0f;
+}
+
+void sc_PathMoveTo(sc_Path* path, saci_Vec2 point) {
+    __sc_path_add(path, SACI_PATH_MOVE, point, point, point);
+}
+
+void sc_PathLineTo(sc_Path* path, saci_Vec2 point) {
+    __sc_path_add(path, SACI_PATH_LINE, point, point, point);
+}
+
+void sc_PathQuadTo(sc_Path* path, saci_Vec2 control, saci_Vec2 point) {
+    __sc_path_add(path, SACI_PATH_QUAD, control, point, point);
+}
+
+void sc_PathCubicTo(sc_Path* path, saci_Vec2 control0, saci_Vec2 control1, saci_Vec2 point) {
+    __sc_path_add(path, SACI_PATH_CUBIC, control0, control1, point);
+}
+
+void sc_PathClose(sc_Path* path) {
+    saci_Vec2 zero = {0, 0};
+    __sc_path_add(path, SACI_PATH_CLOSE, zero, zero, zero);
+}
+
+void sc_RenderPushPathFill(sc_Renderer* renderer, sc_Path* path, float depth, saci_Color color) {
+    float tolerance = __sc_shape_tolerance(renderer);
+    if (path->fillTolerance != tolerance) {
+        saci_ShapeVertices points = {0};
+        saci_PathContour* contours = NULL;
+        saci_u32 contourCount = __sc_path_flatten(path, tolerance, &points, &contours);
+        path->fill.count = 0;
+        for (saci_u32 i = 0; i < contourCount; ++i) {
+            __sc_shape_earClip(points.data + contours[i].first, contours[i].count, &path->fill);
+        }
+        free(points.data);
+        free(contours);
+        path->fillTolerance = tolerance;
+    }
+    __sc_shape_emit(renderer, &path->fill, (saci_Vec2){0, 0}, 1.0f, depth, color);
+}
+
+void sc_RenderPushPathStroke(sc_Renderer* renderer, sc_Path* path, float width, float depth, saci_Color color) {
+    if (width <= 0.0f) return;
+    float tolerance = __sc_shape_tolerance(renderer);
+    if (path->strokeTolerance != tolerance || path->strokeWidth != width) {
+        saci_ShapeVertices points = {0};
+        saci_PathContour* contours = NULL;
+        saci_u32 contourCount = __sc_path_flatten(path, tolerance, &points, &contours);
+        path->stroke.count = 0;
+        for (saci_u32 i = 0; i < contourCount; ++i) {
+            __sc_path_strokeContour(points.data + contours[i].first, contours[i].count, contours[i].closed,
+                                    0.5f * width, &path->stroke);
+        }
+        free(points.data);
+        free(contours);
+        path->strokeTolerance = tolerance;
+        path->strokeWidth = width;
+    }
+    __sc_shape_emit(renderer, &path->stroke, (saci_Vec2){0, 0}, 1.0f, depth, color);
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_shape_deleteRendererObjects(sc_Renderer* renderer) {
+    saci_ShapeCache* cache = renderer->shapeCache;
+    if (!cache) return;
+    for (saci_u32 i = 0; i < cache->capacity; ++i) {
+        __sc_shape_freeEntry(cache->entries[i]);
+    }
+    free(cache->entries);
+    free(cache);
+    renderer->shapeCache = NULL;
+}
+
+float __sc_shape_pixelSize(const sc_Renderer* renderer) {
+    if (renderer->shapePixelSize > 0.0f) return renderer->shapePixelSize;
+    if (renderer->framePixelSize > 0.0f) return renderer->framePixelSize;
+    return SACI_SHAPE_DEFAULT_PIXEL_SIZE;
+}
+
+void __sc_shape_updatePixelSize(sc_Renderer* renderer, int viewportHeight) {
+    const saci_RenderFrame* frame = &renderer->frame;
+    if (viewportHeight <= 0) return;
+    if (!frame->hasCamera) {
+        // Positions are already NDC, 2 units tall
+        renderer->framePixelSize = 2.0f / (float)viewportHeight;
+        return;
+    }
+    if (!frame->cameraValid) return;
+
+    // Clip w at the target, the view height there is 2 w over the vertical
+    // scale. 1 for orthographic projections, the distance for perspective
+    const float point[4] = {frame->camera.target.x, frame->camera.target.y, frame->camera.target.z, 1.0f};
+    float eye[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) eye[row] += frame->view.m[column][row] * point[column];
+    }
+    float w = 0.0f;
+    for (int column = 0; column < 4; ++column) w += frame->projection.m[column][3] * eye[column];
+    float scaleY = fabsf(frame->projection.m[1][1]);
+    if (w <= 0.0f || scaleY == 0.0f) return;
+    renderer->framePixelSize = 2.0f * w / (scaleY * (float)viewportHeight);
+}
+
+float __sc_shape_tolerance(const sc_Renderer* renderer) {
+    return 0.25f * __sc_shape_pixelSize(renderer);
+}
+
+// Segments for a polygon to stay within tolerance of a circle: a chord of
+// angle a sits r (1 - cos(a / 2)) inside it
+saci_u32 __sc_shape_circleSegments(float tolerance, float radius) {
+    if (tolerance >= radius) return 3;
+    float angle = 2.0f * acosf(1.0f - tolerance / radius);
+    float segments = ceilf(2.0f * SACI_SHAPE_PI / angle);
+    if (segments < 3.0f) return 3;
+    if (segments > SACI_SHAPE_MAX_SEGMENTS) return SACI_SHAPE_MAX_SEGMENTS;
+    return (saci_u32)segments;
+}
+
+// The outer edge is the longest, it sets the step for both
+saci_u32 __sc_shape_arcSegments(float tolerance, float radius, float thickness, float startAngle, float endAngle) {
+    float sweep = fabsf(endAngle - startAngle);
+    if (sweep > 2.0f * SACI_SHAPE_PI) sweep = 2.0f * SACI_SHAPE_PI;
+    float turns = sweep / (2.0f * SACI_SHAPE_PI);
+    saci_u32 segments = (saci_u32)ceilf(__sc_shape_circleSegments(tolerance, radius + 0.5f * thickness) * turns);
+    return segments < 1 ? 1 : segments;
+}
+
+void __sc_shape_add(saci_ShapeVertices* vertices, saci_Vec2 point) {
+    if (vertices->count == vertices->capacity) {
+        saci_u32 capacity = vertices->capacity ? vertices->capacity * 2 : 48;
+        saci_Vec2* data = (saci_Vec2*)realloc(vertices->data, capacity * sizeof(saci_Vec2));
+        if (!data) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        vertices->data = data;
+        vertices->capacity = capacity;
+    }
+    vertices->data[vertices->count++] = point;
+}
+
+void __sc_shape_addTriangle(saci_ShapeVertices* vertices, saci_Vec2 a, saci_Vec2 b, saci_Vec2 c) {
+    __sc_shape_add(vertices, a);
+    __sc_shape_add(vertices, b);
+    __sc_shape_add(vertices, c);
+}
+
+void __sc_shape_emit(sc_Renderer* renderer, const saci_ShapeVertices* triangles, saci_Vec2 origin, float scale,
+                     float depth, saci_Color color) {
+    saci_u32 count = triangles->count - triangles->count % 3;
+    if (count == 0) return;
+    saci_Vertice* vertices = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, 0, count);
+    if (!vertices) return;
+    saci_ColorU8 packed = saci_ColorU8FromColor(color);
+    for (saci_u32 i = 0; i < count; ++i) {
+        const saci_Vec2* point = &triangles->data[i];
+        vertices[i] = (saci_Vertice){{origin.x + point->x * scale, origin.y + point->y * scale, depth}, packed, {0, 0}};
+    }
+}
+
+saci_ShapeEntry* __sc_shape_find(sc_Renderer* renderer, saci_ShapeKind kind, const float params[5],
+                                 const saci_Vec2* points, saci_u32 pointCount, saci_u32* hash) {
+    // Over the key bytes
+    saci_u8 kindByte = (saci_u8)kind;
+    saci_u32 h = saci_HashFNV1a(params, 5 * sizeof(float), SACI_FNV1A_SEED);
+    h = saci_HashFNV1a(points, pointCount * sizeof(saci_Vec2), h);
+    h = saci_HashFNV1a(&kindByte, 1, h);
+    *hash = h;
+
+    saci_ShapeCache* cache = renderer->shapeCache;
+    if (!cache) return NULL;
+    saci_u32 mask = cache->capacity - 1;
+    for (saci_u32 slot = h & mask; cache->entries[slot]; slot = (slot + 1) & mask) {
+        saci_ShapeEntry* entry = cache->entries[slot];
+        if (entry->hash != h || entry->kind != kind || entry->pointCount != pointCount) continue;
+        if (memcmp(entry->params, params, sizeof(entry->params)) != 0) continue;
+        if (pointCount && memcmp(entry->points, points, pointCount * sizeof(saci_Vec2)) != 0) continue;
+        entry->lastUsed = renderer->frameIndex;
+        return entry;
+    }
+    return NULL;
+}
+
+saci_ShapeEntry* __sc_shape_insert(sc_Renderer* renderer, saci_ShapeKind kind, const float params[5],
+                                   const saci_Vec2* points, saci_u32 pointCount, saci_u32 hash) {
+    if (!renderer->shapeCache) {
+        saci_ShapeCache* cache = (saci_ShapeCache*)calloc(1, sizeof(saci_ShapeCache));
+        assert(cache);
+        cache->capacity = 256;
+        cache->entries = (saci_ShapeEntry**)calloc(cache->capacity, sizeof(saci_ShapeEntry*));
+        assert(cache->entries);
+        renderer->shapeCache = cache;
+    }
+    saci_ShapeCache* cache = renderer->shapeCache;
+
+    saci_ShapeEntry* entry = (saci_ShapeEntry*)calloc(1, sizeof(saci_ShapeEntry));
+    if (!entry) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return NULL;
+    }
+    if (pointCount) {
+        entry->points = (saci_Vec2*)malloc(pointCount * sizeof(saci_Vec2));
+        if (!entry->points) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            free(entry);
+            return NULL;
+        }
+        memcpy(entry->points, points, pointCount * sizeof(saci_Vec2));
+    }
+    entry->hash = hash;
+    entry->kind = kind;
+    memcpy(entry->params, params, sizeof(entry->params));
+    entry->pointCount = pointCount;
+    entry->lastUsed = renderer->frameIndex;
+
+    if ((cache->count + 1) * 4 > cache->capacity * 3) {
+        // Drop what wasn't drawn last frame, grow if that doesn't free enough
+        __sc_shape_rehash(cache, cache->capacity, renderer->frameIndex ? renderer->frameIndex - 1 : 0);
+        if ((cache->count + 1) * 2 > cache->capacity) __sc_shape_rehash(cache, cache->capacity * 2, 0);
+    }
+    saci_u32 mask = cache->capacity - 1;
+    saci_u32 slot = hash & mask;
+    while (cache->entries[slot]) slot = (slot + 1) & mask;
+    cache->entries[slot] = entry;
+    cache->count++;
+    return entry;
+}
+
+void __sc_shape_rehash(saci_ShapeCache* cache, saci_u32 capacity, saci_u64 keepSince) {
+    saci_ShapeEntry** entries = (saci_ShapeEntry**)calloc(capacity, sizeof(saci_ShapeEntry*));
+    if (!entries) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    saci_u32 count = 0;
+    for (saci_u32 i = 0; i < cache->capacity; ++i) {
+        saci_ShapeEntry* entry = cache->entries[i];
+        if (!entry) continue;
+        if (entry->lastUsed < keepSince) {
+            __sc_shape_freeEntry(entry);
+            continue;
+        }
+        saci_u32 slot = entry->hash & (capacity - 1);
+        while (entries[slot]) slot = (slot + 1) & (capacity - 1);
+        entries[slot] = entry;
+        count++;
+    }
+    free(cache->entries);
+    cache->entries = entries;
+    cache->capacity = capacity;
+    cache->count = count;
+}
+
+void __sc_shape_freeEntry(saci_ShapeEntry* entry) {
+    if (!entry) return;
+    free(entry->points);
+    free(entry->triangles.data);
+    free(entry);
+}
+
+void __sc_shape_tessellateCircle(saci_ShapeVertices* out, saci_u32 segments) {
+    saci_Vec2 center = {0, 0};
+    saci_Vec2 previous = {1, 0};
+    for (saci_u32 i = 1; i <= segments; ++i) {
+        float angle = 2.0f * SACI_SHAPE_PI * (float)i / (float)segments;
+        saci_Vec2 point = i == segments ? (saci_Vec2){1, 0} : (saci_Vec2){cosf(angle), sinf(angle)};
+        __sc_shape_addTriangle(out, center, previous, point);
+        previous = point;
+    }
+}
+
+void __sc_shape_tessellateRoundedRect(saci_ShapeVertices* out, float width, float height, float radius,
+                                      saci_u32 cornerSegments) {
+    if (radius <= 0.0f) {
+        __sc_shape_addTriangle(out, (saci_Vec2){0, 0}, (saci_Vec2){width, 0}, (saci_Vec2){width, height});
+        __sc_shape_addTriangle(out, (saci_Vec2){0, 0}, (saci_Vec2){width, height}, (saci_Vec2){0, height});
+        return;
+    }
+
+    // Convex, so a fan from the middle over the outline covers it
+    const saci_Vec2 corners[4] = {
+        {width - radius, radius},
+        {width - radius, height - radius},
+        {radius, height - radius},
+        {radius, radius},
+    };
+    saci_Vec2 center = {0.5f * width, 0.5f * height};
+    saci_Vec2 first = {0, 0}, previous = {0, 0};
+    saci_Bool started = SACI_FALSE;
+    for (int corner = 0; corner < 4; ++corner) {
+        float startAngle = (corner - 1) * 0.5f * SACI_SHAPE_PI; // bottom right starts pointing down
+        for (saci_u32 i = 0; i <= cornerSegments; ++i) {
+            float angle = startAngle + 0.5f * SACI_SHAPE_PI * (float)i / (float)cornerSegments;
+            saci_Vec2 point = {corners[corner].x + radius * cosf(angle), corners[corner].y + radius * sinf(angle)};
+            if (!started) {
+                first = point;
+                started = SACI_TRUE;
+            } else {
+                __sc_shape_addTriangle(out, center, previous, point);
+            }
+            previous = point;
+        }
+    }
+    __sc_shape_addTriangle(out, center, previous, first);
+}
+
+void __sc_shape_tessellateArc(saci_ShapeVertices* out, float radius, float thickness, float startAngle,
+                              float endAngle, saci_u32 segments) {
+    float sweep = endAngle - startAngle;
+    if (sweep > 2.0f * SACI_SHAPE_PI) sweep = 2.0f * SACI_SHAPE_PI;
+    if (sweep < -2.0f * SACI_SHAPE_PI) sweep = -2.0f * SACI_SHAPE_PI;
+    float outer = radius + 0.5f * thickness;
+    float inner = radius - 0.5f * thickness;
+    if (inner < 0.0f) inner = 0.0f;
+
+    saci_Vec2 previousOuter = {outer * cosf(startAngle), outer * sinf(startAngle)};
+    saci_Vec2 previousInner = {inner * cosf(startAngle), inner * sinf(startAngle)};
+    for (saci_u32 i = 1; i <= segments; ++i) {
+        float angle = startAngle + sweep * (float)i / (float)segments;
+        float c = cosf(angle), s = sinf(angle);
+        saci_Vec2 pointOuter = {outer * c, outer * s};
+        saci_Vec2 pointInner = {inner * c, inner * s};
+        __sc_shape_addTriangle(out, previousInner, previousOuter, pointOuter);
+        if (inner > 0.0f) __sc_shape_addTriangle(out, previousInner, pointOuter, pointInner);
+        previousOuter = pointOuter;
+        previousInner = pointInner;
+    }
+}
+
+// Ear clipping: cut off a convex corner with no other point inside it until
+// a triangle is left. O(n^2) per polygon, which the cache pays once
+void __sc_shape_earClip(const saci_Vec2* points, saci_u32 pointCount, saci_ShapeVertices* out) {
+    // A closing point equal to the first adds nothing
+    while (pointCount > 3 && points[pointCount - 1].x == points[0].x && points[pointCount - 1].y == points[0].y) {
+        pointCount--;
+    }
+    if (pointCount < 3) return;
+
+    float area = 0.0f;
+    for (saci_u32 i = 0; i < pointCount; ++i) {
+        const saci_Vec2* a = &points[i];
+        const saci_Vec2* b = &points[(i + 1) % pointCount];
+        area += a->x * b->y - b->x * a->y;
+    }
+    float winding = area < 0.0f ? -1.0f : 1.0f; // corners are convex on this side
+
+    saci_u32* remaining = (saci_u32*)malloc(pointCount * sizeof(saci_u32));
+    if (!remaining) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    for (saci_u32 i = 0; i < pointCount; ++i) remaining[i] = i;
+    saci_u32 count = pointCount;
+
+#define SACI_SHAPE_CROSS(a, b, c) (((b).x - (a).x) * ((c).y - (a).y) - ((b).y - (a).y) * ((c).x - (a).x))
+    while (count > 3) {
+        saci_Bool clipped = SACI_FALSE;
+        for (saci_u32 k = 0; k < count && !clipped; ++k) {
+            saci_Vec2 a = points[remaining[(k + count - 1) % count]];
+            saci_Vec2 b = points[remaining[k]];
+            saci_Vec2 c = points[remaining[(k + 1) % count]];
+            float cross = SACI_SHAPE_CROSS(a, b, c) * winding;
+            if (cross < 0.0f) continue; // reflex
+
+            saci_Bool ear = SACI_TRUE;
+            if (cross > 0.0f) {
+                for (saci_u32 j = 0; j < count && ear; ++j) {
+                    saci_Vec2 p = points[remaining[j]];
+                    if ((p.x == a.x && p.y == a.y) || (p.x == b.x && p.y == b.y) || (p.x == c.x && p.y == c.y)) {
+                        continue;
+                    }
+                    if (SACI_SHAPE_CROSS(a, b, p) * winding >= 0.0f && SACI_SHAPE_CROSS(b, c, p) * winding >= 0.0f &&
+                        SACI_SHAPE_CROSS(c, a, p) * winding >= 0.0f) {
+                        ear = SACI_FALSE;
+                    }
+                }
+                if (ear) __sc_shape_addTriangle(out, a, b, c);
+            }
+            // Collinear corners are dropped without a triangle
+            if (ear) {
+                memmove(&remaining[k], &remaining[k + 1], (count - k - 1) * sizeof(saci_u32));
+                count--;
+                clipped = SACI_TRUE;
+            }
+        }
+        if (!clipped) {
+            // Self intersecting or numerically stuck, fan what is left
+            for (saci_u32 k = 1; k + 1 < count; ++k) {
+                __sc_shape_addTriangle(out, points[remaining[0]], points[remaining[k]], points[remaining[k + 1]]);
+            }
+            count = 0;
+        }
+    }
+#undef SACI_SHAPE_CROSS
+    if (count == 3) {
+        __sc_shape_addTriangle(out, points[remaining[0]], points[remaining[1]], points[remaining[2]]);
+    }
+    free(remaining);
+}
+
+void __sc_path_add(sc_Path* path, saci_PathCommandType type, saci_Vec2 a, saci_Vec2 b, saci_Vec2 c) {
+    if (path->commandCount == path->commandCapacity) {
+        saci_u32 capacity = path->commandCapacity ? path->commandCapacity * 2 : 16;
+        saci_PathCommand* commands = (saci_PathCommand*)realloc(path->commands, capacity * sizeof(saci_PathCommand));
+        if (!commands) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        path->commands = commands;
+        path->commandCapacity = capacity;
+    }
+    path->commands[path->commandCount++] = (saci_PathCommand){type, {a, b, c}};
+    path->fillTolerance = 0.0f;
+    path->strokeTolerance = 0.0f;
+}
+
+// Curves are split uniformly, a degree d bezier then stays within
+// d (d - 1) / 8 * max |second difference| / n^2 of its chords
+saci_u32 __sc_path_curveSegments(int degree, float secondDifference, float tolerance) {
+    float segments = ceilf(sqrtf(degree * (degree - 1) / 8.0f * secondDifference / tolerance));
+    if (segments < 1.0f) return 1;
+    if (segments > SACI_SHAPE_MAX_CURVE_SEGMENTS) return SACI_SHAPE_MAX_CURVE_SEGMENTS;
+    return (saci_u32)segments;
+}
+
+saci_u32 __sc_path_flatten(const sc_Path* path, float tolerance, saci_ShapeVertices* points,
+                           saci_PathContour** contours) {
+    saci_u32 contourCount = 0, contourCapacity = 0;
+    *contours = NULL;
+    saci_Vec2 pen = {0, 0};
+    saci_Bool open = SACI_FALSE;
+
+    for (saci_u32 i = 0; i < path->commandCount; ++i) {
+        const saci_PathCommand* command = &path->commands[i];
+        if (command->type == SACI_PATH_CLOSE) {
+            if (open) {
+                (*contours)[contourCount - 1].closed = SACI_TRUE;
+                pen = points->data[(*contours)[contourCount - 1].first];
+            }
+            open = SACI_FALSE;
+            continue;
+        }
+        if (command->type == SACI_PATH_MOVE || !open) {
+            if (contourCount == contourCapacity) {
+                contourCapacity = contourCapacity ? contourCapacity * 2 : 4;
+                saci_PathContour* grown =
+                    (saci_PathContour*)realloc(*contours, contourCapacity * sizeof(saci_PathContour));
+                if (!grown) {
+                    fprintf(stderr, "Memory allocation failed.\n");
+                    return contourCount;
+                }
+                *contours = grown;
+            }
+            // Drawing without a move starts where the last contour ended
+            saci_Vec2 start = command->type == SACI_PATH_MOVE ? command->points[0] : pen;
+            (*contours)[contourCount++] = (saci_PathContour){points->count, 1, SACI_FALSE};
+            __sc_shape_add(points, start);
+            pen = start;
+            open = SACI_TRUE;
+            if (command->type == SACI_PATH_MOVE) continue;
+        }
+
+        saci_PathContour* contour = &(*contours)[contourCount - 1];
+        saci_u32 before = points->count;
+        switch (command->type) {
+            case SACI_PATH_LINE: {
+                __sc_shape_add(points, command->points[0]);
+                break;
+            }
+            case SACI_PATH_QUAD: {
+                saci_Vec2 c = command->points[0], end = command->points[1];
+                float ddx = pen.x - 2.0f * c.x + end.x, ddy = pen.y - 2.0f * c.y + end.y;
+                saci_u32 n = __sc_path_curveSegments(2, sqrtf(ddx * ddx + ddy * ddy), tolerance);
+                for (saci_u32 k = 1; k <= n; ++k) {
+                    float t = (float)k / n, mt = 1.0f - t;
+                    __sc_shape_add(points, (saci_Vec2){mt * mt * pen.x + 2.0f * mt * t * c.x + t * t * end.x,
+                                                       mt * mt * pen.y + 2.0f * mt * t * c.y + t * t * end.y});
+                }
+                break;
+            }
+            case SACI_PATH_CUBIC: {
+                saci_Vec2 c0 = command->points[0], c1 = command->points[1], end = command->points[2];
+                float ax = pen.x - 2.0f * c0.x + c1.x, ay = pen.y - 2.0f * c0.y + c1.y;
+                float bx = c0.x - 2.0f * c1.x + end.x, by = c0.y - 2.0f * c1.y + end.y;
+                float dd = sqrtf(fmaxf(ax * ax + ay * ay, bx * bx + by * by));
+                saci_u32 n = __sc_path_curveSegments(3, dd, tolerance);
+                for (saci_u32 k = 1; k <= n; ++k) {
+                    float t = (float)k / n, mt = 1.0f - t;
+                    float w0 = mt * mt * mt, w1 = 3.0f * mt * mt * t, w2 = 3.0f * mt * t * t, w3 = t * t * t;
+                    __sc_shape_add(points, (saci_Vec2){w0 * pen.x + w1 * c0.x + w2 * c1.x + w3 * end.x,
+                                                       w0 * pen.y + w1 * c0.y + w2 * c1.y + w3 * end.y});
+                }
+                break;
+            }
+            default: break;
+        }
+        contour->count += points->count - before;
+        pen = points->data[points->count - 1];
+    }
+    return contourCount;
+}
+
+void __sc_path_strokeContour(const saci_Vec2* points, saci_u32 count, saci_Bool closed, float halfWidth,
+                             saci_ShapeVertices* out) {
+    saci_u32 segmentCount = closed ? count : count - 1;
+    saci_Vec2 previousNormal = {0, 0}, firstNormal = {0, 0};
+    saci_Bool hasPrevious = SACI_FALSE;
+    for (saci_u32 i = 0; i < segmentCount; ++i) {
+        saci_Vec2 a = points[i];
+        saci_Vec2 b = points[(i + 1) % count];
+        float dx = b.x - a.x, dy = b.y - a.y;
+        float length = sqrtf(dx * dx + dy * dy);
+        if (length == 0.0f) continue;
+        saci_Vec2 normal = {-dy / length * halfWidth, dx / length * halfWidth};
+
+        saci_Vec2 a0 = {a.x + normal.x, a.y + normal.y}, a1 = {a.x - normal.x, a.y - normal.y};
+        saci_Vec2 b0 = {b.x + normal.x, b.y + normal.y}, b1 = {b.x - normal.x, b.y - normal.y};
+        __sc_shape_addTriangle(out, a0, b0, b1);
+        __sc_shape_addTriangle(out, a0, b1, a1);
+
+        if (hasPrevious) {
+            // Bevel both sides, the inner one hides under the segments
+            __sc_shape_addTriangle(out, a, (saci_Vec2){a.x + previousNormal.x, a.y + previousNormal.y}, a0);
+            __sc_shape_addTriangle(out, a, (saci_Vec2){a.x - previousNormal.x, a.y - previousNormal.y}, a1);
+        } else {
+            firstNormal = normal;
+        }
+        previousNormal = normal;
+        hasPrevious = SACI_TRUE;
+    }
+    if (closed && hasPrevious) {
+        saci_Vec2 a = points[0];
+        __sc_shape_addTriangle(out, a, (saci_Vec2){a.x + previousNormal.x, a.y + previousNormal.y},
+                               (saci_Vec2){a.x + firstNormal.x, a.y + firstNormal.y});
+        __sc_shape_addTriangle(out, a, (saci_Vec2){a.x - previousNormal.x, a.y - previousNormal.y},
+                               (saci_Vec2){a.x - firstNormal.x, a.y - firstNormal.y});
+    }
+}
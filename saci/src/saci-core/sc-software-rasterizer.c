@@ -0,0 +1,843 @@
+#include <glad/glad.h> // Only for the draw mode enums, nothing here calls GL
+
+#include "sc-rendering-internal.h"
+
+#include "saci-core/sc-texture.h"
+#include "saci-utils/su-jobs.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <stbi/stb_image.h>
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_SOFTWARE_TILE_SIZE 64
+#define SACI_SOFTWARE_MIN_W 1e-5f
+
+// Clip space vertex, before the perspective divide
+typedef struct saci_SoftwareClipVertex {
+    float x, y, z, w;
+    float r, g, b, a;
+    float u, v;
+} saci_SoftwareClipVertex;
+
+// Screen space vertex, attributes are premultiplied by invW so they can be
+// interpolated linearly and stay perspective correct
+typedef struct saci_SoftwareVertex {
+    float x, y, z; // z is the window depth in [0, 1]
+    float invW;
+    float r, g, b, a;
+    float u, v;
+} saci_SoftwareVertex;
+
+typedef struct saci_SoftwarePrimitive {
+    saci_SoftwareVertex v[3];
+    saci_TextureID textureID;
+    saci_Bool isLine;
+
+    int minX, minY, maxX, maxY; // inclusive pixel bounds, already clamped
+
+    // Half-space edge functions, E(x, y) = (A * x + B * y) + C
+    float edgeA[3], edgeB[3], edgeC[3];
+    saci_Bool edgeInclusive[3]; // top-left fill rule
+    float invArea;
+} saci_SoftwarePrimitive;
+
+typedef struct saci_SoftwareBin {
+    saci_u32* primitives;
+    saci_u32 count;
+    saci_u32 capacity;
+} saci_SoftwareBin;
+
+typedef struct saci_SoftwareTexture {
+    int width, height;
+    saci_u8* pixels; // RGBA8, NULL for free slots
+    char* path;      // NULL unless loaded from a file
+    saci_Bool flipImg;
+} saci_SoftwareTexture;
+
+struct saci_SoftwareRenderer {
+    int width, height;
+    saci_u32* color; // RGBA8 in memory order
+    float* depth;
+
+    int tilesX, tilesY;
+    saci_SoftwareBin* bins;
+
+    saci_SoftwarePrimitive* primitives;
+    saci_u32 primitiveCount;
+    saci_u32 primitiveCapacity;
+
+    saci_Bool useZBuffer;
+    saci_Bool alphaBlending;
+    saci_JobPool* jobs;
+};
+
+// Shared by every software renderer, IDs are slot + 1 so 0 stays "no texture"
+static struct {
+    saci_SoftwareTexture* slots;
+    saci_u32 count;
+} sc_softwareTextures;
+// Renderers on other threads sample while textures come and go. A frame
+// holds it for reading over its whole tile pass, changes wait for that
+static pthread_rwlock_t sc_softwareTexturesLock = PTHREAD_RWLOCK_INITIALIZER;
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_software_resizeTargets(saci_SoftwareRenderer* software, int width, int height);
+
+saci_SoftwareClipVertex __sc_software_toClip(const saci_Mat4* mvp, const saci_Vertice* vertice);
+saci_SoftwareClipVertex __sc_software_lerpClip(const saci_SoftwareClipVertex* a, const saci_SoftwareClipVertex* b, float t);
+int __sc_software_clipPolygon(saci_SoftwareClipVertex* in, int count, saci_SoftwareClipVertex* out);
+saci_SoftwareVertex __sc_software_toScreen(const saci_SoftwareRenderer* software, const saci_SoftwareClipVertex* clip);
+
+saci_SoftwarePrimitive* __sc_software_newPrimitive(saci_SoftwareRenderer* software);
+void __sc_software_setupTriangle(saci_SoftwareRenderer* software, saci_SoftwareVertex a, saci_SoftwareVertex b, saci_SoftwareVertex c, saci_TextureID texID);
+void __sc_software_setupLine(saci_SoftwareRenderer* software, saci_SoftwareVertex a, saci_SoftwareVertex b, saci_TextureID texID);
+void __sc_software_addTriangle(saci_SoftwareRenderer* software, const sc_RenderConfig* config, const saci_Mat4* mvp,
+                               const saci_Vertice* a, const saci_Vertice* b, const saci_Vertice* c, saci_TextureID texID);
+void __sc_software_addLine(saci_SoftwareRenderer* software, const saci_Mat4* mvp,
+                           const saci_Vertice* a, const saci_Vertice* b, saci_TextureID texID);
+void __sc_software_binPrimitives(saci_SoftwareRenderer* software);
+
+void __sc_software_rasterizeTile(void* userData, saci_u32 tileIndex, saci_u32 workerIndex);
+void __sc_software_rasterizeTriangle(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                                     int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+void __sc_software_rasterizeLine(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                                 int tileMinX, int tileMinY, int tileMaxX, int tileMaxY);
+void __sc_software_shadePixel(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                              int x, int y, float w0, float w1, float w2);
+
+// The live texture behind id, NULL for 0, unknown and freed ids. The caller
+// holds the registry lock
+saci_SoftwareTexture* __sc_software_findTexture(saci_TextureID id);
+void __sc_software_sampleTexture(saci_TextureID texID, float u, float v, float* rgba);
+saci_u32 __sc_software_packColor(float r, float g, float b, float a);
+
+//----------------------------------------------------------------------------//
+// Software backend
+//----------------------------------------------------------------------------//
+
+void sc_RenderSoftwareSetSize(sc_Renderer* renderer, int width, int height) {
+    assert(renderer->backend == SACI_RENDER_BACKEND_SOFTWARE);
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "Invalid software target size: %dx%d\n", width, height);
+        return;
+    }
+    __sc_software_resizeTargets(renderer->software, width, height);
+}
+
+void sc_RenderSoftwareClear(sc_Renderer* renderer, const saci_Color color) {
+    assert(renderer->backend == SACI_RENDER_BACKEND_SOFTWARE);
+    saci_SoftwareRenderer* software = renderer->software;
+
+    saci_u32 packed = __sc_software_packColor(color.r, color.g, color.b, color.a);
+    size_t pixelCount = (size_t)software->width * software->height;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        software->color[i] = packed;
+        software->depth[i] = 1.0f;
+    }
+}
+
+const saci_u8* sc_RenderSoftwareGetPixels(const sc_Renderer* renderer, int* width, int* height) {
+    assert(renderer->backend == SACI_RENDER_BACKEND_SOFTWARE);
+    if (width) *width = renderer->software->width;
+    if (height) *height = renderer->software->height;
+    return (const saci_u8*)renderer->software->color;
+}
+
+saci_TextureID sc_RenderSoftwareTextureLoad(const char* path, saci_Bool flipImg) {
+    int width = 0, height = 0, nrChannels = 0;
+    stbi_set_flip_vertically_on_load_thread(!flipImg); // same convention as sc_TextureLoadData
+    saci_u8* data = stbi_load(path, &width, &height, &nrChannels, 4);
+    if (!data) {
+        printf("Error: Image data not loaded correctly.\n");
+        return 0;
+    }
+    saci_TextureID id = sc_RenderSoftwareTextureCreate(data, width, height);
+    stbi_image_free(data);
+    if (id != 0) {
+        char* source = strdup(path);
+        pthread_rwlock_wrlock(&sc_softwareTexturesLock);
+        sc_softwareTextures.slots[id - 1].path = source;
+        sc_softwareTextures.slots[id - 1].flipImg = flipImg;
+        pthread_rwlock_unlock(&sc_softwareTexturesLock);
+    }
+    return id;
+}
+
+saci_TextureID sc_RenderSoftwareTextureCreate(const saci_u8* rgba, int width, int height) {
+    if (!rgba || width <= 0 || height <= 0) {
+        printf("Error: Invalid texture dimensions: width=%d, height=%d\n", width, height);
+        return 0;
+    }
+
+    size_t size = (size_t)width * height * 4;
+    saci_u8* pixels = (saci_u8*)malloc(size);
+    if (!pixels) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return 0;
+    }
+    memcpy(pixels, rgba, size);
+
+    pthread_rwlock_wrlock(&sc_softwareTexturesLock);
+    saci_u32 slot = 0;
+    while (slot < sc_softwareTextures.count && sc_softwareTextures.slots[slot].pixels) {
+        slot++;
+    }
+    if (slot == sc_softwareTextures.count) {
+        saci_u32 newCount = sc_softwareTextures.count ? sc_softwareTextures.count * 2 : 8;
+        saci_SoftwareTexture* slots = (saci_SoftwareTexture*)realloc(sc_softwareTextures.slots, newCount * sizeof(saci_SoftwareTexture));
+        if (!slots) {
+            pthread_rwlock_unlock(&sc_softwareTexturesLock);
+            free(pixels);
+            fprintf(stderr, "Memory allocation failed.\n");
+            return 0;
+        }
+        memset(slots + sc_softwareTextures.count, 0, (newCount - sc_softwareTextures.count) * sizeof(saci_SoftwareTexture));
+        sc_softwareTextures.slots = slots;
+        sc_softwareTextures.count = newCount;
+    }
+
+    saci_SoftwareTexture* texture = &sc_softwareTextures.slots[slot];
+    texture->pixels = pixels;
+    texture->width = width;
+    texture->height = height;
+    texture->path = NULL;
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+    return slot + 1;
+}
+
+void sc_RenderSoftwareTextureFree(saci_TextureID textureID) {
+    pthread_rwlock_wrlock(&sc_softwareTexturesLock);
+    if (textureID == 0 || textureID > sc_softwareTextures.count) {
+        pthread_rwlock_unlock(&sc_softwareTexturesLock);
+        return;
+    }
+    saci_SoftwareTexture* texture = &sc_softwareTextures.slots[textureID - 1];
+    free(texture->pixels);
+    free(texture->path);
+    texture->pixels = NULL;
+    texture->path = NULL;
+    texture->width = 0;
+    texture->height = 0;
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+}
+
+//----------------------------------------------------------------------------//
+// Backend entry points
+//----------------------------------------------------------------------------//
+
+void __sc_software_init(sc_Renderer* renderer) {
+    saci_SoftwareRenderer* software = (saci_SoftwareRenderer*)calloc(1, sizeof(saci_SoftwareRenderer));
+    assert(software);
+    software->jobs = saci_CreateJobPool(0);
+    renderer->software = software;
+}
+
+void __sc_software_delete(sc_Renderer* renderer) {
+    saci_SoftwareRenderer* software = renderer->software;
+    if (!software) return;
+
+    saci_DeleteJobPool(software->jobs);
+    for (int i = 0; i < software->tilesX * software->tilesY; ++i) {
+        free(software->bins[i].primitives);
+    }
+    free(software->bins);
+    free(software->primitives);
+    free(software->color);
+    free(software->depth);
+    free(software);
+    renderer->software = NULL;
+}
+
+void __sc_software_renderEnd(sc_Renderer* renderer, const sc_RenderConfig* config) {
+    saci_SoftwareRenderer* software = renderer->software;
+    if (software->width == 0 || software->height == 0) {
+        fprintf(stderr, "Software renderer has no size, call sc_RenderSoftwareSetSize\n");
+        return;
+    }
+
+    // Same transform as the GL shader, positions are clip space without a camera
+    saci_Mat4 mvp = saci_IdentityMat4();
+    if (renderer->frame.hasCamera) {
+        if (!renderer->frame.cameraValid) {
+            return;
+        }
+        mvp = saci_MultiplyMat4(renderer->frame.view, renderer->frame.projection);
+    }
+
+    software->primitiveCount = 0;
+    software->useZBuffer = config->useZBuffer;
+    software->alphaBlending = config->alphaBlending;
+
+    for (saci_u32 i = 0; i < renderer->renderBatch.drawCallCount; ++i) {
+        const saci_RenderCall* call = &renderer->renderBatch.drawCalls[i];
+        const saci_Vertice* vertices = renderer->renderBatch.vertices + call->firstVertex;
+
+        if (call->drawMode == GL_LINES) {
+            for (saci_u32 v = 0; v + 1 < call->vertexCount; v += 2) {
+                __sc_software_addLine(software, &mvp, &vertices[v], &vertices[v + 1], call->textureID);
+            }
+            continue;
+        }
+        for (saci_u32 v = 0; v + 2 < call->vertexCount; v += 3) {
+            __sc_software_addTriangle(software, config, &mvp, &vertices[v], &vertices[v + 1], &vertices[v + 2],
+                                      call->textureID);
+        }
+    }
+
+    __sc_software_binPrimitives(software);
+    pthread_rwlock_rdlock(&sc_softwareTexturesLock);
+    saci_JobPoolParallelFor(software->jobs, software->tilesX * software->tilesY,
+                            __sc_software_rasterizeTile, software);
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+}
+
+saci_Bool __sc_software_textureSource(saci_TextureID id, char** path, saci_Bool* flipImg, int* width, int* height) {
+    pthread_rwlock_rdlock(&sc_softwareTexturesLock);
+    const saci_SoftwareTexture* texture = __sc_software_findTexture(id);
+    if (texture) {
+        if (path) *path = texture->path ? strdup(texture->path) : NULL;
+        if (flipImg) *flipImg = texture->flipImg;
+        *width = texture->width;
+        *height = texture->height;
+    }
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+    return texture != NULL;
+}
+
+saci_Bool __sc_software_textureResize(saci_TextureID id, int width, int height) {
+    saci_u8* pixels = (saci_u8*)calloc((size_t)width * height, 4);
+    if (!pixels) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_FALSE;
+    }
+    pthread_rwlock_wrlock(&sc_softwareTexturesLock);
+    saci_SoftwareTexture* texture = __sc_software_findTexture(id);
+    if (texture) {
+        free(texture->pixels);
+        texture->pixels = pixels;
+        texture->width = width;
+        texture->height = height;
+    }
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+    if (!texture) free(pixels);
+    return texture != NULL;
+}
+
+void __sc_software_textureUpdate(saci_TextureID id, int x, int y, int width, int height, const saci_u8* rgba) {
+    pthread_rwlock_wrlock(&sc_softwareTexturesLock);
+    saci_SoftwareTexture* texture = __sc_software_findTexture(id);
+    if (texture) {
+        assert(x >= 0 && y >= 0 && x + width <= texture->width && y + height <= texture->height);
+        for (int row = 0; row < height; ++row) {
+            memcpy(texture->pixels + ((size_t)(y + row) * texture->width + x) * 4, rgba + (size_t)row * width * 4,
+                   (size_t)width * 4);
+        }
+    }
+    pthread_rwlock_unlock(&sc_softwareTexturesLock);
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_software_resizeTargets(saci_SoftwareRenderer* software, int width, int height) {
+    for (int i = 0; i < software->tilesX * software->tilesY; ++i) {
+        free(software->bins[i].primitives);
+    }
+    free(software->bins);
+    free(software->color);
+    free(software->depth);
+
+    size_t pixelCount = (size_t)width * height;
+    software->color = (saci_u32*)malloc(pixelCount * sizeof(saci_u32));
+    software->depth = (float*)malloc(pixelCount * sizeof(float));
+    assert(software->color && software->depth);
+    software->width = width;
+    software->height = height;
+
+    software->tilesX = (width + SACI_SOFTWARE_TILE_SIZE - 1) / SACI_SOFTWARE_TILE_SIZE;
+    software->tilesY = (height + SACI_SOFTWARE_TILE_SIZE - 1) / SACI_SOFTWARE_TILE_SIZE;
+    software->bins = (saci_SoftwareBin*)calloc((size_t)software->tilesX * software->tilesY, sizeof(saci_SoftwareBin));
+    assert(software->bins);
+
+    for (size_t i = 0; i < pixelCount; ++i) {
+        software->color[i] = 0;
+        software->depth[i] = 1.0f;
+    }
+}
+
+saci_SoftwareClipVertex __sc_software_toClip(const saci_Mat4* mvp, const saci_Vertice* vertice) {
+    const float (*m)[4] = mvp->m; // column major, m[column][row]
+    saci_Vec3 p = vertice->pos;
+    saci_SoftwareClipVertex clip;
+    clip.x = m[0][0] * p.x + m[1][0] * p.y + m[2][0] * p.z + m[3][0];
+    clip.y = m[0][1] * p.x + m[1][1] * p.y + m[2][1] * p.z + m[3][1];
+    clip.z = m[0][2] * p.x + m[1][2] * p.y + m[2][2] * p.z + m[3][2];
+    clip.w = m[0][3] * p.x + m[1][3] * p.y + m[2][3] * p.z + m[3][3];
+    clip.r = vertice->color.r * (1.0f / 255.0f);
+    clip.g = vertice->color.g * (1.0f / 255.0f);
+    clip.b = vertice->color.b * (1.0f / 255.0f);
+    clip.a = vertice->color.a * (1.0f / 255.0f);
+    clip.u = vertice->texCoord.x;
+    clip.v = vertice->texCoord.y;
+    return clip;
+}
+
+saci_SoftwareClipVertex __sc_software_lerpClip(const saci_SoftwareClipVertex* a, const saci_SoftwareClipVertex* b, float t) {
+    saci_SoftwareClipVertex out;
+    const float* pa = &a->x;
+    const float* pb = &b->x;
+    float* po = &out.x;
+    for (size_t i = 0; i < sizeof(saci_SoftwareClipVertex) / sizeof(float); ++i) {
+        po[i] = pa[i] + (pb[i] - pa[i]) * t;
+    }
+    return out;
+}
+
+// Sutherland-Hodgman against w > 0, near (z >= -w) and far (z <= w). x and y
+// are left to the bounding box clamp, the viewport acts as a guard band
+int __sc_software_clipPolygon(saci_SoftwareClipVertex* in, int count, saci_SoftwareClipVertex* out) {
+    saci_SoftwareClipVertex scratch[9];
+    saci_SoftwareClipVertex* src = in;
+    saci_SoftwareClipVertex* dst = scratch;
+
+    for (int plane = 0; plane < 3; ++plane) {
+        int outCount = 0;
+        for (int i = 0; i < count; ++i) {
+            const saci_SoftwareClipVertex* a = &src[i];
+            const saci_SoftwareClipVertex* b = &src[(i + 1) % count];
+            float da, db;
+            if (plane == 0) {
+                da = a->w - SACI_SOFTWARE_MIN_W;
+                db = b->w - SACI_SOFTWARE_MIN_W;
+            } else if (plane == 1) {
+                da = a->z + a->w;
+                db = b->z + b->w;
+            } else {
+                da = a->w - a->z;
+                db = b->w - b->z;
+            }
+
+            if (da >= 0) dst[outCount++] = *a;
+            if ((da >= 0) != (db >= 0)) {
+                dst[outCount++] = __sc_software_lerpClip(a, b, da / (da - db));
+            }
+        }
+        count = outCount;
+        if (count == 0) return 0;
+
+        src = dst;
+        dst = (dst == scratch) ? out : scratch;
+    }
+    if (src != out) memcpy(out, src, count * sizeof(saci_SoftwareClipVertex));
+    return count;
+}
+
+saci_SoftwareVertex __sc_software_toScreen(const saci_SoftwareRenderer* software, const saci_SoftwareClipVertex* clip) {
+    float invW = 1.0f / clip->w;
+    saci_SoftwareVertex v;
+    v.x = (clip->x * invW * 0.5f + 0.5f) * software->width;
+    v.y = (0.5f - clip->y * invW * 0.5f) * software->height; // rows go top to bottom
+    v.z = clip->z * invW * 0.5f + 0.5f;
+    v.invW = invW;
+    v.r = clip->r * invW;
+    v.g = clip->g * invW;
+    v.b = clip->b * invW;
+    v.a = clip->a * invW;
+    v.u = clip->u * invW;
+    v.v = clip->v * invW;
+    return v;
+}
+
+saci_SoftwarePrimitive* __sc_software_newPrimitive(saci_SoftwareRenderer* software) {
+    if (software->primitiveCount == software->primitiveCapacity) {
+        saci_u32 newCapacity = software->primitiveCapacity ? software->primitiveCapacity * 2 : 1024;
+        saci_SoftwarePrimitive* primitives = (saci_SoftwarePrimitive*)realloc(software->primitives, newCapacity * sizeof(saci_SoftwarePrimitive));
+        if (!primitives) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return NULL;
+        }
+        software->primitives = primitives;
+        software->primitiveCapacity = newCapacity;
+    }
+    return &software->primitives[software->primitiveCount++];
+}
+
+void __sc_software_setupTriangle(saci_SoftwareRenderer* software, saci_SoftwareVertex a, saci_SoftwareVertex b, saci_SoftwareVertex c, saci_TextureID texID) {
+    // Twice the signed area, flip the winding so the inside is always E >= 0.
+    // Nothing is culled, just like GL with GL_CULL_FACE disabled
+    float area = (c.x - b.x) * (a.y - b.y) - (c.y - b.y) * (a.x - b.x);
+    if (area == 0.0f || area != area) return;
+    if (area < 0.0f) {
+        saci_SoftwareVertex tmp = b;
+        b = c;
+        c = tmp;
+        area = -area;
+    }
+
+    float minX = fminf(a.x, fminf(b.x, c.x));
+    float minY = fminf(a.y, fminf(b.y, c.y));
+    float maxX = fmaxf(a.x, fmaxf(b.x, c.x));
+    float maxY = fmaxf(a.y, fmaxf(b.y, c.y));
+    if (maxX < 0 || maxY < 0 || minX >= software->width || minY >= software->height) return;
+
+    saci_SoftwarePrimitive* prim = __sc_software_newPrimitive(software);
+    if (!prim) return;
+
+    prim->v[0] = a;
+    prim->v[1] = b;
+    prim->v[2] = c;
+    prim->textureID = texID;
+    prim->isLine = SACI_FALSE;
+    prim->minX = minX < 0 ? 0 : (int)minX;
+    prim->minY = minY < 0 ? 0 : (int)minY;
+    prim->maxX = maxX >= software->width ? software->width - 1 : (int)maxX;
+    prim->maxY = maxY >= software->height ? software->height - 1 : (int)maxY;
+
+    // Edge i is opposite to vertex i, so E_i / area is vertex i's weight
+    for (int i = 0; i < 3; ++i) {
+        const saci_SoftwareVertex* va = &prim->v[(i + 1) % 3];
+        const saci_SoftwareVertex* vb = &prim->v[(i + 2) % 3];
+        prim->edgeA[i] = va->y - vb->y;
+        prim->edgeB[i] = vb->x - va->x;
+        prim->edgeC[i] = va->x * vb->y - va->y * vb->x;
+        prim->edgeInclusive[i] = prim->edgeA[i] > 0 || (prim->edgeA[i] == 0 && prim->edgeB[i] > 0);
+    }
+    prim->invArea = 1.0f / area;
+}
+
+void __sc_software_setupLine(saci_SoftwareRenderer* software, saci_SoftwareVertex a, saci_SoftwareVertex b, saci_TextureID texID) {
+    float minX = fminf(a.x, b.x), maxX = fmaxf(a.x, b.x);
+    float minY = fminf(a.y, b.y), maxY = fmaxf(a.y, b.y);
+    if (maxX < 0 || maxY < 0 || minX >= software->width || minY >= software->height) return;
+
+    saci_SoftwarePrimitive* prim = __sc_software_newPrimitive(software);
+    if (!prim) return;
+
+    prim->v[0] = a;
+    prim->v[1] = b;
+    prim->v[2] = b; // weight is always 0, just keep it finite
+    prim->textureID = texID;
+    prim->isLine = SACI_TRUE;
+    prim->minX = minX < 0 ? 0 : (int)minX;
+    prim->minY = minY < 0 ? 0 : (int)minY;
+    prim->maxX = maxX >= software->width ? software->width - 1 : (int)maxX;
+    prim->maxY = maxY >= software->height ? software->height - 1 : (int)maxY;
+}
+
+void __sc_software_addTriangle(saci_SoftwareRenderer* software, const sc_RenderConfig* config, const saci_Mat4* mvp,
+                               const saci_Vertice* a, const saci_Vertice* b, const saci_Vertice* c, saci_TextureID texID) {
+    saci_SoftwareClipVertex polygon[9];
+    polygon[0] = __sc_software_toClip(mvp, a);
+    polygon[1] = __sc_software_toClip(mvp, b);
+    polygon[2] = __sc_software_toClip(mvp, c);
+
+    int count = __sc_software_clipPolygon(polygon, 3, polygon);
+    if (count < 3) return;
+
+    saci_SoftwareVertex screen[9];
+    for (int i = 0; i < count; ++i) {
+        screen[i] = __sc_software_toScreen(software, &polygon[i]);
+    }
+
+    if (!config->shouldFillShape) {
+        // glPolygonMode(GL_LINE) outlines the triangle, edges made by the
+        // clipper are drawn too, GL does the same
+        for (int i = 0; i < count; ++i) {
+            __sc_software_setupLine(software, screen[i], screen[(i + 1) % count], texID);
+        }
+        return;
+    }
+
+    for (int i = 1; i + 1 < count; ++i) {
+        __sc_software_setupTriangle(software, screen[0], screen[i], screen[i + 1], texID);
+    }
+}
+
+void __sc_software_addLine(saci_SoftwareRenderer* software, const saci_Mat4* mvp,
+                           const saci_Vertice* a, const saci_Vertice* b, saci_TextureID texID) {
+    saci_SoftwareClipVertex ca = __sc_software_toClip(mvp, a);
+    saci_SoftwareClipVertex cb = __sc_software_toClip(mvp, b);
+
+    // Same planes as __sc_software_clipPolygon, on a segment
+    for (int plane = 0; plane < 3; ++plane) {
+        float da, db;
+        if (plane == 0) {
+            da = ca.w - SACI_SOFTWARE_MIN_W;
+            db = cb.w - SACI_SOFTWARE_MIN_W;
+        } else if (plane == 1) {
+            da = ca.z + ca.w;
+            db = cb.z + cb.w;
+        } else {
+            da = ca.w - ca.z;
+            db = cb.w - cb.z;
+        }
+        if (da < 0 && db < 0) return;
+        if (da < 0) {
+            ca = __sc_software_lerpClip(&ca, &cb, da / (da - db));
+        } else if (db < 0) {
+            cb = __sc_software_lerpClip(&ca, &cb, da / (da - db));
+        }
+    }
+
+    __sc_software_setupLine(software, __sc_software_toScreen(software, &ca), __sc_software_toScreen(software, &cb), texID);
+}
+
+// Single threaded pass, keeps each bin in submission order so the result
+// doesn't depend on how tiles get spread over the workers
+void __sc_software_binPrimitives(saci_SoftwareRenderer* software) {
+    for (int i = 0; i < software->tilesX * software->tilesY; ++i) {
+        software->bins[i].count = 0;
+    }
+
+    for (saci_u32 p = 0; p < software->primitiveCount; ++p) {
+        const saci_SoftwarePrimitive* prim = &software->primitives[p];
+        int tileMinX = prim->minX / SACI_SOFTWARE_TILE_SIZE;
+        int tileMinY = prim->minY / SACI_SOFTWARE_TILE_SIZE;
+        int tileMaxX = prim->maxX / SACI_SOFTWARE_TILE_SIZE;
+        int tileMaxY = prim->maxY / SACI_SOFTWARE_TILE_SIZE;
+
+        for (int ty = tileMinY; ty <= tileMaxY; ++ty) {
+            for (int tx = tileMinX; tx <= tileMaxX; ++tx) {
+                saci_SoftwareBin* bin = &software->bins[ty * software->tilesX + tx];
+                if (bin->count == bin->capacity) {
+                    saci_u32 newCapacity = bin->capacity ? bin->capacity * 2 : 64;
+                    saci_u32* primitives = (saci_u32*)realloc(bin->primitives, newCapacity * sizeof(saci_u32));
+                    if (!primitives) {
+                        fprintf(stderr, "Memory allocation failed.\n");
+                        continue;
+                    }
+                    bin->primitives = primitives;
+                    bin->capacity = newCapacity;
+                }
+                bin->primitives[bin->count++] = p;
+            }
+        }
+    }
+}
+
+void __sc_software_rasterizeTile(void* userData, saci_u32 tileIndex, saci_u32 workerIndex) {
+    (void)workerIndex;
+    saci_SoftwareRenderer* software = (saci_SoftwareRenderer*)userData;
+    const saci_SoftwareBin* bin = &software->bins[tileIndex];
+
+    int tileMinX = (tileIndex % software->tilesX) * SACI_SOFTWARE_TILE_SIZE;
+    int tileMinY = (tileIndex / software->tilesX) * SACI_SOFTWARE_TILE_SIZE;
+    int tileMaxX = tileMinX + SACI_SOFTWARE_TILE_SIZE - 1;
+    int tileMaxY = tileMinY + SACI_SOFTWARE_TILE_SIZE - 1;
+    if (tileMaxX >= software->width) tileMaxX = software->width - 1;
+    if (tileMaxY >= software->height) tileMaxY = software->height - 1;
+
+    for (saci_u32 i = 0; i < bin->count; ++i) {
+        const saci_SoftwarePrimitive* prim = &software->primitives[bin->primitives[i]];
+        if (prim->isLine) {
+            __sc_software_rasterizeLine(software, prim, tileMinX, tileMinY, tileMaxX, tileMaxY);
+        } else {
+            __sc_software_rasterizeTriangle(software, prim, tileMinX, tileMinY, tileMaxX, tileMaxY);
+        }
+    }
+}
+
+void __sc_software_rasterizeTriangle(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                                     int tileMinX, int tileMinY, int tileMaxX, int tileMaxY) {
+    int x0 = prim->minX > tileMinX ? prim->minX : tileMinX;
+    int y0 = prim->minY > tileMinY ? prim->minY : tileMinY;
+    int x1 = prim->maxX < tileMaxX ? prim->maxX : tileMaxX;
+    int y1 = prim->maxY < tileMaxY ? prim->maxY : tileMaxY;
+    if (x0 > x1 || y0 > y1) return;
+
+    // Both paths evaluate (A * px + B * py) + C at pixel centers in the same
+    // order, so triangles sharing an edge get exactly opposite values and the
+    // fill rule stays watertight
+#if defined(__SSE2__)
+    const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 edgeA[3], edgeC[3];
+    for (int e = 0; e < 3; ++e) {
+        edgeA[e] = _mm_set1_ps(prim->edgeA[e]);
+        edgeC[e] = _mm_set1_ps(prim->edgeC[e]);
+    }
+
+    for (int y = y0; y <= y1; ++y) {
+        float py = (float)y + 0.5f;
+        __m128 rowTerm[3];
+        for (int e = 0; e < 3; ++e) {
+            rowTerm[e] = _mm_set1_ps(prim->edgeB[e] * py);
+        }
+
+        for (int x = x0; x <= x1; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), laneOffsets);
+            __m128 edge[3];
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int e = 0; e < 3; ++e) {
+                edge[e] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edgeA[e], px), rowTerm[e]), edgeC[e]);
+                __m128 test = prim->edgeInclusive[e] ? _mm_cmpge_ps(edge[e], zero) : _mm_cmpgt_ps(edge[e], zero);
+                inside = _mm_and_ps(inside, test);
+            }
+
+            int mask = _mm_movemask_ps(inside);
+            int lanes = x1 - x + 1;
+            if (lanes < 4) mask &= (1 << lanes) - 1;
+            if (!mask) continue;
+
+            float e0[4], e1[4], e2[4];
+            _mm_storeu_ps(e0, edge[0]);
+            _mm_storeu_ps(e1, edge[1]);
+            _mm_storeu_ps(e2, edge[2]);
+            for (int lane = 0; lane < 4; ++lane) {
+                if (!(mask & (1 << lane))) continue;
+                __sc_software_shadePixel(software, prim, x + lane, y,
+                                         e0[lane] * prim->invArea, e1[lane] * prim->invArea, e2[lane] * prim->invArea);
+            }
+        }
+    }
+#else
+    for (int y = y0; y <= y1; ++y) {
+        float py = (float)y + 0.5f;
+        float rowTerm[3];
+        for (int e = 0; e < 3; ++e) {
+            rowTerm[e] = prim->edgeB[e] * py;
+        }
+
+        for (int x = x0; x <= x1; ++x) {
+            float px = (float)x + 0.5f;
+            float edge[3];
+            saci_Bool inside = SACI_TRUE;
+            for (int e = 0; e < 3; ++e) {
+                edge[e] = ((prim->edgeA[e] * px) + rowTerm[e]) + prim->edgeC[e];
+                inside &= prim->edgeInclusive[e] ? edge[e] >= 0 : edge[e] > 0;
+            }
+            if (!inside) continue;
+            __sc_software_shadePixel(software, prim, x, y,
+                                     edge[0] * prim->invArea, edge[1] * prim->invArea, edge[2] * prim->invArea);
+        }
+    }
+#endif
+}
+
+// DDA over the major axis, clipped to the tile so every pixel is owned by
+// exactly one worker
+void __sc_software_rasterizeLine(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                                 int tileMinX, int tileMinY, int tileMaxX, int tileMaxY) {
+    const saci_SoftwareVertex* a = &prim->v[0];
+    const saci_SoftwareVertex* b = &prim->v[1];
+    float dx = b->x - a->x;
+    float dy = b->y - a->y;
+    float length = fmaxf(fabsf(dx), fabsf(dy));
+    int steps = (int)ceilf(length);
+    if (steps < 1) steps = 1;
+
+    for (int i = 0; i <= steps; ++i) {
+        float t = (float)i / steps;
+        int x = (int)floorf(a->x + dx * t);
+        int y = (int)floorf(a->y + dy * t);
+        if (x < tileMinX || x > tileMaxX || y < tileMinY || y > tileMaxY) continue;
+        __sc_software_shadePixel(software, prim, x, y, 1.0f - t, t, 0.0f);
+    }
+}
+
+void __sc_software_shadePixel(saci_SoftwareRenderer* software, const saci_SoftwarePrimitive* prim,
+                              int x, int y, float w0, float w1, float w2) {
+    const saci_SoftwareVertex* v = prim->v;
+    size_t index = (size_t)y * software->width + x;
+
+    float z = w0 * v[0].z + w1 * v[1].z + w2 * v[2].z;
+    if (software->useZBuffer) {
+        if (!(z < software->depth[index])) return; // GL_LESS
+        software->depth[index] = z;
+    }
+
+    float invW = w0 * v[0].invW + w1 * v[1].invW + w2 * v[2].invW;
+    float wCorrect = 1.0f / invW;
+    float rgba[4] = {
+        (w0 * v[0].r + w1 * v[1].r + w2 * v[2].r) * wCorrect,
+        (w0 * v[0].g + w1 * v[1].g + w2 * v[2].g) * wCorrect,
+        (w0 * v[0].b + w1 * v[1].b + w2 * v[2].b) * wCorrect,
+        (w0 * v[0].a + w1 * v[1].a + w2 * v[2].a) * wCorrect,
+    };
+
+    if (prim->textureID != 0) {
+        float u = (w0 * v[0].u + w1 * v[1].u + w2 * v[2].u) * wCorrect;
+        float t = (w0 * v[0].v + w1 * v[1].v + w2 * v[2].v) * wCorrect;
+        float texel[4];
+        __sc_software_sampleTexture(prim->textureID, u, t, texel);
+        for (int i = 0; i < 4; ++i) rgba[i] *= texel[i];
+    }
+
+    if (software->alphaBlending) {
+        // glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA), alpha included
+        saci_u8 dst[4];
+        memcpy(dst, &software->color[index], sizeof(dst));
+        float srcAlpha = rgba[3] < 0.0f ? 0.0f : (rgba[3] > 1.0f ? 1.0f : rgba[3]);
+        for (int i = 0; i < 4; ++i) {
+            rgba[i] = rgba[i] * srcAlpha + dst[i] / 255.0f * (1.0f - srcAlpha);
+        }
+    }
+    software->color[index] = __sc_software_packColor(rgba[0], rgba[1], rgba[2], rgba[3]);
+}
+
+saci_SoftwareTexture* __sc_software_findTexture(saci_TextureID id) {
+    if (id == 0 || id > sc_softwareTextures.count || !sc_softwareTextures.slots[id - 1].pixels) return NULL;
+    return &sc_softwareTextures.slots[id - 1];
+}
+
+// Bilinear with GL_REPEAT wrapping, the defaults sc_TextureLoad ends up with.
+// Runs inside the frame's read lock on the registry
+void __sc_software_sampleTexture(saci_TextureID texID, float u, float v, float* rgba) {
+    const saci_SoftwareTexture* texture = __sc_software_findTexture(texID);
+    if (!texture) {
+        rgba[0] = rgba[1] = rgba[2] = 0.0f; // incomplete texture, same as GL
+        rgba[3] = 1.0f;
+        return;
+    }
+
+    float fx = (u - floorf(u)) * texture->width - 0.5f;
+    float fy = (v - floorf(v)) * texture->height - 0.5f;
+    int x0 = (int)floorf(fx);
+    int y0 = (int)floorf(fy);
+    float tx = fx - x0;
+    float ty = fy - y0;
+
+    int xs[2] = {(x0 + texture->width) % texture->width, (x0 + 1 + texture->width) % texture->width};
+    int ys[2] = {(y0 + texture->height) % texture->height, (y0 + 1 + texture->height) % texture->height};
+    const saci_u8* t00 = &texture->pixels[((size_t)ys[0] * texture->width + xs[0]) * 4];
+    const saci_u8* t10 = &texture->pixels[((size_t)ys[0] * texture->width + xs[1]) * 4];
+    const saci_u8* t01 = &texture->pixels[((size_t)ys[1] * texture->width + xs[0]) * 4];
+    const saci_u8* t11 = &texture->pixels[((size_t)ys[1] * texture->width + xs[1]) * 4];
+
+    for (int i = 0; i < 4; ++i) {
+        float top = t00[i] + (t10[i] - t00[i]) * tx;
+        float bottom = t01[i] + (t11[i] - t01[i]) * tx;
+        rgba[i] = (top + (bottom - top) * ty) * (1.0f / 255.0f);
+    }
+}
+
+saci_u32 __sc_software_packColor(float r, float g, float b, float a) {
+    float channels[4] = {r, g, b, a};
+    saci_u8 bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        float c = channels[i] < 0.0f ? 0.0f : (channels[i] > 1.0f ? 1.0f : channels[i]);
+        bytes[i] = (saci_u8)(c * 255.0f + 0.5f);
+    }
+    saci_u32 packed;
+    memcpy(&packed, bytes, sizeof(packed)); // keeps RGBA byte order on any endianness
+    return packed;
+}
@@ -0,0 +1,618 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-static-batch.h"
+#include "saci-core/sc-shadering.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+typedef struct saci_StaticBatchItem {
+    saci_TextureID textureID;
+    saci_u32 firstVertex, vertexCount;
+    saci_u32 localFirstIndex; // into batch->indices, relative to firstVertex
+    saci_u32 firstIndex;      // into the built index buffer
+    saci_u32 indexCount;
+    saci_Vec3 boundsMin, boundsMax; // world space
+    saci_Bool enabled;
+    saci_u32 slot; // position in batch->order once built
+} saci_StaticBatchItem;
+
+typedef struct saci_StaticBatchGroup {
+    saci_TextureID textureID;
+    saci_u32 firstItem, itemCount; // into batch->order
+    saci_u32 firstRun, runCount;   // into batch->runCounts/runOffsets
+    saci_u32 enabledIndexCount;
+} saci_StaticBatchGroup;
+
+// std430 Item of the culling shader, one per built item in texture order
+typedef struct saci_StaticBatchCullItem {
+    float boundsMin[4], boundsMax[4];
+    saci_u32 firstIndex;
+    saci_u32 indexCount; // 0 for disabled items
+    saci_u32 group;
+    saci_u32 firstCommand; // the group's first slot in the command buffer
+} saci_StaticBatchCullItem;
+
+// Layout glMultiDrawElementsIndirect reads
+typedef struct saci_DrawElementsIndirectCommand {
+    saci_u32 count, instanceCount, firstIndex;
+    saci_s32 baseVertex;
+    saci_u32 baseInstance;
+} saci_DrawElementsIndirectCommand;
+
+struct sc_StaticBatch {
+    saci_u32 vao, vbo, ibo; // 0 until built with a GL context
+
+    // World space, in the order items were added
+    saci_Vertice* vertices;
+    saci_u32 vertexCount, vertexCapacity;
+    saci_u32* indices;
+    saci_u32 indexCount, indexCapacity;
+
+    saci_StaticBatchItem* items;
+    saci_u32 itemCount, itemCapacity;
+    saci_u32 builtItemCount; // later items wait for the next build
+
+    saci_u32* order; // built item IDs sorted by texture
+    saci_StaticBatchGroup* groups;
+    saci_u32 groupCount;
+
+    // Ranges of contiguous enabled items, what glMultiDrawElements gets
+    GLsizei* runCounts;
+    const void** runOffsets;
+    saci_Bool runsDirty;
+
+    // See sc_StaticBatchSetGPUCulling. Every group owns itemCount commands
+    // from its firstItem on, visible items are packed at the front and the
+    // rest stay zeroed, which draws nothing
+    saci_Bool gpuCulling;
+    saci_u32 cullItemBuffer, commandBuffer, visibleBuffer; // 0 until uploaded
+    saci_StaticBatchCullItem* cullItems; // mirrors cullItemBuffer
+    saci_u32 cullDirtyFirst, cullDirtyEnd; // cullItems to upload again
+    saci_Bool commandsReady; // culled for the current frame
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_staticBatch_sortOrder(sc_StaticBatch* batch);
+void __sc_staticBatch_buildRuns(sc_StaticBatch* batch);
+saci_Bool __sc_staticBatch_gpuCullingSupported(void);
+void __sc_staticBatch_uploadCullItems(sc_StaticBatch* batch);
+saci_Bool __sc_staticBatch_initCullProgram(sc_Renderer* renderer);
+saci_Bool __sc_staticBatch_cull(sc_Renderer* renderer, sc_StaticBatch* batch);
+
+//----------------------------------------------------------------------------//
+// Static Batch Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_StaticBatch* sc_CreateStaticBatch(void) {
+    sc_StaticBatch* batch = (sc_StaticBatch*)calloc(1, sizeof(sc_StaticBatch));
+    assert(batch);
+    return batch;
+}
+
+void sc_DeleteStaticBatch(sc_StaticBatch* batch) {
+    if (!batch) return;
+    if (batch->vao) {
+        glDeleteVertexArrays(1, &batch->vao);
+        glDeleteBuffers(1, &batch->vbo);
+        glDeleteBuffers(1, &batch->ibo);
+    }
+    if (batch->cullItemBuffer) {
+        glDeleteBuffers(1, &batch->cullItemBuffer);
+        glDeleteBuffers(1, &batch->commandBuffer);
+        glDeleteBuffers(1, &batch->visibleBuffer);
+    }
+    free(batch->cullItems);
+    free(batch->vertices);
+    free(batch->indices);
+    free(batch->items);
+    free(batch->order);
+    free(batch->groups);
+    free(batch->runCounts);
+    free(batch->runOffsets);
+    free(batch);
+}
+
+saci_u32 sc_StaticBatchAdd(sc_StaticBatch* batch, const sc_Mesh* mesh, const saci_Mat4* model) {
+    saci_Mat4 identity = saci_IdentityMat4();
+    if (!model) model = &identity;
+
+    saci_u32 firstIndex = mesh->lodCount ? mesh->lods[0].firstIndex : 0;
+    saci_u32 indexCount = mesh->lodCount ? mesh->lods[0].indexCount : mesh->indexCount;
+
+    if (!saci_Reserve((void**)&batch->vertices, &batch->vertexCapacity, batch->vertexCount + mesh->vertexCount,
+                      sizeof(saci_Vertice)) ||
+        !saci_Reserve((void**)&batch->indices, &batch->indexCapacity, batch->indexCount + indexCount,
+                      sizeof(saci_u32)) ||
+        !saci_Reserve((void**)&batch->items, &batch->itemCapacity, batch->itemCount + 1,
+                      sizeof(saci_StaticBatchItem))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return UINT32_MAX;
+    }
+
+    saci_StaticBatchItem* item = &batch->items[batch->itemCount];
+    item->textureID = mesh->textureID;
+    item->firstVertex = batch->vertexCount;
+    item->vertexCount = mesh->vertexCount;
+    item->localFirstIndex = batch->indexCount;
+    item->firstIndex = 0;
+    item->indexCount = indexCount;
+    item->enabled = SACI_TRUE;
+
+    // Pre-transformed, the whole batch then draws with an identity model
+    for (saci_u32 i = 0; i < mesh->vertexCount; ++i) {
+        saci_Vertice vertice = mesh->vertices[i];
+        const float (*m)[4] = model->m;
+        saci_Vec3 p = vertice.pos;
+        vertice.pos = (saci_Vec3){
+            m[0][0] * p.x + m[1][0] * p.y + m[2][0] * p.z + m[3][0],
+            m[0][1] * p.x + m[1][1] * p.y + m[2][1] * p.z + m[3][1],
+            m[0][2] * p.x + m[1][2] * p.y + m[2][2] * p.z + m[3][2],
+        };
+        batch->vertices[batch->vertexCount + i] = vertice;
+
+        if (i == 0) {
+            item->boundsMin = item->boundsMax = vertice.pos;
+            continue;
+        }
+        if (vertice.pos.x < item->boundsMin.x) item->boundsMin.x = vertice.pos.x;
+        if (vertice.pos.y < item->boundsMin.y) item->boundsMin.y = vertice.pos.y;
+        if (vertice.pos.z < item->boundsMin.z) item->boundsMin.z = vertice.pos.z;
+        if (vertice.pos.x > item->boundsMax.x) item->boundsMax.x = vertice.pos.x;
+        if (vertice.pos.y > item->boundsMax.y) item->boundsMax.y = vertice.pos.y;
+        if (vertice.pos.z > item->boundsMax.z) item->boundsMax.z = vertice.pos.z;
+    }
+    memcpy(batch->indices + batch->indexCount, mesh->indices + firstIndex, indexCount * sizeof(saci_u32));
+
+    batch->vertexCount += mesh->vertexCount;
+    batch->indexCount += indexCount;
+    return batch->itemCount++;
+}
+
+void sc_StaticBatchBuild(sc_StaticBatch* batch) {
+    saci_u32 itemCount = batch->itemCount;
+    if (itemCount == 0) return;
+
+    saci_u32* order = (saci_u32*)realloc(batch->order, itemCount * sizeof(saci_u32));
+    saci_StaticBatchGroup* groups = (saci_StaticBatchGroup*)realloc(batch->groups, itemCount * sizeof(saci_StaticBatchGroup));
+    GLsizei* runCounts = (GLsizei*)realloc(batch->runCounts, itemCount * sizeof(GLsizei));
+    const void** runOffsets = (const void**)realloc((void*)batch->runOffsets, itemCount * sizeof(void*));
+    if (order) batch->order = order;
+    if (groups) batch->groups = groups;
+    if (runCounts) batch->runCounts = runCounts;
+    if (runOffsets) batch->runOffsets = runOffsets;
+    if (!order || !groups || !runCounts || !runOffsets) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+
+    for (saci_u32 i = 0; i < itemCount; ++i) order[i] = i;
+    batch->builtItemCount = itemCount;
+    __sc_staticBatch_sortOrder(batch);
+
+    // Index buffer in texture order, so every group is one contiguous range
+    saci_u32* builtIndices = (saci_u32*)malloc(batch->indexCount * sizeof(saci_u32));
+    if (!builtIndices) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        batch->builtItemCount = 0;
+        return;
+    }
+    saci_u32 cursor = 0;
+    batch->groupCount = 0;
+    for (saci_u32 i = 0; i < itemCount; ++i) {
+        saci_StaticBatchItem* item = &batch->items[order[i]];
+        item->firstIndex = cursor;
+        item->slot = i;
+        for (saci_u32 j = 0; j < item->indexCount; ++j) {
+            builtIndices[cursor++] = batch->indices[item->localFirstIndex + j] + item->firstVertex;
+        }
+
+        if (batch->groupCount == 0 || groups[batch->groupCount - 1].textureID != item->textureID) {
+            saci_StaticBatchGroup* group = &groups[batch->groupCount++];
+            group->textureID = item->textureID;
+            group->firstItem = i;
+            group->itemCount = 0;
+        }
+        groups[batch->groupCount - 1].itemCount++;
+    }
+    batch->runsDirty = SACI_TRUE;
+
+    if (__sc_isGLLoaded()) {
+        if (!batch->vao) {
+            glGenVertexArrays(1, &batch->vao);
+            glGenBuffers(1, &batch->vbo);
+            glGenBuffers(1, &batch->ibo);
+        }
+        glBindVertexArray(batch->vao);
+        glBindBuffer(GL_ARRAY_BUFFER, batch->vbo);
+        glBufferData(GL_ARRAY_BUFFER, batch->vertexCount * sizeof(saci_Vertice), batch->vertices, GL_STATIC_DRAW);
+        __sc_setVertexLayout();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, cursor * sizeof(saci_u32), builtIndices, GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (batch->gpuCulling) __sc_staticBatch_uploadCullItems(batch);
+    }
+    free(builtIndices);
+}
+
+saci_u32 sc_StaticBatchItemCount(const sc_StaticBatch* batch) {
+    return batch->itemCount;
+}
+
+void sc_StaticBatchSetEnabled(sc_StaticBatch* batch, saci_u32 item, saci_Bool enabled) {
+    if (item >= batch->itemCount || batch->items[item].enabled == enabled) return;
+    batch->items[item].enabled = enabled;
+    batch->runsDirty = SACI_TRUE;
+
+    if (batch->cullItems && item < batch->builtItemCount) {
+        saci_u32 slot = batch->items[item].slot;
+        batch->cullItems[slot].indexCount = enabled ? batch->items[item].indexCount : 0;
+        if (batch->cullDirtyEnd == batch->cullDirtyFirst) {
+            batch->cullDirtyFirst = slot;
+            batch->cullDirtyEnd = slot + 1;
+        } else {
+            if (slot < batch->cullDirtyFirst) batch->cullDirtyFirst = slot;
+            if (slot + 1 > batch->cullDirtyEnd) batch->cullDirtyEnd = slot + 1;
+        }
+    }
+}
+
+saci_Bool sc_StaticBatchIsEnabled(const sc_StaticBatch* batch, saci_u32 item) {
+    return item < batch->itemCount && batch->items[item].enabled;
+}
+
+saci_Bool sc_StaticBatchSetGPUCulling(sc_StaticBatch* batch, saci_Bool enabled) {
+    if (enabled && !__sc_staticBatch_gpuCullingSupported()) {
+        fprintf(stderr, "GPU culling needs OpenGL 4.3.\n");
+        return SACI_FALSE;
+    }
+    batch->gpuCulling = enabled;
+    batch->commandsReady = SACI_FALSE;
+    if (enabled && batch->vao && !batch->cullItemBuffer) __sc_staticBatch_uploadCullItems(batch);
+    return SACI_TRUE;
+}
+
+//----------------------------------------------------------------------------//
+// Static Batch Usage
+//----------------------------------------------------------------------------//
+
+void sc_RenderPushStaticBatch(sc_Renderer* renderer, sc_StaticBatch* batch) {
+    if (!batch) return;
+    if (renderer->staticBatchCount == renderer->staticBatchCapacity) {
+        saci_u32 newCapacity = renderer->staticBatchCapacity ? renderer->staticBatchCapacity * 2 : 8;
+        sc_StaticBatch** batches = (sc_StaticBatch**)realloc(renderer->staticBatches, newCapacity * sizeof(sc_StaticBatch*));
+        if (!batches) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return;
+        }
+        renderer->staticBatches = batches;
+        renderer->staticBatchCapacity = newCapacity;
+    }
+    renderer->staticBatches[renderer->staticBatchCount++] = batch;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __sc_staticBatch_prepareDraws(sc_Renderer* renderer) {
+    for (saci_u32 i = 0; i < renderer->staticBatchCount; ++i) {
+        sc_StaticBatch* batch = renderer->staticBatches[i];
+        if (batch->runsDirty) __sc_staticBatch_buildRuns(batch);
+
+        batch->commandsReady = SACI_FALSE;
+        if (renderer->backend == SACI_RENDER_BACKEND_OPENGL && batch->gpuCulling && batch->cullItemBuffer) {
+            batch->commandsReady = __sc_staticBatch_cull(renderer, batch);
+        }
+        if (renderer->backend == SACI_RENDER_BACKEND_SOFTWARE) {
+            __sc_staticBatch_pushTriangles(renderer, batch);
+        }
+    }
+}
+
+void __sc_staticBatch_submitDraws(sc_Renderer* renderer, saci_RenderPass pass) {
+    if (renderer->staticBatchCount == 0) return;
+
+    // Same split as __sc_submitBatch, the null backend only counts
+    saci_Bool issueGL = renderer->backend == SACI_RENDER_BACKEND_OPENGL;
+    saci_Bool shade = pass == SACI_RENDER_PASS_SHADE;
+    sc_RenderStats* stats = &renderer->frameStats;
+
+    if (issueGL) {
+        glUseProgram(renderer->shaderProgram);
+        saci_Mat4 identity = saci_IdentityMat4();
+        glUniformMatrix4fv(renderer->modelLoc, 1, GL_FALSE, &identity.m[0][0]);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    int useTexture = -1;
+    for (saci_u32 i = 0; i < renderer->staticBatchCount; ++i) {
+        const sc_StaticBatch* batch = renderer->staticBatches[i];
+        if (issueGL) {
+            if (!batch->vao) continue;
+            glBindVertexArray(batch->vao);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->commandsReady ? batch->commandBuffer : 0);
+        }
+
+        for (saci_u32 g = 0; g < batch->groupCount; ++g) {
+            const saci_StaticBatchGroup* group = &batch->groups[g];
+            if (group->runCount == 0) continue;
+
+            if (issueGL) {
+                if (shade && useTexture != (group->textureID != 0)) {
+                    useTexture = group->textureID != 0;
+                    glUniform1i(renderer->useTextureLoc, useTexture);
+                }
+                if (shade && group->textureID != 0) glBindTexture(GL_TEXTURE_2D, group->textureID);
+
+                if (batch->commandsReady) {
+                    size_t offset = group->firstItem * sizeof(saci_DrawElementsIndirectCommand);
+                    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)offset,
+                                                (GLsizei)group->itemCount, 0);
+                } else if (group->runCount == 1) {
+                    glDrawElements(GL_TRIANGLES, batch->runCounts[group->firstRun], GL_UNSIGNED_INT,
+                                   batch->runOffsets[group->firstRun]);
+                } else {
+                    glMultiDrawElements(GL_TRIANGLES, batch->runCounts + group->firstRun, GL_UNSIGNED_INT,
+                                        batch->runOffsets + group->firstRun, (GLsizei)group->runCount);
+                }
+            }
+            if (!shade) {
+                stats->depthPrePassDrawCalls++;
+                continue;
+            }
+            if (group->textureID != 0) stats->textureBinds++;
+            stats->drawCalls++;
+            stats->vertices += group->enabledIndexCount;
+            stats->triangles += group->enabledIndexCount / 3;
+        }
+    }
+
+    if (issueGL) {
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+}
+
+void __sc_staticBatch_deleteRendererObjects(sc_Renderer* renderer) {
+    if (renderer->cullProgram) glDeleteProgram(renderer->cullProgram);
+    renderer->cullProgram = 0;
+}
+
+void __sc_staticBatch_sortOrder(sc_StaticBatch* batch) {
+    saci_u32* order = batch->order;
+    saci_u32 count = batch->builtItemCount;
+    saci_u32* scratch = (saci_u32*)malloc(count * sizeof(saci_u32));
+    if (!scratch) {
+        // Unsorted still draws correctly, just with more calls
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    // Bottom up merge sort, stable so items keep their add order per texture
+    for (saci_u32 width = 1; width < count; width *= 2) {
+        for (saci_u32 left = 0; left < count; left += 2 * width) {
+            saci_u32 mid = left + width < count ? left + width : count;
+            saci_u32 right = left + 2 * width < count ? left + 2 * width : count;
+            saci_u32 a = left, b = mid, out = left;
+            while (a < mid && b < right) {
+                if (batch->items[order[b]].textureID < batch->items[order[a]].textureID) {
+                    scratch[out++] = order[b++];
+                } else {
+                    scratch[out++] = order[a++];
+                }
+            }
+            while (a < mid) scratch[out++] = order[a++];
+            while (b < right) scratch[out++] = order[b++];
+        }
+        memcpy(order, scratch, count * sizeof(saci_u32));
+    }
+    free(scratch);
+}
+
+void __sc_staticBatch_buildRuns(sc_StaticBatch* batch) {
+    saci_u32 runCount = 0;
+    for (saci_u32 g = 0; g < batch->groupCount; ++g) {
+        saci_StaticBatchGroup* group = &batch->groups[g];
+        group->firstRun = runCount;
+        group->runCount = 0;
+        group->enabledIndexCount = 0;
+
+        saci_Bool extending = SACI_FALSE;
+        for (saci_u32 i = group->firstItem; i < group->firstItem + group->itemCount; ++i) {
+            const saci_StaticBatchItem* item = &batch->items[batch->order[i]];
+            if (!item->enabled) {
+                extending = SACI_FALSE;
+                continue;
+            }
+            // Items follow each other in the index buffer, an enabled
+            // neighbour just makes the current range longer
+            if (extending) {
+                batch->runCounts[runCount - 1] += (GLsizei)item->indexCount;
+            } else {
+                batch->runCounts[runCount] = (GLsizei)item->indexCount;
+                batch->runOffsets[runCount] = (const void*)(item->firstIndex * sizeof(saci_u32));
+                runCount++;
+                group->runCount++;
+                extending = SACI_TRUE;
+            }
+            group->enabledIndexCount += item->indexCount;
+        }
+    }
+    batch->runsDirty = SACI_FALSE;
+}
+
+void __sc_staticBatch_pushTriangles(sc_Renderer* renderer, const sc_StaticBatch* batch) {
+    for (saci_u32 i = 0; i < batch->builtItemCount; ++i) {
+        const saci_StaticBatchItem* item = &batch->items[batch->order[i]];
+        if (!item->enabled) continue;
+        const saci_u32* indices = batch->indices + item->localFirstIndex;
+        const saci_Vertice* vertices = batch->vertices + item->firstVertex;
+        saci_u32 count = item->indexCount - item->indexCount % 3;
+        if (count == 0) continue;
+        saci_Vertice* expanded = __sc_renderBatch_Reserve(&renderer->renderBatch, GL_TRIANGLES, item->textureID, count);
+        if (!expanded) continue;
+        for (saci_u32 j = 0; j < count; ++j) expanded[j] = vertices[indices[j]];
+    }
+}
+
+saci_Bool __sc_staticBatch_gpuCullingSupported(void) {
+    return __sc_isGLLoaded() && GLAD_GL_VERSION_4_3;
+}
+
+void __sc_staticBatch_uploadCullItems(sc_StaticBatch* batch) {
+    saci_u32 count = batch->builtItemCount;
+    if (count == 0) return;
+    saci_StaticBatchCullItem* cullItems =
+        (saci_StaticBatchCullItem*)realloc(batch->cullItems, count * sizeof(saci_StaticBatchCullItem));
+    if (!cullItems) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+    batch->cullItems = cullItems;
+
+    for (saci_u32 g = 0; g < batch->groupCount; ++g) {
+        const saci_StaticBatchGroup* group = &batch->groups[g];
+        for (saci_u32 i = group->firstItem; i < group->firstItem + group->itemCount; ++i) {
+            const saci_StaticBatchItem* item = &batch->items[batch->order[i]];
+            saci_StaticBatchCullItem* cullItem = &cullItems[i];
+            cullItem->boundsMin[0] = item->boundsMin.x;
+            cullItem->boundsMin[1] = item->boundsMin.y;
+            cullItem->boundsMin[2] = item->boundsMin.z;
+            cullItem->boundsMin[3] = 1.0f;
+            cullItem->boundsMax[0] = item->boundsMax.x;
+            cullItem->boundsMax[1] = item->boundsMax.y;
+            cullItem->boundsMax[2] = item->boundsMax.z;
+            cullItem->boundsMax[3] = 1.0f;
+            cullItem->firstIndex = item->firstIndex;
+            cullItem->indexCount = item->enabled ? item->indexCount : 0;
+            cullItem->group = g;
+            cullItem->firstCommand = group->firstItem;
+        }
+    }
+
+    if (!batch->cullItemBuffer) {
+        glGenBuffers(1, &batch->cullItemBuffer);
+        glGenBuffers(1, &batch->commandBuffer);
+        glGenBuffers(1, &batch->visibleBuffer);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->cullItemBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(saci_StaticBatchCullItem), cullItems, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->commandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(saci_DrawElementsIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->visibleBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, batch->groupCount * sizeof(saci_u32), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    batch->cullDirtyFirst = batch->cullDirtyEnd = 0;
+}
+
+saci_Bool __sc_staticBatch_initCullProgram(sc_Renderer* renderer) {
+    const char* cShaderSource =
+        "#version 430 core\n"
+
+        "layout (local_size_x = 64) in;\n"
+
+        "struct Item {\n"
+        "   vec4 boundsMin;\n"
+        "   vec4 boundsMax;\n"
+        "   uint firstIndex;\n"
+        "   uint indexCount;\n"
+        "   uint group;\n"
+        "   uint firstCommand;\n"
+        "};\n"
+        "struct Command {\n"
+        "   uint count;\n"
+        "   uint instanceCount;\n"
+        "   uint firstIndex;\n"
+        "   int baseVertex;\n"
+        "   uint baseInstance;\n"
+        "};\n"
+
+        "layout (std430, binding = 0) readonly buffer Items { Item items[]; };\n"
+        "layout (std430, binding = 1) writeonly buffer Commands { Command commands[]; };\n"
+        "layout (std430, binding = 2) buffer Visible { uint visible[]; };\n"
+
+        "uniform vec4 uPlanes[6];\n"
+        "uniform uint uItemCount;\n"
+
+        "void main()\n"
+        "{\n"
+        "   uint i = gl_GlobalInvocationID.x;\n"
+        "   if (i >= uItemCount) return;\n"
+        "   Item item = items[i];\n"
+        "   if (item.indexCount == 0u) return;\n"
+        "   for (int p = 0; p < 6; ++p) {\n"
+        "       vec3 corner = mix(item.boundsMin.xyz, item.boundsMax.xyz, greaterThanEqual(uPlanes[p].xyz, vec3(0.0)));\n"
+        "       if (dot(uPlanes[p].xyz, corner) + uPlanes[p].w < 0.0) return;\n"
+        "   }\n"
+        "   uint slot = item.firstCommand + atomicAdd(visible[item.group], 1u);\n"
+        "   commands[slot] = Command(item.indexCount, 1u, item.firstIndex, 0, 0u);\n"
+        "}\n\0";
+
+    saci_u32 cShader = sc_CompileShaderC(cShaderSource);
+    if (cShader == 0) return SACI_FALSE;
+    renderer->cullProgram = sc_GetComputeShaderProgram(cShader);
+    if (renderer->cullProgram == 0) return SACI_FALSE;
+    renderer->cullPlanesLoc = glGetUniformLocation(renderer->cullProgram, "uPlanes");
+    renderer->cullItemCountLoc = glGetUniformLocation(renderer->cullProgram, "uItemCount");
+    return SACI_TRUE;
+}
+
+saci_Bool __sc_staticBatch_cull(sc_Renderer* renderer, sc_StaticBatch* batch) {
+    const saci_RenderFrame* frame = &renderer->frame;
+    // Nothing sensible to cull against, the CPU ranges draw everything enabled
+    if (frame->hasCamera && !frame->cameraValid) return SACI_FALSE;
+    if (!renderer->cullProgram && !__sc_staticBatch_initCullProgram(renderer)) return SACI_FALSE;
+
+    if (batch->cullDirtyEnd > batch->cullDirtyFirst) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->cullItemBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, batch->cullDirtyFirst * sizeof(saci_StaticBatchCullItem),
+                        (batch->cullDirtyEnd - batch->cullDirtyFirst) * sizeof(saci_StaticBatchCullItem),
+                        batch->cullItems + batch->cullDirtyFirst);
+        batch->cullDirtyFirst = batch->cullDirtyEnd = 0;
+    }
+
+    // Without a camera the positions already are clip space
+    sc_Frustum frustum;
+    if (frame->hasCamera) {
+        frustum = renderer->camera.frustum;
+    } else {
+        saci_Mat4 identity = saci_IdentityMat4();
+        frustum = sc_FrustumFromMatrix(&identity);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->commandBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch->visibleBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glUseProgram(renderer->cullProgram);
+    glUniform4fv(renderer->cullPlanesLoc, 6, &frustum.planes[0].x);
+    glUniform1ui(renderer->cullItemCountLoc, batch->builtItemCount);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, batch->cullItemBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch->commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch->visibleBuffer);
+    glDispatchCompute((batch->builtItemCount + 63) / 64, 1, 1);
+    // The commands are read by the indirect draws of both passes
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    glUseProgram(0);
+    return SACI_TRUE;
+}
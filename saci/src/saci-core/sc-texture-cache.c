@@ -0,0 +1,266 @@
+#include "saci-core/sc-texture.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_TEXTURE_CACHE_MIN_TABLE 64
+
+typedef struct saci_TextureCacheEntry {
+    char* path; // canonical
+    saci_Bool flipImg;
+    saci_u32 hash; // of path and flipImg
+    saci_TextureID id; // 0 for entries on the free list
+    saci_u32 references;
+    int width, height; // 0 until known, asynchronous loads fill them in later
+} saci_TextureCacheEntry;
+
+struct sc_TextureCache {
+    sc_TextureLoader* loader;
+
+    saci_TextureCacheEntry* entries;
+    saci_u32 entryCount, entryCapacity;
+    saci_u32* freeEntries;
+    saci_u32 freeCount;
+    saci_u32 liveCount;
+
+    // Open addressing with linear probing, both hold entry index + 1 and 0
+    // for an empty slot. Kept at most half full
+    saci_u32* byKey;
+    saci_u32* byId;
+    saci_u32 tableCapacity; // power of two
+
+    saci_u64 references;
+    saci_u64 hits, misses;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_u32 __sc_textureCache_hashKey(const char* path, saci_Bool flipImg);
+saci_u32 __sc_textureCache_hashId(saci_TextureID id);
+// Slot holding the entry, or the empty slot it would go in
+saci_u32 __sc_textureCache_findKey(const sc_TextureCache* cache, const char* path, saci_Bool flipImg, saci_u32 hash);
+saci_u32 __sc_textureCache_findId(const sc_TextureCache* cache, saci_TextureID id);
+// Backward shift deletion, keeps every probe sequence unbroken without tombstones
+void __sc_textureCache_removeSlot(sc_TextureCache* cache, saci_u32* table, saci_u32 slot, saci_Bool byId);
+saci_Bool __sc_textureCache_reserve(sc_TextureCache* cache);
+void __sc_textureCache_freeTexture(sc_TextureCache* cache, saci_TextureID id);
+
+//----------------------------------------------------------------------------//
+// Texture cache
+//----------------------------------------------------------------------------//
+
+sc_TextureCache* sc_CreateTextureCache(sc_TextureLoader* loader) {
+    sc_TextureCache* cache = (sc_TextureCache*)calloc(1, sizeof(sc_TextureCache));
+    assert(cache);
+    cache->loader = loader;
+    return cache;
+}
+
+void sc_DeleteTextureCache(sc_TextureCache* cache) {
+    if (!cache) return;
+    for (saci_u32 i = 0; i < cache->entryCount; ++i) {
+        saci_TextureCacheEntry* entry = &cache->entries[i];
+        if (entry->id == 0) continue;
+        __sc_textureCache_freeTexture(cache, entry->id);
+        free(entry->path);
+    }
+    free(cache->entries);
+    free(cache->freeEntries);
+    free(cache->byKey);
+    free(cache->byId);
+    free(cache);
+}
+
+saci_TextureID sc_TextureCacheAcquire(sc_TextureCache* cache, const char* path, saci_Bool flipImg) {
+    // A file that can't be resolved is keyed by the path as given, the load
+    // reports the error
+    char* canonical = realpath(path, NULL);
+    if (!canonical) canonical = strdup(path);
+    if (!canonical || !__sc_textureCache_reserve(cache)) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(canonical);
+        return 0;
+    }
+
+    saci_u32 hash = __sc_textureCache_hashKey(canonical, flipImg);
+    saci_u32 keySlot = __sc_textureCache_findKey(cache, canonical, flipImg, hash);
+    if (cache->byKey[keySlot] != 0) {
+        saci_TextureCacheEntry* entry = &cache->entries[cache->byKey[keySlot] - 1];
+        entry->references++;
+        cache->references++;
+        cache->hits++;
+        free(canonical);
+        return entry->id;
+    }
+
+    cache->misses++;
+    saci_TextureID id = cache->loader ? sc_TextureLoadAsync(cache->loader, path, flipImg) : sc_TextureLoad(path, flipImg);
+    if (id == 0) {
+        free(canonical);
+        return 0;
+    }
+
+    saci_u32 index = cache->freeCount > 0 ? cache->freeEntries[--cache->freeCount] : cache->entryCount++;
+    saci_TextureCacheEntry* entry = &cache->entries[index];
+    *entry = (saci_TextureCacheEntry){canonical, flipImg, hash, id, 1, 0, 0};
+    if (!cache->loader) __sc_texture_getSource(id, NULL, NULL, &entry->width, &entry->height);
+    cache->byKey[keySlot] = index + 1;
+    cache->byId[__sc_textureCache_findId(cache, id)] = index + 1;
+    cache->liveCount++;
+    cache->references++;
+    return id;
+}
+
+void sc_TextureCacheRetain(sc_TextureCache* cache, saci_TextureID textureID) {
+    saci_u32 slot = __sc_textureCache_findId(cache, textureID);
+    if (cache->tableCapacity == 0 || cache->byId[slot] == 0) {
+        fprintf(stderr, "Texture %u is not in the cache.\n", textureID);
+        return;
+    }
+    cache->entries[cache->byId[slot] - 1].references++;
+    cache->references++;
+}
+
+void sc_TextureCacheRelease(sc_TextureCache* cache, saci_TextureID textureID) {
+    saci_u32 idSlot = __sc_textureCache_findId(cache, textureID);
+    if (cache->tableCapacity == 0 || cache->byId[idSlot] == 0) {
+        fprintf(stderr, "Texture %u is not in the cache.\n", textureID);
+        return;
+    }
+    saci_u32 index = cache->byId[idSlot] - 1;
+    saci_TextureCacheEntry* entry = &cache->entries[index];
+    cache->references--;
+    if (--entry->references > 0) return;
+
+    saci_u32 keySlot = __sc_textureCache_findKey(cache, entry->path, entry->flipImg, entry->hash);
+    __sc_textureCache_removeSlot(cache, cache->byKey, keySlot, SACI_FALSE);
+    __sc_textureCache_removeSlot(cache, cache->byId, idSlot, SACI_TRUE);
+    __sc_textureCache_freeTexture(cache, entry->id);
+    free(entry->path);
+    entry->path = NULL;
+    entry->id = 0;
+    cache->freeEntries[cache->freeCount++] = index;
+    cache->liveCount--;
+}
+
+sc_TextureCacheStats sc_TextureCacheGetStats(const sc_TextureCache* cache) {
+    sc_TextureCacheStats stats = {cache->liveCount, cache->references, cache->hits, cache->misses, 0};
+    for (saci_u32 i = 0; i < cache->entryCount; ++i) {
+        const saci_TextureCacheEntry* entry = &cache->entries[i];
+        if (entry->id == 0) continue;
+        int width = entry->width, height = entry->height;
+        if (width == 0) {
+            // Recorded by the loader once the upload finished
+            if (!__sc_texture_getSource(entry->id, NULL, NULL, &width, &height)) continue;
+        }
+        size_t base = (size_t)width * height * 4;
+        stats.bytes += base + base / 3;
+    }
+    return stats;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_u32 __sc_textureCache_hashKey(const char* path, saci_Bool flipImg) {
+    saci_u8 flip = flipImg ? 1 : 0;
+    return saci_HashFNV1a(&flip, 1, saci_HashFNV1a(path, strlen(path), SACI_FNV1A_SEED));
+}
+
+saci_u32 __sc_textureCache_hashId(saci_TextureID id) {
+    // GL names are mostly sequential, spread them over the table
+    return id * 2654435769u;
+}
+
+saci_u32 __sc_textureCache_findKey(const sc_TextureCache* cache, const char* path, saci_Bool flipImg, saci_u32 hash) {
+    saci_u32 mask = cache->tableCapacity - 1;
+    saci_u32 slot = hash & mask;
+    while (cache->byKey[slot] != 0) {
+        const saci_TextureCacheEntry* entry = &cache->entries[cache->byKey[slot] - 1];
+        if (entry->hash == hash && entry->flipImg == flipImg && strcmp(entry->path, path) == 0) break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+saci_u32 __sc_textureCache_findId(const sc_TextureCache* cache, saci_TextureID id) {
+    if (cache->tableCapacity == 0) return 0;
+    saci_u32 mask = cache->tableCapacity - 1;
+    saci_u32 slot = __sc_textureCache_hashId(id) & mask;
+    while (cache->byId[slot] != 0 && cache->entries[cache->byId[slot] - 1].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void __sc_textureCache_removeSlot(sc_TextureCache* cache, saci_u32* table, saci_u32 slot, saci_Bool byId) {
+    saci_u32 mask = cache->tableCapacity - 1;
+    saci_u32 hole = slot;
+    for (saci_u32 next = (slot + 1) & mask; table[next] != 0; next = (next + 1) & mask) {
+        const saci_TextureCacheEntry* entry = &cache->entries[table[next] - 1];
+        saci_u32 home = (byId ? __sc_textureCache_hashId(entry->id) : entry->hash) & mask;
+        // Moves back unless its home lies cyclically in (hole, next]
+        saci_Bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (stays) continue;
+        table[hole] = table[next];
+        hole = next;
+    }
+    table[hole] = 0;
+}
+
+saci_Bool __sc_textureCache_reserve(sc_TextureCache* cache) {
+    if (cache->entryCount == cache->entryCapacity && cache->freeCount == 0) {
+        saci_u32 newCapacity = cache->entryCapacity ? cache->entryCapacity * 2 : 32;
+        saci_TextureCacheEntry* entries = (saci_TextureCacheEntry*)realloc(cache->entries,
+                                                                           newCapacity * sizeof(saci_TextureCacheEntry));
+        if (!entries) return SACI_FALSE;
+        cache->entries = entries;
+        saci_u32* freeEntries = (saci_u32*)realloc(cache->freeEntries, newCapacity * sizeof(saci_u32));
+        if (!freeEntries) return SACI_FALSE;
+        cache->freeEntries = freeEntries;
+        cache->entryCapacity = newCapacity;
+    }
+
+    if ((cache->liveCount + 1) * 2 <= cache->tableCapacity) return SACI_TRUE;
+    saci_u32 newCapacity = cache->tableCapacity ? cache->tableCapacity * 2 : SACI_TEXTURE_CACHE_MIN_TABLE;
+    saci_u32* byKey = (saci_u32*)calloc(newCapacity, sizeof(saci_u32));
+    saci_u32* byId = (saci_u32*)calloc(newCapacity, sizeof(saci_u32));
+    if (!byKey || !byId) {
+        free(byKey);
+        free(byId);
+        return SACI_FALSE;
+    }
+    free(cache->byKey);
+    free(cache->byId);
+    cache->byKey = byKey;
+    cache->byId = byId;
+    cache->tableCapacity = newCapacity;
+    for (saci_u32 i = 0; i < cache->entryCount; ++i) {
+        const saci_TextureCacheEntry* entry = &cache->entries[i];
+        if (entry->id == 0) continue;
+        cache->byKey[__sc_textureCache_findKey(cache, entry->path, entry->flipImg, entry->hash)] = i + 1;
+        cache->byId[__sc_textureCache_findId(cache, entry->id)] = i + 1;
+    }
+    return SACI_TRUE;
+}
+
+void __sc_textureCache_freeTexture(sc_TextureCache* cache, saci_TextureID id) {
+    if (cache->loader && sc_TextureLoaderIsPending(cache->loader, id)) {
+        sc_TextureLoaderCancel(cache->loader, id);
+    } else {
+        sc_TextureFree(id);
+    }
+}
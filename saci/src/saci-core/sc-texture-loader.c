@@ -0,0 +1,432 @@
+#include <glad/glad.h>
+
+#include "saci-core/sc-texture.h"
+#include "sc-rendering-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <stbi/stb_image.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+#define SACI_TEXTURE_LOADER_MAX_THREADS 16
+#define SACI_TEXTURE_LOADER_DEFAULT_BUDGET 2.0
+// Decoded images waiting for the GL thread, decoding pauses past it so a
+// long queue doesn't hold every image in memory at once
+#define SACI_TEXTURE_LOADER_MAX_DECODED 16
+// Uploaded per step, the budget is checked in between
+#define SACI_TEXTURE_LOADER_STRIP_BYTES (256 * 1024)
+
+static const saci_u8 sc_texturePlaceholder[4] = {128, 128, 128, 255};
+
+typedef enum saci_TextureRequestState {
+    SACI_TEXTURE_REQUEST_QUEUED,
+    SACI_TEXTURE_REQUEST_DECODING,
+    SACI_TEXTURE_REQUEST_DECODED, // or failed, pixels is NULL then
+    SACI_TEXTURE_REQUEST_UPLOADING,
+} saci_TextureRequestState;
+
+typedef struct saci_TextureRequest {
+    saci_TextureID id;
+    char* path;
+    saci_Bool flipImg;
+    saci_TextureRequestState state;
+    saci_Bool cancelled; // while a worker decodes it, dropped once it's back
+
+    saci_u8* pixels;
+    int width, height;
+    // Strips go here while the placeholder is still drawn, copied into id
+    // once complete
+    saci_TextureID staging;
+    saci_u32 rowsCopied;
+
+    struct saci_TextureRequest* next; // in the queued or decoded list
+} saci_TextureRequest;
+
+struct sc_TextureLoader {
+    pthread_t threads[SACI_TEXTURE_LOADER_MAX_THREADS];
+    saci_u32 threadCount;
+    pthread_mutex_t mutex;
+    pthread_cond_t workAvailable;
+    saci_Bool shutdown;
+
+    // Both FIFO, guarded by mutex
+    saci_TextureRequest* queuedHead;
+    saci_TextureRequest* queuedTail;
+    saci_TextureRequest* decodedHead;
+    saci_TextureRequest* decodedTail;
+    saci_u32 decodedCount;
+
+    // Every request not finished yet, for lookups by ID. GL thread only
+    saci_TextureRequest** pending;
+    saci_u32 pendingCount, pendingCapacity;
+
+    // GL thread only
+    double budgetSeconds;
+    saci_TextureRequest* uploading;
+    saci_u32 pbo;
+    saci_u32 copyFramebuffer; // reads the staging texture into the final one
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void* __sc_textureLoader_thread(void* args);
+void __sc_textureLoader_push(saci_TextureRequest** head, saci_TextureRequest** tail, saci_TextureRequest* request);
+saci_TextureRequest* __sc_textureLoader_pop(saci_TextureRequest** head, saci_TextureRequest** tail);
+saci_Bool __sc_textureLoader_unlink(saci_TextureRequest** head, saci_TextureRequest** tail,
+                                    saci_TextureRequest* request);
+saci_u32 __sc_textureLoader_find(const sc_TextureLoader* loader, saci_TextureID textureID);
+// Drops it from the pending list and frees it
+void __sc_textureLoader_finish(sc_TextureLoader* loader, saci_TextureRequest* request);
+// Uploads a strip of rows into the staging texture, or once all are there
+// copies it over the placeholder and builds the mipmaps. True when done
+saci_Bool __sc_textureLoader_uploadStep(sc_TextureLoader* loader, saci_TextureRequest* request);
+void __sc_textureLoader_copyToFinal(sc_TextureLoader* loader, saci_TextureRequest* request);
+
+//----------------------------------------------------------------------------//
+// Asynchronous loading
+//----------------------------------------------------------------------------//
+
+sc_TextureLoader* sc_CreateTextureLoader(saci_u32 threadCount, double uploadMilliseconds) {
+    if (!__sc_isGLLoaded()) {
+        fprintf(stderr, "The texture loader needs an OpenGL context.\n");
+        return NULL;
+    }
+    if (threadCount == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = cores > 0 ? (saci_u32)cores : 1;
+    }
+    if (threadCount > SACI_TEXTURE_LOADER_MAX_THREADS) threadCount = SACI_TEXTURE_LOADER_MAX_THREADS;
+    if (uploadMilliseconds <= 0.0) uploadMilliseconds = SACI_TEXTURE_LOADER_DEFAULT_BUDGET;
+
+    sc_TextureLoader* loader = (sc_TextureLoader*)calloc(1, sizeof(sc_TextureLoader));
+    assert(loader);
+    loader->budgetSeconds = uploadMilliseconds * 1e-3;
+    pthread_mutex_init(&loader->mutex, NULL);
+    pthread_cond_init(&loader->workAvailable, NULL);
+    for (saci_u32 i = 0; i < threadCount; ++i) {
+        if (pthread_create(&loader->threads[i], NULL, __sc_textureLoader_thread, loader) != 0) break;
+        loader->threadCount++;
+    }
+    if (loader->threadCount == 0) {
+        fprintf(stderr, "Failed to start the texture loader threads\n");
+        pthread_cond_destroy(&loader->workAvailable);
+        pthread_mutex_destroy(&loader->mutex);
+        free(loader);
+        return NULL;
+    }
+    glGenBuffers(1, &loader->pbo);
+    glGenFramebuffers(1, &loader->copyFramebuffer);
+    return loader;
+}
+
+void sc_DeleteTextureLoader(sc_TextureLoader* loader) {
+    if (!loader) return;
+
+    pthread_mutex_lock(&loader->mutex);
+    loader->shutdown = SACI_TRUE;
+    pthread_cond_broadcast(&loader->workAvailable);
+    pthread_mutex_unlock(&loader->mutex);
+    for (saci_u32 i = 0; i < loader->threadCount; ++i) {
+        pthread_join(loader->threads[i], NULL);
+    }
+
+    // Every request is in the pending list, whichever queue it was in
+    for (saci_u32 i = 0; i < loader->pendingCount; ++i) {
+        if (loader->pending[i]->staging) glDeleteTextures(1, &loader->pending[i]->staging);
+        stbi_image_free(loader->pending[i]->pixels);
+        free(loader->pending[i]->path);
+        free(loader->pending[i]);
+    }
+    glDeleteBuffers(1, &loader->pbo);
+    glDeleteFramebuffers(1, &loader->copyFramebuffer);
+    pthread_cond_destroy(&loader->workAvailable);
+    pthread_mutex_destroy(&loader->mutex);
+    free(loader->pending);
+    free(loader);
+}
+
+saci_TextureID sc_TextureLoadAsync(sc_TextureLoader* loader, const char* path, saci_Bool flipImg) {
+    if (loader->pendingCount == loader->pendingCapacity) {
+        saci_u32 newCapacity = loader->pendingCapacity ? loader->pendingCapacity * 2 : 64;
+        saci_TextureRequest** pending = (saci_TextureRequest**)realloc(loader->pending,
+                                                                       newCapacity * sizeof(saci_TextureRequest*));
+        if (!pending) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return 0;
+        }
+        loader->pending = pending;
+        loader->pendingCapacity = newCapacity;
+    }
+    saci_TextureRequest* request = (saci_TextureRequest*)calloc(1, sizeof(saci_TextureRequest));
+    char* pathCopy = strdup(path);
+    if (!request || !pathCopy) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        free(request);
+        free(pathCopy);
+        return 0;
+    }
+
+    // Filtering without mipmaps, the default filter would leave the
+    // placeholder incomplete and sampling black
+    saci_TextureID id;
+    glGenTextures(1, &id);
+    glBindTexture(GL_TEXTURE_2D, id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, sc_texturePlaceholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    request->id = id;
+    request->path = pathCopy;
+    request->flipImg = flipImg;
+    request->state = SACI_TEXTURE_REQUEST_QUEUED;
+    loader->pending[loader->pendingCount++] = request;
+
+    pthread_mutex_lock(&loader->mutex);
+    __sc_textureLoader_push(&loader->queuedHead, &loader->queuedTail, request);
+    pthread_cond_signal(&loader->workAvailable);
+    pthread_mutex_unlock(&loader->mutex);
+    return id;
+}
+
+void sc_TextureLoaderCancel(sc_TextureLoader* loader, saci_TextureID textureID) {
+    saci_u32 index = __sc_textureLoader_find(loader, textureID);
+    if (index == loader->pendingCount) {
+        sc_TextureFree(textureID);
+        return;
+    }
+    saci_TextureRequest* request = loader->pending[index];
+    glDeleteTextures(1, &textureID);
+
+    pthread_mutex_lock(&loader->mutex);
+    saci_Bool unlinked = SACI_FALSE;
+    switch (request->state) {
+        case SACI_TEXTURE_REQUEST_QUEUED:
+            unlinked = __sc_textureLoader_unlink(&loader->queuedHead, &loader->queuedTail, request);
+            break;
+        case SACI_TEXTURE_REQUEST_DECODED:
+            unlinked = __sc_textureLoader_unlink(&loader->decodedHead, &loader->decodedTail, request);
+            if (unlinked) {
+                loader->decodedCount--;
+                pthread_cond_broadcast(&loader->workAvailable);
+            }
+            break;
+        case SACI_TEXTURE_REQUEST_DECODING:
+            // The worker still has it, it's dropped when handed back
+            request->cancelled = SACI_TRUE;
+            break;
+        case SACI_TEXTURE_REQUEST_UPLOADING:
+            loader->uploading = NULL;
+            unlinked = SACI_TRUE;
+            break;
+    }
+    pthread_mutex_unlock(&loader->mutex);
+    if (unlinked) __sc_textureLoader_finish(loader, request);
+}
+
+void sc_TextureLoaderUpdate(sc_TextureLoader* loader) {
+    double start = saci_MonotonicSeconds();
+
+    do {
+        if (!loader->uploading) {
+            pthread_mutex_lock(&loader->mutex);
+            saci_TextureRequest* request = __sc_textureLoader_pop(&loader->decodedHead, &loader->decodedTail);
+            if (request) {
+                loader->decodedCount--;
+                pthread_cond_broadcast(&loader->workAvailable);
+            }
+            pthread_mutex_unlock(&loader->mutex);
+            if (!request) break;
+
+            if (request->cancelled) {
+                __sc_textureLoader_finish(loader, request);
+                continue;
+            }
+            if (!request->pixels) {
+                fprintf(stderr, "Failed to load texture %s\n", request->path);
+                __sc_textureLoader_finish(loader, request);
+                continue;
+            }
+            request->state = SACI_TEXTURE_REQUEST_UPLOADING;
+            loader->uploading = request;
+        }
+
+        if (__sc_textureLoader_uploadStep(loader, loader->uploading)) {
+            __sc_textureLoader_finish(loader, loader->uploading);
+            loader->uploading = NULL;
+        }
+    } while (saci_MonotonicSeconds() - start < loader->budgetSeconds);
+}
+
+saci_Bool sc_TextureLoaderIsPending(sc_TextureLoader* loader, saci_TextureID textureID) {
+    return __sc_textureLoader_find(loader, textureID) != loader->pendingCount;
+}
+
+saci_u32 sc_TextureLoaderPendingCount(sc_TextureLoader* loader) {
+    return loader->pendingCount;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void* __sc_textureLoader_thread(void* args) {
+    sc_TextureLoader* loader = (sc_TextureLoader*)args;
+    pthread_mutex_lock(&loader->mutex);
+    for (;;) {
+        while (!loader->shutdown &&
+               (!loader->queuedHead || loader->decodedCount >= SACI_TEXTURE_LOADER_MAX_DECODED)) {
+            pthread_cond_wait(&loader->workAvailable, &loader->mutex);
+        }
+        if (loader->shutdown) break;
+
+        saci_TextureRequest* request = __sc_textureLoader_pop(&loader->queuedHead, &loader->queuedTail);
+        request->state = SACI_TEXTURE_REQUEST_DECODING;
+        pthread_mutex_unlock(&loader->mutex);
+
+        // Same orientation as sc_TextureLoad, set per thread as the global
+        // flag would race with the other workers
+        int channels;
+        stbi_set_flip_vertically_on_load_thread(!request->flipImg);
+        saci_u8* pixels = stbi_load(request->path, &request->width, &request->height, &channels, 4);
+
+        pthread_mutex_lock(&loader->mutex);
+        request->pixels = pixels;
+        request->state = SACI_TEXTURE_REQUEST_DECODED;
+        __sc_textureLoader_push(&loader->decodedHead, &loader->decodedTail, request);
+        loader->decodedCount++;
+    }
+    pthread_mutex_unlock(&loader->mutex);
+    return NULL;
+}
+
+void __sc_textureLoader_push(saci_TextureRequest** head, saci_TextureRequest** tail, saci_TextureRequest* request) {
+    request->next = NULL;
+    if (*tail) {
+        (*tail)->next = request;
+    } else {
+        *head = request;
+    }
+    *tail = request;
+}
+
+saci_TextureRequest* __sc_textureLoader_pop(saci_TextureRequest** head, saci_TextureRequest** tail) {
+    saci_TextureRequest* request = *head;
+    if (!request) return NULL;
+    *head = request->next;
+    if (!*head) *tail = NULL;
+    request->next = NULL;
+    return request;
+}
+
+saci_Bool __sc_textureLoader_unlink(saci_TextureRequest** head, saci_TextureRequest** tail,
+                                    saci_TextureRequest* request) {
+    saci_TextureRequest* previous = NULL;
+    for (saci_TextureRequest* it = *head; it; previous = it, it = it->next) {
+        if (it != request) continue;
+        if (previous) {
+            previous->next = it->next;
+        } else {
+            *head = it->next;
+        }
+        if (*tail == it) *tail = previous;
+        it->next = NULL;
+        return SACI_TRUE;
+    }
+    return SACI_FALSE;
+}
+
+saci_u32 __sc_textureLoader_find(const sc_TextureLoader* loader, saci_TextureID textureID) {
+    for (saci_u32 i = 0; i < loader->pendingCount; ++i) {
+        // A cancelled request's ID may already belong to a new texture
+        if (loader->pending[i]->id == textureID && !loader->pending[i]->cancelled) return i;
+    }
+    return loader->pendingCount;
+}
+
+void __sc_textureLoader_finish(sc_TextureLoader* loader, saci_TextureRequest* request) {
+    for (saci_u32 i = 0; i < loader->pendingCount; ++i) {
+        if (loader->pending[i] != request) continue;
+        loader->pending[i] = loader->pending[--loader->pendingCount];
+        break;
+    }
+    if (request->staging) glDeleteTextures(1, &request->staging);
+    stbi_image_free(request->pixels);
+    free(request->path);
+    free(request);
+}
+
+saci_Bool __sc_textureLoader_uploadStep(sc_TextureLoader* loader, saci_TextureRequest* request) {
+    // The last step on its own, mipmaps of a large image take as long as a strip
+    if (request->rowsCopied == (saci_u32)request->height) {
+        __sc_textureLoader_copyToFinal(loader, request);
+        return SACI_TRUE;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (!request->staging) {
+        glGenTextures(1, &request->staging);
+        glBindTexture(GL_TEXTURE_2D, request->staging);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, request->width, request->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, request->staging);
+    }
+
+    size_t rowSize = (size_t)request->width * 4;
+    saci_u32 rows = (saci_u32)(SACI_TEXTURE_LOADER_STRIP_BYTES / rowSize);
+    if (rows == 0) rows = 1;
+    if (rows > (saci_u32)request->height - request->rowsCopied) rows = (saci_u32)request->height - request->rowsCopied;
+
+    // Fresh storage per strip, the previous one may still be read by the GPU
+    size_t size = rows * rowSize;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader->pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        memcpy(mapped, request->pixels + request->rowsCopied * rowSize, size);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, (GLint)request->rowsCopied, request->width, (GLsizei)rows, GL_RGBA,
+                        GL_UNSIGNED_BYTE, NULL);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    request->rowsCopied += rows;
+    return SACI_FALSE;
+}
+
+void __sc_textureLoader_copyToFinal(sc_TextureLoader* loader, saci_TextureRequest* request) {
+    // The whole image replaces the placeholder in one step, never half
+    // uploaded. A copy on the GPU, the ID handed out stays the same
+    GLint previousFramebuffer;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, loader->copyFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, request->staging, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    glBindTexture(GL_TEXTURE_2D, request->id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, request->width, request->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, request->width, request->height);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousFramebuffer);
+    glDeleteTextures(1, &request->staging);
+    request->staging = 0;
+    __sc_texture_recordSource(request->id, request->path, request->flipImg, request->width, request->height);
+}
@@ -1,7 +1,11 @@
 #include "saci-core/sc-texture.h"
+#include "sc-rendering-internal.h"
 
 #include <glad/glad.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stbi/stb_image.h>
@@ -14,10 +18,32 @@ saci_Bool __sc_isImageLoaded(saci_u8* data);
 saci_s32 __sc_determineTextureFormat(int nrChannels);
 void __sc_setupTexture(saci_TextureID id, saci_Bool useMipmaps);
 
+void __sc_texture_removeSource(saci_TextureID id); // caller holds the lock
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+// Remembers where textures came from, frame captures reference them by path
+typedef struct saci_TextureSource {
+    saci_TextureID id;
+    int width, height;
+    saci_Bool flipImg;
+    char* path;
+} saci_TextureSource;
+
+static struct {
+    saci_TextureSource* sources;
+    saci_u32 count;
+    saci_u32 capacity;
+} sc_textureSources;
+// Window groups load textures from several render threads
+static pthread_mutex_t sc_textureSourcesMutex = PTHREAD_MUTEX_INITIALIZER;
+
 //----------------------------------------------------------------------------//
 
 saci_u8* sc_TextureLoadData(const char* path, saci_Bool flipImg, sc_TextureData* texData) {
-    stbi_set_flip_vertically_on_load(!flipImg);
+    stbi_set_flip_vertically_on_load_thread(!flipImg);
     saci_u8* data = stbi_load(path, &texData->width, &texData->height, &texData->nrChannels, 0);
     assert(texData->width > 0);
     assert(texData->height > 0);
@@ -85,10 +111,12 @@ saci_TextureID sc_TextureLoad(const char* path, saci_Bool flipImg) {
         printf("OpenGL error: %x after glGenerateMipmap\n", err);
     }
     stbi_image_free(texData.data);
+    __sc_texture_recordSource(id, path, flipImg, texData.width, texData.height);
     return id;
 }
 
 void sc_TextureFree(saci_TextureID textureID) {
+    __sc_texture_forgetSource(textureID);
     glDeleteTextures(1, &textureID);
 }
 
@@ -111,6 +139,61 @@ saci_s32 __sc_determineTextureFormat(int nrChannels) {
     return 0; // Unsupported format
 }
 
+saci_Bool __sc_texture_getSource(saci_TextureID id, char** path, saci_Bool* flipImg, int* width, int* height) {
+    saci_Bool found = SACI_FALSE;
+    pthread_mutex_lock(&sc_textureSourcesMutex);
+    for (saci_u32 i = 0; i < sc_textureSources.count; ++i) {
+        const saci_TextureSource* source = &sc_textureSources.sources[i];
+        if (source->id != id) continue;
+        // Another thread may free or replace the record once unlocked
+        if (path) *path = source->path ? strdup(source->path) : NULL;
+        if (flipImg) *flipImg = source->flipImg;
+        *width = source->width;
+        *height = source->height;
+        found = SACI_TRUE;
+        break;
+    }
+    pthread_mutex_unlock(&sc_textureSourcesMutex);
+    return found;
+}
+
+void __sc_texture_recordSource(saci_TextureID id, const char* path, saci_Bool flipImg, int width, int height) {
+    pthread_mutex_lock(&sc_textureSourcesMutex);
+    __sc_texture_removeSource(id); // GL may hand out a freed name again
+    if (sc_textureSources.count == sc_textureSources.capacity) {
+        saci_u32 newCapacity = sc_textureSources.capacity ? sc_textureSources.capacity * 2 : 16;
+        saci_TextureSource* sources = (saci_TextureSource*)realloc(sc_textureSources.sources, newCapacity * sizeof(saci_TextureSource));
+        if (!sources) {
+            pthread_mutex_unlock(&sc_textureSourcesMutex);
+            return;
+        }
+        sc_textureSources.sources = sources;
+        sc_textureSources.capacity = newCapacity;
+    }
+    saci_TextureSource* source = &sc_textureSources.sources[sc_textureSources.count++];
+    source->id = id;
+    source->width = width;
+    source->height = height;
+    source->flipImg = flipImg;
+    source->path = strdup(path);
+    pthread_mutex_unlock(&sc_textureSourcesMutex);
+}
+
+void __sc_texture_forgetSource(saci_TextureID id) {
+    pthread_mutex_lock(&sc_textureSourcesMutex);
+    __sc_texture_removeSource(id);
+    pthread_mutex_unlock(&sc_textureSourcesMutex);
+}
+
+void __sc_texture_removeSource(saci_TextureID id) {
+    for (saci_u32 i = 0; i < sc_textureSources.count; ++i) {
+        if (sc_textureSources.sources[i].id != id) continue;
+        free(sc_textureSources.sources[i].path);
+        sc_textureSources.sources[i] = sc_textureSources.sources[--sc_textureSources.count];
+        return;
+    }
+}
+
 void __sc_setupTexture(saci_TextureID id, saci_Bool useMipmaps) {
     glBindTexture(GL_TEXTURE_2D, id);
 
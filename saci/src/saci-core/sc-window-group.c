@@ -0,0 +1,218 @@
+#include <glad/glad.h>
+
+#include <GLFW/glfw3.h>
+#include "saci-core/sc-window-group.h"
+#include "saci-core/sc-windowing.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct saci_GroupWindow {
+    sc_WindowGroup* group;
+    sc_Window* window;
+    sc_WindowRenderFunctions functions;
+
+    pthread_t thread;
+    saci_Bool threadRunning;
+    atomic_ullong frames;
+} saci_GroupWindow;
+
+struct sc_WindowGroup {
+    sc_Window* resourceWindow; // hidden, its context is the share root
+
+    saci_GroupWindow** windows; // pointers, threads keep theirs while this grows
+    saci_u32 windowCount;
+    saci_u32 windowCapacity;
+
+    saci_Bool running;
+    atomic_bool stop;
+};
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_GroupWindow* __sc_windowGroup_find(const sc_WindowGroup* group, sc_Window* window);
+void* __sc_windowGroup_renderThread(void* args);
+
+//----------------------------------------------------------------------------//
+// Window Group Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+sc_WindowGroup* sc_CreateWindowGroup(void) {
+    sc_WindowGroup* group = (sc_WindowGroup*)calloc(1, sizeof(sc_WindowGroup));
+    assert(group);
+    atomic_init(&group->stop, SACI_FALSE);
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    group->resourceWindow = glfwCreateWindow(1, 1, "", NULL, NULL);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (!group->resourceWindow) {
+        fprintf(stderr, "Could not create the window group's resource context.\n");
+        free(group);
+        return NULL;
+    }
+
+    // Function pointers are process wide, every context of the group comes
+    // from the same driver so loading once is enough
+    glfwMakeContextCurrent(group->resourceWindow);
+    if (!sc_GLADInit()) {
+        fprintf(stderr, "Could not load OpenGL for the window group.\n");
+        glfwDestroyWindow(group->resourceWindow);
+        free(group);
+        return NULL;
+    }
+    return group;
+}
+
+void sc_DeleteWindowGroup(sc_WindowGroup* group) {
+    sc_WindowGroupStop(group);
+    for (saci_u32 i = 0; i < group->windowCount; ++i) {
+        glfwDestroyWindow(group->windows[i]->window);
+        free(group->windows[i]);
+    }
+    free(group->windows);
+    if (glfwGetCurrentContext() == group->resourceWindow) {
+        glfwMakeContextCurrent(NULL);
+    }
+    glfwDestroyWindow(group->resourceWindow);
+    free(group);
+}
+
+sc_Window* sc_WindowGroupCreateWindow(sc_WindowGroup* group, int width, int height, const char* title,
+                                      sc_Monitor* monitor) {
+    if (group->running) {
+        fprintf(stderr, "Windows can't be added to a running window group.\n");
+        return NULL;
+    }
+    sc_Window* window = glfwCreateWindow(width, height, title, monitor, group->resourceWindow);
+    if (!window) return NULL;
+
+    if (group->windowCount == group->windowCapacity) {
+        saci_u32 capacity = group->windowCapacity ? group->windowCapacity * 2 : 4;
+        saci_GroupWindow** windows =
+            (saci_GroupWindow**)realloc(group->windows, sizeof(saci_GroupWindow*) * capacity);
+        assert(windows);
+        group->windows = windows;
+        group->windowCapacity = capacity;
+    }
+    saci_GroupWindow* entry = (saci_GroupWindow*)calloc(1, sizeof(saci_GroupWindow));
+    assert(entry);
+    entry->group = group;
+    entry->window = window;
+    entry->functions.swapInterval = 1;
+    atomic_init(&entry->frames, 0);
+    group->windows[group->windowCount++] = entry;
+
+    // glfwCreateWindow can leave the new context current
+    glfwMakeContextCurrent(group->resourceWindow);
+    return window;
+}
+
+//----------------------------------------------------------------------------//
+// Render threads
+//----------------------------------------------------------------------------//
+
+void sc_WindowGroupSetRenderFunctions(sc_WindowGroup* group, sc_Window* window,
+                                      const sc_WindowRenderFunctions* functions) {
+    saci_GroupWindow* entry = __sc_windowGroup_find(group, window);
+    if (!entry) {
+        fprintf(stderr, "Window is not part of this window group.\n");
+        return;
+    }
+    if (group->running) {
+        fprintf(stderr, "Render functions can't change while the window group runs.\n");
+        return;
+    }
+    entry->functions = *functions;
+}
+
+saci_Bool sc_WindowGroupStart(sc_WindowGroup* group) {
+    if (group->running) return SACI_TRUE;
+
+    // Everything uploaded so far has to be complete before another context
+    // touches it
+    glFinish();
+
+    atomic_store(&group->stop, SACI_FALSE);
+    group->running = SACI_TRUE;
+    for (saci_u32 i = 0; i < group->windowCount; ++i) {
+        saci_GroupWindow* entry = group->windows[i];
+        if (!entry->functions.frame) continue;
+
+        atomic_store(&entry->frames, 0);
+        if (pthread_create(&entry->thread, NULL, __sc_windowGroup_renderThread, entry) != 0) {
+            fprintf(stderr, "Could not start a render thread.\n");
+            sc_WindowGroupStop(group);
+            return SACI_FALSE;
+        }
+        entry->threadRunning = SACI_TRUE;
+    }
+    return SACI_TRUE;
+}
+
+void sc_WindowGroupStop(sc_WindowGroup* group) {
+    if (!group->running) return;
+
+    atomic_store(&group->stop, SACI_TRUE);
+    for (saci_u32 i = 0; i < group->windowCount; ++i) {
+        saci_GroupWindow* entry = group->windows[i];
+        if (!entry->threadRunning) continue;
+        pthread_join(entry->thread, NULL);
+        entry->threadRunning = SACI_FALSE;
+    }
+    group->running = SACI_FALSE;
+}
+
+saci_Bool sc_WindowGroupShouldClose(const sc_WindowGroup* group) {
+    for (saci_u32 i = 0; i < group->windowCount; ++i) {
+        if (glfwWindowShouldClose(group->windows[i]->window)) return SACI_TRUE;
+    }
+    return SACI_FALSE;
+}
+
+void sc_WindowGroupSyncResources(sc_WindowGroup* group) {
+    (void)group;
+    glFinish();
+}
+
+saci_u64 sc_WindowGroupFrameCount(const sc_WindowGroup* group, sc_Window* window) {
+    saci_GroupWindow* entry = __sc_windowGroup_find(group, window);
+    return entry ? atomic_load(&entry->frames) : 0;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_GroupWindow* __sc_windowGroup_find(const sc_WindowGroup* group, sc_Window* window) {
+    for (saci_u32 i = 0; i < group->windowCount; ++i) {
+        if (group->windows[i]->window == window) return group->windows[i];
+    }
+    return NULL;
+}
+
+void* __sc_windowGroup_renderThread(void* args) {
+    saci_GroupWindow* entry = (saci_GroupWindow*)args;
+    const sc_WindowRenderFunctions* functions = &entry->functions;
+
+    glfwMakeContextCurrent(entry->window);
+    glfwSwapInterval(functions->swapInterval);
+
+    if (functions->init) functions->init(entry->window, functions->userData);
+
+    saci_u64 frame = 0;
+    while (!atomic_load(&entry->group->stop)) {
+        functions->frame(entry->window, frame, functions->userData);
+        glfwSwapBuffers(entry->window);
+        atomic_store(&entry->frames, ++frame);
+    }
+
+    if (functions->shutdown) functions->shutdown(entry->window, functions->userData);
+    glfwMakeContextCurrent(NULL);
+    return NULL;
+}
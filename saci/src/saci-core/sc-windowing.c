@@ -53,3 +53,7 @@ void sc_ClearWindow(saci_Color color) {
 void sc_SwapWindowBuffer(sc_Window* window) {
     glfwSwapBuffers(window);
 }
+
+void sc_SetSwapInterval(int interval) {
+    glfwSwapInterval(interval);
+}
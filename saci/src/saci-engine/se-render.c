@@ -0,0 +1,166 @@
+#include "saci-engine/se-render.h"
+#include "se-world-internal.h"
+
+#include "saci-core/sc-mesh.h"
+#include "saci-utils/su-math.h"
+#include "saci-utils/su-types.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_Bool __se_render_reserve(se_World* world, saci_u32 meshCount, saci_u32 spriteCount);
+void __se_render_buildMeshes(const se_QueryChunk* chunk, void* userData);
+void __se_render_buildSprites(const se_QueryChunk* chunk, void* userData);
+// By mesh then entity order, and by group then entity order
+int __se_render_compareMesh(const void* a, const void* b);
+int __se_render_compareGroup(const void* a, const void* b);
+
+//----------------------------------------------------------------------------//
+// World Rendering
+//----------------------------------------------------------------------------//
+
+void se_WorldRender(se_World* world, sc_Renderer* renderer) {
+    saci_u64 transform = SACI_COMPONENT_BIT(SACI_COMPONENT_TRANSFORM);
+    saci_u64 meshes = transform | SACI_COMPONENT_BIT(SACI_COMPONENT_MESH);
+    saci_u64 sprites = transform | SACI_COMPONENT_BIT(SACI_COMPONENT_SPRITE);
+    saci_u32 meshCount = se_WorldQueryCount(world, meshes, 0);
+    saci_u32 spriteCount = se_WorldQueryCount(world, sprites, 0);
+    if (!__se_render_reserve(world, meshCount, spriteCount)) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+
+    saci_WorldRenderScratch* scratch = &world->render;
+    if (meshCount > 0) {
+        se_WorldQueryParallel(world, meshes, 0, __se_render_buildMeshes, scratch);
+
+        // Instances of a mesh go out back to back so the backend binds its
+        // buffers and texture once for all of them. Meshes keep the order of
+        // their first entity, and instances the order of their entities
+        saci_WorldMeshKey* keys = scratch->meshKeys;
+        for (saci_u32 i = 0; i < meshCount; ++i) keys[i] = (saci_WorldMeshKey){scratch->meshes[i], i, i};
+        qsort(keys, meshCount, sizeof(saci_WorldMeshKey), __se_render_compareMesh);
+        for (saci_u32 i = 1; i < meshCount; ++i) {
+            if (keys[i].mesh == keys[i - 1].mesh) keys[i].group = keys[i - 1].group;
+        }
+        qsort(keys, meshCount, sizeof(saci_WorldMeshKey), __se_render_compareGroup);
+
+        for (saci_u32 i = 0; i < meshCount; ++i) {
+            if (keys[i].mesh) sc_RenderPushMesh(renderer, keys[i].mesh, &scratch->models[keys[i].index]);
+        }
+    }
+
+    if (spriteCount > 0) {
+        se_WorldQueryParallel(world, sprites, 0, __se_render_buildSprites, scratch);
+        saci_u32 first = 0;
+        for (saci_u32 i = 1; i <= spriteCount; ++i) {
+            if (i < spriteCount && scratch->textures[i] == scratch->textures[first]) continue;
+            sc_RenderPushVertices(renderer, scratch->vertices + (size_t)first * 6, (size_t)(i - first) * 6,
+                                  scratch->textures[first]);
+            first = i;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+void __se_world_freeRenderScratch(se_World* world) {
+    saci_WorldRenderScratch* scratch = &world->render;
+    free(scratch->models);
+    free(scratch->meshes);
+    free(scratch->meshKeys);
+    free(scratch->vertices);
+    free(scratch->textures);
+}
+
+saci_Bool __se_render_reserve(se_World* world, saci_u32 meshCount, saci_u32 spriteCount) {
+    saci_WorldRenderScratch* scratch = &world->render;
+    if (meshCount > scratch->meshCapacity) {
+        saci_Mat4* models = (saci_Mat4*)realloc(scratch->models, meshCount * sizeof(saci_Mat4));
+        if (!models) return SACI_FALSE;
+        scratch->models = models;
+        sc_Mesh** meshes = (sc_Mesh**)realloc(scratch->meshes, meshCount * sizeof(sc_Mesh*));
+        if (!meshes) return SACI_FALSE;
+        scratch->meshes = meshes;
+        saci_WorldMeshKey* keys = (saci_WorldMeshKey*)realloc(scratch->meshKeys, meshCount * sizeof(saci_WorldMeshKey));
+        if (!keys) return SACI_FALSE;
+        scratch->meshKeys = keys;
+        scratch->meshCapacity = meshCount;
+    }
+    if (spriteCount > scratch->spriteCapacity) {
+        saci_Vertice* vertices = (saci_Vertice*)realloc(scratch->vertices, (size_t)spriteCount * 6 * sizeof(saci_Vertice));
+        if (!vertices) return SACI_FALSE;
+        scratch->vertices = vertices;
+        saci_TextureID* textures = (saci_TextureID*)realloc(scratch->textures, spriteCount * sizeof(saci_TextureID));
+        if (!textures) return SACI_FALSE;
+        scratch->textures = textures;
+        scratch->spriteCapacity = spriteCount;
+    }
+    return SACI_TRUE;
+}
+
+void __se_render_buildMeshes(const se_QueryChunk* chunk, void* userData) {
+    saci_WorldRenderScratch* scratch = (saci_WorldRenderScratch*)userData;
+    const se_Transform* transforms = (const se_Transform*)chunk->columns[SACI_COMPONENT_TRANSFORM];
+    const se_MeshRenderable* renderables = (const se_MeshRenderable*)chunk->columns[SACI_COMPONENT_MESH];
+    saci_Mat4* models = scratch->models + chunk->firstIndex;
+    sc_Mesh** meshes = scratch->meshes + chunk->firstIndex;
+    for (saci_u32 i = 0; i < chunk->count; ++i) {
+        models[i] = saci_TRSMat4(transforms[i].position, transforms[i].rotation, transforms[i].scale);
+        meshes[i] = renderables[i].mesh;
+    }
+}
+
+void __se_render_buildSprites(const se_QueryChunk* chunk, void* userData) {
+    saci_WorldRenderScratch* scratch = (saci_WorldRenderScratch*)userData;
+    const se_Transform* transforms = (const se_Transform*)chunk->columns[SACI_COMPONENT_TRANSFORM];
+    const se_Sprite* sprites = (const se_Sprite*)chunk->columns[SACI_COMPONENT_SPRITE];
+    saci_Vertice* vertices = scratch->vertices + (size_t)chunk->firstIndex * 6;
+    saci_TextureID* textures = scratch->textures + chunk->firstIndex;
+    for (saci_u32 i = 0; i < chunk->count; ++i, vertices += 6) {
+        const se_Transform* transform = &transforms[i];
+        const se_Sprite* sprite = &sprites[i];
+        float c = cosf(transform->rotation.z), s = sinf(transform->rotation.z);
+        float hx = 0.5f * sprite->size.x * transform->scale.x;
+        float hy = 0.5f * sprite->size.y * transform->scale.y;
+        // Half extents along the turned X and Y axes
+        saci_Vec2 ax = {c * hx, s * hx};
+        saci_Vec2 ay = {-s * hy, c * hy};
+        saci_Vec3 p = transform->position;
+
+        saci_Vertice bottomLeft = {{p.x - ax.x - ay.x, p.y - ax.y - ay.y, p.z}, sprite->color, {0, 0}};
+        saci_Vertice bottomRight = {{p.x + ax.x - ay.x, p.y + ax.y - ay.y, p.z}, sprite->color, {1, 0}};
+        saci_Vertice topRight = {{p.x + ax.x + ay.x, p.y + ax.y + ay.y, p.z}, sprite->color, {1, 1}};
+        saci_Vertice topLeft = {{p.x - ax.x + ay.x, p.y - ax.y + ay.y, p.z}, sprite->color, {0, 1}};
+        vertices[0] = bottomLeft;
+        vertices[1] = bottomRight;
+        vertices[2] = topRight;
+        vertices[3] = bottomLeft;
+        vertices[4] = topRight;
+        vertices[5] = topLeft;
+        textures[i] = sprite->textureID;
+    }
+}
+
+int __se_render_compareMesh(const void* a, const void* b) {
+    const saci_WorldMeshKey* keyA = (const saci_WorldMeshKey*)a;
+    const saci_WorldMeshKey* keyB = (const saci_WorldMeshKey*)b;
+    uintptr_t meshA = (uintptr_t)keyA->mesh, meshB = (uintptr_t)keyB->mesh;
+    if (meshA != meshB) return (meshA > meshB) - (meshA < meshB);
+    return (keyA->index > keyB->index) - (keyA->index < keyB->index);
+}
+
+int __se_render_compareGroup(const void* a, const void* b) {
+    const saci_WorldMeshKey* keyA = (const saci_WorldMeshKey*)a;
+    const saci_WorldMeshKey* keyB = (const saci_WorldMeshKey*)b;
+    if (keyA->group != keyB->group) return (keyA->group > keyB->group) - (keyA->group < keyB->group);
+    return (keyA->index > keyB->index) - (keyA->index < keyB->index);
+}
@@ -0,0 +1,77 @@
+#ifndef __SACI_ENGINE_SE_WORLD_INTERNAL_H__
+#define __SACI_ENGINE_SE_WORLD_INTERNAL_H__
+
+#include "saci-engine/se-world.h"
+#include "saci-core/sc-rendering.h"
+
+// Rows per chunk of a parallel query
+#define SACI_ECS_CHUNK_ROWS 1024
+#define SACI_ECS_NO_ARCHETYPE 0xFFFFFFFFu
+
+typedef struct saci_Archetype {
+    saci_u64 components;
+    se_Entity* entities;
+    void* columns[SACI_ECS_MAX_COMPONENTS]; // NULL for missing components and tags
+    saci_u32 count, capacity;
+} saci_Archetype;
+
+typedef struct saci_EntityRecord {
+    saci_u32 generation; // from 1 and bumped on destroy, 0 is never a live handle
+    saci_u32 archetype;  // SACI_ECS_NO_ARCHETYPE once destroyed
+    saci_u32 row;
+} saci_EntityRecord;
+
+// A slice of one archetype a query visits
+typedef struct saci_QueryRange {
+    saci_u32 archetype;
+    saci_u32 first, count;
+    saci_u32 firstIndex;
+} saci_QueryRange;
+
+// A mesh entity's row in the scratch, sorted so instances of a mesh are
+// pushed back to back
+typedef struct saci_WorldMeshKey {
+    sc_Mesh* mesh;
+    saci_u32 index;
+    saci_u32 group; // index of the mesh's first entity
+} saci_WorldMeshKey;
+
+// Scratch se_WorldRender fills on the job pool
+typedef struct saci_WorldRenderScratch {
+    saci_Mat4* models;
+    sc_Mesh** meshes;
+    saci_WorldMeshKey* meshKeys;
+    saci_u32 meshCapacity;
+    saci_Vertice* vertices; // 6 per sprite
+    saci_TextureID* textures;
+    saci_u32 spriteCapacity;
+} saci_WorldRenderScratch;
+
+struct se_World {
+    saci_JobPool* jobs;
+
+    size_t componentSizes[SACI_ECS_MAX_COMPONENTS];
+    saci_u32 componentCount;
+
+    saci_Archetype* archetypes;
+    saci_u32 archetypeCount, archetypeCapacity;
+
+    saci_EntityRecord* records; // by entity index
+    saci_u32 recordCount, recordCapacity;
+    saci_u32* freeIndices;
+    saci_u32 freeCount, freeCapacity;
+    saci_u32 entityCount;
+
+    saci_QueryRange* ranges; // rebuilt by every query
+    saci_u32 rangeCapacity;
+
+    saci_WorldRenderScratch render;
+};
+
+// Entity handle helpers
+#define __se_entityIndex(entity) ((saci_u32)((entity) & 0xFFFFFFFFu))
+#define __se_entityGeneration(entity) ((saci_u32)((entity) >> 32))
+
+void __se_world_freeRenderScratch(se_World* world);
+
+#endif
@@ -0,0 +1,347 @@
+#include "saci-engine/se-world.h"
+#include "se-world-internal.h"
+
+#include "saci-utils/su-general.h"
+#include "saci-utils/su-jobs.h"
+#include "saci-utils/su-types.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------//
+// Base Definitions
+//----------------------------------------------------------------------------//
+
+typedef struct saci_QueryJob {
+    se_World* world;
+    se_SystemFunction system;
+    void* userData;
+} saci_QueryJob;
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+// Finds or creates the archetype, SACI_ECS_NO_ARCHETYPE if it couldn't be
+saci_u32 __se_world_archetype(se_World* world, saci_u64 components);
+// Appends a zeroed row, returns its index or SACI_ECS_NO_ARCHETYPE
+saci_u32 __se_archetype_addRow(se_World* world, saci_Archetype* archetype, se_Entity entity);
+// Swap removes row, fixing the record of the entity moved into it
+void __se_archetype_removeRow(se_World* world, saci_Archetype* archetype, saci_u32 row);
+void __se_world_move(se_World* world, se_Entity entity, saci_u64 components);
+saci_Bool __se_world_matches(const saci_Archetype* archetype, saci_u64 with, saci_u64 without);
+void __se_world_fillChunk(const se_World* world, const saci_QueryRange* range, se_QueryChunk* chunk);
+void __se_world_queryJob(void* userData, saci_u32 index, saci_u32 workerIndex);
+
+//----------------------------------------------------------------------------//
+// World Initialization/Deletion
+//----------------------------------------------------------------------------//
+
+se_World* se_CreateWorld(saci_JobPool* jobs) {
+    se_World* world = (se_World*)calloc(1, sizeof(se_World));
+    assert(world);
+    world->jobs = jobs;
+
+    saci_u32 transform = se_WorldRegisterComponent(world, sizeof(se_Transform));
+    saci_u32 mesh = se_WorldRegisterComponent(world, sizeof(se_MeshRenderable));
+    saci_u32 sprite = se_WorldRegisterComponent(world, sizeof(se_Sprite));
+    assert(transform == SACI_COMPONENT_TRANSFORM && mesh == SACI_COMPONENT_MESH && sprite == SACI_COMPONENT_SPRITE);
+    (void)transform;
+    (void)mesh;
+    (void)sprite;
+    return world;
+}
+
+void se_DeleteWorld(se_World* world) {
+    if (!world) return;
+    for (saci_u32 i = 0; i < world->archetypeCount; ++i) {
+        saci_Archetype* archetype = &world->archetypes[i];
+        for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) free(archetype->columns[c]);
+        free(archetype->entities);
+    }
+    free(world->archetypes);
+    free(world->records);
+    free(world->freeIndices);
+    free(world->ranges);
+    __se_world_freeRenderScratch(world);
+    free(world);
+}
+
+saci_u32 se_WorldRegisterComponent(se_World* world, size_t size) {
+    if (world->componentCount >= SACI_ECS_MAX_COMPONENTS) {
+        fprintf(stderr, "Too many components.\n");
+        return SACI_ECS_MAX_COMPONENTS;
+    }
+    world->componentSizes[world->componentCount] = size;
+    return world->componentCount++;
+}
+
+//----------------------------------------------------------------------------//
+// Entities
+//----------------------------------------------------------------------------//
+
+se_Entity se_WorldCreateEntity(se_World* world, saci_u64 components) {
+    if (world->componentCount < SACI_ECS_MAX_COMPONENTS && components >> world->componentCount) {
+        fprintf(stderr, "Unregistered component.\n");
+        return SACI_NULL_ENTITY;
+    }
+    saci_u32 archetypeIndex = __se_world_archetype(world, components);
+    if (archetypeIndex == SACI_ECS_NO_ARCHETYPE) return SACI_NULL_ENTITY;
+
+    saci_u32 index;
+    saci_Bool reused = world->freeCount > 0;
+    if (reused) {
+        index = world->freeIndices[--world->freeCount];
+    } else {
+        if (!saci_Reserve((void**)&world->records, &world->recordCapacity, world->recordCount + 1,
+                          sizeof(saci_EntityRecord))) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return SACI_NULL_ENTITY;
+        }
+        index = world->recordCount++;
+        world->records[index].generation = 1;
+        world->records[index].archetype = SACI_ECS_NO_ARCHETYPE;
+    }
+
+    saci_EntityRecord* record = &world->records[index];
+    se_Entity entity = ((se_Entity)record->generation << 32) | index;
+    saci_u32 row = __se_archetype_addRow(world, &world->archetypes[archetypeIndex], entity);
+    if (row == SACI_ECS_NO_ARCHETYPE) {
+        // Given back where it came from, the free list still has its slot
+        if (reused) {
+            world->freeIndices[world->freeCount++] = index;
+        } else {
+            world->recordCount--;
+        }
+        return SACI_NULL_ENTITY;
+    }
+    record->archetype = archetypeIndex;
+    record->row = row;
+    world->entityCount++;
+    return entity;
+}
+
+void se_WorldDestroyEntity(se_World* world, se_Entity entity) {
+    if (!se_WorldIsAlive(world, entity)) return;
+    saci_u32 index = __se_entityIndex(entity);
+    if (!saci_Reserve((void**)&world->freeIndices, &world->freeCapacity, world->freeCount + 1, sizeof(saci_u32))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return;
+    }
+
+    saci_EntityRecord* record = &world->records[index];
+    __se_archetype_removeRow(world, &world->archetypes[record->archetype], record->row);
+    record->archetype = SACI_ECS_NO_ARCHETYPE;
+    record->generation = record->generation == 0xFFFFFFFFu ? 1 : record->generation + 1;
+    world->freeIndices[world->freeCount++] = index;
+    world->entityCount--;
+}
+
+void se_WorldAddComponents(se_World* world, se_Entity entity, saci_u64 components) {
+    if (!se_WorldIsAlive(world, entity)) return;
+    saci_u64 current = world->archetypes[world->records[__se_entityIndex(entity)].archetype].components;
+    if ((current | components) != current) __se_world_move(world, entity, current | components);
+}
+
+void se_WorldRemoveComponents(se_World* world, se_Entity entity, saci_u64 components) {
+    if (!se_WorldIsAlive(world, entity)) return;
+    saci_u64 current = world->archetypes[world->records[__se_entityIndex(entity)].archetype].components;
+    if ((current & ~components) != current) __se_world_move(world, entity, current & ~components);
+}
+
+saci_Bool se_WorldIsAlive(const se_World* world, se_Entity entity) {
+    saci_u32 index = __se_entityIndex(entity);
+    if (index >= world->recordCount) return SACI_FALSE;
+    const saci_EntityRecord* record = &world->records[index];
+    return record->archetype != SACI_ECS_NO_ARCHETYPE && record->generation == __se_entityGeneration(entity);
+}
+
+saci_u32 se_WorldEntityCount(const se_World* world) {
+    return world->entityCount;
+}
+
+saci_u64 se_WorldGetComponents(const se_World* world, se_Entity entity) {
+    if (!se_WorldIsAlive(world, entity)) return 0;
+    return world->archetypes[world->records[__se_entityIndex(entity)].archetype].components;
+}
+
+void* se_WorldGetComponent(se_World* world, se_Entity entity, saci_u32 component) {
+    if (component >= SACI_ECS_MAX_COMPONENTS || !se_WorldIsAlive(world, entity)) return NULL;
+    const saci_EntityRecord* record = &world->records[__se_entityIndex(entity)];
+    saci_Archetype* archetype = &world->archetypes[record->archetype];
+    if (!archetype->columns[component]) return NULL;
+    return (saci_u8*)archetype->columns[component] + (size_t)record->row * world->componentSizes[component];
+}
+
+//----------------------------------------------------------------------------//
+// Queries
+//----------------------------------------------------------------------------//
+
+void se_WorldQuery(se_World* world, saci_u64 with, saci_u64 without, se_SystemFunction system, void* userData) {
+    saci_u32 firstIndex = 0;
+    for (saci_u32 i = 0; i < world->archetypeCount; ++i) {
+        const saci_Archetype* archetype = &world->archetypes[i];
+        if (!__se_world_matches(archetype, with, without)) continue;
+        saci_QueryRange range = {i, 0, archetype->count, firstIndex};
+        se_QueryChunk chunk;
+        __se_world_fillChunk(world, &range, &chunk);
+        system(&chunk, userData);
+        firstIndex += archetype->count;
+    }
+}
+
+void se_WorldQueryParallel(se_World* world, saci_u64 with, saci_u64 without, se_SystemFunction system,
+                           void* userData) {
+    if (!world->jobs || saci_JobPoolThreadCount(world->jobs) <= 1) {
+        se_WorldQuery(world, with, without, system, userData);
+        return;
+    }
+
+    // Every archetype in slices of SACI_ECS_CHUNK_ROWS, one job each
+    saci_u32 rangeCount = 0;
+    saci_u32 firstIndex = 0;
+    for (saci_u32 i = 0; i < world->archetypeCount; ++i) {
+        const saci_Archetype* archetype = &world->archetypes[i];
+        if (!__se_world_matches(archetype, with, without)) continue;
+        for (saci_u32 first = 0; first < archetype->count; first += SACI_ECS_CHUNK_ROWS) {
+            if (!saci_Reserve((void**)&world->ranges, &world->rangeCapacity, rangeCount + 1, sizeof(saci_QueryRange))) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                se_WorldQuery(world, with, without, system, userData);
+                return;
+            }
+            saci_u32 count = archetype->count - first < SACI_ECS_CHUNK_ROWS ? archetype->count - first : SACI_ECS_CHUNK_ROWS;
+            world->ranges[rangeCount++] = (saci_QueryRange){i, first, count, firstIndex};
+            firstIndex += count;
+        }
+    }
+
+    saci_QueryJob job = {world, system, userData};
+    saci_JobPoolParallelFor(world->jobs, rangeCount, __se_world_queryJob, &job);
+}
+
+saci_u32 se_WorldQueryCount(const se_World* world, saci_u64 with, saci_u64 without) {
+    saci_u32 count = 0;
+    for (saci_u32 i = 0; i < world->archetypeCount; ++i) {
+        if (__se_world_matches(&world->archetypes[i], with, without)) count += world->archetypes[i].count;
+    }
+    return count;
+}
+
+//----------------------------------------------------------------------------//
+// Helper functions
+//----------------------------------------------------------------------------//
+
+saci_u32 __se_world_archetype(se_World* world, saci_u64 components) {
+    for (saci_u32 i = 0; i < world->archetypeCount; ++i) {
+        if (world->archetypes[i].components == components) return i;
+    }
+    if (!saci_Reserve((void**)&world->archetypes, &world->archetypeCapacity, world->archetypeCount + 1,
+                      sizeof(saci_Archetype))) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return SACI_ECS_NO_ARCHETYPE;
+    }
+    saci_Archetype* archetype = &world->archetypes[world->archetypeCount];
+    memset(archetype, 0, sizeof(saci_Archetype));
+    archetype->components = components;
+    return world->archetypeCount++;
+}
+
+saci_u32 __se_archetype_addRow(se_World* world, saci_Archetype* archetype, se_Entity entity) {
+    if (archetype->count == archetype->capacity) {
+        saci_u32 capacity = archetype->capacity ? archetype->capacity * 2 : 64;
+        // Columns grow one by one, those that made it just stay larger
+        for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) {
+            size_t size = world->componentSizes[c];
+            if (!(archetype->components & SACI_COMPONENT_BIT(c)) || size == 0) continue;
+            void* column = realloc(archetype->columns[c], capacity * size);
+            if (!column) {
+                fprintf(stderr, "Memory allocation failed.\n");
+                return SACI_ECS_NO_ARCHETYPE;
+            }
+            archetype->columns[c] = column;
+        }
+        se_Entity* entities = (se_Entity*)realloc(archetype->entities, capacity * sizeof(se_Entity));
+        if (!entities) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            return SACI_ECS_NO_ARCHETYPE;
+        }
+        archetype->entities = entities;
+        archetype->capacity = capacity;
+    }
+
+    saci_u32 row = archetype->count++;
+    archetype->entities[row] = entity;
+    for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) {
+        if (!archetype->columns[c]) continue;
+        size_t size = world->componentSizes[c];
+        memset((saci_u8*)archetype->columns[c] + (size_t)row * size, 0, size);
+    }
+    return row;
+}
+
+void __se_archetype_removeRow(se_World* world, saci_Archetype* archetype, saci_u32 row) {
+    saci_u32 last = --archetype->count;
+    if (row == last) return;
+    for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) {
+        if (!archetype->columns[c]) continue;
+        size_t size = world->componentSizes[c];
+        saci_u8* column = (saci_u8*)archetype->columns[c];
+        memcpy(column + (size_t)row * size, column + (size_t)last * size, size);
+    }
+    se_Entity moved = archetype->entities[last];
+    archetype->entities[row] = moved;
+    world->records[__se_entityIndex(moved)].row = row;
+}
+
+void __se_world_move(se_World* world, se_Entity entity, saci_u64 components) {
+    if (world->componentCount < SACI_ECS_MAX_COMPONENTS && components >> world->componentCount) {
+        fprintf(stderr, "Unregistered component.\n");
+        return;
+    }
+    saci_EntityRecord* record = &world->records[__se_entityIndex(entity)];
+    saci_u32 targetIndex = __se_world_archetype(world, components);
+    if (targetIndex == SACI_ECS_NO_ARCHETYPE) return;
+
+    // The archetype array may have moved while adding the target
+    saci_Archetype* source = &world->archetypes[record->archetype];
+    saci_Archetype* target = &world->archetypes[targetIndex];
+    saci_u32 row = __se_archetype_addRow(world, target, entity);
+    if (row == SACI_ECS_NO_ARCHETYPE) return;
+
+    for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) {
+        if (!source->columns[c] || !target->columns[c]) continue;
+        size_t size = world->componentSizes[c];
+        memcpy((saci_u8*)target->columns[c] + (size_t)row * size,
+               (saci_u8*)source->columns[c] + (size_t)record->row * size, size);
+    }
+    __se_archetype_removeRow(world, source, record->row);
+    record->archetype = targetIndex;
+    record->row = row;
+}
+
+saci_Bool __se_world_matches(const saci_Archetype* archetype, saci_u64 with, saci_u64 without) {
+    return archetype->count > 0 && (archetype->components & with) == with && !(archetype->components & without);
+}
+
+void __se_world_fillChunk(const se_World* world, const saci_QueryRange* range, se_QueryChunk* chunk) {
+    const saci_Archetype* archetype = &world->archetypes[range->archetype];
+    chunk->count = range->count;
+    chunk->firstIndex = range->firstIndex;
+    chunk->workerIndex = 0;
+    chunk->entities = archetype->entities + range->first;
+    for (saci_u32 c = 0; c < SACI_ECS_MAX_COMPONENTS; ++c) {
+        chunk->columns[c] = archetype->columns[c]
+                                ? (saci_u8*)archetype->columns[c] + (size_t)range->first * world->componentSizes[c]
+                                : NULL;
+    }
+}
+
+void __se_world_queryJob(void* userData, saci_u32 index, saci_u32 workerIndex) {
+    saci_QueryJob* job = (saci_QueryJob*)userData;
+    se_QueryChunk chunk;
+    __se_world_fillChunk(job->world, &job->world->ranges[index], &chunk);
+    chunk.workerIndex = workerIndex;
+    job->system(&chunk, job->userData);
+}
@@ -0,0 +1,48 @@
+#include "saci-utils/su-general.h"
+
+#include "saci-utils/su-types.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define SACI_RESERVE_MIN_CAPACITY 16
+#define SACI_FNV1A_PRIME 16777619u
+
+//------------------------------------------------------------------------------
+// Memory
+//------------------------------------------------------------------------------
+
+saci_Bool saci_Reserve(void** data, saci_u32* capacity, saci_u32 needed, size_t elementSize) {
+    if (needed <= *capacity) return SACI_TRUE;
+    saci_u32 newCapacity = *capacity ? *capacity : SACI_RESERVE_MIN_CAPACITY;
+    while (newCapacity < needed) newCapacity *= 2;
+    void* newData = realloc(*data, newCapacity * elementSize);
+    if (!newData) return SACI_FALSE;
+    *data = newData;
+    *capacity = newCapacity;
+    return SACI_TRUE;
+}
+
+//------------------------------------------------------------------------------
+// Hashing
+//------------------------------------------------------------------------------
+
+saci_u32 saci_HashFNV1a(const void* data, size_t size, saci_u32 seed) {
+    const saci_u8* bytes = (const saci_u8*)data;
+    saci_u32 hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= SACI_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+// Time
+//------------------------------------------------------------------------------
+
+double saci_MonotonicSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
@@ -0,0 +1,162 @@
+#include "saci-utils/su-jobs.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SACI_JOBS_MAX_THREADS 64
+
+struct saci_JobPool {
+    pthread_t threads[SACI_JOBS_MAX_THREADS];
+    saci_u32 threadCount; // includes the dispatching thread
+
+    pthread_mutex_t mutex;
+    pthread_cond_t workAvailable;
+    pthread_cond_t workDone;
+
+    saci_u64 generation; // bumped on every dispatch so sleeping workers wake up once
+    saci_u32 busyWorkers;
+    saci_Bool shutdown;
+
+    saci_JobFunction jobFunction;
+    void* userData;
+    saci_u32 count;
+    atomic_uint nextIndex;
+};
+
+typedef struct saci_JobWorkerArgs {
+    saci_JobPool* pool;
+    saci_u32 workerIndex;
+} saci_JobWorkerArgs;
+
+//------------------------------------------------------------------------------
+// Helper functions
+//------------------------------------------------------------------------------
+
+void __saci_jobPool_drain(saci_JobPool* pool, saci_u32 workerIndex);
+void* __saci_jobPool_worker(void* args);
+
+//------------------------------------------------------------------------------
+
+saci_JobPool* saci_CreateJobPool(saci_u32 threadCount) {
+    if (threadCount == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = cores > 0 ? (saci_u32)cores : 1;
+    }
+    if (threadCount > SACI_JOBS_MAX_THREADS) threadCount = SACI_JOBS_MAX_THREADS;
+
+    saci_JobPool* pool = (saci_JobPool*)calloc(1, sizeof(saci_JobPool));
+    assert(pool);
+    pool->threadCount = threadCount;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->workDone, NULL);
+    atomic_init(&pool->nextIndex, 0);
+
+    // Worker 0 is whoever calls saci_JobPoolParallelFor
+    for (saci_u32 i = 1; i < threadCount; ++i) {
+        saci_JobWorkerArgs* args = (saci_JobWorkerArgs*)malloc(sizeof(saci_JobWorkerArgs));
+        assert(args);
+        args->pool = pool;
+        args->workerIndex = i;
+        if (pthread_create(&pool->threads[i], NULL, __saci_jobPool_worker, args) != 0) {
+            free(args);
+            pool->threadCount = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+void saci_DeleteJobPool(saci_JobPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = SACI_TRUE;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (saci_u32 i = 1; i < pool->threadCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->workDone);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+saci_u32 saci_JobPoolThreadCount(const saci_JobPool* pool) {
+    return pool->threadCount;
+}
+
+void saci_JobPoolParallelFor(saci_JobPool* pool, saci_u32 count,
+                             saci_JobFunction jobFunction, void* userData) {
+    if (count == 0) return;
+
+    if (pool->threadCount <= 1 || count == 1) {
+        for (saci_u32 i = 0; i < count; ++i) jobFunction(userData, i, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->jobFunction = jobFunction;
+    pool->userData = userData;
+    pool->count = count;
+    atomic_store(&pool->nextIndex, 0);
+    pool->busyWorkers = pool->threadCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->mutex);
+
+    __saci_jobPool_drain(pool, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->busyWorkers > 0) {
+        pthread_cond_wait(&pool->workDone, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+//------------------------------------------------------------------------------
+// Helper functions
+//------------------------------------------------------------------------------
+
+void __saci_jobPool_drain(saci_JobPool* pool, saci_u32 workerIndex) {
+    for (;;) {
+        saci_u32 index = atomic_fetch_add(&pool->nextIndex, 1);
+        if (index >= pool->count) break;
+        pool->jobFunction(pool->userData, index, workerIndex);
+    }
+}
+
+void* __saci_jobPool_worker(void* args) {
+    saci_JobWorkerArgs workerArgs = *(saci_JobWorkerArgs*)args;
+    free(args);
+    saci_JobPool* pool = workerArgs.pool;
+
+    saci_u64 seenGeneration = 0;
+    for (;;) {
+        pthread_mutex_lock(&pool->mutex);
+        while (!pool->shutdown && pool->generation == seenGeneration) {
+            pthread_cond_wait(&pool->workAvailable, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            pthread_mutex_unlock(&pool->mutex);
+            break;
+        }
+        seenGeneration = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        __saci_jobPool_drain(pool, workerArgs.workerIndex);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->busyWorkers == 0) {
+            pthread_cond_signal(&pool->workDone);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return NULL;
+}
@@ -100,6 +100,26 @@ saci_u32 saci_HexFromColor(saci_Color color) {
                    (saci_u32)(color.a * SACI_8BIT_COLOR_MAX);
     return hex;
 }
+
+saci_ColorU8 saci_ColorU8FromHex(saci_u32 hex) {
+    saci_ColorU8 color = {(saci_u8)(hex >> 24), (saci_u8)(hex >> 16), (saci_u8)(hex >> 8), (saci_u8)hex};
+    return color;
+}
+
+saci_ColorU8 saci_ColorU8FromColor(saci_Color color) {
+    float channels[4] = {color.r, color.g, color.b, color.a};
+    saci_u8 bytes[4];
+    for (int i = 0; i < 4; ++i) {
+        float c = channels[i] < 0.0f ? 0.0f : (channels[i] > 1.0f ? 1.0f : channels[i]);
+        bytes[i] = (saci_u8)(c * SACI_8BIT_COLOR_MAX + 0.5f);
+    }
+    saci_ColorU8 result = {bytes[0], bytes[1], bytes[2], bytes[3]};
+    return result;
+}
+
+saci_Color saci_ColorFromColorU8(saci_ColorU8 color) {
+    return saci_ColorFromU8(color.r, color.g, color.b, color.a);
+}
 //------------------------------------------------------------------------------
 // Mat4
 //------------------------------------------------------------------------------
@@ -169,3 +189,79 @@ saci_Mat4 saci_OrthoMat4(float left, float right, float bottom, float top, float
 
     return result;
 }
+
+saci_Bool saci_InverseMat4(saci_Mat4 mat, saci_Mat4* result) {
+    // Cofactor expansion on the flat array, the layout doesn't matter since
+    // the inverse of a transpose is the transpose of the inverse
+    const float* m = &mat.m[0][0];
+    float inv[16];
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] +
+             m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] -
+             m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] +
+             m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] -
+              m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] -
+             m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] +
+             m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] -
+             m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] +
+              m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] +
+             m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] -
+             m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] +
+              m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] -
+              m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] -
+             m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] +
+             m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] -
+              m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] +
+              m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == 0.0f) return SACI_FALSE;
+
+    float invDet = 1.0f / det;
+    float* out = &result->m[0][0];
+    for (int i = 0; i < 16; i++) {
+        out[i] = inv[i] * invDet;
+    }
+    return SACI_TRUE;
+}
+
+saci_Mat4 saci_TRSMat4(saci_Vec3 translation, saci_Vec3 rotation, saci_Vec3 scale) {
+    float cx = cosf(rotation.x), sx = sinf(rotation.x);
+    float cy = cosf(rotation.y), sy = sinf(rotation.y);
+    float cz = cosf(rotation.z), sz = sinf(rotation.z);
+
+    // Column major, m[column][row]: Rz * Ry * Rx scaled per column
+    saci_Mat4 m;
+    m.m[0][0] = cz * cy * scale.x;
+    m.m[0][1] = sz * cy * scale.x;
+    m.m[0][2] = -sy * scale.x;
+    m.m[0][3] = 0.0f;
+    m.m[1][0] = (cz * sy * sx - sz * cx) * scale.y;
+    m.m[1][1] = (sz * sy * sx + cz * cx) * scale.y;
+    m.m[1][2] = cy * sx * scale.y;
+    m.m[1][3] = 0.0f;
+    m.m[2][0] = (cz * sy * cx + sz * sx) * scale.z;
+    m.m[2][1] = (sz * sy * cx - cz * sx) * scale.z;
+    m.m[2][2] = cy * cx * scale.z;
+    m.m[2][3] = 0.0f;
+    m.m[3][0] = translation.x;
+    m.m[3][1] = translation.y;
+    m.m[3][2] = translation.z;
+    m.m[3][3] = 1.0f;
+    return m;
+}
@@ -0,0 +1,265 @@
+// saci-replay: replays a capture written by sc_RenderCaptureBegin/End and
+// reports frame times, so the same workload can be compared across backends
+// and commits
+//
+// usage: saci-replay <capture> [-n iterations] [-b null|software|gl] [-s WxH] [-o out.ppm] [-p on|off]
+
+#include <glad/glad.h>
+
+#include <GLFW/glfw3.h>
+#include <saci-core.h>
+#include <saci-core/sc-texture.h>
+#include <saci-utils/su-math.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct saci_ReplayOptions {
+    const char* capturePath;
+    const char* outputPath;
+    sc_RendererBackend backend;
+    int iterations;
+    int width, height;
+    saci_Bool depthPrePass;
+} saci_ReplayOptions;
+
+static double replay_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void replay_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s <capture> [-n iterations] [-b null|software|gl] [-s WxH] [-o out.ppm] [-p on|off]\n"
+            "  -n  times the whole capture is replayed (default 1)\n"
+            "  -b  backend to replay on (default software)\n"
+            "  -s  target size (default 800x600)\n"
+            "  -o  write the last replayed frame as a PPM (software backend only)\n"
+            "  -p  depth pre-pass for frames with the z buffer on (default off)\n",
+            program);
+}
+
+static saci_Bool replay_parseArgs(int argc, char** argv, saci_ReplayOptions* options) {
+    options->capturePath = NULL;
+    options->outputPath = NULL;
+    options->backend = SACI_RENDER_BACKEND_SOFTWARE;
+    options->iterations = 1;
+    options->width = 800;
+    options->height = 600;
+    options->depthPrePass = SACI_FALSE;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (arg[0] != '-') {
+            options->capturePath = arg;
+            continue;
+        }
+        if (!value) return SACI_FALSE;
+        ++i;
+        if (strcmp(arg, "-n") == 0) {
+            options->iterations = atoi(value);
+            if (options->iterations < 1) return SACI_FALSE;
+        } else if (strcmp(arg, "-b") == 0) {
+            if (strcmp(value, "null") == 0) options->backend = SACI_RENDER_BACKEND_NULL;
+            else if (strcmp(value, "software") == 0) options->backend = SACI_RENDER_BACKEND_SOFTWARE;
+            else if (strcmp(value, "gl") == 0) options->backend = SACI_RENDER_BACKEND_OPENGL;
+            else return SACI_FALSE;
+        } else if (strcmp(arg, "-s") == 0) {
+            if (sscanf(value, "%dx%d", &options->width, &options->height) != 2 ||
+                options->width <= 0 || options->height <= 0) {
+                return SACI_FALSE;
+            }
+        } else if (strcmp(arg, "-o") == 0) {
+            options->outputPath = value;
+        } else if (strcmp(arg, "-p") == 0) {
+            if (strcmp(value, "on") == 0) options->depthPrePass = SACI_TRUE;
+            else if (strcmp(value, "off") == 0) options->depthPrePass = SACI_FALSE;
+            else return SACI_FALSE;
+        } else {
+            return SACI_FALSE;
+        }
+    }
+    return options->capturePath != NULL;
+}
+
+// Textures are reloaded from the paths saci recorded; anything that can't be
+// found is replaced by a checkerboard of the recorded size so the rasterizer
+// still does comparable sampling work
+static void replay_mapTextures(sc_RenderCapture* capture, sc_RendererBackend backend) {
+    saci_u32 count = sc_RenderCaptureTextureCount(capture);
+    for (saci_u32 i = 0; i < count; ++i) {
+        sc_RenderCaptureTexture texture = sc_RenderCaptureGetTexture(capture, i);
+        saci_TextureID replayID = 0;
+
+        if (backend == SACI_RENDER_BACKEND_NULL) continue;
+
+        if (backend == SACI_RENDER_BACKEND_SOFTWARE) {
+            if (texture.path) replayID = sc_RenderSoftwareTextureLoad(texture.path, texture.flipImg);
+            if (!replayID) {
+                int width = texture.width > 0 ? texture.width : 64;
+                int height = texture.height > 0 ? texture.height : 64;
+                saci_u8* rgba = (saci_u8*)malloc((size_t)width * height * 4);
+                if (!rgba) continue;
+                for (int y = 0; y < height; ++y) {
+                    for (int x = 0; x < width; ++x) {
+                        saci_u8 value = (((x >> 3) ^ (y >> 3)) & 1) ? 255 : 64;
+                        saci_u8* pixel = &rgba[((size_t)y * width + x) * 4];
+                        pixel[0] = pixel[1] = pixel[2] = value;
+                        pixel[3] = 255;
+                    }
+                }
+                replayID = sc_RenderSoftwareTextureCreate(rgba, width, height);
+                free(rgba);
+            }
+        } else if (texture.path) {
+            replayID = sc_TextureLoad(texture.path, texture.flipImg);
+        }
+
+        if (!replayID) {
+            fprintf(stderr, "saci-replay: texture %u (%s) unavailable\n", texture.id,
+                    texture.path ? texture.path : "not loaded from a file");
+            continue;
+        }
+        sc_RenderCaptureMapTexture(capture, texture.id, replayID);
+    }
+}
+
+static saci_Bool replay_writePPM(const char* path, const sc_Renderer* renderer) {
+    int width, height;
+    const saci_u8* pixels = sc_RenderSoftwareGetPixels(renderer, &width, &height);
+    if (!pixels) return SACI_FALSE;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return SACI_FALSE;
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (int i = 0; i < width * height; ++i) {
+        fwrite(&pixels[i * 4], 1, 3, file);
+    }
+    fclose(file);
+    return SACI_TRUE;
+}
+
+int main(int argc, char** argv) {
+    saci_ReplayOptions options;
+    if (!replay_parseArgs(argc, argv, &options)) {
+        replay_usage(argv[0]);
+        return 1;
+    }
+
+    saci_InitMath();
+
+    sc_RenderCapture* capture = sc_RenderCaptureLoad(options.capturePath);
+    if (!capture) {
+        fprintf(stderr, "saci-replay: can't load capture %s\n", options.capturePath);
+        return 1;
+    }
+    saci_u32 frameCount = sc_RenderCaptureFrameCount(capture);
+    if (frameCount == 0) {
+        fprintf(stderr, "saci-replay: %s has no frames\n", options.capturePath);
+        sc_RenderCaptureFree(capture);
+        return 1;
+    }
+
+    sc_Window* window = NULL;
+    sc_Renderer* renderer = NULL;
+    if (options.backend == SACI_RENDER_BACKEND_OPENGL) {
+        if (!sc_GLFWInit()) {
+            fprintf(stderr, "saci-replay: can't init GLFW\n");
+            sc_RenderCaptureFree(capture);
+            return 1;
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        window = sc_CreateWindow(options.width, options.height, "saci-replay", NULL, NULL);
+        if (!window) {
+            fprintf(stderr, "saci-replay: can't create a GL context\n");
+            sc_Terminate();
+            sc_RenderCaptureFree(capture);
+            return 1;
+        }
+        sc_MakeWindowContext(window);
+        sc_GLADInit();
+        glViewport(0, 0, options.width, options.height);
+        renderer = sc_CreateRenderer(SACI_TRUE);
+    } else {
+        renderer = sc_CreateRendererWithBackend(options.backend, SACI_TRUE);
+        if (options.backend == SACI_RENDER_BACKEND_SOFTWARE) {
+            sc_RenderSoftwareSetSize(renderer, options.width, options.height);
+        }
+    }
+
+    replay_mapTextures(capture, options.backend);
+
+    // Frames keep the rest of their recorded config, see sc_RenderCaptureReplayFrame
+    sc_RenderConfig config = sc_RenderGetDefaultConfig();
+    config.depthPrePass = options.depthPrePass;
+    sc_RenderSetConfig(renderer, &config);
+    sc_RenderSetOverdrawCounter(renderer, SACI_TRUE);
+    double samplesShaded = 0.0;
+    int samplesFrames = 0;
+
+    const saci_Color clearColor = {0.0f, 0.0f, 0.0f, 1.0f};
+    double minFrame = 1e30, maxFrame = 0.0;
+    double start = replay_now();
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (saci_u32 frame = 0; frame < frameCount; ++frame) {
+            double frameStart = replay_now();
+            if (options.backend == SACI_RENDER_BACKEND_SOFTWARE) {
+                sc_RenderSoftwareClear(renderer, clearColor);
+            } else if (options.backend == SACI_RENDER_BACKEND_OPENGL) {
+                sc_ClearWindow(clearColor);
+            }
+
+            sc_RenderCaptureReplayFrame(renderer, capture, frame);
+
+            // Without waiting the GL timings would only measure submission
+            if (options.backend == SACI_RENDER_BACKEND_OPENGL) glFinish();
+
+            double frameTime = replay_now() - frameStart;
+            if (frameTime < minFrame) minFrame = frameTime;
+            if (frameTime > maxFrame) maxFrame = frameTime;
+
+            sc_RenderStats frameStats;
+            sc_RenderGetStats(renderer, &frameStats, NULL);
+            if (frameStats.samplesShaded) {
+                samplesShaded += (double)frameStats.samplesShaded;
+                samplesFrames++;
+            }
+        }
+    }
+    double total = replay_now() - start;
+    double replayed = (double)frameCount * options.iterations;
+
+    sc_RenderStats stats;
+    sc_RenderGetStats(renderer, NULL, &stats);
+
+    printf("capture     %s (%u frames, %u textures)\n", options.capturePath, frameCount,
+           sc_RenderCaptureTextureCount(capture));
+    printf("replayed    %.0f frames in %.3f s\n", replayed, total);
+    printf("frame time  avg %.3f ms  min %.3f ms  max %.3f ms  (%.1f fps)\n",
+           total / replayed * 1e3, minFrame * 1e3, maxFrame * 1e3, replayed / total);
+    printf("per frame   %.1f draw calls  %.0f triangles  %.0f vertices\n",
+           (double)stats.drawCalls / replayed, (double)stats.triangles / replayed,
+           (double)stats.vertices / replayed);
+    if (samplesFrames > 0) {
+        printf("overdraw    %.2f shaded samples per pixel%s\n",
+               samplesShaded / samplesFrames / ((double)options.width * options.height),
+               options.depthPrePass ? " (depth pre-pass)" : "");
+    }
+
+    int result = 0;
+    if (options.outputPath) {
+        if (options.backend != SACI_RENDER_BACKEND_SOFTWARE || !replay_writePPM(options.outputPath, renderer)) {
+            fprintf(stderr, "saci-replay: can't write %s\n", options.outputPath);
+            result = 1;
+        }
+    }
+
+    sc_DeleteRenderer(renderer);
+    sc_RenderCaptureFree(capture);
+    if (window) sc_Terminate();
+    return result;
+}